@@ -0,0 +1,549 @@
+// End-to-end pipeline benchmark
+//
+// Replays recorded monitor videos or frame dumps through the same
+// VitalSignExtractor / EcgClassifier code as the app, with the database and
+// CSV output either skipped or pointed at local files, and reports
+// throughput, per-stage latency percentiles, CPU time and peak RSS as JSON.
+//
+// Build: make bench
+// Run:   ./build/bench [options] <video|image|directory>...
+//        ./build/bench [options] --synthetic N
+//
+// Options:
+//   --config PATH      config.json to take OCR/ML settings from
+//   --output PATH      write the JSON report to PATH instead of stdout
+//   --max-frames N     stop after N frames (0 = all)
+//   --warmup N         frames processed before measurement starts (default 5)
+//   --no-ml            skip the classifier
+//   --csv PATH         append result rows to a CSV file
+//   --sqlite PATH      insert results into a SQLite database
+//   --tag TEXT         free-form label copied into the report
+//   --alloc-budget N   exit with status 3 if steady-state heap allocations
+//                      per frame average above N (needs make ALLOC_TRACKING=1)
+//
+// Synthetic input (rendered frames with known values; adds an accuracy block):
+//   --synthetic N      render N frames instead of reading inputs
+//   --seed S           generator seed (default 1)
+//   --layout NAME      "column" or "row"
+//   --font NAME        simplex, duplex, plain, complex, triplex
+//   --noise SIGMA      Gaussian pixel noise
+//   --blur K           Gaussian blur kernel size
+//   --perspective F    max corner offset as a fraction of the frame
+
+#include "src/config/ConfigManager.h"
+#include "src/database/DatabaseManager.h"
+#include "src/ml/EcgClassifier.h"
+#include "src/monitoring/AllocTracker.h"
+#include "src/ocr/VitalSignExtractor.h"
+#include "src/output/CsvSink.h"
+#include "src/pipeline/FramePool.h"
+#include "src/sim/SyntheticMonitor.h"
+#include "src/utils/Logger.h"
+#include "src/utils/TimestampFormatter.h"
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/videoio.hpp>
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct Options {
+    std::string configPath = "config/config.json";
+    std::string outputPath;
+    std::string csvPath;
+    std::string sqlitePath;
+    std::string tag;
+    long maxFrames = 0;
+    long warmupFrames = 5;
+    double allocBudget = -1.0;
+    bool ml = true;
+    std::vector<std::string> inputs;
+    long syntheticFrames = 0;
+    uint64_t seed = 1;
+    SyntheticMonitorStyle style;
+};
+
+// Stages reported in the JSON, in pipeline order
+enum Stage { DECODE, OCR, PREPROCESS, ML, CSV, DB, FRAME, STAGE_COUNT };
+const char* const kStageNames[STAGE_COUNT] = {"decode", "ocr", "preprocess", "ml", "csv", "db", "frame"};
+
+bool isVideo(const fs::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".mp4" || ext == ".avi" || ext == ".mkv" || ext == ".mov" || ext == ".h264";
+}
+
+bool isImage(const fs::path& path) {
+    std::string ext = path.extension().string();
+    std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".bmp" || ext == ".ppm";
+}
+
+// Walks the inputs in order: video files frame by frame, images (frame
+// dumps) one frame each. Directories are expanded in sorted order.
+class FrameSource {
+public:
+    explicit FrameSource(const std::vector<std::string>& inputs) {
+        for (const auto& input : inputs) {
+            fs::path path(input);
+            if (fs::is_directory(path)) {
+                std::vector<fs::path> entries;
+                for (const auto& entry : fs::directory_iterator(path)) {
+                    if (entry.is_regular_file() && (isVideo(entry.path()) || isImage(entry.path()))) {
+                        entries.push_back(entry.path());
+                    }
+                }
+                std::sort(entries.begin(), entries.end());
+                files_.insert(files_.end(), entries.begin(), entries.end());
+            } else if (fs::exists(path)) {
+                files_.push_back(path);
+            } else {
+                fprintf(stderr, "bench: skipping missing input %s\n", input.c_str());
+            }
+        }
+    }
+    
+    size_t fileCount() const { return files_.size(); }
+    
+    bool next(cv::Mat& frame) {
+        while (true) {
+            if (capture_.isOpened()) {
+                if (capture_.read(frame) && !frame.empty()) {
+                    return true;
+                }
+                capture_.release();
+            }
+            if (index_ >= files_.size()) {
+                return false;
+            }
+            
+            const fs::path& path = files_[index_++];
+            if (isVideo(path)) {
+                if (!capture_.open(path.string())) {
+                    fprintf(stderr, "bench: cannot open video %s\n", path.c_str());
+                }
+                continue;
+            }
+            frame = cv::imread(path.string(), cv::IMREAD_COLOR);
+            if (!frame.empty()) {
+                return true;
+            }
+            fprintf(stderr, "bench: cannot read image %s\n", path.c_str());
+        }
+    }
+    
+private:
+    std::vector<fs::path> files_;
+    size_t index_ = 0;
+    cv::VideoCapture capture_;
+};
+
+// Every measured value is kept, so percentiles are exact (nearest rank)
+// instead of the upper bound of a histogram bucket
+class Samples {
+public:
+    void reserve(size_t n) { values_.reserve(n); }
+    void record(uint64_t value) {
+        values_.push_back(value);
+        sum_ += value;
+        sorted_ = false;
+    }
+    size_t count() const { return values_.size(); }
+    double mean() const { return values_.empty() ? 0.0 : static_cast<double>(sum_) / values_.size(); }
+    uint64_t quantile(double q) {
+        if (values_.empty()) {
+            return 0;
+        }
+        if (!sorted_) {
+            std::sort(values_.begin(), values_.end());
+            sorted_ = true;
+        }
+        size_t rank = static_cast<size_t>(std::ceil(q * values_.size()));
+        return values_[std::min(values_.size(), std::max<size_t>(rank, 1)) - 1];
+    }
+
+private:
+    std::vector<uint64_t> values_;
+    uint64_t sum_ = 0;
+    bool sorted_ = true;
+};
+
+double cpuSeconds(const rusage& usage) {
+    return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec / 1e6 +
+           usage.ru_stime.tv_sec + usage.ru_stime.tv_usec / 1e6;
+}
+
+void usage(const char* argv0) {
+    fprintf(stderr,
+            "Usage: %s [--config PATH] [--output PATH] [--max-frames N] [--warmup N]\n"
+            "          [--no-ml] [--csv PATH] [--sqlite PATH] [--tag TEXT] [--alloc-budget N] <input>...\n"
+            "       %s [options] --synthetic N [--seed S] [--layout column|row] [--font NAME]\n"
+            "          [--noise SIGMA] [--blur K] [--perspective F]\n",
+            argv0,
+            argv0);
+}
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        auto value = [&](const char* name) -> const char* {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "bench: %s needs a value\n", name);
+                return nullptr;
+            }
+            return argv[++i];
+        };
+        const char* v = nullptr;
+        if (arg == "--config") { if (!(v = value("--config"))) return false; options.configPath = v; }
+        else if (arg == "--output") { if (!(v = value("--output"))) return false; options.outputPath = v; }
+        else if (arg == "--max-frames") { if (!(v = value("--max-frames"))) return false; options.maxFrames = atol(v); }
+        else if (arg == "--warmup") { if (!(v = value("--warmup"))) return false; options.warmupFrames = atol(v); }
+        else if (arg == "--csv") { if (!(v = value("--csv"))) return false; options.csvPath = v; }
+        else if (arg == "--sqlite") { if (!(v = value("--sqlite"))) return false; options.sqlitePath = v; }
+        else if (arg == "--tag") { if (!(v = value("--tag"))) return false; options.tag = v; }
+        else if (arg == "--alloc-budget") { if (!(v = value("--alloc-budget"))) return false; options.allocBudget = atof(v); }
+        else if (arg == "--synthetic") { if (!(v = value("--synthetic"))) return false; options.syntheticFrames = atol(v); }
+        else if (arg == "--seed") { if (!(v = value("--seed"))) return false; options.seed = strtoull(v, nullptr, 10); }
+        else if (arg == "--layout") { if (!(v = value("--layout"))) return false; options.style.layout = v; }
+        else if (arg == "--font") { if (!(v = value("--font"))) return false; options.style.fontFace = SyntheticMonitorStyle::fontFromName(v); }
+        else if (arg == "--noise") { if (!(v = value("--noise"))) return false; options.style.noiseSigma = atof(v); }
+        else if (arg == "--blur") { if (!(v = value("--blur"))) return false; options.style.blurKernel = atoi(v); }
+        else if (arg == "--perspective") { if (!(v = value("--perspective"))) return false; options.style.perspective = atof(v); }
+        else if (arg == "--no-ml") { options.ml = false; }
+        else if (arg == "--help" || arg == "-h") { return false; }
+        else if (!arg.empty() && arg[0] == '-') { fprintf(stderr, "bench: unknown option %s\n", arg.c_str()); return false; }
+        else { options.inputs.push_back(arg); }
+    }
+    return !options.inputs.empty() || options.syntheticFrames > 0;
+}
+
+void writeJsonString(FILE* out, const std::string& text) {
+    fputc('"', out);
+    for (char c : text) {
+        if (c == '"' || c == '\\') fputc('\\', out);
+        if (static_cast<unsigned char>(c) < 0x20) { fprintf(out, "\\u%04x", c); continue; }
+        fputc(c, out);
+    }
+    fputc('"', out);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (options.allocBudget >= 0 && !AllocTracker::kCompiled) {
+        fprintf(stderr, "bench: --alloc-budget needs a build with ALLOC_TRACKING=1\n");
+        return 2;
+    }
+    
+    ConfigManager& config = ConfigManager::getInstance();
+    if (!config.loadConfig(options.configPath)) {
+        fprintf(stderr, "bench: using default configuration\n");
+    }
+    std::shared_ptr<const ConfigSnapshot> cfg = config.snapshot();
+    
+    // Keep the log quiet so console output does not skew the numbers
+    Logger::getInstance().init("", LogLevel::WARN, true, false);
+    
+    VitalSignExtractor extractor;
+    if (!extractor.init(cfg->ocr.language, cfg->vitalSigns.labels, cfg->vitalSigns.defaultSpO2)) {
+        fprintf(stderr, "bench: could not initialize Tesseract (%s)\n", cfg->ocr.language.c_str());
+        return 1;
+    }
+    EcgClassifier classifier;
+    
+    DatabaseManager& db = DatabaseManager::getInstance();
+    bool dbEnabled = false;
+    if (!options.sqlitePath.empty()) {
+        dbEnabled = db.initSQLite(options.sqlitePath, cfg->database.sqliteBatchSize,
+                                  cfg->database.sqliteFlushIntervalMs) && db.createTables();
+        if (!dbEnabled) {
+            fprintf(stderr, "bench: SQLite output disabled\n");
+        }
+    }
+    
+    // Same buffering as the live CSV output, without rotation
+    CsvSink csvFile;
+    if (!options.csvPath.empty()) {
+        CsvSinkOptions csvOptions;
+        csvOptions.path = options.csvPath;
+        csvOptions.bufferBytes = static_cast<size_t>(std::max(0, cfg->output.csvBufferKb)) * 1024;
+        csvOptions.flushIntervalMs = std::max(0, cfg->output.csvFlushIntervalMs);
+        csvFile.open(csvOptions);
+    }
+    
+    const bool synthetic = options.syntheticFrames > 0;
+    FrameSource source(options.inputs);
+    if (!synthetic && source.fileCount() == 0) {
+        fprintf(stderr, "bench: no readable inputs\n");
+        return 1;
+    }
+    if (synthetic) {
+        options.maxFrames = options.maxFrames > 0 ? std::min(options.maxFrames, options.syntheticFrames)
+                                                  : options.syntheticFrames;
+    }
+    SyntheticMonitorGenerator generator(options.style, options.seed);
+    SyntheticVitals truth;
+    
+    // Exact-match counts against the generator's ground truth
+    long hrCorrect = 0, spo2Correct = 0, abpCorrect = 0, allCorrect = 0;
+    
+    // Latencies are recorded in microseconds; reserved up front so recording
+    // does not allocate inside the measured loop
+    std::vector<Samples> stages(STAGE_COUNT);
+    Samples frameAllocs;
+    if (options.maxFrames > 0) {
+        for (Samples& samples : stages) {
+            samples.reserve(static_cast<size_t>(options.maxFrames));
+        }
+        frameAllocs.reserve(static_cast<size_t>(options.maxFrames));
+    }
+    auto elapsedUs = [](std::chrono::steady_clock::time_point since) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - since).count());
+    };
+    
+    AllocTracker& allocs = AllocTracker::getInstance();
+    allocs.setWarmupFrames(options.warmupFrames);
+    
+    // Frames are read into a reused buffer, as in the app, sized from the
+    // first decoded frame so real recordings never reallocate it
+    cv::Mat firstFrame;
+    int frameWidth = options.style.width;
+    int frameHeight = options.style.height;
+    if (!synthetic) {
+        if (!source.next(firstFrame)) {
+            fprintf(stderr, "bench: no decodable frames\n");
+            return 1;
+        }
+        frameWidth = firstFrame.cols;
+        frameHeight = firstFrame.rows;
+    }
+    FramePool framePool;
+    if (!framePool.init("bench", 1, frameWidth, frameHeight, FrameBackpressure::Block)) {
+        fprintf(stderr, "bench: cannot allocate frame buffer\n");
+        return 1;
+    }
+    
+    long frames = 0;
+    long measured = 0;
+    rusage usageStart{};
+    auto wallStart = std::chrono::steady_clock::now();
+    
+    while (options.maxFrames == 0 || frames < options.maxFrames) {
+        bool measuring = frames >= options.warmupFrames;
+        if (frames == options.warmupFrames) {
+            getrusage(RUSAGE_SELF, &usageStart);
+            wallStart = std::chrono::steady_clock::now();
+        }
+        
+        AllocFrameScope allocFrame;
+        auto frameStart = std::chrono::steady_clock::now();
+        FramePool::Frame slot = framePool.acquire();
+        cv::Mat& frame = slot.mat();
+        {
+            ALLOC_STAGE(Capture);
+            if (synthetic) {
+                generator.next(frame, truth);
+            } else if (!firstFrame.empty()) {
+                firstFrame.copyTo(frame);
+                firstFrame.release();
+            } else if (!source.next(frame)) {
+                break;
+            }
+        }
+        uint64_t decodeUs = elapsedUs(frameStart);
+        
+        auto t = std::chrono::steady_clock::now();
+        std::map<std::string, std::string> healthData;
+        {
+            ALLOC_STAGE(Ocr);
+            healthData = extractor.processFrame(frame, cfg->ocr.confidenceThreshold);
+        }
+        uint64_t ocrUs = elapsedUs(t);
+        
+        t = std::chrono::steady_clock::now();
+        cv::Mat cropped;
+        {
+            ALLOC_STAGE(Preprocess);
+            classifier.prepare(frame, cropped);
+        }
+        uint64_t preprocessUs = elapsedUs(t);
+        
+        EcgResult result;
+        uint64_t mlUs = 0;
+        if (options.ml) {
+            ALLOC_STAGE(Ml);
+            t = std::chrono::steady_clock::now();
+            result = classifier.run();
+            mlUs = elapsedUs(t);
+        }
+        
+        auto rowTime = std::chrono::system_clock::now();
+        char timeBuf[TimestampFormatter::kBufferSize];
+        TimestampFormatter::formatSeconds(rowTime, timeBuf);
+        std::string timeStr(timeBuf, TimestampFormatter::kSecondsLength);
+        
+        t = std::chrono::steady_clock::now();
+        if (csvFile.isOpen()) {
+            ALLOC_STAGE(Output);
+            csvFile.write(CsvRecord{rowTime, {}, healthData["HR"], healthData["SpO2"], healthData["ABP"],
+                                    result.label, result.confidence});
+        }
+        uint64_t csvUs = elapsedUs(t);
+        
+        t = std::chrono::steady_clock::now();
+        if (dbEnabled) {
+            ALLOC_STAGE(Db);
+            VitalSignData data;
+            data.timestamp = timeStr;
+            data.hr = healthData["HR"];
+            data.spo2 = healthData["SpO2"];
+            data.abp = healthData["ABP"];
+            data.ecg_classification = result.label;
+            data.ecg_confidence = result.confidence;
+            db.insertVitalSign(data);
+        }
+        uint64_t dbUs = elapsedUs(t);
+        allocFrame.end();
+        
+        if (measuring) {
+            stages[DECODE].record(decodeUs);
+            stages[OCR].record(ocrUs);
+            stages[PREPROCESS].record(preprocessUs);
+            if (options.ml) stages[ML].record(mlUs);
+            if (csvFile.isOpen()) stages[CSV].record(csvUs);
+            if (dbEnabled) stages[DB].record(dbUs);
+            stages[FRAME].record(elapsedUs(frameStart));
+            if (AllocTracker::kCompiled) frameAllocs.record(allocs.lastFrameAllocs());
+            measured++;
+            
+            if (synthetic) {
+                bool hrOk = healthData["HR"] == std::to_string(truth.hr);
+                bool spo2Ok = healthData["SpO2"] == std::to_string(truth.spo2);
+                bool abpOk = healthData["ABP"] == truth.abp();
+                hrCorrect += hrOk;
+                spo2Correct += spo2Ok;
+                abpCorrect += abpOk;
+                allCorrect += hrOk && spo2Ok && abpOk;
+            }
+        }
+        frames++;
+    }
+    
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    rusage usageEnd{};
+    getrusage(RUSAGE_SELF, &usageEnd);
+    if (measured == 0) {
+        usageStart = usageEnd;
+    }
+    double cpu = cpuSeconds(usageEnd) - cpuSeconds(usageStart);
+    
+    if (dbEnabled) {
+        db.flush();
+        db.disconnect();
+    }
+    extractor.end();
+    
+    FILE* out = stdout;
+    if (!options.outputPath.empty()) {
+        out = fopen(options.outputPath.c_str(), "w");
+        if (out == nullptr) {
+            fprintf(stderr, "bench: cannot write %s\n", options.outputPath.c_str());
+            return 1;
+        }
+    }
+    
+    fputs("{\n  \"tag\": ", out);
+    writeJsonString(out, options.tag);
+    fputs(",\n  \"config\": ", out);
+    writeJsonString(out, options.configPath);
+    fprintf(out, ",\n  \"frames\": %ld,\n  \"warmup_frames\": %ld,\n  \"measured_frames\": %ld,\n",
+            frames, std::min(frames, options.warmupFrames), measured);
+    fprintf(out, "  \"wall_seconds\": %.6f,\n  \"throughput_fps\": %.3f,\n",
+            wallSeconds, wallSeconds > 0 ? measured / wallSeconds : 0.0);
+    fprintf(out, "  \"cpu_seconds\": %.6f,\n  \"cpu_utilization\": %.3f,\n",
+            cpu, wallSeconds > 0 ? cpu / wallSeconds : 0.0);
+    fprintf(out, "  \"peak_rss_kb\": %ld,\n  \"stages\": {", usageEnd.ru_maxrss);
+    
+    bool first = true;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        Samples& h = stages[i];
+        if (h.count() == 0) {
+            continue;
+        }
+        fprintf(out, "%s\n    \"%s\": {\"count\": %llu, \"mean_ms\": %.3f, \"p50_ms\": %.3f, "
+                     "\"p95_ms\": %.3f, \"p99_ms\": %.3f, \"max_ms\": %.3f}",
+                first ? "" : ",", kStageNames[i], static_cast<unsigned long long>(h.count()),
+                h.mean() / 1000.0, h.quantile(0.50) / 1000.0, h.quantile(0.95) / 1000.0,
+                h.quantile(0.99) / 1000.0, h.quantile(1.0) / 1000.0);
+        first = false;
+    }
+    fputs("\n  }", out);
+    
+    if (synthetic && measured > 0) {
+        fprintf(out, ",\n  \"synthetic\": {\"seed\": %llu, \"layout\": ",
+                static_cast<unsigned long long>(options.seed));
+        writeJsonString(out, options.style.layout);
+        fprintf(out, ", \"noise\": %.3f, \"blur\": %d, \"perspective\": %.3f},\n",
+                options.style.noiseSigma, options.style.blurKernel, options.style.perspective);
+        fprintf(out, "  \"accuracy\": {\"hr\": %.4f, \"spo2\": %.4f, \"abp\": %.4f, \"all\": %.4f}",
+                static_cast<double>(hrCorrect) / measured, static_cast<double>(spo2Correct) / measured,
+                static_cast<double>(abpCorrect) / measured, static_cast<double>(allCorrect) / measured);
+    }
+    
+    bool overBudget = false;
+    if (AllocTracker::kCompiled) {
+        AllocSummary a = allocs.summary();
+        overBudget = options.allocBudget >= 0 && a.steadyAllocsPerFrame > options.allocBudget;
+        fprintf(out, ",\n  \"allocations\": {\"steady_frames\": %ld, \"allocs_per_frame\": %.2f, "
+                     "\"bytes_per_frame\": %.0f, \"p50\": %llu, \"p99\": %llu, \"max\": %llu,\n",
+                a.steadyFrames, a.steadyAllocsPerFrame, a.steadyBytesPerFrame,
+                static_cast<unsigned long long>(frameAllocs.quantile(0.50)),
+                static_cast<unsigned long long>(frameAllocs.quantile(0.99)),
+                static_cast<unsigned long long>(a.steadyMaxAllocs));
+        fprintf(out, "    \"peak_frame_allocs\": %llu, \"peak_heap_bytes\": %lld, \"ei_allocs_per_frame\": %.2f",
+                static_cast<unsigned long long>(a.peakFrameAllocs), static_cast<long long>(a.peakLiveBytes),
+                a.steadyFrames > 0 ? static_cast<double>(a.steadyEi.allocs) / a.steadyFrames : 0.0);
+        if (options.allocBudget >= 0) {
+            fprintf(out, ", \"budget\": %.2f, \"within_budget\": %s",
+                    options.allocBudget, overBudget ? "false" : "true");
+        }
+        fputs(",\n    \"stages\": {", out);
+        for (int i = 0; i < kAllocStageCount; i++) {
+            const AllocCounts& c = a.steady[i];
+            double n = a.steadyFrames > 0 ? static_cast<double>(a.steadyFrames) : 1.0;
+            fprintf(out, "%s\n      \"%s\": {\"allocs_per_frame\": %.2f, \"frees_per_frame\": %.2f, "
+                         "\"bytes_per_frame\": %.0f}",
+                    i == 0 ? "" : ",", AllocTracker::stageName(static_cast<AllocStage>(i)),
+                    c.allocs / n, c.frees / n, c.bytes / n);
+        }
+        fputs("\n    }\n  }", out);
+    }
+    fputs("\n}\n", out);
+    
+    if (out != stdout) {
+        fclose(out);
+    }
+    if (overBudget) {
+        fprintf(stderr, "bench: %.2f allocations per frame exceeds the budget of %.2f\n",
+                allocs.summary().steadyAllocsPerFrame, options.allocBudget);
+        return 3;
+    }
+    return measured > 0 ? 0 : 1;
+}
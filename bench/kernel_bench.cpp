@@ -0,0 +1,431 @@
+// Kernel-level micro-benchmark for the deployed model
+//
+// Walks tflite_learn_12's operator list and times every Conv2D,
+// DepthwiseConv2D, FullyConnected, Pad, Add and Softmax op in isolation
+// through TFLM's KernelRunner, using the op's real tensor shapes,
+// quantization parameters, builtin options and weights. Reports time per
+// invoke, GFLOP/s and effective memory bandwidth for each op.
+//
+// The kernels linked in are whatever the SDK build selects, so build once
+// per implementation and compare the reports:
+//   make kernel_bench                 # reference kernels
+//   make kernel_bench CMSIS_NN=1      # CMSIS-NN kernels (Arm targets)
+//
+// Run:   ./build/kernel_bench [--json] [--op NAME] [--min-time SECONDS]
+
+#include "edge-impulse-sdk/tensorflow/lite/core/api/flatbuffer_conversions.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/kernel_runner.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/kernels/micro_ops.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_error_reporter.h"
+#include "edge-impulse-sdk/tensorflow/lite/micro/micro_interpreter.h"
+#include "edge-impulse-sdk/tensorflow/lite/schema/schema_utils.h"
+#include "tflite-model/tflite_learn_12.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+#if defined(EI_CLASSIFIER_TFLITE_ENABLE_CMSIS_NN) && EI_CLASSIFIER_TFLITE_ENABLE_CMSIS_NN == 1
+const char* const kImplementation = "cmsis-nn";
+#else
+const char* const kImplementation = "reference";
+#endif
+
+// KernelRunner's eval-tensor lookups take temp memory from a fixed 10 KB
+// arena that is only reset when a runner is constructed, so long timing
+// loops are split across fresh runners
+constexpr int kInvokesPerRunner = 32;
+constexpr int kWarmupInvokes = 3;
+constexpr int kRepeats = 5;
+
+struct Options {
+    bool json = false;
+    std::string opFilter;
+    double minSeconds = 0.2;
+};
+
+// Builtin data allocator for ParseOpData; everything is freed per op
+class MallocAllocator : public tflite::BuiltinDataAllocator {
+public:
+    void* Allocate(size_t size, size_t) override { return std::calloc(1, size); }
+    void Deallocate(void* data) override { std::free(data); }
+};
+
+// Owns the tensors handed to KernelRunner for one op
+struct OpTensors {
+    std::vector<TfLiteTensor> tensors;
+    std::vector<void*> allocations;
+
+    ~OpTensors() {
+        for (void* p : allocations) std::free(p);
+    }
+
+    template <typename T>
+    T* allocate(size_t count) {
+        void* p = std::calloc(count ? count : 1, sizeof(T));
+        allocations.push_back(p);
+        return static_cast<T*>(p);
+    }
+
+    TfLiteIntArray* intArray(const std::vector<int>& values) {
+        int* raw = allocate<int>(values.size() + 1);
+        raw[0] = static_cast<int>(values.size());
+        std::copy(values.begin(), values.end(), raw + 1);
+        return reinterpret_cast<TfLiteIntArray*>(raw);
+    }
+
+    TfLiteFloatArray* floatArray(const std::vector<float>& values) {
+        // TfLiteFloatArray is { int size; float data[]; }
+        void* raw = allocate<uint8_t>(sizeof(int) + sizeof(float) * (values.size() + 1));
+        TfLiteFloatArray* array = static_cast<TfLiteFloatArray*>(raw);
+        array->size = static_cast<int>(values.size());
+        std::copy(values.begin(), values.end(), array->data);
+        return array;
+    }
+};
+
+struct OpResult {
+    int index;
+    std::string name;
+    std::string shape;
+    bool ok = false;
+    std::string error;
+    double nsPerInvoke = 0.0;
+    double flops = 0.0;
+    double bytes = 0.0;
+};
+
+int64_t elementCount(const TfLiteIntArray* dims) {
+    int64_t count = 1;
+    for (int i = 0; i < dims->size; i++) count *= dims->data[i];
+    return count;
+}
+
+std::string dimsToString(const TfLiteIntArray* dims) {
+    std::string out = "[";
+    for (int i = 0; i < dims->size; i++) {
+        if (i) out += "x";
+        out += std::to_string(dims->data[i]);
+    }
+    return out + "]";
+}
+
+size_t typeSize(TfLiteType type) {
+    switch (type) {
+        case kTfLiteFloat32: case kTfLiteInt32: return 4;
+        case kTfLiteInt16: return 2;
+        case kTfLiteInt64: return 8;
+        default: return 1;
+    }
+}
+
+bool isBenchmarked(tflite::BuiltinOperator op) {
+    switch (op) {
+        case tflite::BuiltinOperator_CONV_2D:
+        case tflite::BuiltinOperator_DEPTHWISE_CONV_2D:
+        case tflite::BuiltinOperator_FULLY_CONNECTED:
+        case tflite::BuiltinOperator_PAD:
+        case tflite::BuiltinOperator_ADD:
+        case tflite::BuiltinOperator_SOFTMAX:
+            return true;
+        default:
+            return false;
+    }
+}
+
+TfLiteRegistration registrationFor(tflite::BuiltinOperator op) {
+    switch (op) {
+        case tflite::BuiltinOperator_CONV_2D: return tflite::Register_CONV_2D();
+        case tflite::BuiltinOperator_DEPTHWISE_CONV_2D: return tflite::Register_DEPTHWISE_CONV_2D();
+        case tflite::BuiltinOperator_FULLY_CONNECTED: return tflite::Register_FULLY_CONNECTED();
+        case tflite::BuiltinOperator_PAD: return tflite::Register_PAD();
+        case tflite::BuiltinOperator_ADD: return tflite::Register_ADD();
+        default: return tflite::Register_SOFTMAX();
+    }
+}
+
+// Arithmetic work per invoke, counting a multiply-accumulate as two ops.
+// Pad moves data only; Softmax is counted as exp + sum + scale per element.
+double flopsFor(tflite::BuiltinOperator op, const std::vector<TfLiteTensor*>& in, const TfLiteTensor* out) {
+    int64_t outElements = elementCount(out->dims);
+    switch (op) {
+        case tflite::BuiltinOperator_CONV_2D: {
+            const TfLiteIntArray* f = in[1]->dims;      // [OC, KH, KW, IC]
+            return 2.0 * outElements * f->data[1] * f->data[2] * f->data[3];
+        }
+        case tflite::BuiltinOperator_DEPTHWISE_CONV_2D: {
+            const TfLiteIntArray* f = in[1]->dims;      // [1, KH, KW, OC]
+            return 2.0 * outElements * f->data[1] * f->data[2];
+        }
+        case tflite::BuiltinOperator_FULLY_CONNECTED: {
+            const TfLiteIntArray* f = in[1]->dims;      // [OUT, IN]
+            return 2.0 * outElements * f->data[1];
+        }
+        case tflite::BuiltinOperator_ADD:
+            return static_cast<double>(outElements);
+        case tflite::BuiltinOperator_SOFTMAX:
+            return 3.0 * outElements;
+        default:
+            return 0.0;
+    }
+}
+
+// Build a TfLiteTensor from the flatbuffer tensor; constant tensors point at
+// the model's own buffer, activations get seeded random data
+bool buildTensor(const tflite::Model* model, const tflite::Tensor* src, OpTensors& owner,
+                 TfLiteTensor& dst, std::mt19937& rng) {
+    std::memset(&dst, 0, sizeof(dst));
+    if (tflite::ConvertTensorType(src->type(), &dst.type, tflite::GetMicroErrorReporter()) != kTfLiteOk) {
+        return false;
+    }
+
+    std::vector<int> shape;
+    if (src->shape()) {
+        shape.assign(src->shape()->begin(), src->shape()->end());
+    }
+    dst.dims = owner.intArray(shape);
+    dst.bytes = static_cast<size_t>(elementCount(dst.dims)) * typeSize(dst.type);
+
+    const tflite::Buffer* buffer = model->buffers()->Get(src->buffer());
+    if (buffer && buffer->data() && buffer->data()->size() > 0) {
+        dst.data.raw = const_cast<char*>(reinterpret_cast<const char*>(buffer->data()->data()));
+        dst.allocation_type = kTfLiteMmapRo;
+    } else {
+        uint8_t* data = owner.allocate<uint8_t>(dst.bytes);
+        for (size_t i = 0; i < dst.bytes; i++) data[i] = static_cast<uint8_t>(rng());
+        if (dst.type == kTfLiteFloat32) {
+            float* f = reinterpret_cast<float*>(data);
+            for (size_t i = 0; i < dst.bytes / 4; i++) f[i] = static_cast<float>(rng() % 2001) / 1000.0f - 1.0f;
+        }
+        dst.data.raw = reinterpret_cast<char*>(data);
+        dst.allocation_type = kTfLiteArenaRw;
+    }
+
+    const tflite::QuantizationParameters* q = src->quantization();
+    if (q && q->scale() && q->scale()->size() > 0) {
+        std::vector<float> scales(q->scale()->begin(), q->scale()->end());
+        std::vector<int> zeroPoints;
+        if (q->zero_point()) {
+            for (auto zp : *q->zero_point()) zeroPoints.push_back(static_cast<int>(zp));
+        }
+        zeroPoints.resize(scales.size(), 0);
+
+        dst.params.scale = scales[0];
+        dst.params.zero_point = zeroPoints[0];
+
+        auto* affine = owner.allocate<TfLiteAffineQuantization>(1);
+        affine->scale = owner.floatArray(scales);
+        affine->zero_point = owner.intArray(zeroPoints);
+        affine->quantized_dimension = q->quantized_dimension();
+        dst.quantization.type = kTfLiteAffineQuantization;
+        dst.quantization.params = affine;
+    }
+    return true;
+}
+
+OpResult benchmarkOp(const tflite::Model* model, int opIndex, const Options& options) {
+    const tflite::SubGraph* subgraph = model->subgraphs()->Get(0);
+    const tflite::Operator* op = subgraph->operators()->Get(opIndex);
+    const tflite::OperatorCode* code = model->operator_codes()->Get(op->opcode_index());
+    tflite::BuiltinOperator builtin = tflite::GetBuiltinCode(code);
+
+    OpResult result;
+    result.index = opIndex;
+    result.name = tflite::EnumNameBuiltinOperator(builtin);
+
+    // Local tensor table: op inputs first, then outputs; -1 marks an omitted optional input
+    OpTensors owner;
+    std::mt19937 rng(12345 + opIndex);
+    std::vector<int> inputIndices, outputIndices;
+    owner.tensors.reserve(op->inputs()->size() + op->outputs()->size());
+    for (int32_t t : *op->inputs()) {
+        if (t < 0) {
+            inputIndices.push_back(kTfLiteOptionalTensor);
+            continue;
+        }
+        owner.tensors.emplace_back();
+        if (!buildTensor(model, subgraph->tensors()->Get(t), owner, owner.tensors.back(), rng)) {
+            result.error = "unsupported tensor type";
+            return result;
+        }
+        inputIndices.push_back(static_cast<int>(owner.tensors.size()) - 1);
+    }
+    for (int32_t t : *op->outputs()) {
+        owner.tensors.emplace_back();
+        if (!buildTensor(model, subgraph->tensors()->Get(t), owner, owner.tensors.back(), rng)) {
+            result.error = "unsupported tensor type";
+            return result;
+        }
+        outputIndices.push_back(static_cast<int>(owner.tensors.size()) - 1);
+    }
+
+    std::vector<TfLiteTensor*> inputs;
+    for (int i : inputIndices) inputs.push_back(i >= 0 ? &owner.tensors[i] : nullptr);
+    TfLiteTensor* output = &owner.tensors[outputIndices[0]];
+
+    result.shape = inputs[0] ? dimsToString(inputs[0]->dims) : "?";
+    if (inputs.size() > 1 && inputs[1] && builtin != tflite::BuiltinOperator_PAD) {
+        result.shape += " * " + dimsToString(inputs[1]->dims);
+    }
+    result.shape += " -> " + dimsToString(output->dims);
+
+    result.flops = flopsFor(builtin, inputs, output);
+    for (TfLiteTensor* t : inputs) {
+        if (t) result.bytes += static_cast<double>(t->bytes);
+    }
+    result.bytes += static_cast<double>(output->bytes);
+
+    MallocAllocator allocator;
+    void* builtinData = nullptr;
+    if (tflite::ParseOpData(op, builtin, tflite::GetMicroErrorReporter(), &allocator, &builtinData) != kTfLiteOk) {
+        result.error = "cannot parse builtin options";
+        return result;
+    }
+
+    TfLiteIntArray* inputArray = owner.intArray(inputIndices);
+    TfLiteIntArray* outputArray = owner.intArray(outputIndices);
+    TfLiteRegistration registration = registrationFor(builtin);
+
+    // Runs invokes on fresh runners; returns total nanoseconds spent in Invoke()
+    auto runInvokes = [&](int count, double& elapsedNs) -> bool {
+        elapsedNs = 0.0;
+        while (count > 0) {
+            tflite::micro::KernelRunner runner(registration, owner.tensors.data(),
+                                               static_cast<int>(owner.tensors.size()),
+                                               inputArray, outputArray, builtinData);
+            if (runner.InitAndPrepare() != kTfLiteOk) {
+                result.error = "prepare failed (scratch or persistent data exceeds KernelRunner arena?)";
+                return false;
+            }
+            int batch = std::min(count, kInvokesPerRunner);
+            auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < batch; i++) {
+                if (runner.Invoke() != kTfLiteOk) {
+                    result.error = "invoke failed";
+                    return false;
+                }
+            }
+            elapsedNs += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            if (registration.free) runner.Free();
+            count -= batch;
+        }
+        return true;
+    };
+
+    double elapsed = 0.0;
+    if (!runInvokes(kWarmupInvokes, elapsed)) {
+        allocator.Deallocate(builtinData);
+        return result;
+    }
+
+    // Size each repeat to roughly minSeconds / kRepeats, then keep the median
+    double estimateNs = std::max(1.0, elapsed / kWarmupInvokes);
+    int invokesPerRepeat = std::max(kInvokesPerRunner,
+        static_cast<int>(options.minSeconds * 1e9 / kRepeats / estimateNs));
+    std::vector<double> samples;
+    for (int r = 0; r < kRepeats; r++) {
+        if (!runInvokes(invokesPerRepeat, elapsed)) {
+            allocator.Deallocate(builtinData);
+            return result;
+        }
+        samples.push_back(elapsed / invokesPerRepeat);
+    }
+    std::sort(samples.begin(), samples.end());
+    result.nsPerInvoke = samples[samples.size() / 2];
+    result.ok = true;
+
+    allocator.Deallocate(builtinData);
+    return result;
+}
+
+bool parseArgs(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            options.json = true;
+        } else if (arg == "--op" && i + 1 < argc) {
+            options.opFilter = argv[++i];
+        } else if (arg == "--min-time" && i + 1 < argc) {
+            options.minSeconds = atof(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!parseArgs(argc, argv, options)) {
+        fprintf(stderr, "Usage: %s [--json] [--op NAME] [--min-time SECONDS]\n", argv[0]);
+        return 2;
+    }
+
+    const tflite::Model* model = tflite::GetModel(tflite_learn_12);
+    if (model->version() != TFLITE_SCHEMA_VERSION || !model->subgraphs() || model->subgraphs()->size() == 0) {
+        fprintf(stderr, "kernel_bench: unsupported model schema\n");
+        return 1;
+    }
+
+    const tflite::SubGraph* subgraph = model->subgraphs()->Get(0);
+    std::vector<OpResult> results;
+    for (int i = 0; i < static_cast<int>(subgraph->operators()->size()); i++) {
+        const tflite::Operator* op = subgraph->operators()->Get(i);
+        tflite::BuiltinOperator builtin = tflite::GetBuiltinCode(model->operator_codes()->Get(op->opcode_index()));
+        if (!isBenchmarked(builtin)) {
+            continue;
+        }
+        if (!options.opFilter.empty() && options.opFilter != tflite::EnumNameBuiltinOperator(builtin)) {
+            continue;
+        }
+        results.push_back(benchmarkOp(model, i, options));
+        if (!options.json) {
+            const OpResult& r = results.back();
+            if (r.ok) {
+                double seconds = r.nsPerInvoke / 1e9;
+                printf("%4d %-18s %-44s %10.1f us %8.3f GFLOP/s %8.3f GB/s\n", r.index, r.name.c_str(),
+                       r.shape.c_str(), r.nsPerInvoke / 1000.0, r.flops / seconds / 1e9, r.bytes / seconds / 1e9);
+            } else {
+                printf("%4d %-18s %-44s skipped: %s\n", r.index, r.name.c_str(), r.shape.c_str(), r.error.c_str());
+            }
+            fflush(stdout);
+        }
+    }
+
+    double totalNs = 0.0;
+    for (const auto& r : results) {
+        if (r.ok) totalNs += r.nsPerInvoke;
+    }
+
+    if (!options.json) {
+        printf("implementation: %s, ops: %zu, summed kernel time: %.3f ms\n",
+               kImplementation, results.size(), totalNs / 1e6);
+        return 0;
+    }
+
+    printf("{\n  \"model\": \"tflite_learn_12\",\n  \"implementation\": \"%s\",\n", kImplementation);
+    printf("  \"total_ms\": %.4f,\n  \"ops\": [", totalNs / 1e6);
+    for (size_t i = 0; i < results.size(); i++) {
+        const OpResult& r = results[i];
+        printf("%s\n    {\"index\": %d, \"op\": \"%s\", \"shape\": \"%s\", ", i ? "," : "",
+               r.index, r.name.c_str(), r.shape.c_str());
+        if (r.ok) {
+            double seconds = r.nsPerInvoke / 1e9;
+            printf("\"us\": %.3f, \"flops\": %.0f, \"bytes\": %.0f, \"gflops\": %.4f, \"gbps\": %.4f}",
+                   r.nsPerInvoke / 1000.0, r.flops, r.bytes, r.flops / seconds / 1e9, r.bytes / seconds / 1e9);
+        } else {
+            printf("\"error\": \"%s\"}", r.error.c_str());
+        }
+    }
+    printf("\n  ]\n}\n");
+    return 0;
+}
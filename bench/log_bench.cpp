@@ -0,0 +1,107 @@
+// Logging overhead micro-benchmark
+//
+// Replays the per-frame LOG_DEBUG statements from main.cpp's ML path with
+// debug logging switched off and counts heap allocations per frame for the
+// eager string-concatenation style against the level-checked LOG_* macros.
+//
+// Build: make log_bench
+// Run:   ./build/log_bench [frames]
+
+#include "src/utils/Logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+static std::atomic<uint64_t> g_allocations(0);
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+// Mirrors the shape of ei_impulse_result_t fields logged per frame
+struct FakeResult {
+    int dsp = 3;
+    int classification = 17;
+    const char* labels[2] = {"abnormal", "normal"};
+    float values[2] = {0.125f, 0.875f};
+};
+
+struct BenchResult {
+    double allocationsPerFrame;
+    double nsPerFrame;
+};
+
+template <typename Frame>
+BenchResult run(int frames, Frame&& frame) {
+    uint64_t before = g_allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < frames; i++) {
+        frame(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    uint64_t allocations = g_allocations.load() - before;
+    return {static_cast<double>(allocations) / frames,
+            std::chrono::duration<double, std::nano>(elapsed).count() / frames};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 100000;
+    if (frames <= 0) frames = 100000;
+    
+    Logger& logger = Logger::getInstance();
+    logger.init("/dev/null", LogLevel::INFO, false, false);
+    
+    FakeResult result;
+    
+    // Previous macro expansion: arguments are built before the level check
+    BenchResult eager = run(frames, [&](int) {
+        logger.debug("ML Inference - DSP: " + std::to_string(result.dsp) + "ms, Classification: " +
+                     std::to_string(result.classification) + "ms");
+        for (int ix = 0; ix < 2; ix++) {
+            logger.debug("  " + std::string(result.labels[ix]) + ": " + std::to_string(result.values[ix]));
+        }
+    });
+    
+    // Current macros with string concatenation: level checked first
+    BenchResult guarded = run(frames, [&](int) {
+        LOG_DEBUG("ML Inference - DSP: " + std::to_string(result.dsp) + "ms, Classification: " +
+                  std::to_string(result.classification) + "ms");
+        for (int ix = 0; ix < 2; ix++) {
+            LOG_DEBUG("  " + std::string(result.labels[ix]) + ": " + std::to_string(result.values[ix]));
+        }
+    });
+    
+    // Current macros with deferred printf-style formatting
+    BenchResult deferred = run(frames, [&](int) {
+        LOG_DEBUG("ML Inference - DSP: %dms, Classification: %dms", result.dsp, result.classification);
+        for (int ix = 0; ix < 2; ix++) {
+            LOG_DEBUG("  %s: %f", result.labels[ix], result.values[ix]);
+        }
+    });
+    
+    std::printf("{\n");
+    std::printf("  \"frames\": %d,\n", frames);
+    std::printf("  \"debug_enabled\": false,\n");
+    std::printf("  \"eager_concat\": {\"allocs_per_frame\": %.2f, \"ns_per_frame\": %.1f},\n",
+                eager.allocationsPerFrame, eager.nsPerFrame);
+    std::printf("  \"macro_concat\": {\"allocs_per_frame\": %.2f, \"ns_per_frame\": %.1f},\n",
+                guarded.allocationsPerFrame, guarded.nsPerFrame);
+    std::printf("  \"macro_printf\": {\"allocs_per_frame\": %.2f, \"ns_per_frame\": %.1f}\n",
+                deferred.allocationsPerFrame, deferred.nsPerFrame);
+    std::printf("}\n");
+    return 0;
+}
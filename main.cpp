@@ -2,10 +2,7 @@
 #include <opencv2/opencv.hpp>
 #include <opencv2/dnn.hpp>
 #include <tesseract/baseapi.h>
-#include <fstream>
 #include <iostream>
-#include <regex>
-#include <deque>
 #include <chrono>
 #include <iomanip>
 #include <map>
@@ -13,11 +10,31 @@
 #include <cmath>
 #include <csignal>
 #include <atomic>
-#include "edge-impulse-sdk/classifier/ei_run_classifier.h"
+#include <thread>
 #include "unistd.h"
+#include "src/alarm/AlarmEngine.h"
+#include "src/api/QueryServer.h"
 #include "src/config/ConfigManager.h"
 #include "src/utils/Logger.h"
+#include "src/utils/StartupPlan.h"
+#include "src/utils/TimestampFormatter.h"
 #include "src/database/DatabaseManager.h"
+#include "src/ocr/VitalSignExtractor.h"
+#include "src/output/CsvSink.h"
+#include "src/output/ShmPublisher.h"
+#include "src/ocr/TemporalFusion.h"
+#include "src/batch/BatchProcessor.h"
+#include "src/pipeline/FramePool.h"
+#include "src/pipeline/MultiSourcePipeline.h"
+#include "src/pipeline/RateController.h"
+#include "src/sim/SyntheticMonitor.h"
+#include "src/timeseries/ArchiveWriter.h"
+#include "src/timeseries/TimeSeriesStore.h"
+#include "src/ml/EcgClassifier.h"
+#include "src/monitoring/MetricsRegistry.h"
+#include "src/monitoring/MetricsServer.h"
+#include "src/monitoring/Tracer.h"
+#include "src/monitoring/AllocTracker.h"
 
 using namespace cv;
 using namespace cv::dnn;
@@ -32,127 +49,38 @@ void signalHandler(int signum) {
     g_shutdown = true;
 }
 
-// Initialize Tesseract OCR
-static tesseract::TessBaseAPI ocr;
-
-// Define key labels and patterns
-static vector<string> labels;
-static regex spo2_pattern(R"(\bsp[o0]2\b)", regex_constants::icase);
-static regex bp_pattern(R"(^\d{2,3}/\d{2,3}$)");
-
-deque<string> spo2_history;
-string last_spo2_value;
-
-// Use the model's input dimensions from model metadata
-static float features[EI_CLASSIFIER_INPUT_WIDTH * EI_CLASSIFIER_INPUT_HEIGHT];
-
-// Struct to store detected text and position
-struct DetectedText {
-    string word;
-    int x, y, w, h;
-};
-
-// Function to calculate Euclidean distance
-double calculateDistance(int x1, int y1, int x2, int y2) {
-    return sqrt(pow(x1 - x2, 2) + pow(y1 - y2, 2));
+// SIGHUP asks the config watcher thread to reload config.json
+void reloadSignalHandler(int) {
+    ConfigManager::getInstance().requestReload();
 }
 
-// Function to find the closest number to a label
-string findClosestNumber(const DetectedText& labelData, const vector<DetectedText>& detectedNumbers) {
-    if (detectedNumbers.empty()) return "0";
-    
-    string closestNum = "0";
-    double minDistance = numeric_limits<double>::max();
-
-    for (const auto& num : detectedNumbers) {
-        double distance = calculateDistance(labelData.x, labelData.y, num.x, num.y);
-        if (distance < minDistance) {
-            minDistance = distance;
-            closestNum = num.word;
-        }
-    }
-    return closestNum;
+// SIGUSR1 dumps the trace buffers at the next frame boundary
+void traceDumpSignalHandler(int) {
+    Tracer::getInstance().requestDump();
 }
 
-// Function to process the frame and extract values
-map<string, string> processFrame(const Mat& frame) {
-    map<string, string> extractedValues;
-    vector<DetectedText> detectedNumbers;
-    map<string, DetectedText> detectedLabels;
-
-    // Initialize detected labels
-    for (const auto& label : labels) {
-        detectedLabels[label] = {"", -1, -1, -1, -1};
-    }
-
-    // Set Tesseract OCR image
-    ocr.SetImage(frame.data, frame.cols, frame.rows, 3, frame.step);
-    ocr.Recognize(0);
-
-    // Get detected text with position data
-    tesseract::ResultIterator* ri = ocr.GetIterator();
-    if (ri != nullptr) {
-        do {
-            const char* text = ri->GetUTF8Text(tesseract::RIL_WORD);
-            float conf = ri->Confidence(tesseract::RIL_WORD);
-            int x, y, w, h;
-
-            int confidenceThreshold = ConfigManager::getInstance().getOCRConfidenceThreshold();
-            if (text && conf > confidenceThreshold) {
-                ri->BoundingBox(tesseract::RIL_WORD, &x, &y, &w, &h);
-                DetectedText detected{text, x, y, w, h};
-
-                // Check for labels
-                if (regex_search(detected.word, spo2_pattern)) {
-                    detectedLabels["SpO2"] = detected;
-                } else if (find(labels.begin(), labels.end(), detected.word) != labels.end()) {
-                    detectedLabels[detected.word] = detected;
-                } else if (regex_match(detected.word, bp_pattern) || detected.word.find("/") != string::npos) {
-                    detectedNumbers.push_back(detected);
-                }
-            }
-            delete[] text;
-        } while (ri->Next(tesseract::RIL_WORD));
-    }
-
-    // Extract values for each label
-    for (const auto& label : labels) {
-        extractedValues[label] = findClosestNumber(detectedLabels[label], detectedNumbers);
-    }
-
-    // ABP format validation
-    if (!regex_match(extractedValues["ABP"], bp_pattern)) {
-        extractedValues["HR"] = "0";
-        extractedValues["SpO2"] = "0";
-        extractedValues["ABP"] = "0";
-    } else {
-        // Use last known SpO₂ value if missing
-        if (extractedValues["SpO2"] == "0" || extractedValues["SpO2"].empty()) {
-            extractedValues["SpO2"] = last_spo2_value;
-        } else {
-            last_spo2_value = extractedValues["SpO2"];
-        }
-    }
-
-    return extractedValues;
+// Map a config log level name to LogLevel
+LogLevel parseLogLevel(const string& level) {
+    if (level == "debug") return LogLevel::DEBUG;
+    if (level == "warn") return LogLevel::WARN;
+    if (level == "error") return LogLevel::ERROR;
+    if (level == "critical") return LogLevel::CRITICAL;
+    return LogLevel::INFO;
 }
 
-// Function to resize and crop frame
-void resize_and_crop(cv::Mat *in_frame, cv::Mat *out_frame) {
-    float factor_w = static_cast<float>(EI_CLASSIFIER_INPUT_WIDTH) / static_cast<float>(in_frame->cols);
-    float factor_h = static_cast<float>(EI_CLASSIFIER_INPUT_HEIGHT) / static_cast<float>(in_frame->rows);
-    float largest_factor = factor_w > factor_h ? factor_w : factor_h;
-
-    cv::Size resize_size(static_cast<int>(largest_factor * in_frame->cols),
-                         static_cast<int>(largest_factor * in_frame->rows));
-    cv::Mat resized;
-    cv::resize(*in_frame, resized, resize_size);
-
-    int crop_x = resize_size.width > resize_size.height ? (resize_size.width - resize_size.height) / 2 : 0;
-    int crop_y = resize_size.height > resize_size.width ? (resize_size.height - resize_size.width) / 2 : 0;
-    cv::Rect crop_region(crop_x, crop_y, EI_CLASSIFIER_INPUT_WIDTH, EI_CLASSIFIER_INPUT_HEIGHT);
-    *out_frame = resized(crop_region);
-}
+// Pipeline metrics; latencies are recorded in microseconds and exported in seconds
+static MetricsRegistry& metrics = MetricsRegistry::getInstance();
+static Counter& framesCaptured = metrics.counter("vitalsign_frames_captured_total", "Frames read from the video source");
+static Counter& framesDropped = metrics.counter("vitalsign_frames_dropped_total", "Empty or failed frame reads");
+static Counter& framesProcessed = metrics.counter("vitalsign_frames_processed_total", "Frames run through OCR and ML");
+static Gauge& captureFps = metrics.gauge("vitalsign_capture_fps", "Frames captured per second over the last second");
+static Gauge& dbUp = metrics.gauge("vitalsign_db_up", "1 if the last database health check passed");
+static Histogram& captureLatency = metrics.histogram("vitalsign_stage_latency_seconds", "Pipeline stage latency", "stage=\"capture\"", 1e-6);
+static Histogram& ocrLatency = metrics.histogram("vitalsign_stage_latency_seconds", "Pipeline stage latency", "stage=\"ocr\"", 1e-6);
+static Histogram& preprocessLatency = metrics.histogram("vitalsign_stage_latency_seconds", "Pipeline stage latency", "stage=\"preprocess\"", 1e-6);
+static Histogram& mlLatency = metrics.histogram("vitalsign_stage_latency_seconds", "Pipeline stage latency", "stage=\"ml\"", 1e-6);
+static Histogram& outputLatency = metrics.histogram("vitalsign_stage_latency_seconds", "Pipeline stage latency", "stage=\"output\"", 1e-6);
+static Histogram& dbLatency = metrics.histogram("vitalsign_stage_latency_seconds", "Pipeline stage latency", "stage=\"db\"", 1e-6);
 
 // Initialize camera with retry logic
 VideoCapture initializeCamera(int& retryCount) {
@@ -191,10 +119,101 @@ VideoCapture initializeCamera(int& retryCount) {
     return cap;
 }
 
+// Connect the configured database and create its tables
+bool initDatabase(ConfigManager& config, DatabaseManager& db) {
+    string dbType = config.getDBType();
+    LOG_INFO("Initializing database connection (" + dbType + ")...");
+    bool dbReady = false;
+    if (dbType == "sqlite") {
+        dbReady = db.initSQLite(
+            config.getDBSQLitePath(),
+            config.getDBSQLiteBatchSize(),
+            config.getDBSQLiteFlushIntervalMs()
+        );
+    } else {
+        dbReady = db.init(
+            config.getDBHost(),
+            config.getDBPort(),
+            config.getDBName(),
+            config.getDBUser(),
+            config.getDBPassword(),
+            config.getDBConnectionPoolSize(),
+            config.getDBConnectionTimeout()
+        );
+    }
+    if (!dbReady) {
+        return false;
+    }
+    LOG_INFO("Database connected successfully");
+    if (!db.createTables()) {
+        LOG_ERROR("Failed to create database tables");
+    }
+    return true;
+}
+
+// Process the configured video file offline and write rows in timestamp order
+bool runBatch(ConfigManager& config, DatabaseManager& db, bool dbEnabled, CsvSink& csvFile) {
+    BatchOptions options;
+    options.videoPath = config.getVideoSourcePath();
+    options.workers = config.getBatchWorkers();
+    options.segmentSeconds = max(1, config.getBatchSegmentSeconds());
+    options.processingInterval = max(1, config.getProcessingInterval());
+    options.language = config.getOCRLanguage();
+    options.labels = config.getVitalSignLabels();
+    options.defaultSpO2 = config.getDefaultSpO2();
+    options.confidenceThreshold = config.getOCRConfidenceThreshold();
+    options.mlEnabled = config.isMLModelEnabled();
+    
+    auto writeRow = [&](const BatchRow& row) {
+        char timeBuf[TimestampFormatter::kBufferSize];
+        TimestampFormatter::formatSeconds(row.time, timeBuf);
+        string timeStr(timeBuf, TimestampFormatter::kSecondsLength);
+        static const string kMissing;
+        auto field = [&row](const char* label) -> const string& {
+            auto it = row.healthData.find(label);
+            return it != row.healthData.end() ? it->second : kMissing;
+        };
+        const string& hr = field("HR");
+        const string& spo2 = field("SpO2");
+        const string& abp = field("ABP");
+        framesProcessed.inc();
+        
+        csvFile.write(CsvRecord{row.time, {}, hr, spo2, abp, row.ecgClassification, row.ecgConfidence});
+        ArchiveWriter::getInstance().append("", row.time, VitalSample::fromText(hr, spo2, abp),
+                                            row.ecgClassification, row.ecgConfidence);
+        if (dbEnabled && db.isConnected()) {
+            VitalSignData data;
+            data.timestamp = timeStr;
+            data.hr = hr;
+            data.spo2 = spo2;
+            data.abp = abp;
+            data.ecg_classification = row.ecgClassification;
+            data.ecg_confidence = row.ecgConfidence;
+            if (!db.insertVitalSign(data)) {
+                LOG_WARN("Failed to insert batch row for frame " + to_string(row.frameIndex));
+            }
+        }
+    };
+    
+    BatchProcessor processor;
+    BatchStats stats;
+    bool ok = processor.run(options, writeRow, g_shutdown, stats);
+    csvFile.flush();
+    framesCaptured.inc(static_cast<uint64_t>(stats.framesDecoded));
+    LOG_INFO("Batch finished: " + to_string(stats.rowsWritten) + " rows from " +
+             to_string(stats.framesDecoded) + " frames (" + to_string(stats.videoSeconds) + " s of video) in " +
+             to_string(stats.wallSeconds) + " s on " + to_string(stats.workers) + " workers");
+    return ok;
+}
+
 int main(int argc, char** argv) {
+    auto processStart = chrono::steady_clock::now();
+    
     // Register signal handler for graceful shutdown
-    signal(SIGINT, signalHandler);
-    signal(SIGTERM, signalHandler);
+    ::signal(SIGINT, signalHandler);
+    ::signal(SIGTERM, signalHandler);
+    ::signal(SIGHUP, reloadSignalHandler);
+    ::signal(SIGUSR1, traceDumpSignalHandler);
     
     // Load configuration
     ConfigManager& config = ConfigManager::getInstance();
@@ -207,94 +226,317 @@ int main(int argc, char** argv) {
     
     // Initialize logger
     Logger& logger = Logger::getInstance();
-    LogLevel logLevel = LogLevel::INFO;
-    string logLevelStr = config.getLogLevel();
-    if (logLevelStr == "debug") logLevel = LogLevel::DEBUG;
-    else if (logLevelStr == "warn") logLevel = LogLevel::WARN;
-    else if (logLevelStr == "error") logLevel = LogLevel::ERROR;
-    
     logger.init(
         config.getLogFilePath(),
-        logLevel,
+        parseLogLevel(config.getLogLevel()),
         config.isConsoleLoggingEnabled(),
         config.isFileLoggingEnabled(),
         config.getMaxLogFileSizeMB(),
         config.getMaxLogFiles()
     );
     
+    if (config.isAsyncLoggingEnabled()) {
+        LogOverflowPolicy overflowPolicy = config.getLogOverflowPolicy() == "block"
+            ? LogOverflowPolicy::BLOCK
+            : LogOverflowPolicy::DROP;
+        logger.startAsync(config.getLogQueueSize(), overflowPolicy, config.getLogFlushIntervalMs());
+    }
+    
     LOG_INFO("=== Vital Sign Extraction System Starting ===");
     LOG_INFO("Application: " + config.getAppName() + " v" + config.getAppVersion());
     
-    // Initialize vital sign parameters from config
-    labels = config.getVitalSignLabels();
-    last_spo2_value = config.getDefaultSpO2();
+    // Per-frame trace spans, dumped on SIGUSR1 and at shutdown
+    Tracer& tracer = Tracer::getInstance();
+    tracer.setBufferSize(static_cast<size_t>(max(1, config.getTraceBufferSize())));
+    tracer.setThreadName("main");
+    tracer.setEnabled(config.isTracingEnabled());
     
-    // Initialize Tesseract OCR
-    if (ocr.Init(NULL, config.getOCRLanguage().c_str())) {
-        LOG_CRITICAL("Could not initialize Tesseract OCR");
-        return -1;
+    // Camera start-up and the first OCR/TFLM calls allocate their caches;
+    // leave them out of the per-frame allocation numbers
+    AllocTracker::getInstance().setWarmupFrames(30);
+    
+    // Thresholds, intervals, the log level and tracing follow config.json without a restart
+    config.setReloadCallback([&logger, &tracer](const ConfigSnapshot& updated) {
+        logger.setLogLevel(parseLogLevel(updated.logging.level));
+        tracer.setEnabled(updated.tracing.enabled);
+    });
+    config.startHotReload();
+    
+    // Expose metrics for Prometheus scraping
+    MetricsServer& metricsServer = MetricsServer::getInstance();
+    if (config.isMetricsEnabled()) {
+        metrics.gaugeCallback("vitalsign_log_queue_depth", "Log records waiting for the writer thread",
+                              [&logger]() { return static_cast<double>(logger.getQueueDepth()); });
+        metrics.gaugeCallback("vitalsign_log_dropped_records", "Log records dropped on queue overflow",
+                              [&logger]() { return static_cast<double>(logger.getDroppedCount()); });
+        if (AllocTracker::kCompiled) {
+            AllocTracker& allocs = AllocTracker::getInstance();
+            metrics.gaugeCallback("vitalsign_frame_allocations", "Heap allocations during the last frame",
+                                  [&allocs]() { return static_cast<double>(allocs.lastFrameAllocs()); });
+            metrics.gaugeCallback("vitalsign_heap_live_bytes", "Heap bytes currently allocated",
+                                  [&allocs]() { return static_cast<double>(allocs.liveBytes()); });
+            metrics.gaugeCallback("vitalsign_heap_peak_bytes", "Heap high-water mark since start",
+                                  [&allocs]() { return static_cast<double>(allocs.peakLiveBytes()); });
+        }
+        
+        string metricsSocket = config.getMetricsSocketPath();
+        if (!metricsSocket.empty()) {
+            metricsServer.startUnix(metricsSocket);
+        } else {
+            metricsServer.start(config.getMetricsBindAddress(), config.getMetricsPort());
+        }
     }
-    LOG_INFO("Tesseract OCR initialized successfully");
     
-    // Initialize database if enabled
+    // Recorded files can be processed offline in parallel segments instead
+    // of being replayed in real time; video.sources switches to one pipeline
+    // per monitor sharing a pool of Tesseract engines
+    vector<VideoSourceConfig> videoSources = config.getVideoSources();
+    bool batchMode = config.getVideoSourceType() == "file" && config.isBatchModeEnabled();
+    bool multiSource = !batchMode && !videoSources.empty();
+    bool singleSource = !batchMode && !multiSource;
+    
+    // The slow start-up steps (Tesseract data, database connection, camera
+    // retries, first inference) overlap; cheap set-up below runs meanwhile
+    VitalSignExtractor extractor;
+    EcgClassifier classifier;
+    int cameraRetryCount = 0;
+    VideoCapture cap;
     DatabaseManager& db = DatabaseManager::getInstance();
     bool dbEnabled = config.isDatabaseEnabled();
-    
-    if (dbEnabled) {
-        LOG_INFO("Initializing database connection...");
-        if (db.init(
-            config.getDBHost(),
-            config.getDBPort(),
-            config.getDBName(),
-            config.getDBUser(),
-            config.getDBPassword(),
-            config.getDBConnectionPoolSize(),
-            config.getDBConnectionTimeout()
-        )) {
-            LOG_INFO("Database connected successfully");
-            if (!db.createTables()) {
-                LOG_ERROR("Failed to create database tables");
+    Mat warmupFrame;
+    StartupPlan startup;
+    if (singleSource) {
+        startup.add("ocr_init", [&]() {
+            return extractor.init(config.getOCRLanguage(), config.getVitalSignLabels(), config.getDefaultSpO2());
+        });
+        startup.add("camera", [&]() {
+            cap = initializeCamera(cameraRetryCount);
+            return cap.isOpened();
+        });
+        // Run OCR and inference once on a synthetic frame so the first real
+        // frame does not pay for lazy initialization
+        if (config.isStartupWarmupEnabled()) {
+            startup.add("warmup_frame", [&]() {
+                SyntheticMonitorStyle style;
+                style.width = config.getFrameWidth();
+                style.height = config.getFrameHeight();
+                SyntheticMonitorGenerator generator(style);
+                SyntheticVitals truth;
+                generator.next(warmupFrame, truth);
+                return !warmupFrame.empty();
+            });
+            startup.add("ocr_warmup", [&]() {
+                string spo2 = config.getDefaultSpO2();
+                extractor.processFrame(warmupFrame, config.getOCRConfidenceThreshold(), spo2);
+                return true;
+            }, {"ocr_init", "warmup_frame"});
+            if (config.isMLModelEnabled()) {
+                startup.add("ml_warmup", [&]() {
+                    Mat cropped;
+                    classifier.prepare(warmupFrame, cropped);
+                    return classifier.run().ok;
+                }, {"warmup_frame"});
             }
+        }
+    }
+    if (dbEnabled) {
+        startup.add("database", [&]() { return initDatabase(config, db); });
+    }
+    startup.start(config.isStartupParallel());
+    
+    // Recent history of every live source, kept in memory for queries
+    vector<string> seriesIds;
+    for (const VideoSourceConfig& source : videoSources) {
+        seriesIds.push_back(source.id);
+    }
+    if (seriesIds.empty()) {
+        seriesIds.push_back("");
+    }
+    TimeSeriesStore& timeSeries = TimeSeriesStore::getInstance();
+    if (!batchMode && config.isTimeSeriesEnabled()) {
+        TsCapacity capacity;
+        capacity.raw = static_cast<size_t>(max(1, config.getTimeSeriesRawSamples()));
+        capacity.seconds = static_cast<size_t>(max(1, config.getTimeSeriesSecondBuckets()));
+        capacity.minutes = static_cast<size_t>(max(1, config.getTimeSeriesMinuteBuckets()));
+        capacity.hours = static_cast<size_t>(max(1, config.getTimeSeriesHourBuckets()));
+        timeSeries.init(seriesIds, capacity);
+        metrics.gauge("vitalsign_timeseries_bytes", "Memory reserved by the in-memory history")
+            .set(static_cast<double>(timeSeries.memoryBytes()));
+        LOG_INFO("In-memory history: " + to_string(timeSeries.memoryBytes() / 1024) + " KB for " +
+                 to_string(seriesIds.size()) + " sources");
+    }
+    
+    // Local queries of that history
+    QueryServer& queryServer = QueryServer::getInstance();
+    if (timeSeries.isInitialized() && config.isApiEnabled()) {
+        QueryServer::Options apiOptions;
+        apiOptions.maxConnections = config.getApiMaxConnections();
+        apiOptions.maxPoints = config.getApiMaxPoints();
+        apiOptions.idleTimeoutSec = config.getApiIdleTimeoutSec();
+        string apiSocket = config.getApiSocketPath();
+        if (!apiSocket.empty()) {
+            queryServer.startUnix(apiSocket, apiOptions);
         } else {
-            LOG_ERROR("Database initialization failed, continuing without database");
-            dbEnabled = false;
+            queryServer.start(config.getApiBindAddress(), config.getApiPort(), apiOptions);
         }
     }
     
-    // Initialize video capture
-    int cameraRetryCount = 0;
-    VideoCapture cap = initializeCamera(cameraRetryCount);
-    if (!cap.isOpened()) {
-        LOG_CRITICAL("Could not access video source");
-        ocr.End();
+    // Live results for local consumers; batch results are not live
+    ShmPublisher& publisher = ShmPublisher::getInstance();
+    if (!batchMode && config.isPublishEnabled() &&
+        !publisher.init(config.getPublishShmName(), static_cast<size_t>(max(1, config.getPublishCapacity())))) {
+        LOG_ERROR("Shared-memory publishing disabled");
+    }
+    
+    // Clinical alarms on the live vitals
+    AlarmEngine& alarms = AlarmEngine::getInstance();
+    if (!batchMode && config.isAlarmsEnabled()) {
+        if (!alarms.init(seriesIds, config.getAlarmRules())) {
+            LOG_WARN("Alarms enabled but no valid rule configured");
+        } else if (!config.getAlarmSocketPath().empty()) {
+            alarms.listen(config.getAlarmSocketPath());
+        }
+    }
+    
+    // Long-term history as compressed column files
+    ArchiveWriter& archive = ArchiveWriter::getInstance();
+    if (config.isArchiveEnabled() &&
+        !archive.init(config.getArchivePath(), static_cast<size_t>(max(1, config.getArchiveBlockSamples())),
+                      config.getArchiveFlushIntervalSec())) {
+        LOG_ERROR("Archive disabled");
+    }
+    
+    startup.wait();
+    if (singleSource && !startup.succeeded("ocr_init")) {
+        LOG_CRITICAL("Could not initialize Tesseract OCR");
         return -1;
     }
+    if (singleSource) {
+        LOG_INFO("Tesseract OCR initialized successfully");
+    }
+    if (dbEnabled && !startup.succeeded("database")) {
+        LOG_ERROR("Database initialization failed, continuing without database");
+        dbEnabled = false;
+    }
     
     // Initialize CSV output if enabled
-    ofstream csvFile;
+    CsvSink csvFile;
     if (config.isCSVEnabled()) {
-        string csvPath = config.getCSVFile();
-        csvFile.open(csvPath);
-        if (!csvFile.is_open()) {
-            LOG_ERROR("Unable to open CSV file for writing: " + csvPath);
-        } else {
-            csvFile << "Time,HR,SpO2,ABP,ECG_Classification,ECG_Confidence" << endl;
-            LOG_INFO("CSV output enabled: " + csvPath);
+        CsvSinkOptions csvOptions;
+        csvOptions.path = config.getCSVFile();
+        csvOptions.sourceColumn = multiSource;
+        csvOptions.bufferBytes = static_cast<size_t>(max(0, config.getCSVBufferKb())) * 1024;
+        csvOptions.flushIntervalMs = max(0, config.getCSVFlushIntervalMs());
+        csvOptions.maxFileBytes = static_cast<size_t>(max(1, config.getCSVMaxSizeMb())) * 1024 * 1024;
+        csvOptions.maxFiles = config.getCSVMaxFiles();
+        if (!CsvSink::parseSyncPolicy(config.getCSVFsync(), csvOptions.sync)) {
+            LOG_WARN("Unknown output.csv_fsync '" + config.getCSVFsync() + "', using none");
+        }
+        if (!CsvSink::parseRotation(config.getCSVRotate(), csvOptions.rotation)) {
+            LOG_WARN("Unknown output.csv_rotate '" + config.getCSVRotate() + "', using none");
+        }
+        if (csvFile.open(csvOptions)) {
+            LOG_INFO("CSV output enabled: " + csvOptions.path);
+        }
+    }
+    
+    int exitCode = 0;
+    if (batchMode) {
+        if (!runBatch(config, db, dbEnabled, csvFile)) {
+            exitCode = -1;
+        }
+    }
+    
+    MultiSourcePipeline pipeline(db, dbEnabled, csvFile);
+    if (multiSource) {
+        if (!pipeline.start(videoSources, config.getOCREngines(), config.getPipelineWorkers())) {
+            exitCode = -1;
+        }
+        while (exitCode == 0 && !g_shutdown && pipeline.activeSources() > 0) {
+            if (tracer.consumeDumpRequest()) {
+                tracer.dump(config.getTraceOutputPath());
+            }
+            csvFile.flushIfDue();
+            this_thread::sleep_for(chrono::milliseconds(200));
+        }
+        pipeline.stop();
+    }
+    
+    if (singleSource && !cap.isOpened()) {
+        LOG_CRITICAL("Could not access video source");
+        extractor.end();
+        return -1;
+    }
+    
+    // Capture reads into preallocated buffers sized to the stream
+    FramePool framePool;
+    if (singleSource) {
+        FrameBackpressure backpressure = FrameBackpressure::Drop;
+        if (!FramePool::parseBackpressure(config.getFramePoolBackpressure(), backpressure)) {
+            LOG_WARN("Unknown frame_pool_backpressure '" + config.getFramePoolBackpressure() + "', using drop");
+        }
+        int width = static_cast<int>(cap.get(CAP_PROP_FRAME_WIDTH));
+        int height = static_cast<int>(cap.get(CAP_PROP_FRAME_HEIGHT));
+        if (!framePool.init("main", static_cast<size_t>(max(1, config.getFramePoolSize())),
+                            width > 0 ? width : config.getFrameWidth(),
+                            height > 0 ? height : config.getFrameHeight(), backpressure)) {
+            LOG_CRITICAL("Could not allocate frame buffers");
+            extractor.end();
+            return -1;
         }
     }
     
+    RateController rateController("");
+    TemporalFusion fusion;
     int frame_count = 0;
-    int processingInterval = config.getProcessingInterval();
-    bool debugMode = config.isDebugMode();
+    bool firstOutputLogged = false;
+    
+    // Capture rate and health check bookkeeping
+    auto fpsWindowStart = chrono::steady_clock::now();
+    int fpsWindowFrames = 0;
+    auto lastHealthCheck = chrono::steady_clock::time_point();
     
     LOG_INFO("Starting main processing loop...");
-    LOG_INFO("Processing interval: every " + to_string(processingInterval) + " frames");
+    LOG_INFO("Processing interval: every " + to_string(config.getProcessingInterval()) + " frames");
+    if (config.isRateControlEnabled()) {
+        LOG_INFO("Rate control enabled: down to every " + to_string(config.getRateControlMinInterval()) +
+                 " frames on change");
+    }
     
-    while (!g_shutdown) {
-        Mat frame;
-        cap >> frame;
+    while (singleSource && !g_shutdown) {
+        // Pick up hot-reloaded settings once per iteration
+        shared_ptr<const ConfigSnapshot> cfg = config.snapshot();
+        int processingInterval = max(1, cfg->video.processingInterval);
+        bool debugMode = cfg->app.debugMode;
+        
+        if (tracer.consumeDumpRequest()) {
+            tracer.dump(cfg->tracing.outputPath);
+        }
+        csvFile.flushIfDue();
+        
+        // Counted up front so skipped frames get their own trace id too
+        TRACE_FRAME(frame_count);
+        frame_count++;
+        TRACE_SCOPE("frame");
+        AllocFrameScope allocFrame;
+        
+        FramePool::Frame slot = framePool.acquire();
+        if (!slot) {
+            // Every buffer is still held downstream; skip this frame
+            framesDropped.inc();
+            cap.grab();
+            continue;
+        }
+        Mat& frame = slot.mat();
+        {
+            TRACE_SCOPE("capture");
+            ALLOC_STAGE(Capture);
+            ScopedLatency timer(captureLatency);
+            cap.read(frame);
+        }
         
         if (frame.empty()) {
+            framesDropped.inc();
             LOG_WARN("Empty frame received");
             
             // Attempt to reconnect
@@ -307,97 +549,125 @@ int main(int argc, char** argv) {
             }
             continue;
         }
+        
+        framesCaptured.inc();
+        fpsWindowFrames++;
+        auto now = chrono::steady_clock::now();
+        if (now - fpsWindowStart >= chrono::seconds(1)) {
+            captureFps.set(fpsWindowFrames / chrono::duration<double>(now - fpsWindowStart).count());
+            fpsWindowStart = now;
+            fpsWindowFrames = 0;
+        }
+        
+        if (dbEnabled && now - lastHealthCheck >= chrono::seconds(max(1, cfg->monitoring.healthCheckIntervalSec))) {
+            lastHealthCheck = now;
+            bool healthy = db.healthCheck();
+            dbUp.set(healthy ? 1.0 : 0.0);
+            if (!healthy) {
+                LOG_WARN("Database health check failed");
+            }
+        }
+
+        if (rateController.shouldProcess(frame, processingInterval)) {
+            framesProcessed.inc();
 
-        if (frame_count % processingInterval == 0) {
-            auto timestamp = chrono::system_clock::now();
-            time_t time_now = chrono::system_clock::to_time_t(timestamp);
-            ostringstream timeStream;
-            timeStream << put_time(localtime(&time_now), "%Y-%m-%d %H:%M:%S");
-            string timeStr = timeStream.str();
+            char timeBuf[TimestampFormatter::kBufferSize];
+            auto frameTime = chrono::system_clock::now();
+            TimestampFormatter::formatSeconds(frameTime, timeBuf);
+            string timeStr(timeBuf, TimestampFormatter::kSecondsLength);
 
             // Extract vital signs
-            map<string, string> healthData = processFrame(frame);
+            map<string, string> healthData;
+            {
+                ScopedLatency timer(ocrLatency);
+                ALLOC_STAGE(Ocr);
+                healthData = extractor.processFrame(frame, cfg->ocr.confidenceThreshold);
+            }
+            if (cfg->fusion.enabled) {
+                FusedVitals fused = fusion.update(extractor.lastReadings(), *cfg);
+                healthData["HR"] = fused.hrText();
+                healthData["SpO2"] = fused.spo2Text();
+                healthData["ABP"] = fused.abpText();
+            }
+            rateController.onReading(healthData);
+            const string& hr = healthData["HR"];
+            const string& spo2 = healthData["SpO2"];
+            const string& abp = healthData["ABP"];
+            VitalSample vitals = VitalSample::fromText(hr, spo2, abp);
+            timeSeries.append("", frameTime, vitals);
+            alarms.evaluate("", frameTime, vitals);
             
-            // Prepare cropped frame for ML inference
+            // Prepare cropped frame and features for ML inference
             cv::Mat cropped;
-            resize_and_crop(&frame, &cropped);
-
-            // Prepare features for ML model
-            size_t feature_ix = 0;
-            for (int rx = 0; rx < cropped.rows; rx++) {
-                for (int cx = 0; cx < cropped.cols; cx++) {
-                    cv::Vec3b pixel = cropped.at<cv::Vec3b>(rx, cx);
-                    uint8_t b = pixel.val[0];
-                    uint8_t g = pixel.val[1];
-                    uint8_t r = pixel.val[2];
-                    features[feature_ix++] = (r << 16) + (g << 8) + b;
-                }
+            {
+                ScopedLatency timer(preprocessLatency);
+                ALLOC_STAGE(Preprocess);
+                classifier.prepare(frame, cropped);
             }
 
             // Run ML classifier
             string ecgClassification = "unknown";
             float ecgConfidence = 0.0f;
             
-            if (config.isMLModelEnabled()) {
-                ei_impulse_result_t result;
-                signal_t signal;
-                numpy::signal_from_buffer(features, EI_CLASSIFIER_INPUT_WIDTH * EI_CLASSIFIER_INPUT_HEIGHT, &signal);
-                EI_IMPULSE_ERROR res = run_classifier(&signal, &result, false);
-                
-                if (res == 0) {
-                    LOG_DEBUG("ML Inference - DSP: " + to_string(result.timing.dsp) + "ms, Classification: " + to_string(result.timing.classification) + "ms");
-                    
-                    // Find highest confidence classification
-                    float maxConfidence = 0.0f;
-                    for (size_t ix = 0; ix < EI_CLASSIFIER_LABEL_COUNT; ix++) {
-                        if (result.classification[ix].value > maxConfidence) {
-                            maxConfidence = result.classification[ix].value;
-                            ecgClassification = result.classification[ix].label;
-                            ecgConfidence = result.classification[ix].value;
-                        }
-                        
-                        if (debugMode) {
-                            LOG_DEBUG("  " + string(result.classification[ix].label) + ": " + to_string(result.classification[ix].value));
-                        }
-                    }
-                } else {
-                    LOG_ERROR("ML classifier failed with error: " + to_string(res));
+            if (cfg->mlModel.enabled) {
+                EcgResult result;
+                {
+                    ScopedLatency timer(mlLatency);
+                    ALLOC_STAGE(Ml);
+                    result = classifier.run(debugMode);
+                }
+                if (result.ok) {
+                    ecgClassification = result.label;
+                    ecgConfidence = result.confidence;
                 }
             }
+            publisher.publish("", frameTime, vitals, ecgClassification, ecgConfidence);
+            archive.append("", frameTime, vitals, ecgClassification, ecgConfidence);
             
             // Output results
-            if (config.isConsoleOutputEnabled()) {
+            auto outputStart = chrono::steady_clock::now();
+            if (cfg->output.consoleOutput) {
+                ALLOC_STAGE(Output);
                 cout << "Time: " << timeStr 
-                     << " | HR: " << healthData["HR"] 
-                     << " | SpO₂: " << healthData["SpO2"] 
-                     << " | ABP: " << healthData["ABP"]
+                     << " | HR: " << hr
+                     << " | SpO₂: " << spo2
+                     << " | ABP: " << abp
                      << " | ECG: " << ecgClassification << " (" << ecgConfidence << ")"
                      << endl;
             }
             
             // Save to CSV
-            if (csvFile.is_open()) {
-                csvFile << timeStr << "," 
-                       << healthData["HR"] << "," 
-                       << healthData["SpO2"] << "," 
-                       << healthData["ABP"] << ","
-                       << ecgClassification << ","
-                       << ecgConfidence << endl;
+            if (csvFile.isOpen()) {
+                TRACE_SCOPE("csv_write");
+                ALLOC_STAGE(Output);
+                csvFile.write(CsvRecord{frameTime, {}, hr, spo2, abp, ecgClassification, ecgConfidence});
+            }
+            outputLatency.record(static_cast<uint64_t>(chrono::duration_cast<chrono::microseconds>(
+                chrono::steady_clock::now() - outputStart).count()));
+            if (!firstOutputLogged) {
+                firstOutputLogged = true;
+                double firstOutput = chrono::duration<double>(chrono::steady_clock::now() - processStart).count();
+                metrics.gauge("vitalsign_first_output_seconds", "Time from process start to the first processed frame")
+                    .set(firstOutput);
+                LOG_INFO("First output %.0f ms after start", firstOutput * 1000.0);
             }
             
             // Save to database
             if (dbEnabled && db.isConnected()) {
+                TRACE_SCOPE("db_insert");
+                ScopedLatency timer(dbLatency);
+                ALLOC_STAGE(Db);
                 VitalSignData data;
                 data.timestamp = timeStr;
-                data.hr = healthData["HR"];
-                data.spo2 = healthData["SpO2"];
-                data.abp = healthData["ABP"];
+                data.hr = hr;
+                data.spo2 = spo2;
+                data.abp = abp;
                 data.ecg_classification = ecgClassification;
                 data.ecg_confidence = ecgConfidence;
                 
                 if (!db.insertVitalSign(data)) {
                     LOG_WARN("Failed to insert data to database, attempting reconnect...");
-                    if (db.reconnect(config.getDBRetryAttempts(), config.getDBRetryDelayMs())) {
+                    if (db.reconnect(cfg->database.retryAttempts, cfg->database.retryDelayMs)) {
                         db.insertVitalSign(data); // Retry once after reconnect
                     }
                 }
@@ -413,22 +683,35 @@ int main(int argc, char** argv) {
             LOG_INFO("User requested shutdown");
             break;
         }
-
-        frame_count++;
     }
 
     // Cleanup
     LOG_INFO("Shutting down...");
+    config.stopHotReload();
+    metricsServer.stop();
+    queryServer.stop();
+    if (tracer.isEnabled() && config.isTraceDumpOnShutdown()) {
+        tracer.dump(config.getTraceOutputPath());
+    }
+    if (AllocTracker::kCompiled) {
+        AllocSummary allocSummary = AllocTracker::getInstance().summary();
+        LOG_INFO("Heap allocations: " + to_string(allocSummary.steadyAllocsPerFrame) + " per frame over " +
+                 to_string(allocSummary.frames) + " frames, peak heap " +
+                 to_string(allocSummary.peakLiveBytes / 1024) + " KB");
+    }
     cap.release();
     destroyAllWindows();
-    if (csvFile.is_open()) {
+    if (csvFile.isOpen()) {
         csvFile.close();
         LOG_INFO("CSV file closed");
     }
-    ocr.End();
+    archive.close();
+    alarms.shutdown();
+    publisher.close();
+    extractor.end();
     db.disconnect();
-    logger.flush();
 
     LOG_INFO("=== Vital Sign Extraction System Stopped ===");
-    return 0;
+    logger.shutdown();
+    return exitCode;
 }
@@ -18,12 +18,17 @@ CREATE TABLE IF NOT EXISTS vital_signs (
     abp VARCHAR(20),
     ecg_classification VARCHAR(50),
     ecg_confidence REAL,
+    source_id VARCHAR(64),
     created_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP
 );
 
+-- Upgrade tables created before multi-source support
+ALTER TABLE vital_signs ADD COLUMN IF NOT EXISTS source_id VARCHAR(64);
+
 -- Create indexes for better query performance
 CREATE INDEX IF NOT EXISTS idx_vital_signs_timestamp ON vital_signs(timestamp);
 CREATE INDEX IF NOT EXISTS idx_vital_signs_created_at ON vital_signs(created_at);
+CREATE INDEX IF NOT EXISTS idx_vital_signs_source_timestamp ON vital_signs(source_id, timestamp);
 
 -- Create a view for recent vital signs
 CREATE OR REPLACE VIEW recent_vital_signs AS
@@ -35,6 +40,7 @@ SELECT
     abp,
     ecg_classification,
     ecg_confidence,
+    source_id,
     created_at
 FROM vital_signs
 ORDER BY timestamp DESC
@@ -36,6 +36,10 @@ sudo apt install -y tesseract-ocr libtesseract-dev
 echo "Step 5: Installing PostgreSQL client libraries..."
 sudo apt install -y libpq-dev postgresql-client
 
+# Install SQLite (embedded storage backend)
+echo "Installing SQLite libraries..."
+sudo apt install -y libsqlite3-dev sqlite3
+
 # Optional: Install PostgreSQL server locally
 read -p "Do you want to install PostgreSQL server locally? (y/n) " -n 1 -r
 echo
@@ -82,6 +86,7 @@ echo "Step 9: Verifying dependencies..."
 pkg-config --modversion opencv4 || echo "Warning: OpenCV not found via pkg-config"
 pkg-config --modversion tesseract || echo "Warning: Tesseract not found via pkg-config"
 pkg-config --modversion libpq || echo "Warning: libpq not found via pkg-config"
+pkg-config --modversion sqlite3 || echo "Warning: sqlite3 not found via pkg-config"
 
 echo ""
 echo "=== Setup Complete ==="
@@ -0,0 +1,322 @@
+#include "AlarmEngine.h"
+#include "../config/JsonValue.h"
+#include "../monitoring/MetricsRegistry.h"
+#include "../output/ShmPublisher.h"
+#include "../utils/Logger.h"
+#include "../utils/TimestampFormatter.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+MetricsRegistry& metrics = MetricsRegistry::getInstance();
+Counter& cleared = metrics.counter("vitalsign_alarms_cleared_total", "Alarms cleared");
+Histogram& captureLatency = metrics.histogram("vitalsign_alarm_latency_seconds",
+    "Time from frame capture (capture) or sample evaluation (engine) to alarm publication",
+    "stage=\"capture\"", 1e-6);
+Histogram& engineLatency = metrics.histogram("vitalsign_alarm_latency_seconds",
+    "Time from frame capture (capture) or sample evaluation (engine) to alarm publication",
+    "stage=\"engine\"", 1e-9);
+
+void copyText(char* out, size_t size, const std::string& text) {
+    size_t n = std::min(size - 1, text.size());
+    std::memcpy(out, text.data(), n);
+    std::memset(out + n, 0, size - n);
+}
+
+const char* conditionName(int condition) {
+    static const char* const names[] = {"above", "below", "rise", "fall"};
+    return names[condition];
+}
+
+} // namespace
+
+AlarmEngine& AlarmEngine::getInstance() {
+    static AlarmEngine instance;
+    return instance;
+}
+
+bool AlarmEngine::parseSeverity(const std::string& name, AlarmSeverity& severity) {
+    if (name == "info") {
+        severity = AlarmSeverity::Info;
+    } else if (name == "warning") {
+        severity = AlarmSeverity::Warning;
+    } else if (name == "critical") {
+        severity = AlarmSeverity::Critical;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* AlarmEngine::severityName(AlarmSeverity severity) {
+    switch (severity) {
+        case AlarmSeverity::Info: return "info";
+        case AlarmSeverity::Warning: return "warning";
+        case AlarmSeverity::Critical: return "critical";
+    }
+    return "warning";
+}
+
+bool AlarmEngine::init(const std::vector<std::string>& sourceIds, const std::vector<AlarmRuleConfig>& rules) {
+    {
+        std::lock_guard<std::mutex> lock(activeMutex_);
+        active_.clear();
+    }
+    rules_.clear();
+    sources_.clear();
+
+    for (const AlarmRuleConfig& config : rules) {
+        auto rule = std::make_unique<Rule>();
+        rule->name = config.name;
+        rule->source = config.source;
+        rule->value = config.value;
+        rule->withinUs = static_cast<int64_t>(std::max(1, config.withinSec)) * 1000000;
+        rule->forUs = static_cast<int64_t>(std::max(0, config.forSec)) * 1000000;
+
+        if (!TimeSeriesStore::parseField(config.field, rule->field)) {
+            LOG_ERROR("Alarm rule " + config.name + ": unknown field '" + config.field + "', rule skipped");
+            continue;
+        }
+        if (config.when == "above") {
+            rule->condition = Condition::Above;
+        } else if (config.when == "below") {
+            rule->condition = Condition::Below;
+        } else if (config.when == "rise") {
+            rule->condition = Condition::Rise;
+        } else if (config.when == "fall") {
+            rule->condition = Condition::Fall;
+        } else {
+            LOG_ERROR("Alarm rule " + config.name + ": unknown condition '" + config.when + "', rule skipped");
+            continue;
+        }
+        if ((rule->condition == Condition::Rise || rule->condition == Condition::Fall) && config.value <= 0.0f) {
+            LOG_ERROR("Alarm rule " + config.name + ": " + config.when + " needs a positive value, rule skipped");
+            continue;
+        }
+        if (!parseSeverity(config.severity, rule->severity)) {
+            LOG_WARN("Alarm rule " + config.name + ": unknown severity '" + config.severity + "', using warning");
+        }
+        if (!rule->source.empty() &&
+            std::find(sourceIds.begin(), sourceIds.end(), rule->source) == sourceIds.end()) {
+            LOG_WARN("Alarm rule " + config.name + " names unknown source '" + rule->source + "'");
+        }
+        rule->raised = &metrics.counter("vitalsign_alarms_total", "Alarms raised",
+            "rule=\"" + rule->name + "\",severity=\"" + severityName(rule->severity) + "\"");
+        rules_.push_back(std::move(rule));
+    }
+
+    for (const std::string& id : sourceIds) {
+        auto source = std::make_unique<Source>();
+        for (const std::unique_ptr<Rule>& rule : rules_) {
+            if (rule->source.empty() || rule->source == id) {
+                RuleState state;
+                state.rule = rule.get();
+                source->rules.push_back(std::move(state));
+            }
+        }
+        sources_[id] = std::move(source);
+    }
+
+    if (rules_.empty()) {
+        return false;
+    }
+    LOG_INFO("Alarm engine: " + std::to_string(rules_.size()) + " rules over " +
+             std::to_string(sourceIds.size()) + " sources");
+    return true;
+}
+
+bool AlarmEngine::listen(const std::string& socketPath) {
+    return socket_.listen(socketPath, [this]() { return activeLines(); });
+}
+
+std::vector<ActiveAlarm> AlarmEngine::activeAlarms() const {
+    std::lock_guard<std::mutex> lock(activeMutex_);
+    std::vector<ActiveAlarm> alarms;
+    alarms.reserve(active_.size());
+    for (const Active& entry : active_) {
+        alarms.push_back(entry.alarm);
+    }
+    return alarms;
+}
+
+// Greeting for a new socket client
+std::string AlarmEngine::activeLines() const {
+    std::lock_guard<std::mutex> lock(activeMutex_);
+    std::string lines;
+    for (const Active& entry : active_) {
+        lines += eventLine(*entry.rule, entry.alarm.source, "active", entry.alarm.value, entry.alarm.since, 0);
+    }
+    return lines;
+}
+
+// Update the active set before the event is broadcast, so a client that
+// connects in between sees the alarm either in its greeting or as an event
+void AlarmEngine::track(const Rule& rule, const std::string& sourceId, std::chrono::system_clock::time_point time,
+                        int value, bool raised) {
+    std::lock_guard<std::mutex> lock(activeMutex_);
+    if (raised) {
+        ActiveAlarm alarm;
+        alarm.source = sourceId;
+        alarm.rule = rule.name;
+        alarm.severity = rule.severity;
+        alarm.field = rule.field;
+        alarm.value = value;
+        alarm.since = time;
+        active_.push_back(Active{&rule, std::move(alarm)});
+        return;
+    }
+    for (auto it = active_.begin(); it != active_.end(); ++it) {
+        if (it->rule == &rule && it->alarm.source == sourceId) {
+            active_.erase(it);
+            return;
+        }
+    }
+}
+
+std::string AlarmEngine::eventLine(const Rule& rule, const std::string& sourceId, const char* state, int value,
+                                   std::chrono::system_clock::time_point time, int64_t latencyUs) {
+    char numbers[160];
+    std::string line = "{\"source\":";
+    JsonValue::appendQuoted(line, sourceId);
+    line += ",\"rule\":";
+    JsonValue::appendQuoted(line, rule.name);
+    snprintf(numbers, sizeof(numbers),
+             ",\"state\":\"%s\",\"severity\":\"%s\",\"field\":\"%s\",\"value\":%d,\"when\":\"%s\","
+             "\"threshold\":%g,\"time_us\":%" PRId64 ",\"latency_us\":%" PRId64 "}\n",
+             state, severityName(rule.severity), TimeSeriesStore::fieldName(rule.field), value,
+             conditionName(static_cast<int>(rule.condition)), rule.value,
+             TimestampFormatter::toEpochMicros(time), latencyUs);
+    line += numbers;
+    return line;
+}
+
+// Whether the rule's condition holds with this sample; updates the window
+bool AlarmEngine::holds(RuleState& state, int64_t timeUs, int value) const {
+    const Rule& rule = *state.rule;
+    switch (rule.condition) {
+        case Condition::Above:
+            return value > rule.value;
+        case Condition::Below:
+            return value < rule.value;
+        case Condition::Rise:
+        case Condition::Fall: {
+            // Monotonic deque: each sample is pushed and popped at most once
+            bool rise = rule.condition == Condition::Rise;
+            std::deque<std::pair<int64_t, int>>& window = state.window;
+            while (!window.empty() && (rise ? window.back().second >= value : window.back().second <= value)) {
+                window.pop_back();
+            }
+            window.emplace_back(timeUs, value);
+            while (window.front().first < timeUs - rule.withinUs) {
+                window.pop_front();
+            }
+            int change = rise ? value - window.front().second : window.front().second - value;
+            return change >= rule.value;
+        }
+    }
+    return false;
+}
+
+void AlarmEngine::evaluate(const std::string& sourceId, std::chrono::system_clock::time_point time,
+                           const VitalSample& sample) {
+    if (rules_.empty()) {
+        return;
+    }
+    auto it = sources_.find(sourceId);
+    if (it == sources_.end()) {
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    int64_t timeUs = TimestampFormatter::toEpochMicros(time);
+
+    Source& source = *it->second;
+    std::lock_guard<std::mutex> lock(source.mutex);
+    for (RuleState& state : source.rules) {
+        int value = sample.get(state.rule->field);
+        if (value < 0) {
+            continue;
+        }
+        if (!holds(state, timeUs, value)) {
+            state.holding = false;
+            if (state.active) {
+                state.active = false;
+                emit(*state.rule, sourceId, time, value, false, start);
+            }
+            continue;
+        }
+        if (!state.holding) {
+            state.holding = true;
+            state.holdStartUs = timeUs;
+        }
+        if (!state.active && timeUs - state.holdStartUs >= state.rule->forUs) {
+            state.active = true;
+            emit(*state.rule, sourceId, time, value, true, start);
+        }
+    }
+}
+
+void AlarmEngine::emit(const Rule& rule, const std::string& sourceId, std::chrono::system_clock::time_point time,
+                       int value, bool raised, std::chrono::steady_clock::time_point evaluateStart) {
+    const char* severity = severityName(rule.severity);
+    const char* field = TimeSeriesStore::fieldName(rule.field);
+    int64_t latencyUs = std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::system_clock::now() - time).count());
+
+    ShmAlarm alarm;
+    copyText(alarm.rule, sizeof(alarm.rule), rule.name);
+    copyText(alarm.field, sizeof(alarm.field), field);
+    copyText(alarm.severity, sizeof(alarm.severity), severity);
+    alarm.raised = raised ? 1 : 0;
+    alarm.value = value;
+    alarm.latencyUs = static_cast<uint32_t>(std::min<int64_t>(latencyUs, UINT32_MAX));
+    ShmPublisher::getInstance().publishAlarm(sourceId, time, alarm);
+
+    track(rule, sourceId, time, value, raised);
+    if (socket_.isListening()) {
+        socket_.broadcast(eventLine(rule, sourceId, raised ? "raised" : "cleared", value, time, latencyUs));
+    }
+
+    // Latency up to the point consumers can see the event; logging follows
+    captureLatency.record(static_cast<uint64_t>(latencyUs));
+    engineLatency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - evaluateStart).count()));
+
+    const char* where = sourceId.empty() ? "" : " on ";
+    if (!raised) {
+        cleared.inc();
+        LOG_INFO("Alarm cleared: %s%s%s (%s %d)", rule.name.c_str(), where, sourceId.c_str(), field, value);
+        return;
+    }
+    rule.raised->inc();
+    const char* condition = conditionName(static_cast<int>(rule.condition));
+    if (rule.severity == AlarmSeverity::Critical) {
+        LOG_CRITICAL("Alarm raised: %s%s%s (%s %d, %s %g)", rule.name.c_str(), where, sourceId.c_str(),
+                     field, value, condition, rule.value);
+    } else if (rule.severity == AlarmSeverity::Warning) {
+        LOG_WARN("Alarm raised: %s%s%s (%s %d, %s %g)", rule.name.c_str(), where, sourceId.c_str(),
+                 field, value, condition, rule.value);
+    } else {
+        LOG_INFO("Alarm raised: %s%s%s (%s %d, %s %g)", rule.name.c_str(), where, sourceId.c_str(),
+                 field, value, condition, rule.value);
+    }
+}
+
+void AlarmEngine::shutdown() {
+    socket_.close();
+    if (rules_.empty()) {
+        return;
+    }
+    uint64_t count = captureLatency.count();
+    if (count == 0) {
+        LOG_INFO("Alarm engine: no alarms");
+        return;
+    }
+    LOG_INFO("Alarm engine: %" PRIu64 " events; latency from capture p50 %.2f ms, p99 %.2f ms; "
+             "in engine p50 %.1f us, p99 %.1f us", count,
+             captureLatency.quantile(0.50) / 1000.0, captureLatency.quantile(0.99) / 1000.0,
+             engineLatency.quantile(0.50) / 1000.0, engineLatency.quantile(0.99) / 1000.0);
+}
@@ -0,0 +1,123 @@
+#ifndef ALARM_ENGINE_H
+#define ALARM_ENGINE_H
+
+#include "AlarmSocket.h"
+#include "../config/ConfigSnapshot.h"
+#include "../timeseries/TimeSeriesStore.h"
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Counter;
+
+enum class AlarmSeverity { Info, Warning, Critical };
+
+// An alarm that has been raised and not cleared yet
+struct ActiveAlarm {
+    std::string source;
+    std::string rule;
+    AlarmSeverity severity = AlarmSeverity::Warning;
+    VitalField field = VitalField::Hr;
+    int value = 0;                                  // Reading that raised it
+    std::chrono::system_clock::time_point since;    // Capture time of that reading
+};
+
+// Clinical alarm rules evaluated on every fused sample as it is produced.
+// Rules are compiled once from alarms.rules into per-source state, and each
+// sample costs O(1) per rule: a comparison for above/below, a monotonic
+// window minimum (maximum) for rise (fall), and a start time for the
+// for_sec hold. Alarms are edge-triggered: one event when a rule's
+// condition has held for for_sec, one when it stops holding. Events go to
+// the shared-memory ring, the Unix socket and the log, in that order. A
+// socket client that connects later first receives the active alarms.
+class AlarmEngine {
+public:
+    static AlarmEngine& getInstance();
+
+    // Compile rules for these sources ("" is the single-source id). Invalid
+    // rules are logged and skipped; false if none is left.
+    bool init(const std::vector<std::string>& sourceIds, const std::vector<AlarmRuleConfig>& rules);
+    bool isEnabled() const { return !rules_.empty(); }
+
+    // Stream events as JSON lines to clients of this Unix socket; each new
+    // client first gets one "active" line per alarm that is currently raised
+    bool listen(const std::string& socketPath);
+
+    // time is the frame capture time; samples must arrive in time order per
+    // source. Missing readings (-1) leave a rule's state unchanged.
+    void evaluate(const std::string& sourceId, std::chrono::system_clock::time_point time,
+                  const VitalSample& sample);
+
+    // Raised and not yet cleared, oldest first
+    std::vector<ActiveAlarm> activeAlarms() const;
+
+    // Close the socket and log alarm counts and latencies
+    void shutdown();
+
+    static bool parseSeverity(const std::string& name, AlarmSeverity& severity);
+    static const char* severityName(AlarmSeverity severity);
+
+private:
+    AlarmEngine() = default;
+    AlarmEngine(const AlarmEngine&) = delete;
+    AlarmEngine& operator=(const AlarmEngine&) = delete;
+
+    enum class Condition { Above, Below, Rise, Fall };
+
+    struct Rule {
+        std::string name;
+        std::string source;             // Empty = every source
+        VitalField field = VitalField::Hr;
+        Condition condition = Condition::Above;
+        float value = 0.0f;
+        int64_t withinUs = 0;
+        int64_t forUs = 0;
+        AlarmSeverity severity = AlarmSeverity::Warning;
+        Counter* raised = nullptr;
+    };
+
+    struct RuleState {
+        const Rule* rule = nullptr;
+        bool holding = false;           // Condition true since holdStartUs
+        bool active = false;            // Raised and not yet cleared
+        int64_t holdStartUs = 0;
+        // rise: increasing values (front = window minimum);
+        // fall: decreasing values (front = window maximum)
+        std::deque<std::pair<int64_t, int>> window;
+    };
+
+    struct Source {
+        std::mutex mutex;
+        std::vector<RuleState> rules;
+    };
+
+    struct Active {
+        const Rule* rule;
+        ActiveAlarm alarm;
+    };
+
+    bool holds(RuleState& state, int64_t timeUs, int value) const;
+    void emit(const Rule& rule, const std::string& sourceId, std::chrono::system_clock::time_point time,
+              int value, bool raised, std::chrono::steady_clock::time_point evaluateStart);
+    void track(const Rule& rule, const std::string& sourceId, std::chrono::system_clock::time_point time,
+               int value, bool raised);
+    std::string activeLines() const;
+    static std::string eventLine(const Rule& rule, const std::string& sourceId, const char* state, int value,
+                                 std::chrono::system_clock::time_point time, int64_t latencyUs);
+
+    std::vector<std::unique_ptr<Rule>> rules_;
+    std::map<std::string, std::unique_ptr<Source>> sources_;
+    // Innermost lock: held for no other lock, taken by the socket's greeting
+    mutable std::mutex activeMutex_;
+    std::vector<Active> active_;
+    AlarmSocket socket_;
+};
+
+#endif // ALARM_ENGINE_H
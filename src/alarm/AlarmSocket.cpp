@@ -0,0 +1,139 @@
+#include "AlarmSocket.h"
+#include "../monitoring/MetricsRegistry.h"
+#include "../utils/Logger.h"
+
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int kBacklog = 16;
+constexpr int kPollIntervalMs = 250;
+
+Counter& droppedClients = MetricsRegistry::getInstance().counter(
+    "vitalsign_alarm_socket_dropped_total", "Alarm socket clients disconnected for not keeping up");
+
+} // namespace
+
+AlarmSocket::~AlarmSocket() {
+    close();
+}
+
+bool AlarmSocket::listen(const std::string& socketPath, Greeting greeting) {
+    close();
+
+    sockaddr_un addr{};
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        LOG_ERROR("Alarm socket path too long: " + socketPath);
+        return false;
+    }
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG_ERROR("Alarm socket: socket() failed: " + std::string(strerror(errno)));
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(socketPath.c_str());
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, kBacklog) < 0) {
+        LOG_ERROR("Alarm socket: cannot listen on " + socketPath + ": " + strerror(errno));
+        ::close(fd);
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    listenFd_ = fd;
+    socketPath_ = socketPath;
+    greeting_ = std::move(greeting);
+    stop_ = false;
+    listening_ = true;
+    thread_ = std::thread(&AlarmSocket::acceptLoop, this, fd);
+    LOG_INFO("Alarm events available on unix socket " + socketPath);
+    return true;
+}
+
+void AlarmSocket::close() {
+    stop_ = true;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    listening_ = false;
+    for (int fd : clients_) {
+        ::close(fd);
+    }
+    clients_.clear();
+    if (listenFd_ >= 0) {
+        ::close(listenFd_);
+        listenFd_ = -1;
+    }
+    if (!socketPath_.empty()) {
+        unlink(socketPath_.c_str());
+        socketPath_.clear();
+    }
+    greeting_ = nullptr;
+}
+
+// Accept clients as they connect. The greeting is taken and sent under the
+// lock, so no event can fall between it and the client's first broadcast.
+void AlarmSocket::acceptLoop(int listenFd) {
+    while (!stop_.load()) {
+        pollfd pfd{listenFd, POLLIN, 0};
+        if (poll(&pfd, 1, kPollIntervalMs) <= 0) {
+            continue;
+        }
+        while (true) {
+            int fd = accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                break;
+            }
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::string greeting = greeting_ ? greeting_() : std::string();
+            if (!greeting.empty() && !sendLine(fd, greeting)) {
+                ::close(fd);
+                continue;
+            }
+            clients_.push_back(fd);
+        }
+    }
+}
+
+// Whole line or nothing; counts a client that could not keep up
+bool AlarmSocket::sendLine(int fd, const std::string& line) {
+    ssize_t written;
+    do {
+        written = ::send(fd, line.data(), line.size(), MSG_NOSIGNAL | MSG_DONTWAIT);
+    } while (written < 0 && errno == EINTR);
+    if (written == static_cast<ssize_t>(line.size())) {
+        return true;
+    }
+    if (written >= 0 || errno == EAGAIN || errno == EWOULDBLOCK) {
+        droppedClients.inc();
+    }
+    return false;
+}
+
+void AlarmSocket::broadcast(const std::string& line) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (listenFd_ < 0) {
+        return;
+    }
+
+    // A partial write would leave a torn line, so anything short of the
+    // whole line drops the client
+    size_t kept = 0;
+    for (int fd : clients_) {
+        if (sendLine(fd, line)) {
+            clients_[kept++] = fd;
+        } else {
+            ::close(fd);
+        }
+    }
+    clients_.resize(kept);
+}
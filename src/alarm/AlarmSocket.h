@@ -0,0 +1,48 @@
+#ifndef ALARM_SOCKET_H
+#define ALARM_SOCKET_H
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Unix stream socket that pushes alarm events to every connected client as
+// JSON lines. A background thread accepts connections and sends each new
+// client the greeting (the alarms active at that moment) before any event.
+// All client I/O is non-blocking: a client that cannot take a whole line
+// right away is disconnected rather than delaying the alarm path.
+class AlarmSocket {
+public:
+    // Lines for a new client, each ending in '\n'. Called with the socket
+    // lock held, so it must not call back into the socket.
+    using Greeting = std::function<std::string()>;
+
+    AlarmSocket() = default;
+    ~AlarmSocket();
+    AlarmSocket(const AlarmSocket&) = delete;
+    AlarmSocket& operator=(const AlarmSocket&) = delete;
+
+    bool listen(const std::string& socketPath, Greeting greeting = nullptr);
+    bool isListening() const { return listening_.load(); }
+    void close();
+
+    // line must end with '\n'
+    void broadcast(const std::string& line);
+
+private:
+    void acceptLoop(int listenFd);
+    bool sendLine(int fd, const std::string& line);
+
+    std::mutex mutex_;
+    int listenFd_ = -1;
+    std::string socketPath_;
+    std::vector<int> clients_;
+    Greeting greeting_;
+    std::thread thread_;
+    std::atomic<bool> listening_{false};
+    std::atomic<bool> stop_{false};
+};
+
+#endif // ALARM_SOCKET_H
@@ -0,0 +1,637 @@
+#include "QueryServer.h"
+#include "../config/JsonValue.h"
+#include "../monitoring/MetricsRegistry.h"
+#include "../utils/Logger.h"
+#include "../utils/TimestampFormatter.h"
+
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <netinet/in.h>
+#include <strings.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int kPollIntervalMs = 250;
+constexpr int kMaxEvents = 32;
+constexpr uint32_t kListenTag = UINT32_MAX;
+constexpr int kThreadNice = 10;             // Below the capture and OCR threads
+constexpr size_t kResponseReserve = 64 * 1024;
+constexpr size_t kMaxPointBytes = 128;     // Longest formatted point, see appendPoints()
+constexpr int64_t kDefaultRangeSec = 3600;
+
+MetricsRegistry& metrics = MetricsRegistry::getInstance();
+Counter& sourcesRequests = metrics.counter("vitalsign_api_requests_total", "Query API requests", "endpoint=\"sources\"");
+Counter& latestRequests = metrics.counter("vitalsign_api_requests_total", "Query API requests", "endpoint=\"latest\"");
+Counter& rangeRequests = metrics.counter("vitalsign_api_requests_total", "Query API requests", "endpoint=\"range\"");
+Counter& rollupRequests = metrics.counter("vitalsign_api_requests_total", "Query API requests", "endpoint=\"rollup\"");
+Counter& otherRequests = metrics.counter("vitalsign_api_requests_total", "Query API requests", "endpoint=\"other\"");
+Histogram& requestLatency = metrics.histogram("vitalsign_api_request_seconds",
+    "Time to build a query API response", "", 1e-6);
+Gauge& openConnections = metrics.gauge("vitalsign_api_connections", "Open query API connections");
+
+int64_t steadyMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int hexDigit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// Percent-decoded value of name in a query string; false if absent
+bool queryParam(const char* query, size_t length, const char* name, std::string& out) {
+    size_t nameLength = strlen(name);
+    const char* end = query + length;
+    const char* p = query;
+    while (p < end) {
+        const char* next = static_cast<const char*>(memchr(p, '&', static_cast<size_t>(end - p)));
+        if (next == nullptr) next = end;
+        if (static_cast<size_t>(next - p) > nameLength && memcmp(p, name, nameLength) == 0 &&
+            p[nameLength] == '=') {
+            out.clear();
+            for (const char* c = p + nameLength + 1; c < next; c++) {
+                if (*c == '+') {
+                    out += ' ';
+                } else if (*c == '%' && next - c > 2 && hexDigit(c[1]) >= 0 && hexDigit(c[2]) >= 0) {
+                    out += static_cast<char>(hexDigit(c[1]) * 16 + hexDigit(c[2]));
+                    c += 2;
+                } else {
+                    out += *c;
+                }
+            }
+            return true;
+        }
+        p = next + 1;
+    }
+    return false;
+}
+
+bool parseInt64(const std::string& text, int64_t& value) {
+    char* end = nullptr;
+    errno = 0;
+    long long parsed = strtoll(text.c_str(), &end, 10);
+    if (text.empty() || *end != '\0' || errno == ERANGE) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+bool parseResolution(const std::string& name, TsResolution& resolution) {
+    for (int r = 0; r < static_cast<int>(TsResolution::Count); r++) {
+        if (name == TimeSeriesStore::resolutionName(static_cast<TsResolution>(r))) {
+            resolution = static_cast<TsResolution>(r);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whether header `name` is present and its value contains token (any case)
+bool headerHasToken(const char* headers, size_t length, const char* name, const char* token) {
+    size_t nameLength = strlen(name);
+    size_t tokenLength = strlen(token);
+    const char* end = headers + length;
+    for (const char* line = headers; line < end;) {
+        const char* eol = static_cast<const char*>(memchr(line, '\n', static_cast<size_t>(end - line)));
+        if (eol == nullptr) eol = end;
+        if (static_cast<size_t>(eol - line) > nameLength && strncasecmp(line, name, nameLength) == 0 &&
+            line[nameLength] == ':') {
+            for (const char* p = line + nameLength + 1; p + tokenLength <= eol; p++) {
+                if (strncasecmp(p, token, tokenLength) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+        line = eol + 1;
+    }
+    return false;
+}
+
+} // namespace
+
+QueryServer& QueryServer::getInstance() {
+    static QueryServer instance;
+    return instance;
+}
+
+QueryServer::~QueryServer() {
+    stop();
+}
+
+bool QueryServer::start(const std::string& bindAddress, int port, const Options& options) {
+    if (running_) {
+        return true;
+    }
+
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG_ERROR("Query API: socket() failed: " + std::string(strerror(errno)));
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, bindAddress.c_str(), &addr.sin_addr) != 1) {
+        LOG_ERROR("Query API: invalid bind address " + bindAddress);
+        close(fd);
+        return false;
+    }
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 64) < 0) {
+        LOG_ERROR("Query API: cannot listen on " + bindAddress + ":" + std::to_string(port) +
+                  ": " + strerror(errno));
+        close(fd);
+        return false;
+    }
+    if (!launch(fd, options)) {
+        return false;
+    }
+    LOG_INFO("Query API available at http://" + bindAddress + ":" + std::to_string(port) + "/api/");
+    return true;
+}
+
+bool QueryServer::startUnix(const std::string& socketPath, const Options& options) {
+    if (running_) {
+        return true;
+    }
+
+    sockaddr_un addr{};
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        LOG_ERROR("Query API: socket path too long: " + socketPath);
+        return false;
+    }
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG_ERROR("Query API: socket() failed: " + std::string(strerror(errno)));
+        return false;
+    }
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(socketPath.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 64) < 0) {
+        LOG_ERROR("Query API: cannot listen on " + socketPath + ": " + strerror(errno));
+        close(fd);
+        return false;
+    }
+    socketPath_ = socketPath;
+    if (!launch(fd, options)) {
+        return false;
+    }
+    LOG_INFO("Query API available on unix socket " + socketPath);
+    return true;
+}
+
+// Allocate every connection and response buffer up front, then start the thread
+bool QueryServer::launch(int listenFd, const Options& options) {
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.u32 = kListenTag;
+    if (epollFd_ < 0 || epoll_ctl(epollFd_, EPOLL_CTL_ADD, listenFd, &event) < 0) {
+        LOG_ERROR("Query API: epoll setup failed: " + std::string(strerror(errno)));
+        if (epollFd_ >= 0) {
+            close(epollFd_);
+            epollFd_ = -1;
+        }
+        close(listenFd);
+        return false;
+    }
+
+    options_ = options;
+    options_.maxConnections = std::max(1, options.maxConnections);
+    options_.maxPoints = std::max(1, options.maxPoints);
+    connections_ = std::vector<Connection>(static_cast<size_t>(options_.maxConnections));
+    freeSlots_.clear();
+    for (int i = options_.maxConnections - 1; i >= 0; i--) {
+        connections_[i].out.reserve(kResponseReserve);
+        freeSlots_.push_back(i);
+    }
+    // Room for the largest range or rollup response
+    body_.reserve(std::max(kResponseReserve, 1024 + kMaxPointBytes * static_cast<size_t>(options_.maxPoints)));
+    sourceName_.reserve(64);
+    param_.reserve(64);
+    points_.reserve(static_cast<size_t>(options_.maxPoints));
+
+    listenFd_ = listenFd;
+    stop_ = false;
+    running_ = true;
+    thread_ = std::thread(&QueryServer::serveLoop, this);
+    return true;
+}
+
+void QueryServer::stop() {
+    stop_ = true;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    for (Connection& connection : connections_) {
+        if (connection.fd >= 0) {
+            closeConnection(connection);
+        }
+    }
+    if (epollFd_ >= 0) {
+        close(epollFd_);
+        epollFd_ = -1;
+    }
+    if (listenFd_ >= 0) {
+        close(listenFd_);
+        listenFd_ = -1;
+    }
+    if (!socketPath_.empty()) {
+        unlink(socketPath_.c_str());
+        socketPath_.clear();
+    }
+    running_ = false;
+}
+
+void QueryServer::serveLoop() {
+    // Linux applies nice values per thread
+    setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), kThreadNice);
+
+    epoll_event events[kMaxEvents];
+    int64_t lastIdleCheckMs = steadyMs();
+    while (!stop_.load()) {
+        int ready = epoll_wait(epollFd_, events, kMaxEvents, kPollIntervalMs);
+        int64_t nowMs = steadyMs();
+        for (int i = 0; i < ready; i++) {
+            uint32_t tag = events[i].data.u32;
+            if (tag == kListenTag) {
+                acceptClients(nowMs);
+                continue;
+            }
+            Connection& connection = connections_[tag];
+            uint32_t flags = events[i].events;
+            if (connection.fd >= 0 && (flags & (EPOLLIN | EPOLLERR | EPOLLHUP))) {
+                onReadable(connection, nowMs);
+            }
+            if (connection.fd >= 0 && (flags & EPOLLOUT)) {
+                onWritable(connection);
+            }
+        }
+        if (nowMs - lastIdleCheckMs >= 1000) {
+            closeIdle(nowMs);
+            lastIdleCheckMs = nowMs;
+        }
+    }
+}
+
+void QueryServer::acceptClients(int64_t nowMs) {
+    while (true) {
+        int fd = accept4(listenFd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            return;
+        }
+        if (freeSlots_.empty()) {
+            // Table full: refuse rather than grow
+            close(fd);
+            continue;
+        }
+        int slot = freeSlots_.back();
+        freeSlots_.pop_back();
+        Connection& connection = connections_[slot];
+        connection.fd = fd;
+        connection.inLength = 0;
+        connection.out.clear();
+        connection.outSent = 0;
+        connection.closeAfterWrite = false;
+        connection.lastActiveMs = nowMs;
+
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u32 = static_cast<uint32_t>(slot);
+        if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+            closeConnection(connection);
+            continue;
+        }
+        openConnections.set(static_cast<double>(connections_.size() - freeSlots_.size()));
+    }
+}
+
+void QueryServer::closeConnection(Connection& connection) {
+    if (epollFd_ >= 0) {
+        epoll_ctl(epollFd_, EPOLL_CTL_DEL, connection.fd, nullptr);
+    }
+    close(connection.fd);
+    connection.fd = -1;
+    freeSlots_.push_back(static_cast<int>(&connection - connections_.data()));
+    openConnections.set(static_cast<double>(connections_.size() - freeSlots_.size()));
+}
+
+void QueryServer::closeIdle(int64_t nowMs) {
+    int64_t limitMs = static_cast<int64_t>(options_.idleTimeoutSec) * 1000;
+    for (Connection& connection : connections_) {
+        if (connection.fd >= 0 && nowMs - connection.lastActiveMs > limitMs) {
+            closeConnection(connection);
+        }
+    }
+}
+
+// Wait for output space while a response is pending, otherwise for requests
+void QueryServer::updateInterest(Connection& connection) {
+    epoll_event event{};
+    event.events = connection.outSent < connection.out.size() ? EPOLLOUT : EPOLLIN;
+    event.data.u32 = static_cast<uint32_t>(&connection - connections_.data());
+    epoll_ctl(epollFd_, EPOLL_CTL_MOD, connection.fd, &event);
+}
+
+void QueryServer::onReadable(Connection& connection, int64_t nowMs) {
+    while (connection.inLength < kMaxRequestSize) {
+        ssize_t n = ::recv(connection.fd, connection.in + connection.inLength,
+                           kMaxRequestSize - connection.inLength, 0);
+        if (n > 0) {
+            connection.inLength += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        }
+        closeConnection(connection);        // Peer closed, or a real error
+        return;
+    }
+    connection.lastActiveMs = nowMs;
+    if (!handleRequests(connection)) {
+        closeConnection(connection);
+        return;
+    }
+    onWritable(connection);
+}
+
+void QueryServer::onWritable(Connection& connection) {
+    while (connection.outSent < connection.out.size()) {
+        ssize_t n = ::send(connection.fd, connection.out.data() + connection.outSent,
+                           connection.out.size() - connection.outSent, MSG_NOSIGNAL);
+        if (n > 0) {
+            connection.outSent += static_cast<size_t>(n);
+            continue;
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            updateInterest(connection);
+            return;
+        }
+        closeConnection(connection);
+        return;
+    }
+    connection.out.clear();
+    connection.outSent = 0;
+    if (connection.closeAfterWrite) {
+        closeConnection(connection);
+        return;
+    }
+    // Pipelined requests that arrived behind the one just answered
+    if (connection.inLength > 0) {
+        if (!handleRequests(connection)) {
+            closeConnection(connection);
+            return;
+        }
+        if (!connection.out.empty()) {
+            onWritable(connection);
+            return;
+        }
+    }
+    updateInterest(connection);
+}
+
+// Answer every complete request in the input buffer, unless a response is
+// still being sent. False if the connection must be dropped.
+bool QueryServer::handleRequests(Connection& connection) {
+    while (connection.out.empty() && !connection.closeAfterWrite) {
+        char* begin = connection.in;
+        char* headerEnd = static_cast<char*>(memmem(begin, connection.inLength, "\r\n\r\n", 4));
+        if (headerEnd == nullptr) {
+            if (connection.inLength == kMaxRequestSize) {
+                body_.clear();
+                connection.out = "HTTP/1.1 431 Request Header Fields Too Large\r\nContent-Length: 0\r\n"
+                                 "Connection: close\r\n\r\n";
+                connection.closeAfterWrite = true;
+                connection.inLength = 0;
+            }
+            return true;
+        }
+        size_t requestLength = static_cast<size_t>(headerEnd - begin) + 4;
+        auto start = std::chrono::steady_clock::now();
+
+        // Request line: METHOD SP TARGET SP VERSION
+        char* lineEnd = static_cast<char*>(memchr(begin, '\r', requestLength));
+        char* targetStart = static_cast<char*>(memchr(begin, ' ', static_cast<size_t>(lineEnd - begin)));
+        char* targetEnd = targetStart != nullptr
+            ? static_cast<char*>(memchr(targetStart + 1, ' ', static_cast<size_t>(lineEnd - targetStart - 1)))
+            : nullptr;
+        if (targetEnd == nullptr) {
+            return false;
+        }
+        bool http11 = static_cast<size_t>(lineEnd - targetEnd) > 8 && memcmp(targetEnd + 1, "HTTP/1.1", 8) == 0;
+        const char* headers = lineEnd + 2;
+        size_t headersLength = static_cast<size_t>(headerEnd - headers) + 2;
+        bool keepAlive = http11 ? !headerHasToken(headers, headersLength, "Connection", "close")
+                                : headerHasToken(headers, headersLength, "Connection", "keep-alive");
+        if (headerHasToken(headers, headersLength, "Content-Length", "") ||
+            headerHasToken(headers, headersLength, "Transfer-Encoding", "")) {
+            keepAlive = false;          // Bodies are not read, so the stream cannot be resynchronized
+        }
+
+        const char* status;
+        if (targetStart - begin == 3 && memcmp(begin, "GET", 3) == 0) {
+            status = route(targetStart + 1, static_cast<size_t>(targetEnd - targetStart - 1));
+        } else {
+            status = error("405 Method Not Allowed", "only GET is supported");
+        }
+
+        char header[192];
+        int headerLength = snprintf(header, sizeof(header),
+                                    "HTTP/1.1 %s\r\nContent-Type: application/json\r\nContent-Length: %zu\r\n"
+                                    "Connection: %s\r\n\r\n",
+                                    status, body_.size(), keepAlive ? "keep-alive" : "close");
+        connection.out.append(header, static_cast<size_t>(headerLength));
+        connection.out += body_;
+        connection.closeAfterWrite = !keepAlive;
+
+        connection.inLength -= requestLength;
+        memmove(begin, begin + requestLength, connection.inLength);
+        requestLatency.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count()));
+    }
+    return true;
+}
+
+const char* QueryServer::route(const char* target, size_t length) {
+    const char* question = static_cast<const char*>(memchr(target, '?', length));
+    size_t pathLength = question != nullptr ? static_cast<size_t>(question - target) : length;
+    const char* query = question != nullptr ? question + 1 : target + length;
+    size_t queryLength = static_cast<size_t>(target + length - query);
+    auto pathIs = [&](const char* path) {
+        return strlen(path) == pathLength && memcmp(target, path, pathLength) == 0;
+    };
+
+    if (pathIs("/api/sources")) {
+        sourcesRequests.inc();
+        return sources();
+    }
+    if (!queryParam(query, queryLength, "source", sourceName_)) {
+        sourceName_.clear();            // Single-source mode
+    }
+    if (pathIs("/api/latest")) {
+        latestRequests.inc();
+        return latest(sourceName_);
+    }
+    if (pathIs("/api/range")) {
+        rangeRequests.inc();
+        return points(sourceName_, query, queryLength, false);
+    }
+    if (pathIs("/api/rollup")) {
+        rollupRequests.inc();
+        return points(sourceName_, query, queryLength, true);
+    }
+    otherRequests.inc();
+    if (pathIs("/health")) {
+        body_ = "{\"status\":\"ok\"}";
+        return "200 OK";
+    }
+    return error("404 Not Found", "unknown endpoint");
+}
+
+const char* QueryServer::error(const char* status, const char* message) {
+    body_ = "{\"error\":\"";
+    body_ += message;
+    body_ += "\"}";
+    return status;
+}
+
+const char* QueryServer::sources() {
+    body_ = "{\"sources\":[";
+    bool first = true;
+    for (const std::string& id : TimeSeriesStore::getInstance().sourceIds()) {
+        if (!first) body_ += ',';
+        JsonValue::appendQuoted(body_, id);
+        first = false;
+    }
+    body_ += "]}";
+    return "200 OK";
+}
+
+const char* QueryServer::latest(const std::string& sourceId) {
+    TimeSeriesStore& store = TimeSeriesStore::getInstance();
+    if (!store.hasSource(sourceId)) {
+        return error("404 Not Found", "unknown source");
+    }
+    body_ = "{\"source\":";
+    JsonValue::appendQuoted(body_, sourceId);
+    for (int f = 0; f < static_cast<int>(VitalField::Count); f++) {
+        VitalField field = static_cast<VitalField>(f);
+        TsPoint point;
+        body_ += ",\"";
+        body_ += TimeSeriesStore::fieldName(field);
+        body_ += "\":";
+        if (store.latest(sourceId, field, point)) {
+            char value[64];
+            snprintf(value, sizeof(value), "{\"time_ms\":%" PRId64 ",\"value\":%.5g}",
+                     point.timeUs / 1000, static_cast<double>(point.mean));
+            body_ += value;
+        } else {
+            body_ += "null";
+        }
+    }
+    body_ += '}';
+    return "200 OK";
+}
+
+const char* QueryServer::points(const std::string& sourceId, const char* query, size_t length, bool rollup) {
+    VitalField field;
+    if (!queryParam(query, length, "field", param_) || !TimeSeriesStore::parseField(param_, field)) {
+        return error("400 Bad Request", "field must be hr, spo2, systolic or diastolic");
+    }
+
+    // Range: from/to in epoch milliseconds, or the last N seconds
+    int64_t nowUs = TimestampFormatter::toEpochMicros(std::chrono::system_clock::now());
+    int64_t toUs = nowUs;
+    int64_t fromUs = nowUs - kDefaultRangeSec * 1000000;
+    int64_t value;
+    if (queryParam(query, length, "to", param_)) {
+        if (!parseInt64(param_, value) || __builtin_mul_overflow(value, 1000, &toUs)) {
+            return error("400 Bad Request", "to must be epoch milliseconds");
+        }
+    }
+    if (queryParam(query, length, "from", param_)) {
+        if (!parseInt64(param_, value) || __builtin_mul_overflow(value, 1000, &fromUs)) {
+            return error("400 Bad Request", "from must be epoch milliseconds");
+        }
+    } else if (queryParam(query, length, "last", param_)) {
+        int64_t lastUs;
+        if (!parseInt64(param_, value) || value <= 0 || __builtin_mul_overflow(value, 1000000, &lastUs) ||
+            __builtin_sub_overflow(toUs, lastUs, &fromUs)) {
+            return error("400 Bad Request", "last must be seconds");
+        }
+    }
+    if (fromUs > toUs) {
+        return error("400 Bad Request", "from is after to");
+    }
+
+    TimeSeriesStore& store = TimeSeriesStore::getInstance();
+    TsResolution resolution = TsResolution::Raw;
+    bool found;
+    if (rollup) {
+        if (!queryParam(query, length, "resolution", param_) || !parseResolution(param_, resolution)) {
+            return error("400 Bad Request", "resolution must be raw, 1s, 1m or 1h");
+        }
+        found = store.queryResolution(sourceId, field, resolution, fromUs, toUs,
+                                      static_cast<size_t>(options_.maxPoints), points_);
+    } else {
+        size_t maxPoints = static_cast<size_t>(options_.maxPoints);
+        if (queryParam(query, length, "max_points", param_)) {
+            if (!parseInt64(param_, value) || value <= 0) return error("400 Bad Request", "max_points must be positive");
+            maxPoints = std::min(maxPoints, static_cast<size_t>(value));
+        }
+        found = store.query(sourceId, field, fromUs, toUs, maxPoints, points_, &resolution);
+    }
+    if (!found) {
+        return error("404 Not Found", "unknown source");
+    }
+
+    body_ = "{\"source\":";
+    JsonValue::appendQuoted(body_, sourceId);
+    body_ += ",\"field\":\"";
+    body_ += TimeSeriesStore::fieldName(field);
+    body_ += "\",";
+    appendPoints(TimeSeriesStore::resolutionName(resolution));
+    return "200 OK";
+}
+
+void QueryServer::appendPoints(const char* resolution) {
+    body_ += "\"resolution\":\"";
+    body_ += resolution;
+    body_ += "\",\"columns\":[\"time_ms\",\"min\",\"max\",\"mean\",\"count\"],\"points\":[";
+    char row[kMaxPointBytes];
+    for (size_t i = 0; i < points_.size(); i++) {
+        const TsPoint& point = points_[i];
+        int n = snprintf(row, sizeof(row), "%s[%" PRId64 ",%.5g,%.5g,%.5g,%u]", i > 0 ? "," : "",
+                         point.timeUs / 1000, static_cast<double>(point.min), static_cast<double>(point.max),
+                         static_cast<double>(point.mean), point.count);
+        body_.append(row, static_cast<size_t>(n));
+    }
+    body_ += "]}";
+}
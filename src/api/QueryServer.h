@@ -0,0 +1,91 @@
+#ifndef QUERY_SERVER_H
+#define QUERY_SERVER_H
+
+#include "../timeseries/TimeSeriesStore.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Read-only HTTP/1.1 JSON API over TimeSeriesStore:
+//   GET /api/sources
+//   GET /api/latest?source=ID
+//   GET /api/range?source=ID&field=hr[&from=MS&to=MS|&last=SEC][&max_points=N]
+//   GET /api/rollup?source=ID&field=hr&resolution=1m[&from=MS&to=MS|&last=SEC]
+// One I/O thread runs an epoll loop over a fixed table of keep-alive
+// connections. The request buffers, the response body (sized for max_points)
+// and the point buffer the store fills in place are allocated by start(). A
+// connection's send buffer grows at most once, to the largest response it
+// carries, so a steady request load does not touch the heap. Queries only
+// hold the lock of the source they read, and the thread runs at a lower
+// priority than frame processing.
+class QueryServer {
+public:
+    struct Options {
+        int maxConnections = 64;
+        int maxPoints = 2000;           // Upper bound for range and rollup
+        int idleTimeoutSec = 30;        // Keep-alive connections idle this long are closed
+    };
+
+    static QueryServer& getInstance();
+
+    bool start(const std::string& bindAddress, int port, const Options& options);
+    bool startUnix(const std::string& socketPath, const Options& options);
+    void stop();
+
+    bool isRunning() const { return running_.load(); }
+
+private:
+    QueryServer() = default;
+    ~QueryServer();
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    static constexpr size_t kMaxRequestSize = 4096;
+
+    struct Connection {
+        int fd = -1;
+        size_t inLength = 0;
+        char in[kMaxRequestSize];
+        std::string out;                // Pending response bytes
+        size_t outSent = 0;
+        bool closeAfterWrite = false;
+        int64_t lastActiveMs = 0;
+    };
+
+    bool launch(int listenFd, const Options& options);
+    void serveLoop();
+    void acceptClients(int64_t nowMs);
+    void onReadable(Connection& connection, int64_t nowMs);
+    void onWritable(Connection& connection);
+    bool handleRequests(Connection& connection);
+    void closeConnection(Connection& connection);
+    void closeIdle(int64_t nowMs);
+    void updateInterest(Connection& connection);
+
+    // Fill body_ and return the status line
+    const char* route(const char* target, size_t length);
+    const char* sources();
+    const char* latest(const std::string& sourceId);
+    const char* points(const std::string& sourceId, const char* query, size_t length, bool rollup);
+    const char* error(const char* status, const char* message);
+    void appendPoints(const char* resolution);
+
+    Options options_;
+    int listenFd_ = -1;
+    int epollFd_ = -1;
+    std::string socketPath_;
+    std::vector<Connection> connections_;
+    std::vector<int> freeSlots_;
+    std::string body_;                  // Response body under construction
+    std::string sourceName_;
+    std::string param_;
+    std::vector<TsPoint> points_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stop_{false};
+};
+
+#endif // QUERY_SERVER_H
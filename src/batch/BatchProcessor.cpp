@@ -0,0 +1,240 @@
+#include "BatchProcessor.h"
+#include "../ml/EcgClassifier.h"
+#include "../monitoring/Tracer.h"
+#include "../ocr/VitalSignExtractor.h"
+#include "../utils/Logger.h"
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include <sys/stat.h>
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+struct Segment {
+    int64_t firstFrame = 0;
+    int64_t endFrame = 0;               // Exclusive; the last segment runs to EOF
+    std::vector<BatchRow> rows;
+    int64_t framesDecoded = 0;
+    bool done = false;
+};
+
+// The SDK keeps its tensor arena in globals. Inference is short next to
+// OCR, so workers simply take turns.
+std::mutex g_classifierMutex;
+
+std::chrono::system_clock::time_point recordingStart(const std::string& path, double durationSeconds) {
+    struct stat st {};
+    std::chrono::system_clock::time_point end = stat(path.c_str(), &st) == 0
+        ? std::chrono::system_clock::from_time_t(st.st_mtime)
+        : std::chrono::system_clock::now();
+    return end - std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::duration<double>(durationSeconds));
+}
+
+// Decode one segment and run OCR/ML on its processed frames. Frames in
+// between are only grabbed (demuxed and decoded, not converted).
+void processSegment(const BatchOptions& options, Segment& segment, cv::VideoCapture& capture,
+                    VitalSignExtractor& extractor, EcgClassifier& classifier, double fps,
+                    std::chrono::system_clock::time_point start, const std::atomic<bool>& cancel) {
+    TRACE_SCOPE("batch_segment");
+    if (!capture.isOpened() && !capture.open(options.videoPath)) {
+        LOG_ERROR("Batch: cannot open " + options.videoPath);
+        return;
+    }
+    capture.set(cv::CAP_PROP_POS_FRAMES, static_cast<double>(segment.firstFrame));
+
+    cv::Mat frame;
+    cv::Mat cropped;
+    // Each segment starts from the configured default, as a fresh run would,
+    // so the output does not depend on which worker ran the segment before
+    std::string lastSpO2 = options.defaultSpO2;
+    int interval = std::max(1, options.processingInterval);
+    for (int64_t index = segment.firstFrame; index < segment.endFrame; index++) {
+        if (cancel.load(std::memory_order_relaxed) || !capture.grab()) {
+            break;
+        }
+        segment.framesDecoded++;
+        if (index % interval != 0) {
+            continue;
+        }
+        if (!capture.retrieve(frame) || frame.empty()) {
+            continue;
+        }
+
+        BatchRow row;
+        row.frameIndex = index;
+        row.time = start + std::chrono::duration_cast<std::chrono::system_clock::duration>(
+            std::chrono::duration<double>(index / fps));
+        row.healthData = extractor.processFrame(frame, options.confidenceThreshold, lastSpO2);
+
+        if (options.mlEnabled) {
+            classifier.prepare(frame, cropped);
+            EcgResult result;
+            {
+                std::lock_guard<std::mutex> lock(g_classifierMutex);
+                result = classifier.run();
+            }
+            if (result.ok) {
+                row.ecgClassification = result.label;
+                row.ecgConfidence = result.confidence;
+            }
+        }
+        segment.rows.push_back(std::move(row));
+    }
+}
+
+} // namespace
+
+bool BatchProcessor::run(const BatchOptions& options, const RowCallback& onRow,
+                         const std::atomic<bool>& cancel, BatchStats& stats) {
+    auto wallStart = std::chrono::steady_clock::now();
+    stats = BatchStats();
+
+    cv::VideoCapture probe(options.videoPath);
+    if (!probe.isOpened()) {
+        LOG_ERROR("Batch: cannot open " + options.videoPath);
+        return false;
+    }
+    double fps = probe.get(cv::CAP_PROP_FPS);
+    int64_t frameCount = static_cast<int64_t>(probe.get(cv::CAP_PROP_FRAME_COUNT));
+    probe.release();
+    if (fps <= 0.0) {
+        LOG_WARN("Batch: file reports no frame rate, assuming 30 fps");
+        fps = 30.0;
+    }
+
+    // Without a frame count the file cannot be split; fall back to one segment
+    std::vector<Segment> segments;
+    int64_t segmentFrames = std::max<int64_t>(1, static_cast<int64_t>(options.segmentSeconds * fps));
+    if (frameCount <= 0) {
+        LOG_WARN("Batch: file reports no frame count, processing it as a single segment");
+        segments.resize(1);
+    } else {
+        segments.resize(static_cast<size_t>((frameCount + segmentFrames - 1) / segmentFrames));
+    }
+    for (size_t i = 0; i < segments.size(); i++) {
+        segments[i].firstFrame = static_cast<int64_t>(i) * segmentFrames;
+        segments[i].endFrame = segments[i].firstFrame + segmentFrames;
+    }
+    // Frame counts come from container metadata and can be short
+    segments.back().endFrame = std::numeric_limits<int64_t>::max();
+
+    int workers = options.workers > 0 ? options.workers
+                                      : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    workers = std::min<int>(workers, static_cast<int>(segments.size()));
+    stats.segments = static_cast<int>(segments.size());
+    stats.workers = workers;
+
+    std::chrono::system_clock::time_point start = recordingStart(options.videoPath, frameCount / fps);
+    LOG_INFO("Batch: " + options.videoPath + ", " + std::to_string(frameCount) + " frames at " +
+             std::to_string(fps) + " fps, " + std::to_string(segments.size()) + " segments on " +
+             std::to_string(workers) + " workers");
+
+    // Parallelism comes from the segments; keep OpenCV from oversubscribing
+    int previousCvThreads = cv::getNumThreads();
+    cv::setNumThreads(1);
+
+    // Workers may run at most this many segments ahead of the writer, which
+    // bounds the rows held in memory for long recordings
+    const size_t window = static_cast<size_t>(workers) * 2;
+    std::mutex mutex;
+    std::condition_variable changed;
+    size_t nextSegment = 0;
+    size_t nextToEmit = 0;
+    int liveWorkers = workers;
+
+    auto worker = [&]() {
+        Tracer::getInstance().setThreadName("batch");
+        VitalSignExtractor extractor;
+        bool ready = extractor.init(options.language, options.labels, options.defaultSpO2);
+        if (!ready) {
+            LOG_ERROR("Batch: worker could not initialize Tesseract (" + options.language + ")");
+        }
+        EcgClassifier classifier;
+        cv::VideoCapture capture;
+
+        while (ready) {
+            size_t index;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() {
+                    return cancel.load(std::memory_order_relaxed) || nextSegment >= segments.size() ||
+                           nextSegment < nextToEmit + window;
+                });
+                if (cancel.load(std::memory_order_relaxed) || nextSegment >= segments.size()) {
+                    break;
+                }
+                index = nextSegment++;
+            }
+
+            processSegment(options, segments[index], capture, extractor, classifier, fps, start, cancel);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            segments[index].done = true;
+            changed.notify_all();
+        }
+
+        extractor.end();
+        std::lock_guard<std::mutex> lock(mutex);
+        liveWorkers--;
+        changed.notify_all();
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < workers; i++) {
+        threads.emplace_back(worker);
+    }
+
+    // Hand segments to the callback in file order as they complete
+    bool ok = true;
+    while (nextToEmit < segments.size()) {
+        std::vector<BatchRow> rows;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // cancel is a plain flag (set from a signal handler), so poll it
+            while (!segments[nextToEmit].done && liveWorkers > 0 && !cancel.load(std::memory_order_relaxed)) {
+                changed.wait_for(lock, std::chrono::milliseconds(200));
+            }
+            if (!segments[nextToEmit].done) {
+                ok = liveWorkers > 0 || cancel.load(std::memory_order_relaxed);
+                break;
+            }
+            rows.swap(segments[nextToEmit].rows);
+            stats.framesDecoded += segments[nextToEmit].framesDecoded;
+            nextToEmit++;
+            changed.notify_all();
+        }
+
+        for (const BatchRow& row : rows) {
+            onRow(row);
+        }
+        stats.rowsWritten += static_cast<int64_t>(rows.size());
+        LOG_INFO("Batch: segment " + std::to_string(nextToEmit) + "/" + std::to_string(segments.size()) +
+                 " written (" + std::to_string(rows.size()) + " rows)");
+    }
+
+    {
+        // Release workers still waiting for the window to move
+        std::lock_guard<std::mutex> lock(mutex);
+        nextSegment = segments.size();
+        changed.notify_all();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    cv::setNumThreads(previousCvThreads);
+
+    if (!ok) {
+        LOG_ERROR("Batch: all workers stopped before segment " + std::to_string(nextToEmit + 1) + " finished");
+    }
+    stats.videoSeconds = stats.framesDecoded / fps;
+    stats.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+    return ok;
+}
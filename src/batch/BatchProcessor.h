@@ -0,0 +1,62 @@
+#ifndef BATCH_PROCESSOR_H
+#define BATCH_PROCESSOR_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// One processed frame from a recorded video
+struct BatchRow {
+    int64_t frameIndex = 0;
+    std::chrono::system_clock::time_point time;     // Recording time of the frame
+    std::map<std::string, std::string> healthData;
+    std::string ecgClassification = "unknown";
+    float ecgConfidence = 0.0f;
+};
+
+struct BatchOptions {
+    std::string videoPath;
+    int workers = 0;                    // 0 = one per hardware thread
+    int segmentSeconds = 600;
+    int processingInterval = 300;       // Process every N-th frame of the file
+    std::string language = "eng";
+    std::vector<std::string> labels;
+    std::string defaultSpO2;
+    int confidenceThreshold = 50;
+    bool mlEnabled = true;
+};
+
+struct BatchStats {
+    int segments = 0;
+    int workers = 0;
+    int64_t framesDecoded = 0;
+    int64_t rowsWritten = 0;
+    double videoSeconds = 0.0;
+    double wallSeconds = 0.0;
+};
+
+// Offline processing of a recorded video file. The file is split into
+// fixed-length time segments; each worker opens its own VideoCapture, seeks
+// to a segment and runs OCR and inference on every processingInterval-th
+// frame with its own VitalSignExtractor. Finished segments are handed to
+// the row callback strictly in file order on the calling thread, so CSV
+// and database output come out sorted by timestamp.
+//
+// Row times are the file's modification time minus its duration plus the
+// frame offset, i.e. the recorder is assumed to have closed the file when
+// recording stopped.
+class BatchProcessor {
+public:
+    using RowCallback = std::function<void(const BatchRow& row)>;
+
+    // Blocks until the whole file is processed or cancel becomes true;
+    // returns false if the file cannot be opened or no worker could start
+    bool run(const BatchOptions& options, const RowCallback& onRow,
+             const std::atomic<bool>& cancel, BatchStats& stats);
+};
+
+#endif // BATCH_PROCESSOR_H
@@ -1,26 +1,76 @@
 #include "ConfigManager.h"
+#include "JsonValue.h"
+#include "../utils/Logger.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
+#include <filesystem>
+#include <chrono>
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// How often the watcher thread checks for SIGHUP requests and shutdown
+constexpr int kWatchPollMs = 250;
+
+} // namespace
 
 ConfigManager& ConfigManager::getInstance() {
     static ConfigManager instance;
     return instance;
 }
 
+ConfigManager::ConfigManager()
+    : snapshot_(std::make_shared<const ConfigSnapshot>()) {
+}
+
+ConfigManager::~ConfigManager() {
+    stopHotReload();
+}
+
+std::shared_ptr<const ConfigSnapshot> ConfigManager::parseFile(const std::string& configPath,
+                                                               std::string& error) const {
+    std::ifstream file(configPath);
+    if (!file.is_open()) {
+        error = "Could not open config file: " + configPath;
+        return nullptr;
+    }
+    
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    
+    JsonValue root;
+    std::string parseError;
+    if (!JsonValue::parse(buffer.str(), root, &parseError)) {
+        error = "Invalid JSON in " + configPath + ": " + parseError;
+        return nullptr;
+    }
+    if (!root.isObject()) {
+        error = "Config root must be an object: " + configPath;
+        return nullptr;
+    }
+    
+    return ConfigSnapshot::fromJson(root);
+}
+
 bool ConfigManager::loadConfig(const std::string& configPath) {
     try {
-        std::ifstream file(configPath);
-        if (!file.is_open()) {
-            std::cerr << "Error: Could not open config file: " << configPath << std::endl;
+        configPath_ = configPath;
+        
+        std::string error;
+        std::shared_ptr<const ConfigSnapshot> parsed = parseFile(configPath, error);
+        if (!parsed) {
+            std::cerr << "Error: " << error << std::endl;
             return false;
         }
         
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        std::string content = buffer.str();
-        
-        parseJSON(content);
+        std::atomic_store(&snapshot_, parsed);
         loaded_ = true;
         
         std::cout << "Configuration loaded successfully from: " << configPath << std::endl;
@@ -31,235 +81,266 @@ bool ConfigManager::loadConfig(const std::string& configPath) {
     }
 }
 
-// Helper to extract value from JSON (simplified parser)
-std::string ConfigManager::extractValue(const std::string& content, const std::string& key) const {
-    std::string searchKey = "\"" + key + "\"";
-    size_t pos = content.find(searchKey);
-    if (pos == std::string::npos) return "";
+std::shared_ptr<const ConfigSnapshot> ConfigManager::snapshot() const {
+    return std::atomic_load(&snapshot_);
+}
+
+bool ConfigManager::reload() {
+    std::string error;
+    std::shared_ptr<const ConfigSnapshot> parsed;
+    try {
+        parsed = parseFile(configPath_, error);
+    } catch (const std::exception& e) {
+        error = e.what();
+    }
     
-    pos = content.find(":", pos);
-    if (pos == std::string::npos) return "";
+    if (!parsed) {
+        LOG_ERROR("Config reload failed, keeping previous configuration: " + error);
+        return false;
+    }
     
-    pos = content.find_first_not_of(" \t\n\r", pos + 1);
-    if (pos == std::string::npos) return "";
+    std::atomic_store(&snapshot_, parsed);
+    loaded_ = true;
+    LOG_INFO("Configuration reloaded from: " + configPath_);
     
-    char delimiter = content[pos];
-    if (delimiter == '"') {
-        size_t start = pos + 1;
-        size_t end = content.find('"', start);
-        if (end != std::string::npos) {
-            return content.substr(start, end - start);
-        }
-    } else if (delimiter == 't' || delimiter == 'f') {
-        // Boolean
-        size_t end = content.find_first_of(",\n}", pos);
-        std::string value = content.substr(pos, end - pos);
-        value.erase(std::remove_if(value.begin(), value.end(), ::isspace), value.end());
-        return value;
-    } else if (std::isdigit(delimiter) || delimiter == '-') {
-        // Number
-        size_t end = content.find_first_of(",\n}", pos);
-        std::string value = content.substr(pos, end - pos);
-        value.erase(std::remove_if(value.begin(), value.end(), ::isspace), value.end());
-        return value;
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    if (reloadCallback_) {
+        reloadCallback_(*parsed);
     }
-    
-    return "";
+    return true;
 }
 
-void ConfigManager::parseJSON(const std::string& content) {
-    // Simplified JSON parser - extracts key-value pairs
-    // For production, use nlohmann/json or similar library
-    
-    // Application settings
-    config_["app.name"] = extractValue(content, "name");
-    config_["app.version"] = extractValue(content, "version");
-    config_["app.debug_mode"] = extractValue(content, "debug_mode");
-    
-    // Video settings
-    config_["video.source_type"] = extractValue(content, "source_type");
-    config_["video.source_path"] = extractValue(content, "source_path");
-    config_["video.camera_index"] = extractValue(content, "camera_index");
-    config_["video.frame_width"] = extractValue(content, "frame_width");
-    config_["video.frame_height"] = extractValue(content, "frame_height");
-    config_["video.processing_interval"] = extractValue(content, "processing_interval");
-    config_["video.reconnect_attempts"] = extractValue(content, "reconnect_attempts");
-    config_["video.reconnect_delay_ms"] = extractValue(content, "reconnect_delay_ms");
-    
-    // OCR settings
-    config_["ocr.language"] = extractValue(content, "language");
-    config_["ocr.confidence_threshold"] = extractValue(content, "confidence_threshold");
-    config_["ocr.tesseract_config"] = extractValue(content, "tesseract_config");
-    config_["ocr.page_segmentation_mode"] = extractValue(content, "page_segmentation_mode");
-    
-    // Vital signs
-    config_["vital_signs.default_spo2"] = extractValue(content, "default_spo2");
-    config_["vital_signs.spo2_history_size"] = extractValue(content, "spo2_history_size");
-    config_["vital_signs.hr_min"] = extractValue(content, "hr_min");
-    config_["vital_signs.hr_max"] = extractValue(content, "hr_max");
-    config_["vital_signs.spo2_min"] = extractValue(content, "spo2_min");
-    config_["vital_signs.spo2_max"] = extractValue(content, "spo2_max");
-    config_["vital_signs.abp_systolic_min"] = extractValue(content, "abp_systolic_min");
-    config_["vital_signs.abp_systolic_max"] = extractValue(content, "abp_systolic_max");
-    config_["vital_signs.abp_diastolic_min"] = extractValue(content, "abp_diastolic_min");
-    config_["vital_signs.abp_diastolic_max"] = extractValue(content, "abp_diastolic_max");
-    
-    // ML Model
-    config_["ml_model.enabled"] = extractValue(content, "enabled");
-    config_["ml_model.input_width"] = extractValue(content, "input_width");
-    config_["ml_model.input_height"] = extractValue(content, "input_height");
-    config_["ml_model.confidence_threshold"] = extractValue(content, "confidence_threshold");
-    
-    // Database
-    config_["database.enabled"] = extractValue(content, "enabled");
-    config_["database.type"] = extractValue(content, "type");
-    config_["database.host"] = extractValue(content, "host");
-    config_["database.port"] = extractValue(content, "port");
-    config_["database.database"] = extractValue(content, "database");
-    config_["database.user"] = extractValue(content, "user");
-    config_["database.password"] = extractValue(content, "password");
-    config_["database.connection_pool_size"] = extractValue(content, "connection_pool_size");
-    config_["database.connection_timeout"] = extractValue(content, "connection_timeout");
-    config_["database.retry_attempts"] = extractValue(content, "retry_attempts");
-    config_["database.retry_delay_ms"] = extractValue(content, "retry_delay_ms");
-    
-    // Output
-    config_["output.csv_enabled"] = extractValue(content, "csv_enabled");
-    config_["output.csv_file"] = extractValue(content, "csv_file");
-    config_["output.console_output"] = extractValue(content, "console_output");
-    
-    // Logging
-    config_["logging.level"] = extractValue(content, "level");
-    config_["logging.console_enabled"] = extractValue(content, "console_enabled");
-    config_["logging.file_enabled"] = extractValue(content, "file_enabled");
-    config_["logging.file_path"] = extractValue(content, "file_path");
-    config_["logging.max_file_size_mb"] = extractValue(content, "max_file_size_mb");
-    config_["logging.max_files"] = extractValue(content, "max_files");
-    config_["logging.pattern"] = extractValue(content, "pattern");
-    
-    // Monitoring
-    config_["monitoring.health_check_interval_sec"] = extractValue(content, "health_check_interval_sec");
-    config_["monitoring.metrics_enabled"] = extractValue(content, "metrics_enabled");
-    config_["monitoring.alert_on_error"] = extractValue(content, "alert_on_error");
+void ConfigManager::requestReload() {
+    reloadRequested_.store(true, std::memory_order_relaxed);
 }
 
-// Helper methods
-std::string ConfigManager::getString(const std::string& key, const std::string& defaultValue) const {
-    auto it = config_.find(key);
-    return (it != config_.end() && !it->second.empty()) ? it->second : defaultValue;
+void ConfigManager::setReloadCallback(std::function<void(const ConfigSnapshot&)> callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    reloadCallback_ = std::move(callback);
 }
 
-int ConfigManager::getInt(const std::string& key, int defaultValue) const {
-    auto it = config_.find(key);
-    if (it != config_.end() && !it->second.empty()) {
-        try {
-            return std::stoi(it->second);
-        } catch (...) {
-            return defaultValue;
-        }
+bool ConfigManager::startHotReload() {
+    if (watcherThread_.joinable()) {
+        return true;
+    }
+    if (configPath_.empty()) {
+        LOG_WARN("Config hot reload not started: no config file loaded");
+        return false;
     }
-    return defaultValue;
+    
+    stopWatcher_ = false;
+    watcherThread_ = std::thread(&ConfigManager::watchLoop, this);
+    return true;
 }
 
-bool ConfigManager::getBool(const std::string& key, bool defaultValue) const {
-    auto it = config_.find(key);
-    if (it != config_.end() && !it->second.empty()) {
-        std::string value = it->second;
-        std::transform(value.begin(), value.end(), value.begin(), ::tolower);
-        return value == "true" || value == "1";
+void ConfigManager::stopHotReload() {
+    stopWatcher_ = true;
+    if (watcherThread_.joinable()) {
+        watcherThread_.join();
     }
-    return defaultValue;
 }
 
-float ConfigManager::getFloat(const std::string& key, float defaultValue) const {
-    auto it = config_.find(key);
-    if (it != config_.end() && !it->second.empty()) {
-        try {
-            return std::stof(it->second);
-        } catch (...) {
-            return defaultValue;
+void ConfigManager::watchLoop() {
+    int inotifyFd = -1;
+#ifdef __linux__
+    // Watch the directory rather than the file so editors that save by
+    // writing a temp file and renaming it over the original are caught too
+    fs::path path(configPath_);
+    std::string dir = path.has_parent_path() ? path.parent_path().string() : ".";
+    std::string fileName = path.filename().string();
+    
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd >= 0 && inotify_add_watch(inotifyFd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+#endif
+    
+    if (inotifyFd < 0) {
+        LOG_WARN("Config file watch unavailable; reload with SIGHUP");
+    } else {
+        LOG_INFO("Watching " + configPath_ + " for changes");
+    }
+    
+    while (!stopWatcher_.load()) {
+        bool changed = false;
+        
+#ifdef __linux__
+        if (inotifyFd >= 0) {
+            pollfd pfd{inotifyFd, POLLIN, 0};
+            if (poll(&pfd, 1, kWatchPollMs) > 0) {
+                alignas(inotify_event) char buffer[4096];
+                ssize_t length;
+                while ((length = read(inotifyFd, buffer, sizeof(buffer))) > 0) {
+                    for (char* ptr = buffer; ptr < buffer + length;) {
+                        const inotify_event* event = reinterpret_cast<const inotify_event*>(ptr);
+                        if (event->len > 0 && fileName == event->name) {
+                            changed = true;
+                        }
+                        ptr += sizeof(inotify_event) + event->len;
+                    }
+                }
+            }
+        } else
+#endif
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(kWatchPollMs));
         }
+        
+        if (reloadRequested_.exchange(false)) {
+            changed = true;
+        }
+        if (changed) {
+            reload();
+        }
+    }
+    
+#ifdef __linux__
+    if (inotifyFd >= 0) {
+        close(inotifyFd);
     }
-    return defaultValue;
+#endif
 }
 
 // Application settings
-std::string ConfigManager::getAppName() const { return getString("app.name", "VitalSignExtractor"); }
-std::string ConfigManager::getAppVersion() const { return getString("app.version", "1.0.0"); }
-bool ConfigManager::isDebugMode() const { return getBool("app.debug_mode", false); }
+std::string ConfigManager::getAppName() const { return snapshot()->app.name; }
+std::string ConfigManager::getAppVersion() const { return snapshot()->app.version; }
+bool ConfigManager::isDebugMode() const { return snapshot()->app.debugMode; }
 
 // Video settings
-std::string ConfigManager::getVideoSourceType() const { return getString("video.source_type", "file"); }
-std::string ConfigManager::getVideoSourcePath() const { return getString("video.source_path", ""); }
-int ConfigManager::getCameraIndex() const { return getInt("video.camera_index", 0); }
-int ConfigManager::getFrameWidth() const { return getInt("video.frame_width", 640); }
-int ConfigManager::getFrameHeight() const { return getInt("video.frame_height", 480); }
-int ConfigManager::getProcessingInterval() const { return getInt("video.processing_interval", 300); }
-int ConfigManager::getReconnectAttempts() const { return getInt("video.reconnect_attempts", 5); }
-int ConfigManager::getReconnectDelayMs() const { return getInt("video.reconnect_delay_ms", 2000); }
+std::string ConfigManager::getVideoSourceType() const { return snapshot()->video.sourceType; }
+std::string ConfigManager::getVideoSourcePath() const { return snapshot()->video.sourcePath; }
+int ConfigManager::getCameraIndex() const { return snapshot()->video.cameraIndex; }
+int ConfigManager::getFrameWidth() const { return snapshot()->video.frameWidth; }
+int ConfigManager::getFrameHeight() const { return snapshot()->video.frameHeight; }
+int ConfigManager::getProcessingInterval() const { return snapshot()->video.processingInterval; }
+int ConfigManager::getReconnectAttempts() const { return snapshot()->video.reconnectAttempts; }
+int ConfigManager::getReconnectDelayMs() const { return snapshot()->video.reconnectDelayMs; }
+bool ConfigManager::isBatchModeEnabled() const { return snapshot()->video.batchMode; }
+int ConfigManager::getBatchWorkers() const { return snapshot()->video.batchWorkers; }
+int ConfigManager::getBatchSegmentSeconds() const { return snapshot()->video.batchSegmentSeconds; }
+std::vector<VideoSourceConfig> ConfigManager::getVideoSources() const { return snapshot()->video.sources; }
+int ConfigManager::getOCREngines() const { return snapshot()->video.ocrEngines; }
+int ConfigManager::getPipelineWorkers() const { return snapshot()->video.pipelineWorkers; }
+int ConfigManager::getFramePoolSize() const { return snapshot()->video.framePoolSize; }
+std::string ConfigManager::getFramePoolBackpressure() const { return snapshot()->video.framePoolBackpressure; }
+
+// Rate control settings
+bool ConfigManager::isRateControlEnabled() const { return snapshot()->rateControl.enabled; }
+int ConfigManager::getRateControlMinInterval() const { return snapshot()->rateControl.minInterval; }
+float ConfigManager::getCpuBudgetPercent() const { return snapshot()->rateControl.cpuBudgetPercent; }
+
+// Temporal fusion settings
+bool ConfigManager::isFusionEnabled() const { return snapshot()->fusion.enabled; }
+int ConfigManager::getFusionWindow() const { return snapshot()->fusion.window; }
+
+// In-memory history settings
+bool ConfigManager::isTimeSeriesEnabled() const { return snapshot()->timeSeries.enabled; }
+int ConfigManager::getTimeSeriesRawSamples() const { return snapshot()->timeSeries.rawSamples; }
+int ConfigManager::getTimeSeriesSecondBuckets() const { return snapshot()->timeSeries.secondBuckets; }
+int ConfigManager::getTimeSeriesMinuteBuckets() const { return snapshot()->timeSeries.minuteBuckets; }
+int ConfigManager::getTimeSeriesHourBuckets() const { return snapshot()->timeSeries.hourBuckets; }
+
+// Compressed archive settings
+bool ConfigManager::isArchiveEnabled() const { return snapshot()->archive.enabled; }
+std::string ConfigManager::getArchivePath() const { return snapshot()->archive.path; }
+int ConfigManager::getArchiveBlockSamples() const { return snapshot()->archive.blockSamples; }
+int ConfigManager::getArchiveFlushIntervalSec() const { return snapshot()->archive.flushIntervalSec; }
 
 // OCR settings
-std::string ConfigManager::getOCRLanguage() const { return getString("ocr.language", "eng"); }
-int ConfigManager::getOCRConfidenceThreshold() const { return getInt("ocr.confidence_threshold", 50); }
-std::string ConfigManager::getTesseractConfig() const { return getString("ocr.tesseract_config", ""); }
-int ConfigManager::getPageSegmentationMode() const { return getInt("ocr.page_segmentation_mode", 3); }
+std::string ConfigManager::getOCRLanguage() const { return snapshot()->ocr.language; }
+int ConfigManager::getOCRConfidenceThreshold() const { return snapshot()->ocr.confidenceThreshold; }
+std::string ConfigManager::getTesseractConfig() const { return snapshot()->ocr.tesseractConfig; }
+int ConfigManager::getPageSegmentationMode() const { return snapshot()->ocr.pageSegmentationMode; }
 
 // Vital signs settings
-std::string ConfigManager::getDefaultSpO2() const { return getString("vital_signs.default_spo2", "81"); }
-std::vector<std::string> ConfigManager::getVitalSignLabels() const {
-    return {"HR", "SpO2", "ABP"};
-}
-int ConfigManager::getSpO2HistorySize() const { return getInt("vital_signs.spo2_history_size", 10); }
+std::string ConfigManager::getDefaultSpO2() const { return snapshot()->vitalSigns.defaultSpO2; }
+std::vector<std::string> ConfigManager::getVitalSignLabels() const { return snapshot()->vitalSigns.labels; }
+int ConfigManager::getSpO2HistorySize() const { return snapshot()->vitalSigns.spo2HistorySize; }
 
 ConfigManager::ValidationRanges ConfigManager::getValidationRanges() const {
-    ValidationRanges ranges;
-    ranges.hr_min = getInt("vital_signs.hr_min", 30);
-    ranges.hr_max = getInt("vital_signs.hr_max", 200);
-    ranges.spo2_min = getInt("vital_signs.spo2_min", 70);
-    ranges.spo2_max = getInt("vital_signs.spo2_max", 100);
-    ranges.abp_systolic_min = getInt("vital_signs.abp_systolic_min", 70);
-    ranges.abp_systolic_max = getInt("vital_signs.abp_systolic_max", 200);
-    ranges.abp_diastolic_min = getInt("vital_signs.abp_diastolic_min", 40);
-    ranges.abp_diastolic_max = getInt("vital_signs.abp_diastolic_max", 130);
-    return ranges;
+    return snapshot()->vitalSigns.validation;
 }
 
 // ML Model settings
-bool ConfigManager::isMLModelEnabled() const { return getBool("ml_model.enabled", true); }
-int ConfigManager::getMLInputWidth() const { return getInt("ml_model.input_width", 96); }
-int ConfigManager::getMLInputHeight() const { return getInt("ml_model.input_height", 96); }
-float ConfigManager::getMLConfidenceThreshold() const { return getFloat("ml_model.confidence_threshold", 0.7f); }
+bool ConfigManager::isMLModelEnabled() const { return snapshot()->mlModel.enabled; }
+int ConfigManager::getMLInputWidth() const { return snapshot()->mlModel.inputWidth; }
+int ConfigManager::getMLInputHeight() const { return snapshot()->mlModel.inputHeight; }
+float ConfigManager::getMLConfidenceThreshold() const { return snapshot()->mlModel.confidenceThreshold; }
 
 // Database settings
-bool ConfigManager::isDatabaseEnabled() const { return getBool("database.enabled", false); }
-std::string ConfigManager::getDBType() const { return getString("database.type", "postgresql"); }
-std::string ConfigManager::getDBHost() const { return getString("database.host", "localhost"); }
-int ConfigManager::getDBPort() const { return getInt("database.port", 5432); }
-std::string ConfigManager::getDBName() const { return getString("database.database", "vital_signs_db"); }
-std::string ConfigManager::getDBUser() const { return getString("database.user", "vitalsign_user"); }
-std::string ConfigManager::getDBPassword() const { return getString("database.password", ""); }
-int ConfigManager::getDBConnectionPoolSize() const { return getInt("database.connection_pool_size", 5); }
-int ConfigManager::getDBConnectionTimeout() const { return getInt("database.connection_timeout", 30); }
-int ConfigManager::getDBRetryAttempts() const { return getInt("database.retry_attempts", 3); }
-int ConfigManager::getDBRetryDelayMs() const { return getInt("database.retry_delay_ms", 1000); }
+bool ConfigManager::isDatabaseEnabled() const { return snapshot()->database.enabled; }
+std::string ConfigManager::getDBType() const { return snapshot()->database.type; }
+std::string ConfigManager::getDBHost() const { return snapshot()->database.host; }
+int ConfigManager::getDBPort() const { return snapshot()->database.port; }
+std::string ConfigManager::getDBName() const { return snapshot()->database.name; }
+std::string ConfigManager::getDBUser() const { return snapshot()->database.user; }
+std::string ConfigManager::getDBPassword() const { return snapshot()->database.password; }
+int ConfigManager::getDBConnectionPoolSize() const { return snapshot()->database.connectionPoolSize; }
+int ConfigManager::getDBConnectionTimeout() const { return snapshot()->database.connectionTimeout; }
+int ConfigManager::getDBRetryAttempts() const { return snapshot()->database.retryAttempts; }
+int ConfigManager::getDBRetryDelayMs() const { return snapshot()->database.retryDelayMs; }
+std::string ConfigManager::getDBSQLitePath() const { return snapshot()->database.sqlitePath; }
+int ConfigManager::getDBSQLiteBatchSize() const { return snapshot()->database.sqliteBatchSize; }
+int ConfigManager::getDBSQLiteFlushIntervalMs() const { return snapshot()->database.sqliteFlushIntervalMs; }
 
 // Output settings
-bool ConfigManager::isCSVEnabled() const { return getBool("output.csv_enabled", true); }
-std::string ConfigManager::getCSVFile() const { return getString("output.csv_file", "live_vital_signs_output.csv"); }
-bool ConfigManager::isConsoleOutputEnabled() const { return getBool("output.console_output", true); }
+bool ConfigManager::isCSVEnabled() const { return snapshot()->output.csvEnabled; }
+std::string ConfigManager::getCSVFile() const { return snapshot()->output.csvFile; }
+int ConfigManager::getCSVBufferKb() const { return snapshot()->output.csvBufferKb; }
+int ConfigManager::getCSVFlushIntervalMs() const { return snapshot()->output.csvFlushIntervalMs; }
+std::string ConfigManager::getCSVFsync() const { return snapshot()->output.csvFsync; }
+std::string ConfigManager::getCSVRotate() const { return snapshot()->output.csvRotate; }
+int ConfigManager::getCSVMaxSizeMb() const { return snapshot()->output.csvMaxSizeMb; }
+int ConfigManager::getCSVMaxFiles() const { return snapshot()->output.csvMaxFiles; }
+bool ConfigManager::isConsoleOutputEnabled() const { return snapshot()->output.consoleOutput; }
+
+// Shared-memory publisher settings
+bool ConfigManager::isPublishEnabled() const { return snapshot()->publish.enabled; }
+std::string ConfigManager::getPublishShmName() const { return snapshot()->publish.shmName; }
+int ConfigManager::getPublishCapacity() const { return snapshot()->publish.capacity; }
+
+// Query API settings
+bool ConfigManager::isApiEnabled() const { return snapshot()->api.enabled; }
+std::string ConfigManager::getApiBindAddress() const { return snapshot()->api.bindAddress; }
+int ConfigManager::getApiPort() const { return snapshot()->api.port; }
+std::string ConfigManager::getApiSocketPath() const { return snapshot()->api.socketPath; }
+int ConfigManager::getApiMaxConnections() const { return snapshot()->api.maxConnections; }
+int ConfigManager::getApiMaxPoints() const { return snapshot()->api.maxPoints; }
+int ConfigManager::getApiIdleTimeoutSec() const { return snapshot()->api.idleTimeoutSec; }
+
+// Start-up settings
+bool ConfigManager::isStartupParallel() const { return snapshot()->startup.parallel; }
+bool ConfigManager::isStartupWarmupEnabled() const { return snapshot()->startup.warmup; }
+
+// Alarm settings
+bool ConfigManager::isAlarmsEnabled() const { return snapshot()->alarms.enabled; }
+std::string ConfigManager::getAlarmSocketPath() const { return snapshot()->alarms.socketPath; }
+std::vector<AlarmRuleConfig> ConfigManager::getAlarmRules() const { return snapshot()->alarms.rules; }
 
 // Logging settings
-std::string ConfigManager::getLogLevel() const { return getString("logging.level", "info"); }
-bool ConfigManager::isConsoleLoggingEnabled() const { return getBool("logging.console_enabled", true); }
-bool ConfigManager::isFileLoggingEnabled() const { return getBool("logging.file_enabled", true); }
-std::string ConfigManager::getLogFilePath() const { return getString("logging.file_path", "logs/vitalsign.log"); }
-int ConfigManager::getMaxLogFileSizeMB() const { return getInt("logging.max_file_size_mb", 10); }
-int ConfigManager::getMaxLogFiles() const { return getInt("logging.max_files", 5); }
-std::string ConfigManager::getLogPattern() const { 
-    return getString("logging.pattern", "[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] [%t] %v"); 
-}
+std::string ConfigManager::getLogLevel() const { return snapshot()->logging.level; }
+bool ConfigManager::isConsoleLoggingEnabled() const { return snapshot()->logging.consoleEnabled; }
+bool ConfigManager::isFileLoggingEnabled() const { return snapshot()->logging.fileEnabled; }
+std::string ConfigManager::getLogFilePath() const { return snapshot()->logging.filePath; }
+int ConfigManager::getMaxLogFileSizeMB() const { return snapshot()->logging.maxFileSizeMB; }
+int ConfigManager::getMaxLogFiles() const { return snapshot()->logging.maxFiles; }
+std::string ConfigManager::getLogPattern() const { return snapshot()->logging.pattern; }
+bool ConfigManager::isAsyncLoggingEnabled() const { return snapshot()->logging.async; }
+int ConfigManager::getLogQueueSize() const { return snapshot()->logging.queueSize; }
+std::string ConfigManager::getLogOverflowPolicy() const { return snapshot()->logging.overflowPolicy; }
+int ConfigManager::getLogFlushIntervalMs() const { return snapshot()->logging.flushIntervalMs; }
 
 // Monitoring settings
-int ConfigManager::getHealthCheckIntervalSec() const { return getInt("monitoring.health_check_interval_sec", 60); }
-bool ConfigManager::isMetricsEnabled() const { return getBool("monitoring.metrics_enabled", true); }
-bool ConfigManager::isAlertOnError() const { return getBool("monitoring.alert_on_error", true); }
+int ConfigManager::getHealthCheckIntervalSec() const { return snapshot()->monitoring.healthCheckIntervalSec; }
+bool ConfigManager::isMetricsEnabled() const { return snapshot()->monitoring.metricsEnabled; }
+bool ConfigManager::isAlertOnError() const { return snapshot()->monitoring.alertOnError; }
+std::string ConfigManager::getMetricsBindAddress() const { return snapshot()->monitoring.metricsBindAddress; }
+int ConfigManager::getMetricsPort() const { return snapshot()->monitoring.metricsPort; }
+std::string ConfigManager::getMetricsSocketPath() const { return snapshot()->monitoring.metricsSocketPath; }
+
+// Tracing settings
+bool ConfigManager::isTracingEnabled() const { return snapshot()->tracing.enabled; }
+int ConfigManager::getTraceBufferSize() const { return snapshot()->tracing.bufferSize; }
+std::string ConfigManager::getTraceOutputPath() const { return snapshot()->tracing.outputPath; }
+bool ConfigManager::isTraceDumpOnShutdown() const { return snapshot()->tracing.dumpOnShutdown; }
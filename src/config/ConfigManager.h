@@ -7,10 +7,15 @@
 #include <memory>
 #include <fstream>
 #include <stdexcept>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <functional>
+#include "ConfigSnapshot.h"
 
-// Simple JSON parser (using nlohmann/json would be better, but keeping dependencies minimal)
-// For production, consider using nlohmann/json library
-
+// Loads config.json in one pass into an immutable ConfigSnapshot and publishes
+// it atomically. Hot paths should grab snapshot() once and read its fields;
+// the individual getters remain for startup code.
 class ConfigManager {
 public:
     static ConfigManager& getInstance();
@@ -18,6 +23,24 @@ public:
     // Initialize configuration from file
     bool loadConfig(const std::string& configPath);
     
+    // Current configuration; the returned snapshot never changes underneath the caller
+    std::shared_ptr<const ConfigSnapshot> snapshot() const;
+    
+    // Re-read the file loaded by loadConfig(). On parse errors the previous
+    // snapshot stays active.
+    bool reload();
+    
+    // Ask the watcher thread to reload. Async-signal-safe, for SIGHUP handlers.
+    void requestReload();
+    
+    // Watch the config file (inotify) and service requestReload() on a
+    // background thread
+    bool startHotReload();
+    void stopHotReload();
+    
+    // Called on the watcher thread after each successful reload
+    void setReloadCallback(std::function<void(const ConfigSnapshot&)> callback);
+    
     // Application settings
     std::string getAppName() const;
     std::string getAppVersion() const;
@@ -32,6 +55,36 @@ public:
     int getProcessingInterval() const;
     int getReconnectAttempts() const;
     int getReconnectDelayMs() const;
+    bool isBatchModeEnabled() const;
+    int getBatchWorkers() const;
+    int getBatchSegmentSeconds() const;
+    std::vector<VideoSourceConfig> getVideoSources() const;
+    int getOCREngines() const;
+    int getPipelineWorkers() const;
+    int getFramePoolSize() const;
+    std::string getFramePoolBackpressure() const;
+    
+    // Rate control settings
+    bool isRateControlEnabled() const;
+    int getRateControlMinInterval() const;
+    float getCpuBudgetPercent() const;
+    
+    // Temporal fusion settings
+    bool isFusionEnabled() const;
+    int getFusionWindow() const;
+    
+    // In-memory history settings
+    bool isTimeSeriesEnabled() const;
+    int getTimeSeriesRawSamples() const;
+    int getTimeSeriesSecondBuckets() const;
+    int getTimeSeriesMinuteBuckets() const;
+    int getTimeSeriesHourBuckets() const;
+    
+    // Compressed archive settings
+    bool isArchiveEnabled() const;
+    std::string getArchivePath() const;
+    int getArchiveBlockSamples() const;
+    int getArchiveFlushIntervalSec() const;
     
     // OCR settings
     std::string getOCRLanguage() const;
@@ -45,12 +98,7 @@ public:
     int getSpO2HistorySize() const;
     
     // Validation ranges
-    struct ValidationRanges {
-        int hr_min, hr_max;
-        int spo2_min, spo2_max;
-        int abp_systolic_min, abp_systolic_max;
-        int abp_diastolic_min, abp_diastolic_max;
-    };
+    using ValidationRanges = ::ValidationRanges;
     ValidationRanges getValidationRanges() const;
     
     // ML Model settings
@@ -71,12 +119,44 @@ public:
     int getDBConnectionTimeout() const;
     int getDBRetryAttempts() const;
     int getDBRetryDelayMs() const;
+    std::string getDBSQLitePath() const;
+    int getDBSQLiteBatchSize() const;
+    int getDBSQLiteFlushIntervalMs() const;
     
     // Output settings
     bool isCSVEnabled() const;
     std::string getCSVFile() const;
+    int getCSVBufferKb() const;
+    int getCSVFlushIntervalMs() const;
+    std::string getCSVFsync() const;
+    std::string getCSVRotate() const;
+    int getCSVMaxSizeMb() const;
+    int getCSVMaxFiles() const;
     bool isConsoleOutputEnabled() const;
     
+    // Shared-memory publisher settings
+    bool isPublishEnabled() const;
+    std::string getPublishShmName() const;
+    int getPublishCapacity() const;
+    
+    // Query API settings
+    bool isApiEnabled() const;
+    std::string getApiBindAddress() const;
+    int getApiPort() const;
+    std::string getApiSocketPath() const;
+    int getApiMaxConnections() const;
+    int getApiMaxPoints() const;
+    int getApiIdleTimeoutSec() const;
+    
+    // Start-up settings
+    bool isStartupParallel() const;
+    bool isStartupWarmupEnabled() const;
+    
+    // Alarm settings
+    bool isAlarmsEnabled() const;
+    std::string getAlarmSocketPath() const;
+    std::vector<AlarmRuleConfig> getAlarmRules() const;
+    
     // Logging settings
     std::string getLogLevel() const;
     bool isConsoleLoggingEnabled() const;
@@ -85,31 +165,46 @@ public:
     int getMaxLogFileSizeMB() const;
     int getMaxLogFiles() const;
     std::string getLogPattern() const;
+    bool isAsyncLoggingEnabled() const;
+    int getLogQueueSize() const;
+    std::string getLogOverflowPolicy() const;
+    int getLogFlushIntervalMs() const;
     
     // Monitoring settings
     int getHealthCheckIntervalSec() const;
     bool isMetricsEnabled() const;
     bool isAlertOnError() const;
+    std::string getMetricsBindAddress() const;
+    int getMetricsPort() const;
+    std::string getMetricsSocketPath() const;
+    
+    // Tracing settings
+    bool isTracingEnabled() const;
+    int getTraceBufferSize() const;
+    std::string getTraceOutputPath() const;
+    bool isTraceDumpOnShutdown() const;
     
 private:
-    ConfigManager() = default;
-    ~ConfigManager() = default;
+    ConfigManager();
+    ~ConfigManager();
     ConfigManager(const ConfigManager&) = delete;
     ConfigManager& operator=(const ConfigManager&) = delete;
     
-    // Simple config storage
-    std::map<std::string, std::string> config_;
+    // Published snapshot; accessed only through std::atomic_load/atomic_store
+    std::shared_ptr<const ConfigSnapshot> snapshot_;
+    std::string configPath_;
     bool loaded_ = false;
     
+    // Hot reload state
+    std::thread watcherThread_;
+    std::atomic<bool> stopWatcher_{false};
+    std::atomic<bool> reloadRequested_{false};
+    std::mutex callbackMutex_;
+    std::function<void(const ConfigSnapshot&)> reloadCallback_;
+    
     // Helper methods
-    std::string getString(const std::string& key, const std::string& defaultValue = "") const;
-    int getInt(const std::string& key, int defaultValue = 0) const;
-    bool getBool(const std::string& key, bool defaultValue = false) const;
-    float getFloat(const std::string& key, float defaultValue = 0.0f) const;
-    
-    // Parse JSON manually (simplified)
-    void parseJSON(const std::string& content);
-    std::string extractValue(const std::string& content, const std::string& key) const;
+    std::shared_ptr<const ConfigSnapshot> parseFile(const std::string& configPath, std::string& error) const;
+    void watchLoop();
 };
 
 #endif // CONFIG_MANAGER_H
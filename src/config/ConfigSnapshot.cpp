@@ -0,0 +1,237 @@
+#include "ConfigSnapshot.h"
+#include "JsonValue.h"
+
+namespace {
+
+// Small readers that keep the current (default) value when a key is absent
+// or holds the wrong JSON type
+void read(const JsonValue& root, const char* path, std::string& field) {
+    const JsonValue* v = root.find(path);
+    if (v != nullptr && v->isString()) field = v->asString();
+}
+
+void read(const JsonValue& root, const char* path, int& field) {
+    const JsonValue* v = root.find(path);
+    if (v != nullptr && v->isNumber()) field = v->asInt();
+}
+
+void read(const JsonValue& root, const char* path, float& field) {
+    const JsonValue* v = root.find(path);
+    if (v != nullptr && v->isNumber()) field = static_cast<float>(v->asNumber());
+}
+
+void read(const JsonValue& root, const char* path, bool& field) {
+    const JsonValue* v = root.find(path);
+    if (v != nullptr && v->isBool()) field = v->asBool();
+}
+
+void read(const JsonValue& root, const char* path, std::vector<std::string>& field) {
+    const JsonValue* v = root.find(path);
+    if (v == nullptr || !v->isArray()) return;
+    std::vector<std::string> values;
+    for (const JsonValue& item : v->items()) {
+        if (item.isString()) values.push_back(item.asString());
+    }
+    if (!values.empty()) field = std::move(values);
+}
+
+void read(const JsonValue& root, const char* path, std::vector<VideoSourceConfig>& field) {
+    const JsonValue* v = root.find(path);
+    if (v == nullptr || !v->isArray()) return;
+    std::vector<VideoSourceConfig> sources;
+    for (const JsonValue& item : v->items()) {
+        if (!item.isObject()) continue;
+        VideoSourceConfig source;
+        read(item, "id", source.id);
+        read(item, "type", source.type);
+        read(item, "camera_index", source.cameraIndex);
+        read(item, "path", source.path);
+        read(item, "processing_interval", source.processingInterval);
+        if (source.id.empty()) source.id = "source" + std::to_string(sources.size() + 1);
+        sources.push_back(std::move(source));
+    }
+    field = std::move(sources);
+}
+
+void read(const JsonValue& root, const char* path, std::vector<AlarmRuleConfig>& field) {
+    const JsonValue* v = root.find(path);
+    if (v == nullptr || !v->isArray()) return;
+    std::vector<AlarmRuleConfig> rules;
+    for (const JsonValue& item : v->items()) {
+        if (!item.isObject()) continue;
+        AlarmRuleConfig rule;
+        read(item, "name", rule.name);
+        read(item, "field", rule.field);
+        read(item, "source", rule.source);
+        read(item, "when", rule.when);
+        read(item, "value", rule.value);
+        read(item, "within_sec", rule.withinSec);
+        read(item, "for_sec", rule.forSec);
+        read(item, "severity", rule.severity);
+        if (rule.name.empty()) rule.name = "rule" + std::to_string(rules.size() + 1);
+        rules.push_back(std::move(rule));
+    }
+    field = std::move(rules);
+}
+
+} // namespace
+
+std::shared_ptr<const ConfigSnapshot> ConfigSnapshot::fromJson(const JsonValue& root) {
+    auto cfg = std::make_shared<ConfigSnapshot>();
+    
+    // Application settings
+    read(root, "application.name", cfg->app.name);
+    read(root, "application.version", cfg->app.version);
+    read(root, "application.debug_mode", cfg->app.debugMode);
+    
+    // Video settings
+    read(root, "video.source_type", cfg->video.sourceType);
+    read(root, "video.source_path", cfg->video.sourcePath);
+    read(root, "video.camera_index", cfg->video.cameraIndex);
+    read(root, "video.frame_width", cfg->video.frameWidth);
+    read(root, "video.frame_height", cfg->video.frameHeight);
+    read(root, "video.processing_interval", cfg->video.processingInterval);
+    read(root, "video.reconnect_attempts", cfg->video.reconnectAttempts);
+    read(root, "video.reconnect_delay_ms", cfg->video.reconnectDelayMs);
+    read(root, "video.batch_mode", cfg->video.batchMode);
+    read(root, "video.batch_workers", cfg->video.batchWorkers);
+    read(root, "video.batch_segment_seconds", cfg->video.batchSegmentSeconds);
+    read(root, "video.sources", cfg->video.sources);
+    read(root, "video.ocr_engines", cfg->video.ocrEngines);
+    read(root, "video.pipeline_workers", cfg->video.pipelineWorkers);
+    read(root, "video.frame_pool_size", cfg->video.framePoolSize);
+    read(root, "video.frame_pool_backpressure", cfg->video.framePoolBackpressure);
+    
+    // Rate control
+    read(root, "rate_control.enabled", cfg->rateControl.enabled);
+    read(root, "rate_control.min_interval", cfg->rateControl.minInterval);
+    read(root, "rate_control.stable_readings", cfg->rateControl.stableReadings);
+    read(root, "rate_control.hr_delta", cfg->rateControl.hrDelta);
+    read(root, "rate_control.spo2_delta", cfg->rateControl.spo2Delta);
+    read(root, "rate_control.abp_delta", cfg->rateControl.abpDelta);
+    read(root, "rate_control.change_threshold", cfg->rateControl.changeThreshold);
+    read(root, "rate_control.cpu_budget_percent", cfg->rateControl.cpuBudgetPercent);
+    
+    // OCR settings
+    read(root, "ocr.language", cfg->ocr.language);
+    read(root, "ocr.confidence_threshold", cfg->ocr.confidenceThreshold);
+    read(root, "ocr.tesseract_config", cfg->ocr.tesseractConfig);
+    read(root, "ocr.page_segmentation_mode", cfg->ocr.pageSegmentationMode);
+    
+    // Vital signs
+    read(root, "vital_signs.default_spo2", cfg->vitalSigns.defaultSpO2);
+    read(root, "vital_signs.labels", cfg->vitalSigns.labels);
+    read(root, "vital_signs.spo2_history_size", cfg->vitalSigns.spo2HistorySize);
+    ValidationRanges& ranges = cfg->vitalSigns.validation;
+    read(root, "vital_signs.validation.hr_min", ranges.hr_min);
+    read(root, "vital_signs.validation.hr_max", ranges.hr_max);
+    read(root, "vital_signs.validation.spo2_min", ranges.spo2_min);
+    read(root, "vital_signs.validation.spo2_max", ranges.spo2_max);
+    read(root, "vital_signs.validation.abp_systolic_min", ranges.abp_systolic_min);
+    read(root, "vital_signs.validation.abp_systolic_max", ranges.abp_systolic_max);
+    read(root, "vital_signs.validation.abp_diastolic_min", ranges.abp_diastolic_min);
+    read(root, "vital_signs.validation.abp_diastolic_max", ranges.abp_diastolic_max);
+    
+    // Temporal fusion
+    read(root, "fusion.enabled", cfg->fusion.enabled);
+    read(root, "fusion.window", cfg->fusion.window);
+    read(root, "fusion.tolerance", cfg->fusion.tolerance);
+    
+    // In-memory history
+    read(root, "timeseries.enabled", cfg->timeSeries.enabled);
+    read(root, "timeseries.raw_samples", cfg->timeSeries.rawSamples);
+    read(root, "timeseries.second_buckets", cfg->timeSeries.secondBuckets);
+    read(root, "timeseries.minute_buckets", cfg->timeSeries.minuteBuckets);
+    read(root, "timeseries.hour_buckets", cfg->timeSeries.hourBuckets);
+    
+    // Compressed archive
+    read(root, "archive.enabled", cfg->archive.enabled);
+    read(root, "archive.path", cfg->archive.path);
+    read(root, "archive.block_samples", cfg->archive.blockSamples);
+    read(root, "archive.flush_interval_sec", cfg->archive.flushIntervalSec);
+    
+    // ML Model
+    read(root, "ml_model.enabled", cfg->mlModel.enabled);
+    read(root, "ml_model.input_width", cfg->mlModel.inputWidth);
+    read(root, "ml_model.input_height", cfg->mlModel.inputHeight);
+    read(root, "ml_model.confidence_threshold", cfg->mlModel.confidenceThreshold);
+    
+    // Database
+    read(root, "database.enabled", cfg->database.enabled);
+    read(root, "database.type", cfg->database.type);
+    read(root, "database.host", cfg->database.host);
+    read(root, "database.port", cfg->database.port);
+    read(root, "database.database", cfg->database.name);
+    read(root, "database.user", cfg->database.user);
+    read(root, "database.password", cfg->database.password);
+    read(root, "database.connection_pool_size", cfg->database.connectionPoolSize);
+    read(root, "database.connection_timeout", cfg->database.connectionTimeout);
+    read(root, "database.retry_attempts", cfg->database.retryAttempts);
+    read(root, "database.retry_delay_ms", cfg->database.retryDelayMs);
+    read(root, "database.sqlite_path", cfg->database.sqlitePath);
+    read(root, "database.sqlite_batch_size", cfg->database.sqliteBatchSize);
+    read(root, "database.sqlite_flush_interval_ms", cfg->database.sqliteFlushIntervalMs);
+    
+    // Output
+    read(root, "output.csv_enabled", cfg->output.csvEnabled);
+    read(root, "output.csv_file", cfg->output.csvFile);
+    read(root, "output.csv_buffer_kb", cfg->output.csvBufferKb);
+    read(root, "output.csv_flush_interval_ms", cfg->output.csvFlushIntervalMs);
+    read(root, "output.csv_fsync", cfg->output.csvFsync);
+    read(root, "output.csv_rotate", cfg->output.csvRotate);
+    read(root, "output.csv_max_size_mb", cfg->output.csvMaxSizeMb);
+    read(root, "output.csv_max_files", cfg->output.csvMaxFiles);
+    read(root, "output.console_output", cfg->output.consoleOutput);
+    
+    // Shared-memory publisher
+    read(root, "publish.enabled", cfg->publish.enabled);
+    read(root, "publish.shm_name", cfg->publish.shmName);
+    read(root, "publish.capacity", cfg->publish.capacity);
+    
+    // Query API
+    read(root, "api.enabled", cfg->api.enabled);
+    read(root, "api.bind_address", cfg->api.bindAddress);
+    read(root, "api.port", cfg->api.port);
+    read(root, "api.socket_path", cfg->api.socketPath);
+    read(root, "api.max_connections", cfg->api.maxConnections);
+    read(root, "api.max_points", cfg->api.maxPoints);
+    read(root, "api.idle_timeout_sec", cfg->api.idleTimeoutSec);
+    
+    // Start-up
+    read(root, "startup.parallel", cfg->startup.parallel);
+    read(root, "startup.warmup", cfg->startup.warmup);
+    
+    // Alarms
+    read(root, "alarms.enabled", cfg->alarms.enabled);
+    read(root, "alarms.socket_path", cfg->alarms.socketPath);
+    read(root, "alarms.rules", cfg->alarms.rules);
+    
+    // Logging
+    read(root, "logging.level", cfg->logging.level);
+    read(root, "logging.console_enabled", cfg->logging.consoleEnabled);
+    read(root, "logging.file_enabled", cfg->logging.fileEnabled);
+    read(root, "logging.file_path", cfg->logging.filePath);
+    read(root, "logging.max_file_size_mb", cfg->logging.maxFileSizeMB);
+    read(root, "logging.max_files", cfg->logging.maxFiles);
+    read(root, "logging.pattern", cfg->logging.pattern);
+    read(root, "logging.async", cfg->logging.async);
+    read(root, "logging.queue_size", cfg->logging.queueSize);
+    read(root, "logging.overflow_policy", cfg->logging.overflowPolicy);
+    read(root, "logging.flush_interval_ms", cfg->logging.flushIntervalMs);
+    
+    // Monitoring
+    read(root, "monitoring.health_check_interval_sec", cfg->monitoring.healthCheckIntervalSec);
+    read(root, "monitoring.metrics_enabled", cfg->monitoring.metricsEnabled);
+    read(root, "monitoring.alert_on_error", cfg->monitoring.alertOnError);
+    read(root, "monitoring.metrics_bind_address", cfg->monitoring.metricsBindAddress);
+    read(root, "monitoring.metrics_port", cfg->monitoring.metricsPort);
+    read(root, "monitoring.metrics_socket", cfg->monitoring.metricsSocketPath);
+    
+    // Tracing
+    read(root, "tracing.enabled", cfg->tracing.enabled);
+    read(root, "tracing.buffer_size", cfg->tracing.bufferSize);
+    read(root, "tracing.output_path", cfg->tracing.outputPath);
+    read(root, "tracing.dump_on_shutdown", cfg->tracing.dumpOnShutdown);
+    
+    return cfg;
+}
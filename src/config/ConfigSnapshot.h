@@ -0,0 +1,220 @@
+#ifndef CONFIG_SNAPSHOT_H
+#define CONFIG_SNAPSHOT_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+class JsonValue;
+
+// Validation ranges
+struct ValidationRanges {
+    int hr_min = 30, hr_max = 200;
+    int spo2_min = 70, spo2_max = 100;
+    int abp_systolic_min = 70, abp_systolic_max = 200;
+    int abp_diastolic_min = 40, abp_diastolic_max = 130;
+};
+
+// One monitor feed in multi-source mode (video.sources)
+struct VideoSourceConfig {
+    std::string id;                  // Bed/monitor id stored with each row
+    std::string type = "camera";     // "camera", "file" or "stream"
+    int cameraIndex = 0;
+    std::string path;                // File path or stream URL
+    int processingInterval = 0;      // 0 = video.processing_interval
+};
+
+// One clinical alarm rule (alarms.rules), compiled by AlarmEngine
+struct AlarmRuleConfig {
+    std::string name;
+    std::string field;               // "hr", "spo2", "systolic" or "diastolic"
+    std::string source;              // Empty = every source
+    std::string when = "above";      // "above", "below", "rise" or "fall"
+    float value = 0.0f;              // Threshold, or change for rise/fall
+    int withinSec = 60;              // rise/fall window
+    int forSec = 0;                  // Condition must hold this long before raising
+    std::string severity = "warning";    // "info", "warning" or "critical"
+};
+
+// Immutable, fully typed view of config.json. Built once per (re)load and
+// shared through ConfigManager::snapshot(), so hot paths read plain fields
+// instead of parsing strings. Member defaults are the built-in defaults used
+// when a key is missing or has the wrong type.
+struct ConfigSnapshot {
+    struct Application {
+        std::string name = "VitalSignExtractor";
+        std::string version = "1.0.0";
+        bool debugMode = false;
+    } app;
+    
+    struct Video {
+        std::string sourceType = "file";
+        std::string sourcePath;
+        int cameraIndex = 0;
+        int frameWidth = 640;
+        int frameHeight = 480;
+        int processingInterval = 300;
+        int reconnectAttempts = 5;
+        int reconnectDelayMs = 2000;
+        bool batchMode = false;          // Process a "file" source offline in parallel segments
+        int batchWorkers = 0;            // 0 = one per hardware thread
+        int batchSegmentSeconds = 600;
+        std::vector<VideoSourceConfig> sources;   // Non-empty = multi-source mode
+        int ocrEngines = 0;              // Shared Tesseract engines; 0 = min(sources, cores)
+        int pipelineWorkers = 0;         // Multi-source executor threads; 0 = cores
+        int framePoolSize = 4;           // Preallocated frame buffers per source
+        std::string framePoolBackpressure = "drop";   // When all are in use: "drop" or "block"
+    } video;
+    
+    // Adaptive processing rate; processing_interval becomes the slowest rate
+    struct RateControl {
+        bool enabled = false;
+        int minInterval = 15;            // Fastest rate, in frames
+        int stableReadings = 3;          // Quiet readings before the interval doubles
+        int hrDelta = 5;                 // Changes that count as "not quiet"
+        int spo2Delta = 2;
+        int abpDelta = 10;
+        float changeThreshold = 0.0f;    // Mean thumbnail pixel difference; 0 = off
+        float cpuBudgetPercent = 0.0f;   // Of all cores; 0 = no limit
+    } rateControl;
+    
+    struct OCR {
+        std::string language = "eng";
+        int confidenceThreshold = 50;
+        std::string tesseractConfig;
+        int pageSegmentationMode = 3;
+    } ocr;
+    
+    struct VitalSigns {
+        std::string defaultSpO2 = "81";
+        std::vector<std::string> labels = {"HR", "SpO2", "ABP"};
+        int spo2HistorySize = 10;
+        ValidationRanges validation;
+    } vitalSigns;
+    
+    // Temporal fusion of OCR reads; SpO2 uses vital_signs.spo2_history_size
+    struct Fusion {
+        bool enabled = false;
+        int window = 5;                  // Reads per field
+        int tolerance = 2;               // Reads within this of the fused value count as agreeing
+    } fusion;
+    
+    // In-memory history (TimeSeriesStore); ring sizes per source and field
+    struct TimeSeries {
+        bool enabled = true;
+        int rawSamples = 4096;
+        int secondBuckets = 3600;
+        int minuteBuckets = 1440;
+        int hourBuckets = 720;
+    } timeSeries;
+    
+    // Compressed on-disk history (ArchiveWriter)
+    struct Archive {
+        bool enabled = false;
+        std::string path = "data/archive";
+        int blockSamples = 4096;         // Samples per encoded block
+        int flushIntervalSec = 60;       // Write a partial block after this long
+    } archive;
+    
+    struct MLModel {
+        bool enabled = true;
+        int inputWidth = 96;
+        int inputHeight = 96;
+        float confidenceThreshold = 0.7f;
+    } mlModel;
+    
+    struct Database {
+        bool enabled = false;
+        std::string type = "postgresql";
+        std::string host = "localhost";
+        int port = 5432;
+        std::string name = "vital_signs_db";
+        std::string user = "vitalsign_user";
+        std::string password;
+        int connectionPoolSize = 5;
+        int connectionTimeout = 30;
+        int retryAttempts = 3;
+        int retryDelayMs = 1000;
+        std::string sqlitePath = "data/vital_signs.db";
+        int sqliteBatchSize = 50;
+        int sqliteFlushIntervalMs = 1000;
+    } database;
+    
+    struct Output {
+        bool csvEnabled = true;
+        std::string csvFile = "live_vital_signs_output.csv";
+        int csvBufferKb = 64;
+        int csvFlushIntervalMs = 1000;
+        std::string csvFsync = "none";  // "none", "rotate" or "flush"
+        std::string csvRotate = "none"; // "none", "size" or "daily"
+        int csvMaxSizeMb = 100;
+        int csvMaxFiles = 10;
+        bool consoleOutput = true;
+    } output;
+    
+    // Shared-memory ring of live results for local consumers
+    struct Publish {
+        bool enabled = false;
+        std::string shmName = "/vitalsign_live";
+        int capacity = 1024;             // Records; rounded up to a power of two
+    } publish;
+    
+    // Local HTTP/JSON query API over the in-memory history
+    struct Api {
+        bool enabled = false;
+        std::string bindAddress = "127.0.0.1";
+        int port = 9465;
+        std::string socketPath;          // Unix socket instead of TCP when set
+        int maxConnections = 64;
+        int maxPoints = 2000;            // Points per range/rollup response
+        int idleTimeoutSec = 30;
+    } api;
+    
+    // Real-time threshold alarms over the fused vitals
+    struct Alarms {
+        bool enabled = false;
+        std::string socketPath;          // Unix socket streaming events; empty = none
+        std::vector<AlarmRuleConfig> rules;
+    } alarms;
+    
+    // Start-up: overlap the slow initialization steps and warm them up
+    struct Startup {
+        bool parallel = true;
+        bool warmup = true;              // Run OCR and inference once on a synthetic frame
+    } startup;
+    
+    struct Logging {
+        std::string level = "info";
+        bool consoleEnabled = true;
+        bool fileEnabled = true;
+        std::string filePath = "logs/vitalsign.log";
+        int maxFileSizeMB = 10;
+        int maxFiles = 5;
+        std::string pattern = "[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] [%t] %v";
+        bool async = true;
+        int queueSize = 8192;
+        std::string overflowPolicy = "drop";
+        int flushIntervalMs = 1000;
+    } logging;
+    
+    struct Monitoring {
+        int healthCheckIntervalSec = 60;
+        bool metricsEnabled = true;
+        bool alertOnError = true;
+        std::string metricsBindAddress = "127.0.0.1";
+        int metricsPort = 9464;
+        std::string metricsSocketPath;     // Unix socket instead of TCP when set
+    } monitoring;
+    
+    struct Tracing {
+        bool enabled = false;
+        int bufferSize = 16384;            // Spans kept per thread
+        std::string outputPath = "logs/trace.json";
+        bool dumpOnShutdown = true;
+    } tracing;
+    
+    // Build a snapshot from a parsed document, falling back to defaults per key
+    static std::shared_ptr<const ConfigSnapshot> fromJson(const JsonValue& root);
+};
+
+#endif // CONFIG_SNAPSHOT_H
@@ -0,0 +1,275 @@
+#include "JsonValue.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text) : text_(text) {}
+    
+    bool parseDocument(JsonValue& out, std::string* error) {
+        skipWhitespace();
+        if (!parseValue(out, 0)) {
+            if (error) *error = error_ + " at offset " + std::to_string(pos_);
+            return false;
+        }
+        skipWhitespace();
+        if (pos_ != text_.size()) {
+            if (error) *error = "Trailing characters at offset " + std::to_string(pos_);
+            return false;
+        }
+        return true;
+    }
+    
+private:
+    static constexpr int kMaxDepth = 64;
+    
+    const std::string& text_;
+    size_t pos_ = 0;
+    std::string error_;
+    
+    bool fail(const char* message) {
+        error_ = message;
+        return false;
+    }
+    
+    void skipWhitespace() {
+        while (pos_ < text_.size()) {
+            char c = text_[pos_];
+            if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+                pos_++;
+            } else if (c == '/' && pos_ + 1 < text_.size() && text_[pos_ + 1] == '/') {
+                while (pos_ < text_.size() && text_[pos_] != '\n') pos_++;
+            } else {
+                break;
+            }
+        }
+    }
+    
+    bool consumeLiteral(const char* literal) {
+        size_t len = std::strlen(literal);
+        if (text_.compare(pos_, len, literal) != 0) {
+            return fail("Invalid literal");
+        }
+        pos_ += len;
+        return true;
+    }
+    
+    bool parseValue(JsonValue& out, int depth) {
+        if (depth > kMaxDepth) return fail("Nesting too deep");
+        if (pos_ >= text_.size()) return fail("Unexpected end of input");
+        
+        switch (text_[pos_]) {
+            case '{': return parseObject(out, depth);
+            case '[': return parseArray(out, depth);
+            case '"':
+                out.type_ = JsonValue::Type::String;
+                return parseString(out.string_);
+            case 't':
+                out.type_ = JsonValue::Type::Bool;
+                out.bool_ = true;
+                return consumeLiteral("true");
+            case 'f':
+                out.type_ = JsonValue::Type::Bool;
+                out.bool_ = false;
+                return consumeLiteral("false");
+            case 'n':
+                out.type_ = JsonValue::Type::Null;
+                return consumeLiteral("null");
+            default:
+                return parseNumber(out);
+        }
+    }
+    
+    bool parseNumber(JsonValue& out) {
+        const char* start = text_.c_str() + pos_;
+        char* end = nullptr;
+        double value = std::strtod(start, &end);
+        if (end == start) return fail("Invalid value");
+        out.type_ = JsonValue::Type::Number;
+        out.number_ = value;
+        pos_ += static_cast<size_t>(end - start);
+        return true;
+    }
+    
+    static void appendUtf8(std::string& out, unsigned codepoint) {
+        if (codepoint < 0x80) {
+            out += static_cast<char>(codepoint);
+        } else if (codepoint < 0x800) {
+            out += static_cast<char>(0xC0 | (codepoint >> 6));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        } else if (codepoint < 0x10000) {
+            out += static_cast<char>(0xE0 | (codepoint >> 12));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        } else {
+            out += static_cast<char>(0xF0 | (codepoint >> 18));
+            out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+            out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (codepoint & 0x3F));
+        }
+    }
+    
+    bool parseHex4(unsigned& value) {
+        if (pos_ + 4 > text_.size()) return fail("Truncated unicode escape");
+        value = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = text_[pos_++];
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= static_cast<unsigned>(c - '0');
+            else if (c >= 'a' && c <= 'f') value |= static_cast<unsigned>(c - 'a' + 10);
+            else if (c >= 'A' && c <= 'F') value |= static_cast<unsigned>(c - 'A' + 10);
+            else return fail("Invalid unicode escape");
+        }
+        return true;
+    }
+    
+    bool parseString(std::string& out) {
+        pos_++; // opening quote
+        out.clear();
+        while (pos_ < text_.size()) {
+            char c = text_[pos_++];
+            if (c == '"') return true;
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos_ >= text_.size()) break;
+            char esc = text_[pos_++];
+            switch (esc) {
+                case '"':  out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/':  out += '/'; break;
+                case 'b':  out += '\b'; break;
+                case 'f':  out += '\f'; break;
+                case 'n':  out += '\n'; break;
+                case 'r':  out += '\r'; break;
+                case 't':  out += '\t'; break;
+                case 'u': {
+                    unsigned codepoint;
+                    if (!parseHex4(codepoint)) return false;
+                    // Combine surrogate pairs
+                    if (codepoint >= 0xD800 && codepoint <= 0xDBFF &&
+                        text_.compare(pos_, 2, "\\u") == 0) {
+                        pos_ += 2;
+                        unsigned low;
+                        if (!parseHex4(low)) return false;
+                        if (low < 0xDC00 || low > 0xDFFF) return fail("Invalid surrogate pair");
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, codepoint);
+                    break;
+                }
+                default:
+                    return fail("Invalid escape sequence");
+            }
+        }
+        return fail("Unterminated string");
+    }
+    
+    bool parseArray(JsonValue& out, int depth) {
+        pos_++; // [
+        out.type_ = JsonValue::Type::Array;
+        skipWhitespace();
+        if (pos_ < text_.size() && text_[pos_] == ']') {
+            pos_++;
+            return true;
+        }
+        for (;;) {
+            skipWhitespace();
+            out.items_.emplace_back();
+            if (!parseValue(out.items_.back(), depth + 1)) return false;
+            skipWhitespace();
+            if (pos_ >= text_.size()) return fail("Unterminated array");
+            char c = text_[pos_++];
+            if (c == ']') return true;
+            if (c != ',') return fail("Expected ',' or ']'");
+        }
+    }
+    
+    bool parseObject(JsonValue& out, int depth) {
+        pos_++; // {
+        out.type_ = JsonValue::Type::Object;
+        skipWhitespace();
+        if (pos_ < text_.size() && text_[pos_] == '}') {
+            pos_++;
+            return true;
+        }
+        for (;;) {
+            skipWhitespace();
+            if (pos_ >= text_.size() || text_[pos_] != '"') return fail("Expected member name");
+            out.keys_.emplace_back();
+            if (!parseString(out.keys_.back())) return false;
+            skipWhitespace();
+            if (pos_ >= text_.size() || text_[pos_] != ':') return fail("Expected ':'");
+            pos_++;
+            skipWhitespace();
+            out.items_.emplace_back();
+            if (!parseValue(out.items_.back(), depth + 1)) return false;
+            skipWhitespace();
+            if (pos_ >= text_.size()) return fail("Unterminated object");
+            char c = text_[pos_++];
+            if (c == '}') return true;
+            if (c != ',') return fail("Expected ',' or '}'");
+        }
+    }
+};
+
+bool JsonValue::parse(const std::string& text, JsonValue& out, std::string* error) {
+    out = JsonValue();
+    JsonParser parser(text);
+    return parser.parseDocument(out, error);
+}
+
+void JsonValue::appendQuoted(std::string& out, const std::string& text) {
+    out += '"';
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    out += '"';
+}
+
+bool JsonValue::asBool(bool defaultValue) const {
+    return type_ == Type::Bool ? bool_ : defaultValue;
+}
+
+double JsonValue::asNumber(double defaultValue) const {
+    return type_ == Type::Number ? number_ : defaultValue;
+}
+
+int JsonValue::asInt(int defaultValue) const {
+    return type_ == Type::Number ? static_cast<int>(number_) : defaultValue;
+}
+
+std::string JsonValue::asString(const std::string& defaultValue) const {
+    return type_ == Type::String ? string_ : defaultValue;
+}
+
+const JsonValue* JsonValue::get(const std::string& key) const {
+    if (type_ != Type::Object) return nullptr;
+    for (size_t i = 0; i < keys_.size(); i++) {
+        if (keys_[i] == key) return &items_[i];
+    }
+    return nullptr;
+}
+
+const JsonValue* JsonValue::find(const std::string& path) const {
+    const JsonValue* node = this;
+    size_t start = 0;
+    while (node != nullptr) {
+        size_t dot = path.find('.', start);
+        node = node->get(path.substr(start, dot == std::string::npos ? std::string::npos : dot - start));
+        if (dot == std::string::npos) return node;
+        start = dot + 1;
+    }
+    return nullptr;
+}
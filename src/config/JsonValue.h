@@ -0,0 +1,57 @@
+#ifndef JSON_VALUE_H
+#define JSON_VALUE_H
+
+#include <string>
+#include <vector>
+
+// Minimal JSON document model with a one-pass recursive-descent parser.
+// Objects keep member order; lookups are linear, which is fine for config-sized
+// documents that are parsed once and then copied into typed structs.
+class JsonValue {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+    
+    // Parse text into out. Returns false and fills error (if given) on malformed input.
+    // "//" line comments are tolerated so documented examples can be pasted as-is.
+    static bool parse(const std::string& text, JsonValue& out, std::string* error = nullptr);
+    
+    // Append text to out as a quoted, escaped JSON string
+    static void appendQuoted(std::string& out, const std::string& text);
+    
+    Type type() const { return type_; }
+    bool isNull() const { return type_ == Type::Null; }
+    bool isBool() const { return type_ == Type::Bool; }
+    bool isNumber() const { return type_ == Type::Number; }
+    bool isString() const { return type_ == Type::String; }
+    bool isArray() const { return type_ == Type::Array; }
+    bool isObject() const { return type_ == Type::Object; }
+    
+    // Typed accessors falling back to defaultValue on type mismatch
+    bool asBool(bool defaultValue = false) const;
+    double asNumber(double defaultValue = 0.0) const;
+    int asInt(int defaultValue = 0) const;
+    std::string asString(const std::string& defaultValue = "") const;
+    
+    // Array elements, or object values in document order
+    const std::vector<JsonValue>& items() const { return items_; }
+    // Object member names, parallel to items()
+    const std::vector<std::string>& keys() const { return keys_; }
+    size_t size() const { return items_.size(); }
+    
+    // Object member lookup; nullptr if absent or not an object
+    const JsonValue* get(const std::string& key) const;
+    // Dotted path lookup through nested objects, e.g. "video.source_type"
+    const JsonValue* find(const std::string& path) const;
+    
+private:
+    friend class JsonParser;
+    
+    Type type_ = Type::Null;
+    bool bool_ = false;
+    double number_ = 0.0;
+    std::string string_;
+    std::vector<std::string> keys_;
+    std::vector<JsonValue> items_;
+};
+
+#endif // JSON_VALUE_H
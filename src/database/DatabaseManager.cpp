@@ -1,6 +1,7 @@
 #include "DatabaseManager.h"
+#include "PostgresBackend.h"
+#include "SqliteBackend.h"
 #include "../utils/Logger.h"
-#include <sstream>
 #include <thread>
 #include <chrono>
 
@@ -20,220 +21,103 @@ bool DatabaseManager::init(const std::string& host,
                            const std::string& password,
                            int poolSize,
                            int timeout) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    host_ = host;
-    port_ = port;
-    dbname_ = dbname;
-    user_ = user;
-    password_ = password;
-    poolSize_ = poolSize;
-    timeout_ = timeout;
-    
-    initialized_ = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        backend_.reset(new PostgresBackend(host, port, dbname, user, password, timeout));
+        poolSize_ = poolSize;
+        initialized_ = true;
+    }
     LOG_INFO("DatabaseManager initialized with host: " + host + ", database: " + dbname);
     
     return connect();
 }
 
-std::string DatabaseManager::buildConnectionString() {
-    std::ostringstream oss;
-    oss << "host=" << host_
-        << " port=" << port_
-        << " dbname=" << dbname_
-        << " user=" << user_
-        << " password=" << password_
-        << " connect_timeout=" << timeout_;
-    return oss.str();
-}
-
-bool DatabaseManager::connect() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (conn_ != nullptr && PQstatus(conn_) == CONNECTION_OK) {
-        LOG_DEBUG("Database already connected");
-        return true;
+bool DatabaseManager::initSQLite(const std::string& path,
+                                 int batchSize,
+                                 int flushIntervalMs) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        backend_.reset(new SqliteBackend(path, batchSize, flushIntervalMs));
+        initialized_ = true;
     }
+    LOG_INFO("DatabaseManager initialized with SQLite database: " + path);
     
-    std::string connStr = buildConnectionString();
-    conn_ = PQconnectdb(connStr.c_str());
-    
-    if (PQstatus(conn_) != CONNECTION_OK) {
-        std::string error = PQerrorMessage(conn_);
-        LOG_ERROR("Database connection failed: " + error);
-        PQfinish(conn_);
-        conn_ = nullptr;
-        return false;
-    }
-    
-    LOG_INFO("Database connected successfully");
-    return true;
+    return connect();
 }
 
-void DatabaseManager::disconnect() {
+std::shared_ptr<StorageBackend> DatabaseManager::backend() {
     std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (conn_ != nullptr) {
-        PQfinish(conn_);
-        conn_ = nullptr;
-        LOG_INFO("Database disconnected");
-    }
+    return backend_;
 }
 
-bool DatabaseManager::isConnected() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return conn_ != nullptr && PQstatus(conn_) == CONNECTION_OK;
+std::string DatabaseManager::getBackendName() {
+    std::shared_ptr<StorageBackend> b = backend();
+    return b != nullptr ? b->name() : "none";
 }
 
-bool DatabaseManager::createTables() {
-    std::string createTableQuery = R"(
-        CREATE TABLE IF NOT EXISTS vital_signs (
-            id SERIAL PRIMARY KEY,
-            timestamp TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP,
-            hr VARCHAR(10),
-            spo2 VARCHAR(10),
-            abp VARCHAR(20),
-            ecg_classification VARCHAR(50),
-            ecg_confidence REAL,
-            created_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP
-        );
-        
-        CREATE INDEX IF NOT EXISTS idx_vital_signs_timestamp ON vital_signs(timestamp);
-    )";
-    
-    if (executeQuery(createTableQuery)) {
-        LOG_INFO("Database tables created/verified successfully");
-        return true;
+bool DatabaseManager::connect() {
+    std::shared_ptr<StorageBackend> b = backend();
+    if (b == nullptr) {
+        LOG_ERROR("Cannot connect: DatabaseManager not initialized");
+        return false;
     }
-    
-    LOG_ERROR("Failed to create database tables");
-    return false;
+    return b->connect();
 }
 
-bool DatabaseManager::executeQuery(const std::string& query) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (conn_ == nullptr || PQstatus(conn_) != CONNECTION_OK) {
-        LOG_ERROR("Cannot execute query: Database not connected");
-        return false;
-    }
-    
-    PGresult* res = PQexec(conn_, query.c_str());
-    ExecStatusType status = PQresultStatus(res);
-    
-    bool success = (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK);
-    
-    if (!success) {
-        std::string error = PQerrorMessage(conn_);
-        LOG_ERROR("Query execution failed: " + error);
+void DatabaseManager::disconnect() {
+    std::shared_ptr<StorageBackend> b = backend();
+    if (b != nullptr) {
+        b->disconnect();
     }
-    
-    PQclear(res);
-    return success;
 }
 
-PGresult* DatabaseManager::executeQueryWithResult(const std::string& query) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    if (conn_ == nullptr || PQstatus(conn_) != CONNECTION_OK) {
-        LOG_ERROR("Cannot execute query: Database not connected");
-        return nullptr;
-    }
-    
-    PGresult* res = PQexec(conn_, query.c_str());
-    ExecStatusType status = PQresultStatus(res);
-    
-    if (status != PGRES_TUPLES_OK && status != PGRES_COMMAND_OK) {
-        std::string error = PQerrorMessage(conn_);
-        LOG_ERROR("Query execution failed: " + error);
-        PQclear(res);
-        return nullptr;
-    }
-    
-    return res;
+bool DatabaseManager::isConnected() {
+    std::shared_ptr<StorageBackend> b = backend();
+    return b != nullptr && b->isConnected();
 }
 
-std::string DatabaseManager::escapeString(const std::string& input) {
-    if (conn_ == nullptr) return input;
-    
-    char* escaped = PQescapeLiteral(conn_, input.c_str(), input.length());
-    if (escaped == nullptr) {
-        LOG_WARN("Failed to escape string: " + input);
-        return input;
-    }
-    
-    std::string result(escaped);
-    PQfreemem(escaped);
-    return result;
+bool DatabaseManager::createTables() {
+    std::shared_ptr<StorageBackend> b = backend();
+    return b != nullptr && b->createTables();
 }
 
 bool DatabaseManager::insertVitalSign(const VitalSignData& data) {
-    if (!isConnected()) {
-        LOG_ERROR("Cannot insert data: Database not connected");
+    std::shared_ptr<StorageBackend> b = backend();
+    if (b == nullptr) {
+        LOG_ERROR("Cannot insert data: DatabaseManager not initialized");
         return false;
     }
-    
-    std::ostringstream query;
-    query << "INSERT INTO vital_signs (timestamp, hr, spo2, abp, ecg_classification, ecg_confidence) VALUES ("
-          << "'" << data.timestamp << "', "
-          << "'" << data.hr << "', "
-          << "'" << data.spo2 << "', "
-          << "'" << data.abp << "', "
-          << "'" << data.ecg_classification << "', "
-          << data.ecg_confidence
-          << ");";
-    
-    if (executeQuery(query.str())) {
-        LOG_DEBUG("Vital sign data inserted successfully");
-        return true;
-    }
-    
-    LOG_ERROR("Failed to insert vital sign data");
-    return false;
+    return b->insertVitalSign(data);
+}
+
+bool DatabaseManager::flush() {
+    std::shared_ptr<StorageBackend> b = backend();
+    return b == nullptr || b->flush();
 }
 
 std::vector<VitalSignData> DatabaseManager::getRecentVitalSigns(int limit) {
-    std::vector<VitalSignData> results;
-    
-    std::ostringstream query;
-    query << "SELECT timestamp, hr, spo2, abp, ecg_classification, ecg_confidence "
-          << "FROM vital_signs ORDER BY timestamp DESC LIMIT " << limit << ";";
-    
-    PGresult* res = executeQueryWithResult(query.str());
-    if (res == nullptr) {
-        return results;
+    std::shared_ptr<StorageBackend> b = backend();
+    if (b == nullptr) {
+        return {};
     }
-    
-    int rows = PQntuples(res);
-    for (int i = 0; i < rows; i++) {
-        VitalSignData data;
-        data.timestamp = PQgetvalue(res, i, 0);
-        data.hr = PQgetvalue(res, i, 1);
-        data.spo2 = PQgetvalue(res, i, 2);
-        data.abp = PQgetvalue(res, i, 3);
-        data.ecg_classification = PQgetvalue(res, i, 4);
-        data.ecg_confidence = std::stof(PQgetvalue(res, i, 5));
-        results.push_back(data);
-    }
-    
-    PQclear(res);
-    LOG_DEBUG("Retrieved " + std::to_string(rows) + " vital sign records");
-    
-    return results;
+    return b->getRecentVitalSigns(limit);
+}
+
+int64_t DatabaseManager::streamVitalSigns(const std::string& start,
+                                          const std::string& end,
+                                          const VitalSignRowCallback& callback,
+                                          int fetchSize) {
+    std::shared_ptr<StorageBackend> b = backend();
+    if (b == nullptr) {
+        LOG_ERROR("Cannot stream vital signs: DatabaseManager not initialized");
+        return -1;
+    }
+    return b->streamVitalSigns(start, end, callback, fetchSize);
 }
 
 bool DatabaseManager::healthCheck() {
-    if (!isConnected()) {
-        return false;
-    }
-    
-    PGresult* res = executeQueryWithResult("SELECT 1;");
-    if (res != nullptr) {
-        PQclear(res);
-        return true;
-    }
-    
-    return false;
+    std::shared_ptr<StorageBackend> b = backend();
+    return b != nullptr && b->healthCheck();
 }
 
 bool DatabaseManager::reconnect(int maxAttempts, int delayMs) {
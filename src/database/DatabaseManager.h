@@ -5,23 +5,13 @@
 #include <memory>
 #include <vector>
 #include <mutex>
-#include <libpq-fe.h>
-
-// Structure to hold vital sign data
-struct VitalSignData {
-    std::string timestamp;
-    std::string hr;
-    std::string spo2;
-    std::string abp;
-    std::string ecg_classification;
-    float ecg_confidence;
-};
+#include "StorageBackend.h"
 
 class DatabaseManager {
 public:
     static DatabaseManager& getInstance();
     
-    // Initialize database connection
+    // Initialize PostgreSQL backend and connect
     bool init(const std::string& host,
               int port,
               const std::string& dbname,
@@ -30,6 +20,14 @@ public:
               int poolSize = 5,
               int timeout = 30);
     
+    // Initialize embedded SQLite backend and open the database file
+    bool initSQLite(const std::string& path,
+                    int batchSize = 50,
+                    int flushIntervalMs = 1000);
+    
+    // Name of the active backend ("postgresql", "sqlite" or "none")
+    std::string getBackendName();
+    
     // Database operations
     bool connect();
     void disconnect();
@@ -41,9 +39,20 @@ public:
     // Insert vital sign data
     bool insertVitalSign(const VitalSignData& data);
     
+    // Push buffered inserts (SQLite batches) to disk
+    bool flush();
+    
     // Query operations (for future use)
     std::vector<VitalSignData> getRecentVitalSigns(int limit = 100);
     
+    // Stream rows with start <= timestamp < end in ascending order, fetching
+    // fetchSize rows at a time so memory stays constant regardless of range
+    // length. Returns rows delivered, or -1 on error.
+    int64_t streamVitalSigns(const std::string& start,
+                             const std::string& end,
+                             const VitalSignRowCallback& callback,
+                             int fetchSize = 1000);
+    
     // Health check
     bool healthCheck();
     
@@ -56,24 +65,15 @@ private:
     DatabaseManager(const DatabaseManager&) = delete;
     DatabaseManager& operator=(const DatabaseManager&) = delete;
     
-    PGconn* conn_ = nullptr;
+    std::shared_ptr<StorageBackend> backend_;
     std::mutex mutex_;
     
-    std::string host_;
-    int port_;
-    std::string dbname_;
-    std::string user_;
-    std::string password_;
-    int poolSize_;
-    int timeout_;
-    
+    int poolSize_ = 5;
     bool initialized_ = false;
     
-    // Helper methods
-    std::string buildConnectionString();
-    bool executeQuery(const std::string& query);
-    PGresult* executeQueryWithResult(const std::string& query);
-    std::string escapeString(const std::string& input);
+    // Reference to the active backend that stays valid if init() replaces
+    // it meanwhile; null before init()
+    std::shared_ptr<StorageBackend> backend();
 };
 
 #endif // DATABASE_MANAGER_H
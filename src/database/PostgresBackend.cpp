@@ -0,0 +1,302 @@
+#include "PostgresBackend.h"
+#include "../utils/Logger.h"
+#include "../utils/TimestampFormatter.h"
+#include <sstream>
+#include <cstdlib>
+
+PostgresBackend::PostgresBackend(const std::string& host,
+                                 int port,
+                                 const std::string& dbname,
+                                 const std::string& user,
+                                 const std::string& password,
+                                 int timeout)
+    : host_(host),
+      port_(port),
+      dbname_(dbname),
+      user_(user),
+      password_(password),
+      timeout_(timeout) {
+}
+
+PostgresBackend::~PostgresBackend() {
+    disconnect();
+}
+
+std::string PostgresBackend::buildConnectionString() {
+    std::ostringstream oss;
+    oss << "host=" << host_
+        << " port=" << port_
+        << " dbname=" << dbname_
+        << " user=" << user_
+        << " password=" << password_
+        << " connect_timeout=" << timeout_;
+    return oss.str();
+}
+
+bool PostgresBackend::connect() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (conn_ != nullptr && PQstatus(conn_) == CONNECTION_OK) {
+        LOG_DEBUG("Database already connected");
+        return true;
+    }
+    
+    std::string connStr = buildConnectionString();
+    conn_ = PQconnectdb(connStr.c_str());
+    
+    if (PQstatus(conn_) != CONNECTION_OK) {
+        std::string error = PQerrorMessage(conn_);
+        LOG_ERROR("Database connection failed: " + error);
+        PQfinish(conn_);
+        conn_ = nullptr;
+        return false;
+    }
+    
+    LOG_INFO("Database connected successfully");
+    return true;
+}
+
+void PostgresBackend::disconnect() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (conn_ != nullptr) {
+        PQfinish(conn_);
+        conn_ = nullptr;
+        LOG_INFO("Database disconnected");
+    }
+}
+
+bool PostgresBackend::isConnected() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return conn_ != nullptr && PQstatus(conn_) == CONNECTION_OK;
+}
+
+bool PostgresBackend::createTables() {
+    std::string createTableQuery = R"(
+        CREATE TABLE IF NOT EXISTS vital_signs (
+            id SERIAL PRIMARY KEY,
+            timestamp TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP,
+            hr VARCHAR(10),
+            spo2 VARCHAR(10),
+            abp VARCHAR(20),
+            ecg_classification VARCHAR(50),
+            ecg_confidence REAL,
+            source_id VARCHAR(64),
+            created_at TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP
+        );
+        
+        -- Tables created before multi-source support lack the column
+        ALTER TABLE vital_signs ADD COLUMN IF NOT EXISTS source_id VARCHAR(64);
+        
+        CREATE INDEX IF NOT EXISTS idx_vital_signs_timestamp ON vital_signs(timestamp);
+        CREATE INDEX IF NOT EXISTS idx_vital_signs_source_timestamp ON vital_signs(source_id, timestamp);
+    )";
+    
+    if (executeQuery(createTableQuery)) {
+        LOG_INFO("Database tables created/verified successfully");
+        return true;
+    }
+    
+    LOG_ERROR("Failed to create database tables");
+    return false;
+}
+
+bool PostgresBackend::executeQuery(const std::string& query) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (conn_ == nullptr || PQstatus(conn_) != CONNECTION_OK) {
+        LOG_ERROR("Cannot execute query: Database not connected");
+        return false;
+    }
+    
+    PGresult* res = PQexec(conn_, query.c_str());
+    ExecStatusType status = PQresultStatus(res);
+    
+    bool success = (status == PGRES_COMMAND_OK || status == PGRES_TUPLES_OK);
+    
+    if (!success) {
+        std::string error = PQerrorMessage(conn_);
+        LOG_ERROR("Query execution failed: " + error);
+    }
+    
+    PQclear(res);
+    return success;
+}
+
+PGresult* PostgresBackend::executeQueryWithResult(const std::string& query) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (conn_ == nullptr || PQstatus(conn_) != CONNECTION_OK) {
+        LOG_ERROR("Cannot execute query: Database not connected");
+        return nullptr;
+    }
+    
+    PGresult* res = PQexec(conn_, query.c_str());
+    ExecStatusType status = PQresultStatus(res);
+    
+    if (status != PGRES_TUPLES_OK && status != PGRES_COMMAND_OK) {
+        std::string error = PQerrorMessage(conn_);
+        LOG_ERROR("Query execution failed: " + error);
+        PQclear(res);
+        return nullptr;
+    }
+    
+    return res;
+}
+
+bool PostgresBackend::insertVitalSign(const VitalSignData& data) {
+    // Every value goes in as a parameter: the vitals are OCR text
+    static const char* const kInsert =
+        "INSERT INTO vital_signs (timestamp, hr, spo2, abp, ecg_classification, ecg_confidence, source_id) "
+        "VALUES ($1, $2, $3, $4, $5, $6, $7)";
+    std::string confidence = std::to_string(data.ecg_confidence);
+    const char* params[7] = {
+        data.timestamp.c_str(),
+        data.hr.c_str(),
+        data.spo2.c_str(),
+        data.abp.c_str(),
+        data.ecg_classification.c_str(),
+        confidence.c_str(),
+        data.source_id.empty() ? nullptr : data.source_id.c_str()     // NULL in single-source mode
+    };
+    
+    PGresult* res = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (conn_ == nullptr || PQstatus(conn_) != CONNECTION_OK) {
+            LOG_ERROR("Cannot insert data: Database not connected");
+            return false;
+        }
+        res = PQexecParams(conn_, kInsert, 7, nullptr, params, nullptr, nullptr, 0);
+    }
+    bool success = PQresultStatus(res) == PGRES_COMMAND_OK;
+    if (success) {
+        LOG_DEBUG("Vital sign data inserted successfully");
+    } else {
+        LOG_ERROR("Failed to insert vital sign data: " + std::string(PQresultErrorMessage(res)));
+    }
+    PQclear(res);
+    return success;
+}
+
+std::vector<VitalSignData> PostgresBackend::getRecentVitalSigns(int limit) {
+    std::vector<VitalSignData> results;
+    
+    std::ostringstream query;
+    query << "SELECT timestamp, hr, spo2, abp, ecg_classification, ecg_confidence, source_id "
+          << "FROM vital_signs ORDER BY timestamp DESC LIMIT " << limit << ";";
+    
+    PGresult* res = executeQueryWithResult(query.str());
+    if (res == nullptr) {
+        return results;
+    }
+    
+    int rows = PQntuples(res);
+    results.reserve(rows);
+    for (int i = 0; i < rows; i++) {
+        VitalSignData data;
+        data.timestamp = PQgetvalue(res, i, 0);
+        data.hr = PQgetvalue(res, i, 1);
+        data.spo2 = PQgetvalue(res, i, 2);
+        data.abp = PQgetvalue(res, i, 3);
+        data.ecg_classification = PQgetvalue(res, i, 4);
+        data.ecg_confidence = std::strtof(PQgetvalue(res, i, 5), nullptr);
+        data.source_id = PQgetvalue(res, i, 6);
+        results.push_back(std::move(data));
+    }
+    
+    PQclear(res);
+    LOG_DEBUG("Retrieved %d vital sign records", rows);
+    
+    return results;
+}
+
+int64_t PostgresBackend::streamVitalSigns(const std::string& start,
+                                          const std::string& end,
+                                          const VitalSignRowCallback& callback,
+                                          int fetchSize) {
+    // Keyset pagination on (timestamp, id): every batch is a statement of
+    // its own, so the lock is only held while a batch is fetched and the
+    // callback may use the database. The timestamp comes back as local
+    // wall-clock text, the way it was written, and is converted here so the
+    // result does not depend on the session time zone.
+    const int batchSize = fetchSize > 0 ? fetchSize : 1000;
+    const std::string columns =
+        "SELECT to_char(timestamp, 'YYYY-MM-DD HH24:MI:SS.US'), id, "
+        "hr, spo2, abp, ecg_classification, ecg_confidence, source_id FROM vital_signs ";
+    const std::string order = " ORDER BY timestamp, id LIMIT " + std::to_string(batchSize);
+    const std::string firstQuery = columns +
+        "WHERE timestamp >= $1::timestamp AND timestamp < $2::timestamp" + order;
+    const std::string nextQuery = columns +
+        "WHERE timestamp < $2::timestamp AND (timestamp > $3::timestamp OR "
+        "(timestamp = $3::timestamp AND id > $4::integer))" + order;
+    
+    std::string lastTimestamp;
+    std::string lastId;
+    int64_t delivered = 0;
+    
+    while (true) {
+        PGresult* res = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (conn_ == nullptr || PQstatus(conn_) != CONNECTION_OK) {
+                LOG_ERROR("Cannot stream vital signs: Database not connected");
+                return -1;
+            }
+            const char* params[4] = {start.c_str(), end.c_str(), lastTimestamp.c_str(), lastId.c_str()};
+            bool first = lastId.empty();
+            res = PQexecParams(conn_, first ? firstQuery.c_str() : nextQuery.c_str(), first ? 2 : 4,
+                               nullptr, params, nullptr, nullptr, 0);
+        }
+        if (PQresultStatus(res) != PGRES_TUPLES_OK) {
+            LOG_ERROR("Vital sign stream query failed: " + std::string(PQresultErrorMessage(res)));
+            PQclear(res);
+            return -1;
+        }
+        
+        int rows = PQntuples(res);
+        for (int i = 0; i < rows; i++) {
+            VitalSignRow row;
+            if (!TimestampFormatter::parseLocal(PQgetvalue(res, i, 0), row.timestamp_us)) {
+                row.timestamp_us = 0;
+            }
+            row.hr = PQgetvalue(res, i, 2);
+            row.spo2 = PQgetvalue(res, i, 3);
+            row.abp = PQgetvalue(res, i, 4);
+            row.ecg_classification = PQgetvalue(res, i, 5);
+            row.ecg_confidence = PQgetisnull(res, i, 6) ? 0.0f : std::strtof(PQgetvalue(res, i, 6), nullptr);
+            row.source_id = PQgetvalue(res, i, 7);
+            delivered++;
+            
+            if (!callback(row)) {
+                PQclear(res);
+                return delivered;
+            }
+        }
+        if (rows > 0) {
+            lastTimestamp = PQgetvalue(res, rows - 1, 0);
+            lastId = PQgetvalue(res, rows - 1, 1);
+        }
+        PQclear(res);
+        if (rows < batchSize) {
+            break;
+        }
+    }
+    
+    LOG_DEBUG("Streamed %lld vital sign records", static_cast<long long>(delivered));
+    return delivered;
+}
+
+bool PostgresBackend::healthCheck() {
+    if (!isConnected()) {
+        return false;
+    }
+    
+    PGresult* res = executeQueryWithResult("SELECT 1;");
+    if (res != nullptr) {
+        PQclear(res);
+        return true;
+    }
+    
+    return false;
+}
@@ -0,0 +1,59 @@
+#ifndef POSTGRES_BACKEND_H
+#define POSTGRES_BACKEND_H
+
+#include "StorageBackend.h"
+#include <mutex>
+#include <libpq-fe.h>
+
+// PostgreSQL storage via libpq
+class PostgresBackend : public StorageBackend {
+public:
+    PostgresBackend(const std::string& host,
+                    int port,
+                    const std::string& dbname,
+                    const std::string& user,
+                    const std::string& password,
+                    int timeout);
+    ~PostgresBackend() override;
+    
+    const char* name() const override { return "postgresql"; }
+    
+    bool connect() override;
+    void disconnect() override;
+    bool isConnected() override;
+    
+    bool createTables() override;
+    bool insertVitalSign(const VitalSignData& data) override;
+    
+    std::vector<VitalSignData> getRecentVitalSigns(int limit) override;
+    
+    // Walks the range in keyset-paginated batches of fetchSize rows, so
+    // memory stays constant regardless of range length
+    int64_t streamVitalSigns(const std::string& start,
+                             const std::string& end,
+                             const VitalSignRowCallback& callback,
+                             int fetchSize) override;
+    
+    bool healthCheck() override;
+    
+private:
+    PostgresBackend(const PostgresBackend&) = delete;
+    PostgresBackend& operator=(const PostgresBackend&) = delete;
+    
+    PGconn* conn_ = nullptr;
+    std::mutex mutex_;
+    
+    std::string host_;
+    int port_;
+    std::string dbname_;
+    std::string user_;
+    std::string password_;
+    int timeout_;
+    
+    // Helper methods
+    std::string buildConnectionString();
+    bool executeQuery(const std::string& query);
+    PGresult* executeQueryWithResult(const std::string& query);
+};
+
+#endif // POSTGRES_BACKEND_H
@@ -0,0 +1,400 @@
+#include "SqliteBackend.h"
+#include "../utils/Logger.h"
+#include "../monitoring/MetricsRegistry.h"
+#include "../utils/TimestampFormatter.h"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const char* columnText(sqlite3_stmt* stmt, int col) {
+    const unsigned char* text = sqlite3_column_text(stmt, col);
+    return text != nullptr ? reinterpret_cast<const char*>(text) : "";
+}
+
+} // namespace
+
+SqliteBackend::SqliteBackend(const std::string& path, int batchSize, int flushIntervalMs)
+    : path_(path),
+      batchSize_(batchSize > 0 ? batchSize : 1),
+      flushInterval_(flushIntervalMs > 0 ? flushIntervalMs : 0) {
+}
+
+SqliteBackend::~SqliteBackend() {
+    disconnect();
+}
+
+bool SqliteBackend::exec(const char* sql) {
+    char* errMsg = nullptr;
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &errMsg) != SQLITE_OK) {
+        LOG_ERROR("SQLite query failed: " + std::string(errMsg != nullptr ? errMsg : "unknown error"));
+        sqlite3_free(errMsg);
+        return false;
+    }
+    return true;
+}
+
+bool SqliteBackend::connect() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (db_ != nullptr) {
+        LOG_DEBUG("SQLite database already open");
+        return true;
+    }
+    
+    // Create directory if it doesn't exist
+    fs::path dbDir = fs::path(path_).parent_path();
+    std::error_code ec;
+    if (!dbDir.empty() && !fs::exists(dbDir)) {
+        fs::create_directories(dbDir, ec);
+    }
+    
+    if (sqlite3_open_v2(path_.c_str(), &db_,
+                        SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX,
+                        nullptr) != SQLITE_OK) {
+        LOG_ERROR("SQLite open failed: " + std::string(db_ != nullptr ? sqlite3_errmsg(db_) : path_));
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return false;
+    }
+    
+    // WAL lets readers run alongside the writer; NORMAL sync is durable
+    // across application crashes and only risks the last batch on power loss
+    sqlite3_busy_timeout(db_, 5000);
+    if (!exec("PRAGMA journal_mode=WAL;") || !exec("PRAGMA synchronous=NORMAL;")) {
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return false;
+    }
+    
+    if (flushInterval_.count() > 0) {
+        stopFlusher_ = false;
+        flusher_ = std::thread(&SqliteBackend::flusherLoop, this);
+    }
+    
+    LOG_INFO("SQLite database opened: " + path_);
+    return true;
+}
+
+void SqliteBackend::flusherLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stopFlusher_) {
+        if (pendingRows_ == 0) {
+            // Woken when an insert opens the next batch
+            flusherWake_.wait(lock);
+            continue;
+        }
+        std::chrono::steady_clock::time_point deadline = batchStarted_ + flushInterval_;
+        if (std::chrono::steady_clock::now() >= deadline) {
+            commitBatchLocked();
+        } else {
+            flusherWake_.wait_until(lock, deadline);
+        }
+    }
+}
+
+void SqliteBackend::finalizeStatementsLocked() {
+    if (insertStmt_ != nullptr) {
+        sqlite3_finalize(insertStmt_);
+        insertStmt_ = nullptr;
+    }
+}
+
+bool SqliteBackend::hasColumnLocked(const char* table, const char* column) {
+    sqlite3_stmt* stmt = nullptr;
+    std::string query = std::string("PRAGMA table_info(") + table + ");";
+    if (sqlite3_prepare_v2(db_, query.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        return false;
+    }
+    bool found = false;
+    while (!found && sqlite3_step(stmt) == SQLITE_ROW) {
+        found = std::string(columnText(stmt, 1)) == column;
+    }
+    sqlite3_finalize(stmt);
+    return found;
+}
+
+void SqliteBackend::disconnect() {
+    // Stop the flusher first; it needs mutex_ to exit
+    std::thread flusher;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopFlusher_ = true;
+        flusherWake_.notify_all();
+        flusher.swap(flusher_);
+    }
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    // Commit whatever the last batch holds before closing
+    if (db_ != nullptr) {
+        commitBatchLocked();
+        finalizeStatementsLocked();
+        sqlite3_close(db_);
+        db_ = nullptr;
+        LOG_INFO("SQLite database closed");
+    }
+}
+
+bool SqliteBackend::isConnected() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return db_ != nullptr;
+}
+
+bool SqliteBackend::createTables() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (db_ == nullptr) {
+        LOG_ERROR("Cannot create tables: SQLite database not open");
+        return false;
+    }
+    
+    const char* createTableQuery = R"(
+        CREATE TABLE IF NOT EXISTS vital_signs (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            timestamp TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP,
+            hr TEXT,
+            spo2 TEXT,
+            abp TEXT,
+            ecg_classification TEXT,
+            ecg_confidence REAL,
+            source_id TEXT,
+            created_at TEXT NOT NULL DEFAULT CURRENT_TIMESTAMP
+        );
+        
+        CREATE INDEX IF NOT EXISTS idx_vital_signs_timestamp ON vital_signs(timestamp);
+    )";
+    
+    if (!exec(createTableQuery)) {
+        LOG_ERROR("Failed to create SQLite tables");
+        return false;
+    }
+    
+    // Tables created before multi-source support lack source_id, and SQLite
+    // has no ADD COLUMN IF NOT EXISTS
+    if (!hasColumnLocked("vital_signs", "source_id") &&
+        !exec("ALTER TABLE vital_signs ADD COLUMN source_id TEXT;")) {
+        LOG_ERROR("Failed to add source_id column");
+        return false;
+    }
+    if (!exec("CREATE INDEX IF NOT EXISTS idx_vital_signs_source_timestamp ON vital_signs(source_id, timestamp);")) {
+        return false;
+    }
+    
+    finalizeStatementsLocked();
+    if (sqlite3_prepare_v2(db_,
+                           "INSERT INTO vital_signs (timestamp, hr, spo2, abp, ecg_classification, ecg_confidence, source_id) "
+                           "VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7);",
+                           -1, &insertStmt_, nullptr) != SQLITE_OK) {
+        LOG_ERROR("Failed to prepare SQLite insert: " + std::string(sqlite3_errmsg(db_)));
+        return false;
+    }
+    
+    LOG_INFO("SQLite tables created/verified successfully");
+    return true;
+}
+
+bool SqliteBackend::commitBatchLocked() {
+    if (pendingRows_ == 0) {
+        return true;
+    }
+    
+    static Histogram& batchRows = MetricsRegistry::getInstance().histogram(
+        "vitalsign_db_batch_rows", "Rows per committed SQLite transaction");
+    
+    bool ok = exec("COMMIT;");
+    if (ok) {
+        batchRows.record(static_cast<uint64_t>(pendingRows_));
+        LOG_DEBUG("Committed SQLite batch of %d rows", pendingRows_);
+    } else {
+        exec("ROLLBACK;");
+    }
+    pendingRows_ = 0;
+    return ok;
+}
+
+bool SqliteBackend::insertVitalSign(const VitalSignData& data) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    if (db_ == nullptr || insertStmt_ == nullptr) {
+        LOG_ERROR("Cannot insert data: SQLite database not ready");
+        return false;
+    }
+    
+    if (pendingRows_ == 0) {
+        if (!exec("BEGIN;")) {
+            return false;
+        }
+        batchStarted_ = std::chrono::steady_clock::now();
+        flusherWake_.notify_one();
+    }
+    
+    sqlite3_bind_text(insertStmt_, 1, data.timestamp.c_str(), static_cast<int>(data.timestamp.size()), SQLITE_STATIC);
+    sqlite3_bind_text(insertStmt_, 2, data.hr.c_str(), static_cast<int>(data.hr.size()), SQLITE_STATIC);
+    sqlite3_bind_text(insertStmt_, 3, data.spo2.c_str(), static_cast<int>(data.spo2.size()), SQLITE_STATIC);
+    sqlite3_bind_text(insertStmt_, 4, data.abp.c_str(), static_cast<int>(data.abp.size()), SQLITE_STATIC);
+    sqlite3_bind_text(insertStmt_, 5, data.ecg_classification.c_str(),
+                      static_cast<int>(data.ecg_classification.size()), SQLITE_STATIC);
+    sqlite3_bind_double(insertStmt_, 6, data.ecg_confidence);
+    if (data.source_id.empty()) {
+        sqlite3_bind_null(insertStmt_, 7);
+    } else {
+        sqlite3_bind_text(insertStmt_, 7, data.source_id.c_str(), static_cast<int>(data.source_id.size()), SQLITE_STATIC);
+    }
+    
+    int rc = sqlite3_step(insertStmt_);
+    sqlite3_reset(insertStmt_);
+    sqlite3_clear_bindings(insertStmt_);
+    
+    if (rc != SQLITE_DONE) {
+        LOG_ERROR("Failed to insert vital sign data: " + std::string(sqlite3_errmsg(db_)));
+        return false;
+    }
+    pendingRows_++;
+    
+    if (pendingRows_ >= batchSize_ ||
+        std::chrono::steady_clock::now() - batchStarted_ >= flushInterval_) {
+        return commitBatchLocked();
+    }
+    return true;
+}
+
+bool SqliteBackend::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return db_ == nullptr || commitBatchLocked();
+}
+
+std::vector<VitalSignData> SqliteBackend::getRecentVitalSigns(int limit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<VitalSignData> results;
+    
+    if (db_ == nullptr) {
+        LOG_ERROR("Cannot query: SQLite database not open");
+        return results;
+    }
+    
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db_,
+                           "SELECT timestamp, hr, spo2, abp, ecg_classification, ecg_confidence, source_id "
+                           "FROM vital_signs ORDER BY timestamp DESC LIMIT ?1;",
+                           -1, &stmt, nullptr) != SQLITE_OK) {
+        LOG_ERROR("Query preparation failed: " + std::string(sqlite3_errmsg(db_)));
+        return results;
+    }
+    sqlite3_bind_int(stmt, 1, limit);
+    
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        VitalSignData data;
+        data.timestamp = columnText(stmt, 0);
+        data.hr = columnText(stmt, 1);
+        data.spo2 = columnText(stmt, 2);
+        data.abp = columnText(stmt, 3);
+        data.ecg_classification = columnText(stmt, 4);
+        data.ecg_confidence = static_cast<float>(sqlite3_column_double(stmt, 5));
+        data.source_id = columnText(stmt, 6);
+        results.push_back(std::move(data));
+    }
+    sqlite3_finalize(stmt);
+    
+    LOG_DEBUG("Retrieved %zu vital sign records", results.size());
+    return results;
+}
+
+int64_t SqliteBackend::streamVitalSigns(const std::string& start,
+                                        const std::string& end,
+                                        const VitalSignRowCallback& callback,
+                                        int fetchSize) {
+    // Keyset pagination on (timestamp, id), as in the PostgreSQL backend:
+    // each batch is copied out under the lock and handed to the callback
+    // after it is released, so the callback may use the database
+    const int batchSize = fetchSize > 0 ? fetchSize : 1000;
+    std::vector<BufferedRow> batch;
+    std::string lastTimestamp;
+    int64_t lastId = -1;
+    int64_t delivered = 0;
+    
+    while (true) {
+        size_t rows = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (db_ == nullptr) {
+                LOG_ERROR("Cannot stream vital signs: SQLite database not open");
+                return -1;
+            }
+            sqlite3_stmt* stmt = nullptr;
+            if (sqlite3_prepare_v2(db_,
+                                   "SELECT timestamp, id, hr, spo2, abp, ecg_classification, ecg_confidence, source_id "
+                                   "FROM vital_signs WHERE timestamp >= ?1 AND timestamp < ?2 "
+                                   "AND (?4 < 0 OR timestamp > ?3 OR (timestamp = ?3 AND id > ?4)) "
+                                   "ORDER BY timestamp, id LIMIT ?5;",
+                                   -1, &stmt, nullptr) != SQLITE_OK) {
+                LOG_ERROR("Query preparation failed: " + std::string(sqlite3_errmsg(db_)));
+                return -1;
+            }
+            sqlite3_bind_text(stmt, 1, start.c_str(), static_cast<int>(start.size()), SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 2, end.c_str(), static_cast<int>(end.size()), SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 3, lastTimestamp.c_str(), static_cast<int>(lastTimestamp.size()), SQLITE_STATIC);
+            sqlite3_bind_int64(stmt, 4, lastId);
+            sqlite3_bind_int(stmt, 5, batchSize);
+            
+            int rc;
+            while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+                if (rows == batch.size()) {
+                    batch.emplace_back();
+                }
+                BufferedRow& row = batch[rows++];
+                row.timestamp = columnText(stmt, 0);
+                row.id = sqlite3_column_int64(stmt, 1);
+                row.hr = columnText(stmt, 2);
+                row.spo2 = columnText(stmt, 3);
+                row.abp = columnText(stmt, 4);
+                row.ecgClassification = columnText(stmt, 5);
+                row.ecgConfidence = static_cast<float>(sqlite3_column_double(stmt, 6));
+                row.sourceId = columnText(stmt, 7);
+            }
+            sqlite3_finalize(stmt);
+            if (rc != SQLITE_DONE) {
+                LOG_ERROR("SQLite stream failed: " + std::string(sqlite3_errmsg(db_)));
+                return -1;
+            }
+        }
+        
+        for (size_t i = 0; i < rows; i++) {
+            const BufferedRow& buffered = batch[i];
+            VitalSignRow row;
+            if (!TimestampFormatter::parseLocal(buffered.timestamp.c_str(), row.timestamp_us)) {
+                row.timestamp_us = 0;
+            }
+            row.hr = buffered.hr.c_str();
+            row.spo2 = buffered.spo2.c_str();
+            row.abp = buffered.abp.c_str();
+            row.ecg_classification = buffered.ecgClassification.c_str();
+            row.ecg_confidence = buffered.ecgConfidence;
+            row.source_id = buffered.sourceId.c_str();
+            delivered++;
+            
+            if (!callback(row)) {
+                return delivered;
+            }
+        }
+        if (rows > 0) {
+            lastTimestamp = batch[rows - 1].timestamp;
+            lastId = batch[rows - 1].id;
+        }
+        if (rows < static_cast<size_t>(batchSize)) {
+            break;
+        }
+    }
+    
+    LOG_DEBUG("Streamed %lld vital sign records", static_cast<long long>(delivered));
+    return delivered;
+}
+
+bool SqliteBackend::healthCheck() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return db_ != nullptr && exec("SELECT 1;");
+}
@@ -0,0 +1,80 @@
+#ifndef SQLITE_BACKEND_H
+#define SQLITE_BACKEND_H
+
+#include "StorageBackend.h"
+#include <mutex>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
+#include <sqlite3.h>
+
+// Embedded SQLite storage for devices without a PostgreSQL server.
+// Runs in WAL mode and groups inserts into transactions of batchSize rows
+// through a prepared statement. A background thread commits any batch that
+// has been open for flushIntervalMs, so rows reach disk even when inserts stop.
+class SqliteBackend : public StorageBackend {
+public:
+    SqliteBackend(const std::string& path, int batchSize, int flushIntervalMs);
+    ~SqliteBackend() override;
+    
+    const char* name() const override { return "sqlite"; }
+    
+    bool connect() override;
+    void disconnect() override;
+    bool isConnected() override;
+    
+    bool createTables() override;
+    bool insertVitalSign(const VitalSignData& data) override;
+    bool flush() override;
+    
+    std::vector<VitalSignData> getRecentVitalSigns(int limit) override;
+    int64_t streamVitalSigns(const std::string& start,
+                             const std::string& end,
+                             const VitalSignRowCallback& callback,
+                             int fetchSize) override;
+    
+    bool healthCheck() override;
+    
+private:
+    SqliteBackend(const SqliteBackend&) = delete;
+    SqliteBackend& operator=(const SqliteBackend&) = delete;
+    
+    sqlite3* db_ = nullptr;
+    sqlite3_stmt* insertStmt_ = nullptr;
+    std::mutex mutex_;
+    
+    // Commits batches older than flushInterval_; runs while connected
+    std::thread flusher_;
+    std::condition_variable flusherWake_;
+    bool stopFlusher_ = false;
+    
+    std::string path_;
+    int batchSize_;
+    std::chrono::milliseconds flushInterval_;
+    
+    // Open batch transaction state
+    int pendingRows_ = 0;
+    std::chrono::steady_clock::time_point batchStarted_;
+    
+    // One row of a streamed batch, copied out of the statement
+    struct BufferedRow {
+        std::string timestamp;
+        int64_t id = 0;
+        std::string hr;
+        std::string spo2;
+        std::string abp;
+        std::string ecgClassification;
+        float ecgConfidence = 0.0f;
+        std::string sourceId;
+    };
+    
+    void flusherLoop();
+    
+    // Helper methods (caller holds mutex_)
+    bool exec(const char* sql);
+    bool commitBatchLocked();
+    void finalizeStatementsLocked();
+    bool hasColumnLocked(const char* table, const char* column);
+};
+
+#endif // SQLITE_BACKEND_H
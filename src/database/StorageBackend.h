@@ -0,0 +1,68 @@
+#ifndef STORAGE_BACKEND_H
+#define STORAGE_BACKEND_H
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <cstdint>
+
+// Structure to hold vital sign data
+struct VitalSignData {
+    std::string timestamp;
+    std::string hr;
+    std::string spo2;
+    std::string abp;
+    std::string ecg_classification;
+    float ecg_confidence;
+    std::string source_id;          // Bed/monitor id; empty (NULL) for single-source setups
+};
+
+// Row view handed to streaming query callbacks. Text fields point into the
+// backend's current result buffer and are only valid until the callback returns.
+struct VitalSignRow {
+    int64_t timestamp_us;           // Stored local timestamp as microseconds since epoch
+    const char* hr;
+    const char* spo2;
+    const char* abp;
+    const char* ecg_classification;
+    float ecg_confidence;
+    const char* source_id;          // "" when the row has no source
+};
+
+// Return false from the callback to stop the stream early. Backends call it
+// without holding their lock, so it may itself use the database.
+using VitalSignRowCallback = std::function<bool(const VitalSignRow&)>;
+
+// Interface implemented by each storage engine behind DatabaseManager
+class StorageBackend {
+public:
+    virtual ~StorageBackend() = default;
+    
+    virtual const char* name() const = 0;
+    
+    // Connection management
+    virtual bool connect() = 0;
+    virtual void disconnect() = 0;
+    virtual bool isConnected() = 0;
+    
+    // Create tables if they don't exist
+    virtual bool createTables() = 0;
+    
+    // Insert vital sign data (backends may buffer until flush())
+    virtual bool insertVitalSign(const VitalSignData& data) = 0;
+    
+    // Push any buffered inserts to durable storage
+    virtual bool flush() { return true; }
+    
+    // Query operations
+    virtual std::vector<VitalSignData> getRecentVitalSigns(int limit) = 0;
+    virtual int64_t streamVitalSigns(const std::string& start,
+                                     const std::string& end,
+                                     const VitalSignRowCallback& callback,
+                                     int fetchSize) = 0;
+    
+    // Health check
+    virtual bool healthCheck() = 0;
+};
+
+#endif // STORAGE_BACKEND_H
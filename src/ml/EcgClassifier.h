@@ -0,0 +1,46 @@
+#ifndef ECG_CLASSIFIER_H
+#define ECG_CLASSIFIER_H
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Outcome of one run of the Edge Impulse impulse
+struct EcgResult {
+    bool ok = false;
+    int error = 0;                      // EI_IMPULSE_ERROR when !ok
+    std::string label = "unknown";
+    float confidence = 0.0f;
+    int64_t dspUs = 0;
+    int64_t classificationUs = 0;
+};
+
+// Function to resize and crop frame to the model input size. out_frame is a
+// view into resized; passing the same resized Mat every time reuses its buffer.
+void resize_and_crop(cv::Mat *in_frame, cv::Mat *out_frame, cv::Mat *resized);
+
+// Wraps the Edge Impulse classifier. This is the only translation unit that
+// includes ei_run_classifier.h, which defines non-inline functions.
+// The SDK keeps its tensor arena in globals, so run() must not be called
+// from more than one thread at a time.
+class EcgClassifier {
+public:
+    EcgClassifier();
+    
+    static int inputWidth();
+    static int inputHeight();
+    
+    // Resize/crop the frame and pack its pixels into the feature buffer;
+    // cropped stays valid until the next prepare()
+    void prepare(const cv::Mat& frame, cv::Mat& cropped);
+    
+    // Classify the last prepared features; logScores logs every label's score
+    EcgResult run(bool logScores = false);
+    
+private:
+    std::vector<float> features_;
+    cv::Mat resized_;                   // Reused by every prepare()
+};
+
+#endif // ECG_CLASSIFIER_H
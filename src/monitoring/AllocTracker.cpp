@@ -0,0 +1,346 @@
+#include "AllocTracker.h"
+#include "MetricsRegistry.h"
+
+#include <algorithm>
+
+#if ALLOC_TRACKING
+#if !defined(__GLIBC__)
+#error "ALLOC_TRACKING=1 needs glibc: malloc is interposed through __libc_malloc"
+#endif
+#include "edge-impulse-sdk/porting/ei_classifier_porting.h"
+#include <cerrno>
+#include <malloc.h>
+#include <new>
+#endif
+
+namespace {
+
+// Per-thread tallies, so a frame only counts its own thread's allocations
+// and not those of the logger, servers or executor workers running beside
+// it. Constant-initialised TLS: the hooks never allocate to reach it.
+struct ThreadCounters {
+    AllocCounts stages[kAllocStageCount];
+    AllocCounts ei;
+};
+
+thread_local ThreadCounters t_counters;
+thread_local int t_stage = 0;
+
+// Plain static storage: zero-initialised before any constructor runs, so
+// allocations made during static initialisation are counted too
+std::atomic<int64_t> g_liveBytes;
+std::atomic<int64_t> g_peakLiveBytes;
+
+const char* const kStageNames[kAllocStageCount] = {
+    "other", "capture", "ocr", "preprocess", "ml", "output", "db"
+};
+
+AllocCounts delta(const AllocCounts& now, const AllocCounts& then) {
+    AllocCounts d;
+    d.allocs = now.allocs - then.allocs;
+    d.frees = now.frees - then.frees;
+    d.bytes = now.bytes - then.bytes;
+    return d;
+}
+
+void accumulate(AllocCounts& total, const AllocCounts& d) {
+    total.allocs += d.allocs;
+    total.frees += d.frees;
+    total.bytes += d.bytes;
+}
+
+} // namespace
+
+AllocTracker& AllocTracker::getInstance() {
+    static AllocTracker instance;
+    return instance;
+}
+
+AllocTracker::AllocTracker() : steadyAllocs_(new Histogram()) {
+    take(frameStart_);
+}
+
+AllocTracker::~AllocTracker() = default;
+
+const char* AllocTracker::stageName(AllocStage stage) {
+    int index = static_cast<int>(stage);
+    return index >= 0 && index < kAllocStageCount ? kStageNames[index] : "unknown";
+}
+
+AllocStage AllocTracker::setStage(AllocStage stage) {
+    AllocStage previous = static_cast<AllocStage>(t_stage);
+    t_stage = static_cast<int>(stage);
+    return previous;
+}
+
+void AllocTracker::onAlloc(size_t requested, size_t usable, bool ei) {
+    AllocCounts& stage = t_counters.stages[t_stage];
+    stage.allocs++;
+    stage.bytes += requested;
+    if (ei) {
+        t_counters.ei.allocs++;
+        t_counters.ei.bytes += requested;
+    }
+
+    int64_t live = g_liveBytes.fetch_add(static_cast<int64_t>(usable), std::memory_order_relaxed) +
+                   static_cast<int64_t>(usable);
+    int64_t peak = g_peakLiveBytes.load(std::memory_order_relaxed);
+    while (live > peak && !g_peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+}
+
+void AllocTracker::onFree(size_t usable, bool ei) {
+    t_counters.stages[t_stage].frees++;
+    if (ei) {
+        t_counters.ei.frees++;
+    }
+    g_liveBytes.fetch_sub(static_cast<int64_t>(usable), std::memory_order_relaxed);
+}
+
+void AllocTracker::take(Snapshot& snapshot) {
+    for (int i = 0; i < kAllocStageCount; i++) {
+        snapshot.stages[i] = t_counters.stages[i];
+    }
+    snapshot.ei = t_counters.ei;
+}
+
+void AllocTracker::beginFrame() {
+    take(frameStart_);
+}
+
+void AllocTracker::endFrame() {
+    Snapshot now;
+    take(now);
+
+    bool steady = summary_.frames >= warmupFrames_;
+    uint64_t allocs = 0;
+    for (int i = 0; i < kAllocStageCount; i++) {
+        AllocCounts d = delta(now.stages[i], frameStart_.stages[i]);
+        allocs += d.allocs;
+        if (steady) {
+            accumulate(summary_.steady[i], d);
+        }
+    }
+
+    summary_.frames++;
+    summary_.peakFrameAllocs = std::max(summary_.peakFrameAllocs, allocs);
+    if (steady) {
+        accumulate(summary_.steadyEi, delta(now.ei, frameStart_.ei));
+        summary_.steadyFrames++;
+        summary_.steadyMaxAllocs = std::max(summary_.steadyMaxAllocs, allocs);
+        steadyAllocs_->record(allocs);
+    }
+    lastFrameAllocs_.store(allocs, std::memory_order_relaxed);
+    frameStart_ = now;
+}
+
+int64_t AllocTracker::liveBytes() const {
+    return g_liveBytes.load(std::memory_order_relaxed);
+}
+
+int64_t AllocTracker::peakLiveBytes() const {
+    return g_peakLiveBytes.load(std::memory_order_relaxed);
+}
+
+AllocSummary AllocTracker::summary() const {
+    AllocSummary result = summary_;
+    if (result.steadyFrames > 0) {
+        uint64_t allocs = 0;
+        uint64_t bytes = 0;
+        for (int i = 0; i < kAllocStageCount; i++) {
+            allocs += result.steady[i].allocs;
+            bytes += result.steady[i].bytes;
+        }
+        result.steadyAllocsPerFrame = static_cast<double>(allocs) / result.steadyFrames;
+        result.steadyBytesPerFrame = static_cast<double>(bytes) / result.steadyFrames;
+    }
+    result.liveBytes = liveBytes();
+    result.peakLiveBytes = peakLiveBytes();
+    return result;
+}
+
+uint64_t AllocTracker::steadyQuantile(double q) const {
+    return steadyAllocs_->count() > 0 ? steadyAllocs_->quantile(q) : 0;
+}
+
+void AllocTracker::reset() {
+    summary_ = AllocSummary();
+    steadyAllocs_.reset(new Histogram());
+    lastFrameAllocs_.store(0, std::memory_order_relaxed);
+    take(frameStart_);
+}
+
+#if ALLOC_TRACKING
+
+// Replacement allocators. glibc lets a program interpose malloc, free,
+// calloc, realloc and the aligned variants; the originals stay reachable
+// as __libc_*. OpenCV (fastMalloc -> posix_memalign), Tesseract and libc
+// itself all land here. operator new is replaced as well so C++
+// allocations are counted even where libstdc++ does not route through
+// malloc. Sizes for frees come from malloc_usable_size.
+
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+namespace {
+
+inline void* trackedMalloc(size_t size, bool ei) {
+    void* ptr = __libc_malloc(size);
+    if (ptr != nullptr) {
+        AllocTracker::onAlloc(size, malloc_usable_size(ptr), ei);
+    }
+    return ptr;
+}
+
+inline void* trackedCalloc(size_t count, size_t size, bool ei) {
+    void* ptr = __libc_calloc(count, size);
+    if (ptr != nullptr) {
+        AllocTracker::onAlloc(count * size, malloc_usable_size(ptr), ei);
+    }
+    return ptr;
+}
+
+inline void* trackedAligned(size_t alignment, size_t size) {
+    void* ptr = __libc_memalign(alignment, size);
+    if (ptr != nullptr) {
+        AllocTracker::onAlloc(size, malloc_usable_size(ptr), false);
+    }
+    return ptr;
+}
+
+inline void trackedFree(void* ptr, bool ei) {
+    if (ptr != nullptr) {
+        AllocTracker::onFree(malloc_usable_size(ptr), ei);
+        __libc_free(ptr);
+    }
+}
+
+void* newOrThrow(size_t size) {
+    if (size == 0) {
+        size = 1;
+    }
+    while (true) {
+        void* ptr = trackedMalloc(size, false);
+        if (ptr != nullptr) {
+            return ptr;
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void* alignedNewOrThrow(size_t size, std::align_val_t alignment) {
+    if (size == 0) {
+        size = 1;
+    }
+    void* ptr = trackedAligned(static_cast<size_t>(alignment), size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+} // namespace
+
+extern "C" {
+
+void* malloc(size_t size) {
+    return trackedMalloc(size, false);
+}
+
+void* calloc(size_t count, size_t size) {
+    return trackedCalloc(count, size, false);
+}
+
+void* realloc(void* ptr, size_t size) {
+    if (ptr == nullptr) {
+        return trackedMalloc(size, false);
+    }
+    if (size == 0) {
+        trackedFree(ptr, false);
+        return nullptr;
+    }
+    size_t oldUsable = malloc_usable_size(ptr);
+    void* moved = __libc_realloc(ptr, size);
+    if (moved != nullptr) {
+        AllocTracker::onFree(oldUsable, false);
+        AllocTracker::onAlloc(size, malloc_usable_size(moved), false);
+    }
+    return moved;
+}
+
+void free(void* ptr) {
+    trackedFree(ptr, false);
+}
+
+void* memalign(size_t alignment, size_t size) {
+    return trackedAligned(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    return trackedAligned(alignment, size);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t size) {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    void* ptr = trackedAligned(alignment, size);
+    if (ptr == nullptr) {
+        return ENOMEM;
+    }
+    *out = ptr;
+    return 0;
+}
+
+} // extern "C"
+
+// Edge Impulse SDK allocations (DSP buffers, TFLM arena) are also tallied
+// separately so the report can show the SDK's share
+void* ei_malloc(size_t size) {
+    return trackedMalloc(size, true);
+}
+
+void* ei_calloc(size_t nitems, size_t size) {
+    return trackedCalloc(nitems, size, true);
+}
+
+void ei_free(void* ptr) {
+    trackedFree(ptr, true);
+}
+
+void* operator new(size_t size) { return newOrThrow(size); }
+void* operator new[](size_t size) { return newOrThrow(size); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return trackedMalloc(size ? size : 1, false); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return trackedMalloc(size ? size : 1, false); }
+void* operator new(size_t size, std::align_val_t alignment) { return alignedNewOrThrow(size, alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return alignedNewOrThrow(size, alignment); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAligned(static_cast<size_t>(alignment), size ? size : 1);
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAligned(static_cast<size_t>(alignment), size ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept { trackedFree(ptr, false); }
+void operator delete[](void* ptr) noexcept { trackedFree(ptr, false); }
+void operator delete(void* ptr, size_t) noexcept { trackedFree(ptr, false); }
+void operator delete[](void* ptr, size_t) noexcept { trackedFree(ptr, false); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr, false); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { trackedFree(ptr, false); }
+void operator delete(void* ptr, std::align_val_t) noexcept { trackedFree(ptr, false); }
+void operator delete[](void* ptr, std::align_val_t) noexcept { trackedFree(ptr, false); }
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept { trackedFree(ptr, false); }
+void operator delete[](void* ptr, size_t, std::align_val_t) noexcept { trackedFree(ptr, false); }
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(ptr, false); }
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept { trackedFree(ptr, false); }
+
+#endif // ALLOC_TRACKING
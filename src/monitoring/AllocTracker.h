@@ -0,0 +1,153 @@
+#ifndef ALLOC_TRACKER_H
+#define ALLOC_TRACKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+class Histogram;
+
+// Compile-time switch: build with -DALLOC_TRACKING=1 (make ALLOC_TRACKING=1)
+// to replace operator new/delete, the glibc malloc family and the SDK's
+// ei_malloc/ei_calloc/ei_free with counting versions. Off by default; with
+// it off the ALLOC_* macros vanish and the tracker reports zeros.
+#ifndef ALLOC_TRACKING
+#define ALLOC_TRACKING 0
+#endif
+
+// Pipeline stage an allocation is charged to (per thread, see ALLOC_STAGE)
+enum class AllocStage : int {
+    Other = 0,
+    Capture,
+    Ocr,
+    Preprocess,
+    Ml,
+    Output,
+    Db,
+    Count
+};
+
+constexpr int kAllocStageCount = static_cast<int>(AllocStage::Count);
+
+struct AllocCounts {
+    uint64_t allocs = 0;
+    uint64_t frees = 0;
+    uint64_t bytes = 0;      // Bytes requested by the allocations
+};
+
+// Results over the frames seen since the last reset()
+struct AllocSummary {
+    long frames = 0;
+    long steadyFrames = 0;                   // Frames after the warm-up
+    AllocCounts steady[kAllocStageCount];    // Summed over steady frames
+    AllocCounts steadyEi;                    // ei_* (DSP/TFLM) share of the above
+    double steadyAllocsPerFrame = 0.0;
+    double steadyBytesPerFrame = 0.0;
+    uint64_t steadyMaxAllocs = 0;            // Worst steady frame
+    uint64_t peakFrameAllocs = 0;            // Worst frame including warm-up
+    int64_t liveBytes = 0;
+    int64_t peakLiveBytes = 0;               // Heap high-water mark since start
+};
+
+// Counts heap allocations and bytes per pipeline stage per frame. Counts are
+// kept per thread and a frame only includes the allocations of the thread
+// that runs beginFrame/endFrame (the frame loop's), so background threads
+// do not leak into it; helper threads it hands work to are not counted
+// either. The hooks only touch thread-locals and the relaxed live-heap
+// atomics, so they are safe on any thread and never allocate themselves.
+// beginFrame/endFrame/summary/reset belong to the frame loop's thread.
+class AllocTracker {
+public:
+    static constexpr bool kCompiled = ALLOC_TRACKING != 0;
+    
+    static AllocTracker& getInstance();
+    
+    static const char* stageName(AllocStage stage);
+    
+    // Charge allocations on the calling thread to stage; returns the previous one
+    static AllocStage setStage(AllocStage stage);
+    
+    // Called by the replacement allocators
+    static void onAlloc(size_t requested, size_t usable, bool ei);
+    static void onFree(size_t usable, bool ei);
+    
+    // Frames before this many are reported as warm-up only
+    void setWarmupFrames(long frames) { warmupFrames_ = frames; }
+    
+    void beginFrame();
+    void endFrame();
+    
+    // Allocations in the last completed frame, all stages
+    uint64_t lastFrameAllocs() const { return lastFrameAllocs_.load(std::memory_order_relaxed); }
+    int64_t liveBytes() const;
+    int64_t peakLiveBytes() const;
+    
+    AllocSummary summary() const;
+    
+    // Approximate steady-state allocations per frame at quantile q (0..1)
+    uint64_t steadyQuantile(double q) const;
+    
+    // Forget frame statistics (the live/peak heap counters keep running)
+    void reset();
+    
+private:
+    AllocTracker();
+    ~AllocTracker();
+    AllocTracker(const AllocTracker&) = delete;
+    AllocTracker& operator=(const AllocTracker&) = delete;
+    
+    struct Snapshot {
+        AllocCounts stages[kAllocStageCount];
+        AllocCounts ei;
+    };
+    static void take(Snapshot& snapshot);
+    
+    long warmupFrames_ = 0;
+    Snapshot frameStart_;
+    AllocSummary summary_;
+    std::unique_ptr<Histogram> steadyAllocs_;
+    std::atomic<uint64_t> lastFrameAllocs_{0};
+};
+
+// Charges allocations in the enclosing scope to a stage
+class AllocStageScope {
+public:
+    explicit AllocStageScope(AllocStage stage) : previous_(AllocTracker::setStage(stage)) {}
+    ~AllocStageScope() { AllocTracker::setStage(previous_); }
+    
+private:
+    AllocStage previous_;
+};
+
+// Brackets one frame of the frame loop: beginFrame() now, endFrame() at
+// end() or when the scope exits, so early continue/break paths still close
+// the frame. Does nothing unless ALLOC_TRACKING is compiled in.
+class AllocFrameScope {
+public:
+    AllocFrameScope() {
+        if (AllocTracker::kCompiled) AllocTracker::getInstance().beginFrame();
+    }
+    ~AllocFrameScope() { end(); }
+    AllocFrameScope(const AllocFrameScope&) = delete;
+    AllocFrameScope& operator=(const AllocFrameScope&) = delete;
+    
+    void end() {
+        if (AllocTracker::kCompiled && !ended_) AllocTracker::getInstance().endFrame();
+        ended_ = true;
+    }
+    
+private:
+    bool ended_ = false;
+};
+
+#define ALLOC_CONCAT_INNER(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_INNER(a, b)
+
+#if ALLOC_TRACKING
+#define ALLOC_STAGE(stage) AllocStageScope ALLOC_CONCAT(allocStage_, __LINE__)(AllocStage::stage)
+#else
+#define ALLOC_STAGE(stage) do {} while (0)
+#endif
+
+#endif // ALLOC_TRACKER_H
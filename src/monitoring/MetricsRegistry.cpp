@@ -0,0 +1,209 @@
+#include "MetricsRegistry.h"
+
+#include <cstdio>
+#include <set>
+
+uint64_t Histogram::bucketUpperBound(int index) {
+    if (index < kSubBuckets) {
+        return static_cast<uint64_t>(index);
+    }
+    int shift = index / kSubBuckets - 1;
+    uint64_t sub = static_cast<uint64_t>(index % kSubBuckets);
+    uint64_t lower = (static_cast<uint64_t>(kSubBuckets) + sub) << shift;
+    return lower + (uint64_t(1) << shift) - 1;
+}
+
+uint64_t Histogram::quantile(double q) const {
+    uint64_t counts[kBucketCount];
+    uint64_t total = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    
+    if (q < 0.0) q = 0.0;
+    if (q > 1.0) q = 1.0;
+    uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total - 1)) + 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < kBucketCount; ++i) {
+        seen += counts[i];
+        if (seen >= rank) {
+            return bucketUpperBound(i);
+        }
+    }
+    return bucketUpperBound(kBucketCount - 1);
+}
+
+MetricsRegistry& MetricsRegistry::getInstance() {
+    static MetricsRegistry instance;
+    return instance;
+}
+
+MetricsRegistry::Entry* MetricsRegistry::find(Kind kind, const std::string& name, const std::string& labels) {
+    for (auto& entry : entries_) {
+        if (entry.kind == kind && entry.name == name && entry.labels == labels) {
+            return &entry;
+        }
+    }
+    return nullptr;
+}
+
+MetricsRegistry::Entry& MetricsRegistry::add(Kind kind, const std::string& name,
+                                             const std::string& help, const std::string& labels) {
+    entries_.emplace_back();
+    Entry& entry = entries_.back();
+    entry.kind = kind;
+    entry.name = name;
+    entry.help = help;
+    entry.labels = labels;
+    return entry;
+}
+
+Counter& MetricsRegistry::counter(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (Entry* existing = find(Kind::Counter, name, labels)) {
+        return *existing->counter;
+    }
+    Entry& entry = add(Kind::Counter, name, help, labels);
+    entry.counter.reset(new Counter());
+    return *entry.counter;
+}
+
+Gauge& MetricsRegistry::gauge(const std::string& name, const std::string& help, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (Entry* existing = find(Kind::Gauge, name, labels)) {
+        return *existing->gauge;
+    }
+    Entry& entry = add(Kind::Gauge, name, help, labels);
+    entry.gauge.reset(new Gauge());
+    return *entry.gauge;
+}
+
+Histogram& MetricsRegistry::histogram(const std::string& name, const std::string& help,
+                                      const std::string& labels, double unitScale) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (Entry* existing = find(Kind::Histogram, name, labels)) {
+        return *existing->histogram;
+    }
+    Entry& entry = add(Kind::Histogram, name, help, labels);
+    entry.histogram.reset(new Histogram(unitScale));
+    return *entry.histogram;
+}
+
+void MetricsRegistry::gaugeCallback(const std::string& name, const std::string& help,
+                                    std::function<double()> sample, const std::string& labels) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (Entry* existing = find(Kind::Callback, name, labels)) {
+        existing->sample = std::move(sample);
+        return;
+    }
+    Entry& entry = add(Kind::Callback, name, help, labels);
+    entry.sample = std::move(sample);
+}
+
+namespace {
+
+void appendNumber(std::string& out, double value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.10g", value);
+    out += buffer;
+}
+
+void appendSeries(std::string& out, const std::string& name, const char* suffix,
+                  const std::string& labels, const char* extraLabel = nullptr) {
+    out += name;
+    out += suffix;
+    if (!labels.empty() || extraLabel) {
+        out += '{';
+        out += labels;
+        if (extraLabel) {
+            if (!labels.empty()) out += ',';
+            out += extraLabel;
+        }
+        out += '}';
+    }
+    out += ' ';
+}
+
+} // namespace
+
+std::string MetricsRegistry::renderPrometheus() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string out;
+    out.reserve(entries_.size() * 128);
+    
+    // Series sharing a name are emitted together under one HELP/TYPE header
+    std::set<std::string> emitted;
+    for (const auto& first : entries_) {
+        if (!emitted.insert(first.name).second) {
+            continue;
+        }
+        out += "# HELP " + first.name + " " + first.help + "\n";
+        const char* type = first.kind == Kind::Counter ? "counter"
+                         : first.kind == Kind::Histogram ? "histogram" : "gauge";
+        out += "# TYPE " + first.name + " " + type + "\n";
+        
+        for (const auto& entry : entries_) {
+            if (entry.name != first.name) {
+                continue;
+            }
+            switch (entry.kind) {
+                case Kind::Counter:
+                    appendSeries(out, entry.name, "", entry.labels);
+                    out += std::to_string(entry.counter->value());
+                    out += '\n';
+                    break;
+                case Kind::Gauge:
+                    appendSeries(out, entry.name, "", entry.labels);
+                    appendNumber(out, entry.gauge->value());
+                    out += '\n';
+                    break;
+                case Kind::Callback:
+                    appendSeries(out, entry.name, "", entry.labels);
+                    appendNumber(out, entry.sample ? entry.sample() : 0.0);
+                    out += '\n';
+                    break;
+                case Kind::Histogram: {
+                    // Export one cumulative bucket per power of two, always
+                    // the same set so every series has a continuous history.
+                    // The top group also holds saturated values and is only
+                    // covered by +Inf.
+                    const Histogram& h = *entry.histogram;
+                    uint64_t cumulative = 0;
+                    for (int i = 0; i < Histogram::kBucketCount - Histogram::kSubBuckets; ++i) {
+                        cumulative += h.bucketCount(i);
+                        if ((i + 1) % Histogram::kSubBuckets != 0) {
+                            continue;
+                        }
+                        std::string le = "le=\"";
+                        char buffer[32];
+                        snprintf(buffer, sizeof(buffer), "%.6g",
+                                 static_cast<double>(Histogram::bucketUpperBound(i)) * h.unitScale());
+                        le += buffer;
+                        le += '"';
+                        appendSeries(out, entry.name, "_bucket", entry.labels, le.c_str());
+                        out += std::to_string(cumulative);
+                        out += '\n';
+                    }
+                    for (int i = Histogram::kBucketCount - Histogram::kSubBuckets; i < Histogram::kBucketCount; ++i) {
+                        cumulative += h.bucketCount(i);
+                    }
+                    appendSeries(out, entry.name, "_bucket", entry.labels, "le=\"+Inf\"");
+                    out += std::to_string(cumulative);
+                    out += '\n';
+                    appendSeries(out, entry.name, "_sum", entry.labels);
+                    appendNumber(out, static_cast<double>(h.sum()) * h.unitScale());
+                    out += '\n';
+                    appendSeries(out, entry.name, "_count", entry.labels);
+                    out += std::to_string(cumulative);
+                    out += '\n';
+                    break;
+                }
+            }
+        }
+    }
+    return out;
+}
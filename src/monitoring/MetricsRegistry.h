@@ -0,0 +1,157 @@
+#ifndef METRICS_REGISTRY_H
+#define METRICS_REGISTRY_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Monotonic counter. inc() is a single relaxed fetch_add.
+class Counter {
+public:
+    void inc(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+    
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+// Point-in-time value. set() is a single relaxed store.
+class Gauge {
+public:
+    void set(double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        bits_.store(bits, std::memory_order_relaxed);
+    }
+    double value() const {
+        uint64_t bits = bits_.load(std::memory_order_relaxed);
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+    
+private:
+    std::atomic<uint64_t> bits_{0};
+};
+
+// Log-linear (HDR-style) histogram over non-negative integer samples.
+// Each power of two is split into kSubBuckets linear buckets, so any
+// recorded value is resolved to within 1/kSubBuckets (12.5%) of itself.
+// record() is three relaxed fetch_adds and no branches on shared state.
+class Histogram {
+public:
+    static constexpr int kSubBucketBits = 3;
+    static constexpr int kSubBuckets = 1 << kSubBucketBits;
+    static constexpr int kMaxExponent = 40;     // Values saturate at 2^40
+    static constexpr int kBucketCount = (kMaxExponent - kSubBucketBits + 2) * kSubBuckets;
+    
+    // unitScale converts recorded units to the exported unit
+    // (e.g. 1e-6 to record microseconds and export seconds)
+    explicit Histogram(double unitScale = 1.0) : unitScale_(unitScale) {}
+    
+    void record(uint64_t value) {
+        buckets_[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+    }
+    
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+    double unitScale() const { return unitScale_; }
+    
+    // Approximate value at quantile q (0..1) in recorded units
+    uint64_t quantile(double q) const;
+    
+    // Upper bound (inclusive) of bucket i in recorded units
+    static uint64_t bucketUpperBound(int index);
+    uint64_t bucketCount(int index) const { return buckets_[index].load(std::memory_order_relaxed); }
+    
+    static int bucketIndex(uint64_t value) {
+        if (value < static_cast<uint64_t>(kSubBuckets)) {
+            return static_cast<int>(value);
+        }
+        int msb = 63 - __builtin_clzll(value);
+        if (msb > kMaxExponent) {
+            return kBucketCount - 1;
+        }
+        int shift = msb - kSubBucketBits;
+        int sub = static_cast<int>((value >> shift) & (kSubBuckets - 1));
+        return (shift + 1) * kSubBuckets + sub;
+    }
+    
+private:
+    double unitScale_;
+    std::atomic<uint64_t> buckets_[kBucketCount] = {};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+};
+
+// Records elapsed microseconds into a histogram when it goes out of scope
+class ScopedLatency {
+public:
+    explicit ScopedLatency(Histogram& histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() {
+        histogram_.record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start_).count()));
+    }
+    
+private:
+    Histogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Process-wide metric registry rendered in Prometheus text format.
+// Registration takes a mutex and is meant for startup; the returned
+// references stay valid for the life of the process and are updated
+// without locks. Registering the same name and labels twice returns the
+// existing metric.
+class MetricsRegistry {
+public:
+    static MetricsRegistry& getInstance();
+    
+    // labels uses Prometheus syntax without braces, e.g. "stage=\"ocr\""
+    Counter& counter(const std::string& name, const std::string& help, const std::string& labels = "");
+    Gauge& gauge(const std::string& name, const std::string& help, const std::string& labels = "");
+    Histogram& histogram(const std::string& name, const std::string& help,
+                         const std::string& labels = "", double unitScale = 1.0);
+    
+    // Gauge whose value is sampled at scrape time (e.g. a queue depth)
+    void gaugeCallback(const std::string& name, const std::string& help,
+                       std::function<double()> sample, const std::string& labels = "");
+    
+    // Prometheus text exposition format (version 0.0.4)
+    std::string renderPrometheus() const;
+    
+private:
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+    
+    enum class Kind { Counter, Gauge, Histogram, Callback };
+    
+    struct Entry {
+        Kind kind;
+        std::string name;
+        std::string help;
+        std::string labels;
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+        std::function<double()> sample;
+    };
+    
+    Entry* find(Kind kind, const std::string& name, const std::string& labels);
+    Entry& add(Kind kind, const std::string& name, const std::string& help, const std::string& labels);
+    
+    mutable std::mutex mutex_;
+    std::deque<Entry> entries_;
+};
+
+#endif // METRICS_REGISTRY_H
@@ -0,0 +1,198 @@
+#include "MetricsServer.h"
+#include "MetricsRegistry.h"
+#include "../utils/Logger.h"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    constexpr int kPollIntervalMs = 250;
+    constexpr int kClientTimeoutMs = 1000;
+    constexpr size_t kMaxRequestSize = 4096;
+    
+    bool sendAll(int fd, const char* data, size_t length) {
+        while (length > 0) {
+            ssize_t written = ::send(fd, data, length, MSG_NOSIGNAL);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                return false;
+            }
+            data += written;
+            length -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+    
+    void sendResponse(int fd, const char* status, const char* contentType, const std::string& body) {
+        std::string header = std::string("HTTP/1.0 ") + status + "\r\n"
+                           + "Content-Type: " + contentType + "\r\n"
+                           + "Content-Length: " + std::to_string(body.size()) + "\r\n"
+                           + "Connection: close\r\n\r\n";
+        if (sendAll(fd, header.data(), header.size())) {
+            sendAll(fd, body.data(), body.size());
+        }
+    }
+}
+
+MetricsServer& MetricsServer::getInstance() {
+    static MetricsServer instance;
+    return instance;
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start(const std::string& bindAddress, int port) {
+    if (running_) {
+        return true;
+    }
+    
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG_ERROR("Metrics server: socket() failed: " + std::string(strerror(errno)));
+        return false;
+    }
+    
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (inet_pton(AF_INET, bindAddress.c_str(), &addr.sin_addr) != 1) {
+        LOG_ERROR("Metrics server: invalid bind address " + bindAddress);
+        close(fd);
+        return false;
+    }
+    
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+        LOG_ERROR("Metrics server: cannot listen on " + bindAddress + ":" + std::to_string(port) +
+                  ": " + strerror(errno));
+        close(fd);
+        return false;
+    }
+    
+    listenFd_ = fd;
+    stop_ = false;
+    running_ = true;
+    thread_ = std::thread(&MetricsServer::serveLoop, this);
+    LOG_INFO("Metrics available at http://" + bindAddress + ":" + std::to_string(port) + "/metrics");
+    return true;
+}
+
+bool MetricsServer::startUnix(const std::string& socketPath) {
+    if (running_) {
+        return true;
+    }
+    
+    sockaddr_un addr{};
+    if (socketPath.size() >= sizeof(addr.sun_path)) {
+        LOG_ERROR("Metrics server: socket path too long: " + socketPath);
+        return false;
+    }
+    
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        LOG_ERROR("Metrics server: socket() failed: " + std::string(strerror(errno)));
+        return false;
+    }
+    
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, socketPath.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(socketPath.c_str());
+    
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || listen(fd, 8) < 0) {
+        LOG_ERROR("Metrics server: cannot listen on " + socketPath + ": " + strerror(errno));
+        close(fd);
+        return false;
+    }
+    
+    listenFd_ = fd;
+    socketPath_ = socketPath;
+    stop_ = false;
+    running_ = true;
+    thread_ = std::thread(&MetricsServer::serveLoop, this);
+    LOG_INFO("Metrics available on unix socket " + socketPath);
+    return true;
+}
+
+void MetricsServer::stop() {
+    stop_ = true;
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    if (listenFd_ >= 0) {
+        close(listenFd_);
+        listenFd_ = -1;
+    }
+    if (!socketPath_.empty()) {
+        unlink(socketPath_.c_str());
+        socketPath_.clear();
+    }
+    running_ = false;
+}
+
+void MetricsServer::serveLoop() {
+    while (!stop_.load()) {
+        pollfd pfd{listenFd_, POLLIN, 0};
+        int ready = poll(&pfd, 1, kPollIntervalMs);
+        if (ready <= 0) {
+            continue;
+        }
+        
+        int clientFd = accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (clientFd < 0) {
+            continue;
+        }
+        handleClient(clientFd);
+        close(clientFd);
+    }
+}
+
+void MetricsServer::handleClient(int clientFd) {
+    // Read until the end of the request headers; a scraper sends only a GET
+    char request[kMaxRequestSize];
+    size_t length = 0;
+    while (length < sizeof(request) - 1) {
+        pollfd pfd{clientFd, POLLIN, 0};
+        if (poll(&pfd, 1, kClientTimeoutMs) <= 0) {
+            return;
+        }
+        ssize_t n = ::recv(clientFd, request + length, sizeof(request) - 1 - length, 0);
+        if (n <= 0) {
+            return;
+        }
+        length += static_cast<size_t>(n);
+        request[length] = '\0';
+        if (strstr(request, "\r\n\r\n") || strstr(request, "\n\n")) {
+            break;
+        }
+    }
+    request[length] = '\0';
+    
+    if (strncmp(request, "GET ", 4) != 0) {
+        sendResponse(clientFd, "405 Method Not Allowed", "text/plain", "Method not allowed\n");
+        return;
+    }
+    
+    const char* path = request + 4;
+    size_t pathLength = strcspn(path, " ?\r\n");
+    std::string target(path, pathLength);
+    
+    if (target == "/metrics") {
+        sendResponse(clientFd, "200 OK", "text/plain; version=0.0.4; charset=utf-8",
+                     MetricsRegistry::getInstance().renderPrometheus());
+    } else if (target == "/" || target == "/health") {
+        sendResponse(clientFd, "200 OK", "text/plain", "OK\n");
+    } else {
+        sendResponse(clientFd, "404 Not Found", "text/plain", "Not found\n");
+    }
+}
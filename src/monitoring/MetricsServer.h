@@ -0,0 +1,38 @@
+#ifndef METRICS_SERVER_H
+#define METRICS_SERVER_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+// Minimal HTTP/1.0 listener serving MetricsRegistry in Prometheus text
+// format on GET /metrics. Binds a loopback TCP port, or a Unix domain
+// socket when a socket path is given. One request per connection, handled
+// on a single background thread so scrapes never touch the pipeline threads.
+class MetricsServer {
+public:
+    static MetricsServer& getInstance();
+    
+    bool start(const std::string& bindAddress, int port);
+    bool startUnix(const std::string& socketPath);
+    void stop();
+    
+    bool isRunning() const { return running_.load(); }
+    
+private:
+    MetricsServer() = default;
+    ~MetricsServer();
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+    
+    void serveLoop();
+    void handleClient(int clientFd);
+    
+    int listenFd_ = -1;
+    std::string socketPath_;
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stop_{false};
+};
+
+#endif // METRICS_SERVER_H
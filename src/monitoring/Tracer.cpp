@@ -0,0 +1,136 @@
+#include "Tracer.h"
+#include "../utils/Logger.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+    thread_local uint64_t tlsFrameId = 0;
+    
+    // Escape a span or thread name for a JSON string literal
+    void writeJsonString(FILE* out, const char* text) {
+        fputc('"', out);
+        for (const char* p = text; *p; ++p) {
+            unsigned char c = static_cast<unsigned char>(*p);
+            if (c == '"' || c == '\\') {
+                fputc('\\', out);
+                fputc(c, out);
+            } else if (c < 0x20) {
+                fprintf(out, "\\u%04x", c);
+            } else {
+                fputc(c, out);
+            }
+        }
+        fputc('"', out);
+    }
+}
+
+Tracer& Tracer::getInstance() {
+    static Tracer instance;
+    return instance;
+}
+
+void Tracer::setBufferSize(size_t spansPerThread) {
+    bufferSize_.store(spansPerThread > 0 ? spansPerThread : 1, std::memory_order_relaxed);
+}
+
+void Tracer::setFrame(uint64_t frameId) {
+    tlsFrameId = frameId;
+}
+
+Tracer::ThreadBuffer& Tracer::localBuffer() {
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer) {
+        buffer = std::make_shared<ThreadBuffer>();
+        buffer->tid = static_cast<int>(syscall(SYS_gettid));
+        buffer->spans.resize(bufferSize_.load(std::memory_order_relaxed));
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers_.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void Tracer::setThreadName(const std::string& name) {
+    ThreadBuffer& buffer = localBuffer();
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffer.threadName = name;
+}
+
+void Tracer::record(const char* name, int64_t startNs, int64_t durationNs) {
+    ThreadBuffer& buffer = localBuffer();
+    uint64_t index = buffer.written.load(std::memory_order_relaxed);
+    buffer.spans[index % buffer.spans.size()] = TraceSpan{name, startNs, durationNs, tlsFrameId};
+    buffer.written.store(index + 1, std::memory_order_release);
+}
+
+bool Tracer::dump(const std::string& path) {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffers = buffers_;
+    }
+    
+    FILE* out = fopen(path.c_str(), "w");
+    if (out == nullptr) {
+        LOG_ERROR("Cannot write trace file: " + path);
+        return false;
+    }
+    
+    const int pid = static_cast<int>(getpid());
+    size_t spanCount = 0;
+    bool first = true;
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", out);
+    
+    for (const auto& buffer : buffers) {
+        std::string threadName;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            threadName = buffer->threadName;
+        }
+        if (!threadName.empty()) {
+            fprintf(out, "%s{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":%d,\"tid\":%d,\"args\":{\"name\":",
+                    first ? "" : ",\n", pid, buffer->tid);
+            writeJsonString(out, threadName.c_str());
+            fputs("}}", out);
+            first = false;
+        }
+        
+        // Copy out the live window, then drop anything the writer lapped
+        // while we were copying
+        const size_t capacity = buffer->spans.size();
+        uint64_t end = buffer->written.load(std::memory_order_acquire);
+        uint64_t begin = end > capacity ? end - capacity : 0;
+        std::vector<TraceSpan> spans;
+        spans.reserve(static_cast<size_t>(end - begin));
+        for (uint64_t i = begin; i < end; ++i) {
+            spans.push_back(buffer->spans[i % capacity]);
+        }
+        uint64_t after = buffer->written.load(std::memory_order_acquire);
+        size_t skip = 0;
+        if (after > capacity && after - capacity > begin) {
+            skip = static_cast<size_t>(std::min<uint64_t>(after - capacity - begin, spans.size()));
+        }
+        
+        for (size_t i = skip; i < spans.size(); ++i) {
+            const TraceSpan& span = spans[i];
+            fprintf(out, "%s{\"ph\":\"X\",\"name\":", first ? "" : ",\n");
+            writeJsonString(out, span.name);
+            fprintf(out, ",\"pid\":%d,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}}",
+                    pid, buffer->tid, span.startNs / 1000.0, span.durationNs / 1000.0,
+                    static_cast<unsigned long long>(span.frameId));
+            first = false;
+            ++spanCount;
+        }
+    }
+    
+    fputs("\n]}\n", out);
+    bool ok = fclose(out) == 0;
+    if (ok) {
+        LOG_INFO("Wrote %zu trace spans to %s", spanCount, path.c_str());
+    } else {
+        LOG_ERROR("Failed to write trace file: " + path);
+    }
+    return ok;
+}
@@ -0,0 +1,112 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Compile-time switch: build with -DTRACE_COMPILED=0 to remove every
+// TRACE_* macro from the binary
+#ifndef TRACE_COMPILED
+#define TRACE_COMPILED 1
+#endif
+
+// One completed span ("X" event in the Chrome trace format)
+struct TraceSpan {
+    const char* name;       // Must be a string literal or otherwise outlive the tracer
+    int64_t startNs;
+    int64_t durationNs;
+    uint64_t frameId;
+};
+
+// Records begin/end spans into per-thread ring buffers and writes them out
+// as Chrome/Perfetto trace-event JSON. Recording is a relaxed flag check
+// when disabled and a clock read plus a store into the calling thread's
+// ring when enabled; no locks are taken on the recording path.
+class Tracer {
+public:
+    static Tracer& getInstance();
+    
+    // Spans kept per thread; applies to threads that record after the call
+    void setBufferSize(size_t spansPerThread);
+    
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+    
+    // Tag spans recorded on this thread with a frame number
+    static void setFrame(uint64_t frameId);
+    
+    // Name shown for the calling thread in the trace viewer
+    void setThreadName(const std::string& name);
+    
+    // Append a finished span for the calling thread
+    void record(const char* name, int64_t startNs, int64_t durationNs);
+    
+    // Write all buffered spans as trace-event JSON. Safe to call while other
+    // threads record; spans overwritten during the dump may be skipped.
+    bool dump(const std::string& path);
+    
+    // Ask for a dump at the next frame boundary. Async-signal-safe (SIGUSR1).
+    void requestDump() { dumpRequested_.store(true, std::memory_order_relaxed); }
+    bool consumeDumpRequest() { return dumpRequested_.exchange(false, std::memory_order_relaxed); }
+    
+    static int64_t nowNs() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+    
+private:
+    Tracer() = default;
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+    
+    struct ThreadBuffer {
+        int tid;
+        std::string threadName;
+        std::vector<TraceSpan> spans;
+        std::atomic<uint64_t> written{0};
+    };
+    
+    ThreadBuffer& localBuffer();
+    
+    std::atomic<bool> enabled_{false};
+    std::atomic<bool> dumpRequested_{false};
+    std::atomic<size_t> bufferSize_{16384};
+    
+    // Buffers outlive their threads so spans from finished workers still dump
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+};
+
+// RAII span covering the enclosing scope
+class TraceScope {
+public:
+    explicit TraceScope(const char* name)
+        : name_(name), startNs_(Tracer::getInstance().isEnabled() ? Tracer::nowNs() : 0) {}
+    ~TraceScope() {
+        if (startNs_ != 0) {
+            Tracer::getInstance().record(name_, startNs_, Tracer::nowNs() - startNs_);
+        }
+    }
+    
+private:
+    const char* name_;
+    int64_t startNs_;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#if TRACE_COMPILED
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_FRAME(id) Tracer::setFrame(id)
+#else
+#define TRACE_SCOPE(name) do {} while (0)
+#define TRACE_FRAME(id) do {} while (0)
+#endif
+
+#endif // TRACER_H
@@ -0,0 +1,12 @@
+#ifndef OCR_READING_H
+#define OCR_READING_H
+
+#include <string>
+
+// Value read for one label, with the Tesseract confidence (0-100) of the word
+struct OcrReading {
+    std::string value = "0";
+    float confidence = 0.0f;
+};
+
+#endif // OCR_READING_H
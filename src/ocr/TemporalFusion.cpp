@@ -0,0 +1,236 @@
+#include "TemporalFusion.h"
+#include "../monitoring/MetricsRegistry.h"
+#include "../timeseries/TimeSeriesStore.h"
+
+#include <algorithm>
+
+namespace {
+
+const OcrReading* find(const std::map<std::string, OcrReading>& readings, const char* label) {
+    auto it = readings.find(label);
+    return it != readings.end() ? &it->second : nullptr;
+}
+
+} // namespace
+
+SlidingMedian::SlidingMedian(size_t window) {
+    resize(window);
+}
+
+void SlidingMedian::resize(size_t window) {
+    ring_.assign(std::max<size_t>(1, window), -1);
+    next_ = 0;
+    filled_ = 0;
+    sorted_.clear();
+    mid_ = sorted_.end();
+}
+
+void SlidingMedian::push(int value) {
+    if (filled_ == ring_.size() && ring_[next_] >= 0) {
+        erase(ring_[next_]);
+    }
+    ring_[next_] = value;
+    next_ = (next_ + 1) % ring_.size();
+    filled_ = std::min(filled_ + 1, ring_.size());
+    if (value >= 0) {
+        insert(value);
+    }
+}
+
+// mid_ always points at index (n - 1) / 2 of the n sorted samples
+void SlidingMedian::insert(int value) {
+    sorted_.insert(value);
+    size_t n = sorted_.size();
+    if (n == 1) {
+        mid_ = sorted_.begin();
+        return;
+    }
+    // Equal values are inserted after existing ones, i.e. after mid_
+    if (value < *mid_) {
+        if (n % 2 == 0) {
+            --mid_;
+        }
+    } else if (n % 2 == 1) {
+        ++mid_;
+    }
+}
+
+void SlidingMedian::erase(int value) {
+    size_t n = sorted_.size();
+    if (n == 1) {
+        sorted_.clear();
+        mid_ = sorted_.end();
+        return;
+    }
+    if (value == *mid_) {
+        auto victim = mid_;
+        if (n % 2 == 0) {
+            ++mid_;
+        } else {
+            --mid_;
+        }
+        sorted_.erase(victim);
+    } else if (value < *mid_) {
+        sorted_.erase(sorted_.lower_bound(value));
+        if (n % 2 == 0) {
+            ++mid_;
+        }
+    } else {
+        sorted_.erase(sorted_.lower_bound(value));
+        if (n % 2 == 1) {
+            --mid_;
+        }
+    }
+}
+
+std::string FusedVitals::hrText() const {
+    return hr.value >= 0 ? std::to_string(hr.value) : "0";
+}
+
+std::string FusedVitals::spo2Text() const {
+    return spo2.value >= 0 ? std::to_string(spo2.value) : "0";
+}
+
+std::string FusedVitals::abpText() const {
+    if (systolic.value < 0 || diastolic.value < 0) {
+        return "0";
+    }
+    return std::to_string(systolic.value) + "/" + std::to_string(diastolic.value);
+}
+
+TemporalFusion::TemporalFusion(const std::string& source) {
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    const char* help = "OCR reads dropped for being outside the validation ranges";
+    hr_.rejected = &metrics.counter("vitalsign_fusion_rejected_reads_total", help, "field=\"hr\"");
+    spo2_.rejected = &metrics.counter("vitalsign_fusion_rejected_reads_total", help, "field=\"spo2\"");
+    systolic_.rejected = &metrics.counter("vitalsign_fusion_rejected_reads_total", help, "field=\"abp\"");
+    diastolic_.rejected = systolic_.rejected;
+
+    const char* stabilityHelp = "Share of the fusion window's confidence agreeing with the fused value";
+    std::string prefix = source.empty() ? "" : "source=\"" + source + "\",";
+    hr_.stability = &metrics.gauge("vitalsign_fusion_stability", stabilityHelp, prefix + "field=\"hr\"");
+    spo2_.stability = &metrics.gauge("vitalsign_fusion_stability", stabilityHelp, prefix + "field=\"spo2\"");
+    systolic_.stability = &metrics.gauge("vitalsign_fusion_stability", stabilityHelp,
+                                         prefix + "field=\"systolic\"");
+    diastolic_.stability = &metrics.gauge("vitalsign_fusion_stability", stabilityHelp,
+                                          prefix + "field=\"diastolic\"");
+}
+
+void TemporalFusion::Field::resize(size_t window) {
+    window = std::max<size_t>(1, window);
+    median.resize(window);
+    values.assign(window, -1);
+    weights.assign(window, 0.0f);
+    next = 0;
+    votes.clear();
+    ranked.clear();
+    totalWeight = 0.0f;
+}
+
+// Adjust one value's weight in both views; O(log window)
+void TemporalFusion::Field::addVote(int value, float delta) {
+    auto it = votes.find(value);
+    float weight = delta;
+    if (it != votes.end()) {
+        ranked.erase(std::make_pair(it->second, value));
+        weight += it->second;
+    }
+    if (weight <= 1e-6f) {
+        if (it != votes.end()) {
+            votes.erase(it);
+        }
+        return;
+    }
+    if (it != votes.end()) {
+        it->second = weight;
+    } else {
+        votes.emplace(value, weight);
+    }
+    ranked.insert(std::make_pair(weight, value));
+}
+
+void TemporalFusion::Field::push(int value, float weight) {
+    int old = values[next];
+    if (old >= 0) {
+        addVote(old, -weights[next]);
+        totalWeight -= weights[next];
+    }
+    values[next] = value;
+    weights[next] = value >= 0 ? weight : 0.0f;
+    next = (next + 1) % values.size();
+    if (value >= 0) {
+        addVote(value, weight);
+        totalWeight += weight;
+    }
+    if (votes.empty()) {
+        totalWeight = 0.0f;
+    }
+    median.push(value);
+}
+
+FusedField TemporalFusion::Field::fuse(int tolerance) const {
+    FusedField fused;
+    if (votes.empty() || totalWeight <= 0.0f) {
+        return fused;
+    }
+
+    const std::pair<float, int>& winner = *ranked.rbegin();
+    fused.value = winner.first * 2.0f >= totalWeight ? winner.second : median.median();
+
+    float agreeing = 0.0f;
+    for (auto it = votes.lower_bound(fused.value - tolerance);
+         it != votes.end() && it->first <= fused.value + tolerance; ++it) {
+        agreeing += it->second;
+    }
+    fused.stability = std::min(1.0f, agreeing / totalWeight);
+    return fused;
+}
+
+void TemporalFusion::pushRead(Field& field, int value, float confidence, int min, int max) {
+    if (value >= 0 && (value < min || value > max)) {
+        field.rejected->inc();
+        value = -1;
+    }
+    // Tesseract confidence 0-100; a read it is unsure of still counts a little
+    field.push(value, std::max(confidence, 1.0f) / 100.0f);
+}
+
+FusedVitals TemporalFusion::update(const std::map<std::string, OcrReading>& readings, const ConfigSnapshot& cfg) {
+    size_t window = static_cast<size_t>(std::max(1, cfg.fusion.window));
+    size_t spo2Window = static_cast<size_t>(std::max(1, cfg.vitalSigns.spo2HistorySize));
+    if (window != window_) {
+        hr_.resize(window);
+        systolic_.resize(window);
+        diastolic_.resize(window);
+        window_ = window;
+    }
+    if (spo2Window != spo2Window_) {
+        spo2_.resize(spo2Window);
+        spo2Window_ = spo2Window;
+    }
+
+    const ValidationRanges& ranges = cfg.vitalSigns.validation;
+    const OcrReading* hr = find(readings, "HR");
+    const OcrReading* spo2 = find(readings, "SpO2");
+    const OcrReading* abp = find(readings, "ABP");
+
+    VitalSample read = VitalSample::fromText(hr ? hr->value : std::string(), spo2 ? spo2->value : std::string(),
+                                             abp ? abp->value : std::string());
+    pushRead(hr_, read.hr, hr ? hr->confidence : 0.0f, ranges.hr_min, ranges.hr_max);
+    pushRead(spo2_, read.spo2, spo2 ? spo2->confidence : 0.0f, ranges.spo2_min, ranges.spo2_max);
+    float abpConfidence = abp ? abp->confidence : 0.0f;
+    pushRead(systolic_, read.systolic, abpConfidence, ranges.abp_systolic_min, ranges.abp_systolic_max);
+    pushRead(diastolic_, read.diastolic, abpConfidence, ranges.abp_diastolic_min, ranges.abp_diastolic_max);
+
+    int tolerance = std::max(0, cfg.fusion.tolerance);
+    FusedVitals fused;
+    fused.hr = hr_.fuse(tolerance);
+    fused.spo2 = spo2_.fuse(tolerance);
+    fused.systolic = systolic_.fuse(tolerance);
+    fused.diastolic = diastolic_.fuse(tolerance);
+    hr_.stability->set(fused.hr.stability);
+    spo2_.stability->set(fused.spo2.stability);
+    systolic_.stability->set(fused.systolic.stability);
+    diastolic_.stability->set(fused.diastolic.stability);
+    return fused;
+}
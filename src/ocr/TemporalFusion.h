@@ -0,0 +1,108 @@
+#ifndef TEMPORAL_FUSION_H
+#define TEMPORAL_FUSION_H
+
+#include "OcrReading.h"
+#include "../config/ConfigSnapshot.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+class Counter;
+class Gauge;
+
+// Median of the last N integer samples; slots may be empty (missed reads).
+// push() is O(log N): the median iterator is moved by at most one step per
+// insert or evict instead of being searched for.
+class SlidingMedian {
+public:
+    explicit SlidingMedian(size_t window = 5);
+
+    void resize(size_t window);             // Clears the samples
+    void push(int value);                   // value < 0 = missed read
+    bool empty() const { return sorted_.empty(); }
+    size_t size() const { return sorted_.size(); }
+    int median() const { return *mid_; }    // Lower median; only when !empty()
+
+private:
+    void insert(int value);
+    void erase(int value);
+
+    std::vector<int> ring_;
+    size_t next_ = 0;
+    size_t filled_ = 0;
+    std::multiset<int> sorted_;
+    std::multiset<int>::iterator mid_;
+};
+
+// Fused value of one field; value < 0 when the window holds no valid read
+struct FusedField {
+    int value = -1;
+    float stability = 0.0f;     // Share of the window's confidence agreeing with value
+};
+
+struct FusedVitals {
+    FusedField hr;
+    FusedField spo2;
+    FusedField systolic;
+    FusedField diastolic;
+
+    // Same string form as VitalSignExtractor output ("0" = no value)
+    std::string hrText() const;
+    std::string spo2Text() const;
+    std::string abpText() const;
+};
+
+// Per-source temporal fusion of OCR reads. Each field keeps the last
+// fusion.window reads (vital_signs.spo2_history_size for SpO2); reads outside
+// the validation ranges are dropped before they enter the window. The fused
+// value is the confidence-weighted vote winner when it holds at least half
+// of the window's weight, otherwise the sliding median. Each field's
+// stability is exported as vitalsign_fusion_stability. Not thread-safe;
+// one instance per source, fed in frame order.
+class TemporalFusion {
+public:
+    // source labels the stability gauges; empty for single-source setups
+    explicit TemporalFusion(const std::string& source = "");
+
+    FusedVitals update(const std::map<std::string, OcrReading>& readings, const ConfigSnapshot& cfg);
+
+private:
+    // (weight, value) ordered so the last entry is the heaviest value, the
+    // lowest one on ties
+    struct ByWeight {
+        bool operator()(const std::pair<float, int>& a, const std::pair<float, int>& b) const {
+            return a.first != b.first ? a.first < b.first : a.second > b.second;
+        }
+    };
+
+    struct Field {
+        Counter* rejected = nullptr;
+        Gauge* stability = nullptr;
+        SlidingMedian median;
+        std::vector<int> values;        // Ring of reads, -1 = missed
+        std::vector<float> weights;
+        size_t next = 0;
+        std::map<int, float> votes;     // Weight per distinct value in the window
+        std::set<std::pair<float, int>, ByWeight> ranked;   // Same votes, by weight
+        float totalWeight = 0.0f;
+
+        void resize(size_t window);
+        void push(int value, float weight);
+        void addVote(int value, float delta);
+        FusedField fuse(int tolerance) const;
+    };
+
+    void pushRead(Field& field, int value, float confidence, int min, int max);
+
+    Field hr_;
+    Field spo2_;
+    Field systolic_;
+    Field diastolic_;
+    size_t window_ = 0;
+    size_t spo2Window_ = 0;
+};
+
+#endif // TEMPORAL_FUSION_H
@@ -0,0 +1,150 @@
+#include "VitalSignExtractor.h"
+#include "../monitoring/MetricsRegistry.h"
+#include "../monitoring/Tracer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <regex>
+
+namespace {
+
+// Define key label and value patterns
+const std::regex spo2_pattern(R"(\bsp[o0]2\b)", std::regex_constants::icase);
+const std::regex bp_pattern(R"(^\d{2,3}/\d{2,3}$)");
+const std::regex number_pattern(R"(^\d{2,3}$)");
+
+Histogram& ocrConfidence = MetricsRegistry::getInstance().histogram(
+    "vitalsign_ocr_word_confidence", "Tesseract per-word confidence (0-100)");
+
+// Struct to store detected text and position
+struct DetectedText {
+    std::string word;
+    int x, y, w, h;
+    float conf;
+};
+
+// Function to calculate Euclidean distance
+double calculateDistance(int x1, int y1, int x2, int y2) {
+    return std::sqrt(std::pow(x1 - x2, 2) + std::pow(y1 - y2, 2));
+}
+
+// Function to find the closest number to a label
+OcrReading findClosestNumber(const DetectedText& labelData, const std::vector<DetectedText>& detectedNumbers) {
+    OcrReading closest;
+    double minDistance = std::numeric_limits<double>::max();
+
+    for (const auto& num : detectedNumbers) {
+        double distance = calculateDistance(labelData.x, labelData.y, num.x, num.y);
+        if (distance < minDistance) {
+            minDistance = distance;
+            closest.value = num.word;
+            closest.confidence = num.conf;
+        }
+    }
+    return closest;
+}
+
+} // namespace
+
+VitalSignExtractor::~VitalSignExtractor() {
+    end();
+}
+
+bool VitalSignExtractor::init(const std::string& language, const std::vector<std::string>& labels,
+                              const std::string& defaultSpO2) {
+    labels_ = labels;
+    lastSpO2Value_ = defaultSpO2;
+    if (ocr_.Init(NULL, language.c_str())) {
+        return false;
+    }
+    initialized_ = true;
+    return true;
+}
+
+void VitalSignExtractor::end() {
+    if (initialized_) {
+        ocr_.End();
+        initialized_ = false;
+    }
+}
+
+std::map<std::string, std::string> VitalSignExtractor::processFrame(const cv::Mat& frame, int confidenceThreshold) {
+    return processFrame(frame, confidenceThreshold, lastSpO2Value_);
+}
+
+// Function to process the frame and extract values
+std::map<std::string, std::string> VitalSignExtractor::processFrame(const cv::Mat& frame, int confidenceThreshold,
+                                                                    std::string& lastSpO2) {
+    std::map<std::string, std::string> extractedValues;
+    std::vector<DetectedText> detectedNumbers;     // Plain integers: HR, SpO2
+    std::vector<DetectedText> detectedPressures;   // Systolic/diastolic: ABP
+    std::map<std::string, DetectedText> detectedLabels;
+    TRACE_SCOPE("processFrame");
+
+    // Initialize detected labels
+    for (const auto& label : labels_) {
+        detectedLabels[label] = {"", -1, -1, -1, -1, 0.0f};
+    }
+
+    // Set Tesseract OCR image
+    ocr_.SetImage(frame.data, frame.cols, frame.rows, 3, frame.step);
+    ocr_.Recognize(0);
+
+    // Get detected text with position data
+    tesseract::ResultIterator* ri = ocr_.GetIterator();
+    if (ri != nullptr) {
+        do {
+            const char* text = ri->GetUTF8Text(tesseract::RIL_WORD);
+            float conf = ri->Confidence(tesseract::RIL_WORD);
+            int x, y, w, h;
+            
+            if (text) {
+                ocrConfidence.record(conf > 0.0f ? static_cast<uint64_t>(conf) : 0);
+            }
+
+            if (text && conf > confidenceThreshold) {
+                ri->BoundingBox(tesseract::RIL_WORD, &x, &y, &w, &h);
+                DetectedText detected{text, x, y, w, h, conf};
+
+                // Check for labels
+                if (std::regex_search(detected.word, spo2_pattern)) {
+                    detectedLabels["SpO2"] = detected;
+                } else if (std::find(labels_.begin(), labels_.end(), detected.word) != labels_.end()) {
+                    detectedLabels[detected.word] = detected;
+                } else if (std::regex_match(detected.word, bp_pattern) || detected.word.find("/") != std::string::npos) {
+                    detectedPressures.push_back(detected);
+                } else if (std::regex_match(detected.word, number_pattern)) {
+                    detectedNumbers.push_back(detected);
+                }
+            }
+            delete[] text;
+        } while (ri->Next(tesseract::RIL_WORD));
+        delete ri;
+    }
+
+    // Extract values for each label
+    lastReadings_.clear();
+    for (const auto& label : labels_) {
+        OcrReading reading = findClosestNumber(detectedLabels[label],
+                                               label == "ABP" ? detectedPressures : detectedNumbers);
+        extractedValues[label] = reading.value;
+        lastReadings_[label] = std::move(reading);
+    }
+
+    // ABP format validation
+    if (!std::regex_match(extractedValues["ABP"], bp_pattern)) {
+        extractedValues["HR"] = "0";
+        extractedValues["SpO2"] = "0";
+        extractedValues["ABP"] = "0";
+    } else {
+        // Use last known SpO₂ value if missing
+        if (extractedValues["SpO2"] == "0" || extractedValues["SpO2"].empty()) {
+            extractedValues["SpO2"] = lastSpO2;
+        } else {
+            lastSpO2 = extractedValues["SpO2"];
+        }
+    }
+
+    return extractedValues;
+}
@@ -0,0 +1,47 @@
+#ifndef VITAL_SIGN_EXTRACTOR_H
+#define VITAL_SIGN_EXTRACTOR_H
+
+#include "OcrReading.h"
+
+#include <opencv2/core.hpp>
+#include <tesseract/baseapi.h>
+#include <map>
+#include <string>
+#include <vector>
+
+// Reads HR/SpO2/ABP off a monitor frame with Tesseract. Each instance owns
+// its own TessBaseAPI and (unless the caller supplies one) SpO2 carry-over
+// state, so one instance must only be used from one thread at a time.
+class VitalSignExtractor {
+public:
+    VitalSignExtractor() = default;
+    ~VitalSignExtractor();
+    VitalSignExtractor(const VitalSignExtractor&) = delete;
+    VitalSignExtractor& operator=(const VitalSignExtractor&) = delete;
+    
+    // Initialize Tesseract; returns false if the language data cannot be loaded
+    bool init(const std::string& language, const std::vector<std::string>& labels,
+              const std::string& defaultSpO2);
+    void end();
+    
+    // Extract a value for every label; words below confidenceThreshold are ignored
+    std::map<std::string, std::string> processFrame(const cv::Mat& frame, int confidenceThreshold);
+    
+    // Same, but the SpO2 carry-over lives in the caller's lastSpO2 so one
+    // pooled extractor can serve several sources
+    std::map<std::string, std::string> processFrame(const cv::Mat& frame, int confidenceThreshold,
+                                                    std::string& lastSpO2);
+    
+    // Per-label values of the last processFrame() before the ABP check and
+    // SpO2 carry-over, for callers that validate and smooth fields themselves
+    const std::map<std::string, OcrReading>& lastReadings() const { return lastReadings_; }
+    
+private:
+    tesseract::TessBaseAPI ocr_;
+    bool initialized_ = false;
+    std::vector<std::string> labels_;
+    std::string lastSpO2Value_;
+    std::map<std::string, OcrReading> lastReadings_;
+};
+
+#endif // VITAL_SIGN_EXTRACTOR_H
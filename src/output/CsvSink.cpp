@@ -0,0 +1,318 @@
+#include "CsvSink.h"
+#include "../monitoring/MetricsRegistry.h"
+#include "../utils/Logger.h"
+#include "../utils/TimestampFormatter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <filesystem>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+Counter& bytesWritten = MetricsRegistry::getInstance().counter(
+    "vitalsign_csv_bytes_total", "Bytes written to the CSV output");
+Counter& flushes = MetricsRegistry::getInstance().counter(
+    "vitalsign_csv_flushes_total", "CSV buffer flushes");
+Counter& rotations = MetricsRegistry::getInstance().counter(
+    "vitalsign_csv_rotations_total", "CSV files rotated");
+Counter& writeErrors = MetricsRegistry::getInstance().counter(
+    "vitalsign_csv_write_errors_total", "CSV flushes that failed; their rows are lost");
+
+const char* kHeader = "Time,HR,SpO2,ABP,ECG_Classification,ECG_Confidence\n";
+const char* kSourceHeader = "Time,Source,HR,SpO2,ABP,ECG_Classification,ECG_Confidence\n";
+
+bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Start of the local day after time
+std::chrono::system_clock::time_point nextMidnight(std::chrono::system_clock::time_point time) {
+    time_t seconds = std::chrono::system_clock::to_time_t(time);
+    struct tm parts;
+    localtime_r(&seconds, &parts);
+    parts.tm_mday += 1;
+    parts.tm_hour = 0;
+    parts.tm_min = 0;
+    parts.tm_sec = 0;
+    parts.tm_isdst = -1;
+    return std::chrono::system_clock::from_time_t(mktime(&parts));
+}
+
+} // namespace
+
+CsvSink::~CsvSink() {
+    close();
+}
+
+bool CsvSink::open(const CsvSinkOptions& options) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closeLocked();
+    options_ = options;
+    options_.maxFileBytes = std::max<size_t>(1, options_.maxFileBytes);
+    // A buffer larger than a file would rotate on every flush
+    if (options_.rotation == CsvRotation::Size) {
+        options_.bufferBytes = std::min(options_.bufferBytes, options_.maxFileBytes);
+    }
+    if (options_.bufferBytes == 0) {
+        options_.bufferBytes = 1;
+    }
+    buffer_.reserve(options_.bufferBytes + 256);
+
+    // A file left over from an earlier day is rotated before appending to it
+    if (options_.rotation == CsvRotation::Daily) {
+        auto now = std::chrono::system_clock::now();
+        struct stat info;
+        if (stat(options_.path.c_str(), &info) == 0 && info.st_size > 0) {
+            auto modified = std::chrono::system_clock::from_time_t(info.st_mtime);
+            if (nextMidnight(modified) <= now) {
+                std::error_code ec;
+                fs::rename(options_.path, datedPath(modified), ec);
+                if (ec) {
+                    LOG_WARN("Could not rotate old CSV file: " + ec.message());
+                }
+            }
+        }
+    }
+    return openFile();
+}
+
+bool CsvSink::openFile() {
+    fs::path dir = fs::path(options_.path).parent_path();
+    std::error_code ec;
+    if (!dir.empty()) {
+        fs::create_directories(dir, ec);
+    }
+
+    fd_ = ::open(options_.path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        LOG_ERROR("Unable to open CSV file for writing: " + options_.path + ": " + strerror(errno));
+        return false;
+    }
+    struct stat info;
+    fileBytes_ = fstat(fd_, &info) == 0 ? static_cast<uint64_t>(info.st_size) : 0;
+    headerBytes_ = 0;
+    if (fileBytes_ == 0) {
+        const char* header = options_.sourceColumn ? kSourceHeader : kHeader;
+        size_t length = strlen(header);
+        if (writeAll(fd_, header, length)) {
+            fileBytes_ = length;
+            headerBytes_ = length;
+        }
+    }
+
+    auto now = std::chrono::system_clock::now();
+    fileStart_ = now;
+    if (options_.rotation == CsvRotation::Daily) {
+        nextRotation_ = nextMidnight(now);
+    }
+    return true;
+}
+
+void CsvSink::write(const CsvRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ < 0) {
+        return;
+    }
+
+    if (record.time >= nextRotation_) {
+        flushLocked();
+        rotateLocked(fileStart_);
+        if (fd_ < 0) {
+            return;
+        }
+        fileStart_ = record.time;
+        nextRotation_ = nextMidnight(record.time);
+    }
+
+    if (buffer_.empty()) {
+        oldestBuffered_ = std::chrono::steady_clock::now();
+    }
+    size_t before = buffer_.size();
+
+    // Format in place: timestamp, fields, then the confidence as "%g",
+    // which matches what the stream output used to print
+    char timeBuf[TimestampFormatter::kBufferSize];
+    TimestampFormatter::formatSeconds(record.time, timeBuf);
+    buffer_.append(timeBuf, TimestampFormatter::kSecondsLength);
+    buffer_ += ',';
+    if (options_.sourceColumn) {
+        buffer_.append(record.sourceId.data(), record.sourceId.size());
+        buffer_ += ',';
+    }
+    buffer_.append(record.hr.data(), record.hr.size());
+    buffer_ += ',';
+    buffer_.append(record.spo2.data(), record.spo2.size());
+    buffer_ += ',';
+    buffer_.append(record.abp.data(), record.abp.size());
+    buffer_ += ',';
+    buffer_.append(record.ecgLabel.data(), record.ecgLabel.size());
+    char confBuf[32];
+    int confLength = snprintf(confBuf, sizeof(confBuf), ",%g\n", record.ecgConfidence);
+    buffer_.append(confBuf, static_cast<size_t>(confLength));
+
+    // Size rotation: a row that would take the file past max_size starts
+    // the next one, after the rows before it are written to this one. A file
+    // holding only its header is never rotated, so an oversized row cannot
+    // churn.
+    if (options_.rotation == CsvRotation::Size && fileBytes_ + buffer_.size() > options_.maxFileBytes &&
+        fileBytes_ + before > headerBytes_) {
+        writeLocked(before);
+        rotateLocked(fileStart_);
+        if (fd_ < 0) {
+            buffer_.clear();
+            return;
+        }
+        oldestBuffered_ = std::chrono::steady_clock::now();
+    }
+
+    if (buffer_.size() >= options_.bufferBytes ||
+        std::chrono::steady_clock::now() - oldestBuffered_ >= std::chrono::milliseconds(options_.flushIntervalMs)) {
+        flushLocked();
+    }
+}
+
+void CsvSink::flushIfDue() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!buffer_.empty() &&
+        std::chrono::steady_clock::now() - oldestBuffered_ >= std::chrono::milliseconds(options_.flushIntervalMs)) {
+        flushLocked();
+    }
+}
+
+void CsvSink::flush() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flushLocked();
+}
+
+void CsvSink::flushLocked() {
+    writeLocked(buffer_.size());
+}
+
+// Write the first length bytes of the buffer (whole rows) and drop them
+void CsvSink::writeLocked(size_t length) {
+    if (fd_ < 0 || length == 0) {
+        return;
+    }
+
+    if (!writeAll(fd_, buffer_.data(), length)) {
+        writeErrors.inc();
+        LOG_ERROR("CSV write failed: " + std::string(strerror(errno)));
+    } else {
+        fileBytes_ += length;
+        bytesWritten.inc(length);
+        flushes.inc();
+        if (options_.sync == CsvSyncPolicy::Flush) {
+            fdatasync(fd_);
+        }
+    }
+    buffer_.erase(0, length);
+}
+
+std::string CsvSink::datedPath(std::chrono::system_clock::time_point fileTime) const {
+    time_t seconds = std::chrono::system_clock::to_time_t(fileTime);
+    struct tm parts;
+    localtime_r(&seconds, &parts);
+    char day[16];
+    strftime(day, sizeof(day), "%Y-%m-%d", &parts);
+
+    fs::path path(options_.path);
+    std::string stem = (path.parent_path() / path.stem()).string();
+    std::string extension = path.extension().string();
+    std::string dated = stem + "." + day + extension;
+    // Never replace an earlier file of the same day
+    for (int n = 1; fs::exists(dated); n++) {
+        dated = stem + "." + day + "-" + std::to_string(n) + extension;
+    }
+    return dated;
+}
+
+// Rename the current file away and open a fresh one; the caller has flushed
+void CsvSink::rotateLocked(std::chrono::system_clock::time_point fileTime) {
+    if (options_.sync != CsvSyncPolicy::None) {
+        fsync(fd_);
+    }
+    ::close(fd_);
+    fd_ = -1;
+
+    std::error_code ec;
+    if (options_.rotation == CsvRotation::Daily) {
+        fs::rename(options_.path, datedPath(fileTime), ec);
+    } else {
+        int keep = options_.maxFiles > 0 ? options_.maxFiles : 1;
+        fs::remove(options_.path + "." + std::to_string(keep), ec);
+        for (int i = keep - 1; i >= 1; i--) {
+            std::string from = options_.path + "." + std::to_string(i);
+            if (fs::exists(from, ec)) {
+                fs::rename(from, options_.path + "." + std::to_string(i + 1), ec);
+            }
+        }
+        fs::rename(options_.path, options_.path + ".1", ec);
+    }
+    if (ec) {
+        LOG_WARN("CSV rotation rename failed: " + ec.message());
+    }
+    rotations.inc();
+    openFile();
+}
+
+void CsvSink::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closeLocked();
+}
+
+void CsvSink::closeLocked() {
+    if (fd_ < 0) {
+        return;
+    }
+    flushLocked();
+    if (options_.sync != CsvSyncPolicy::None) {
+        fsync(fd_);
+    }
+    ::close(fd_);
+    fd_ = -1;
+}
+
+bool CsvSink::parseSyncPolicy(const std::string& name, CsvSyncPolicy& policy) {
+    if (name == "none") {
+        policy = CsvSyncPolicy::None;
+    } else if (name == "rotate") {
+        policy = CsvSyncPolicy::Rotate;
+    } else if (name == "flush") {
+        policy = CsvSyncPolicy::Flush;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool CsvSink::parseRotation(const std::string& name, CsvRotation& rotation) {
+    if (name == "none") {
+        rotation = CsvRotation::None;
+    } else if (name == "size") {
+        rotation = CsvRotation::Size;
+    } else if (name == "daily") {
+        rotation = CsvRotation::Daily;
+    } else {
+        return false;
+    }
+    return true;
+}
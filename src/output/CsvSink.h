@@ -0,0 +1,95 @@
+#ifndef CSV_SINK_H
+#define CSV_SINK_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+// When the sink calls fsync
+enum class CsvSyncPolicy {
+    None,       // Leave it to the OS (a process crash loses at most the buffer)
+    Rotate,     // Before a file is rotated or closed
+    Flush       // After every buffer flush (also bounds loss on power failure)
+};
+
+enum class CsvRotation {
+    None,
+    Size,       // file -> file.1 -> file.2 ... once max_size_mb is reached
+    Daily       // file -> file stem.YYYY-MM-DD.ext at local midnight
+};
+
+struct CsvSinkOptions {
+    std::string path;
+    bool sourceColumn = false;          // Multi-source layout with a Source column
+    size_t bufferBytes = 64 * 1024;     // Flush once this much is buffered
+    int flushIntervalMs = 1000;         // ...or once the oldest buffered row is this old
+    CsvSyncPolicy sync = CsvSyncPolicy::None;
+    CsvRotation rotation = CsvRotation::None;
+    size_t maxFileBytes = 100 * 1024 * 1024;
+    int maxFiles = 10;                  // Size rotation: rotated files kept
+};
+
+// One output row; the views only need to live for the write() call
+struct CsvRecord {
+    std::chrono::system_clock::time_point time;
+    std::string_view sourceId;
+    std::string_view hr;
+    std::string_view spo2;
+    std::string_view abp;
+    std::string_view ecgLabel;
+    float ecgConfidence = 0.0f;
+};
+
+// Buffered CSV writer for the vitals rows. Rows are formatted straight into
+// an in-memory buffer, which is written with one write() call when it fills
+// up or the flush interval passes, so a reader never sees a partial line.
+// The file is opened for append and gets the header only when empty;
+// rotation renames the file away (atomic) and starts a new one, so
+// `tail -F` follows it. Size rotation happens before the row that would
+// overflow the file. Thread-safe.
+class CsvSink {
+public:
+    CsvSink() = default;
+    ~CsvSink();
+    CsvSink(const CsvSink&) = delete;
+    CsvSink& operator=(const CsvSink&) = delete;
+
+    // Closes a file that is already open first. Under size rotation the
+    // buffer is clamped to maxFileBytes.
+    bool open(const CsvSinkOptions& options);
+    bool isOpen() const { return fd_ >= 0; }
+
+    void write(const CsvRecord& record);
+
+    // Write the buffer if the flush interval has passed; call regularly so
+    // rows do not wait for the next write() when processing pauses
+    void flushIfDue();
+    void flush();
+    void close();
+
+    static bool parseSyncPolicy(const std::string& name, CsvSyncPolicy& policy);
+    static bool parseRotation(const std::string& name, CsvRotation& rotation);
+
+private:
+    bool openFile();
+    void flushLocked();
+    void writeLocked(size_t length);
+    void closeLocked();
+    void rotateLocked(std::chrono::system_clock::time_point fileTime);
+    std::string datedPath(std::chrono::system_clock::time_point fileTime) const;
+
+    std::mutex mutex_;
+    CsvSinkOptions options_;
+    int fd_ = -1;
+    std::string buffer_;
+    uint64_t fileBytes_ = 0;
+    uint64_t headerBytes_ = 0;                             // Header written to the current file
+    std::chrono::steady_clock::time_point oldestBuffered_;
+    std::chrono::system_clock::time_point nextRotation_ = std::chrono::system_clock::time_point::max();
+    std::chrono::system_clock::time_point fileStart_;      // Time of the first row of the file
+};
+
+#endif // CSV_SINK_H
@@ -0,0 +1,165 @@
+#include "ShmPublisher.h"
+#include "../monitoring/MetricsRegistry.h"
+#include "../utils/Logger.h"
+#include "../utils/TimestampFormatter.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+
+Counter& published = MetricsRegistry::getInstance().counter(
+    "vitalsign_shm_published_total", "Records published to the shared-memory ring");
+
+void copyText(char* out, size_t size, const std::string& text) {
+    size_t n = std::min(size - 1, text.size());
+    std::memcpy(out, text.data(), n);
+    std::memset(out + n, 0, size - n);
+}
+
+} // namespace
+
+ShmPublisher& ShmPublisher::getInstance() {
+    static ShmPublisher instance;
+    return instance;
+}
+
+ShmPublisher::~ShmPublisher() {
+    close();
+}
+
+bool ShmPublisher::init(const std::string& name, size_t capacity) {
+    close();
+
+    uint64_t slots = 1;
+    while (slots < capacity) {
+        slots <<= 1;
+    }
+
+    // A fresh segment each start, so readers of an old one never see it reused
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        LOG_ERROR("shm_open " + name + " failed: " + strerror(errno));
+        return false;
+    }
+    size_t bytes = shmRingBytes(slots);
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        LOG_ERROR("Cannot size shared memory " + name + ": " + strerror(errno));
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void* mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        LOG_ERROR("Cannot map shared memory " + name + ": " + strerror(errno));
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // The segment starts zeroed; construct the atomics in place, then the
+    // magic last so readers never see a half-initialized header
+    ShmRingHeader* header = new (mapping) ShmRingHeader();
+    ShmSlot* ring = shmRingSlots(header);
+    for (uint64_t i = 0; i < slots; i++) {
+        new (&ring[i]) ShmSlot();
+    }
+    header->version = kShmRingVersion;
+    header->recordSize = sizeof(ShmRecord);
+    header->capacity = slots;
+    header->producerPid = getpid();
+    header->startedUs = TimestampFormatter::toEpochMicros(std::chrono::system_clock::now());
+    header->closed.store(0, std::memory_order_relaxed);
+    header->head.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header->magic, kShmRingMagic, sizeof(kShmRingMagic));
+
+    // Producers see the new mapping only once it is complete
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        slots_ = ring;
+        mask_ = slots - 1;
+        next_ = 0;
+        bytes_ = bytes;
+        name_ = name;
+        header_.store(header, std::memory_order_release);
+    }
+    LOG_INFO("Publishing live results to shared memory " + name + " (" + std::to_string(slots) + " slots)");
+    return true;
+}
+
+void ShmPublisher::publish(const std::string& sourceId, std::chrono::system_clock::time_point time,
+                           const VitalSample& vitals, const std::string& ecgLabel, float ecgConfidence) {
+    if (!isOpen()) {
+        return;
+    }
+
+    ShmRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.timeUs = TimestampFormatter::toEpochMicros(time);
+    copyText(record.sourceId, sizeof(record.sourceId), sourceId);
+    record.type = static_cast<uint32_t>(ShmRecordType::Vitals);
+    record.vitals.hr = vitals.hr;
+    record.vitals.spo2 = vitals.spo2;
+    record.vitals.systolic = vitals.systolic;
+    record.vitals.diastolic = vitals.diastolic;
+    record.vitals.ecgConfidence = ecgConfidence;
+    copyText(record.vitals.ecgLabel, sizeof(record.vitals.ecgLabel), ecgLabel);
+    commit(record);
+}
+
+void ShmPublisher::publishAlarm(const std::string& sourceId, std::chrono::system_clock::time_point time,
+                                const ShmAlarm& alarm) {
+    if (!isOpen()) {
+        return;
+    }
+
+    ShmRecord record;
+    std::memset(&record, 0, sizeof(record));
+    record.timeUs = TimestampFormatter::toEpochMicros(time);
+    copyText(record.sourceId, sizeof(record.sourceId), sourceId);
+    record.type = static_cast<uint32_t>(ShmRecordType::Alarm);
+    record.alarm = alarm;
+    commit(record);
+}
+
+void ShmPublisher::commit(ShmRecord& record) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ShmRingHeader* header = header_.load(std::memory_order_relaxed);
+    if (header == nullptr) {
+        return;
+    }
+    record.sequence = next_;
+    uint64_t words[kShmRecordWords];
+    std::memcpy(words, &record, sizeof(record));
+
+    // Seqlock write: odd while the words change, even once they are complete
+    ShmSlot& slot = slots_[next_ & mask_];
+    slot.seq.store(2 * next_ + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < kShmRecordWords; i++) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.seq.store(2 * next_ + 2, std::memory_order_release);
+    header->head.store(++next_, std::memory_order_release);
+    published.inc();
+}
+
+void ShmPublisher::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ShmRingHeader* header = header_.load(std::memory_order_relaxed);
+    if (header == nullptr) {
+        return;
+    }
+    header_.store(nullptr, std::memory_order_relaxed);
+    header->closed.store(1, std::memory_order_release);
+    munmap(header, bytes_);
+    shm_unlink(name_.c_str());
+    slots_ = nullptr;
+}
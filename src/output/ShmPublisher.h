@@ -0,0 +1,54 @@
+#ifndef SHM_PUBLISHER_H
+#define SHM_PUBLISHER_H
+
+#include "ShmRing.h"
+#include "../timeseries/TimeSeriesStore.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+
+// Publishes every processed sample into a POSIX shared-memory ring (see
+// ShmRing.h) for local consumers such as dashboards and alarm processes.
+// publish() is a handful of stores into the mapping: no syscall, no
+// allocation, and it never waits for a reader. Readers that fall more than
+// a ring behind lose the overwritten records. Producers (the writer and the
+// alarm engine) are serialized by a mutex that readers never touch.
+class ShmPublisher {
+public:
+    static ShmPublisher& getInstance();
+
+    // Create (or recreate) the segment, e.g. name "/vitalsign_live";
+    // capacity is rounded up to a power of two
+    bool init(const std::string& name, size_t capacity);
+    bool isOpen() const { return header_.load(std::memory_order_acquire) != nullptr; }
+
+    void publish(const std::string& sourceId, std::chrono::system_clock::time_point time,
+                 const VitalSample& vitals, const std::string& ecgLabel, float ecgConfidence);
+    void publishAlarm(const std::string& sourceId, std::chrono::system_clock::time_point time,
+                      const ShmAlarm& alarm);
+
+    // Mark the ring closed for readers and unmap it; the name is unlinked
+    void close();
+
+private:
+    ShmPublisher() = default;
+    ~ShmPublisher();
+    ShmPublisher(const ShmPublisher&) = delete;
+    ShmPublisher& operator=(const ShmPublisher&) = delete;
+
+    void commit(ShmRecord& record);
+
+    // Set and cleared under mutex_; atomic so publish() can skip the lock
+    // while no segment is open
+    std::atomic<ShmRingHeader*> header_{nullptr};
+    ShmSlot* slots_ = nullptr;
+    uint64_t mask_ = 0;
+    std::mutex mutex_;              // Held by producers only
+    uint64_t next_ = 0;             // Producer-local copy of head
+    size_t bytes_ = 0;
+    std::string name_;
+};
+
+#endif // SHM_PUBLISHER_H
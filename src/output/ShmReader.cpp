@@ -0,0 +1,119 @@
+#include "ShmReader.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+ShmReader::~ShmReader() {
+    close();
+}
+
+bool ShmReader::open(const std::string& name, bool fromOldest) {
+    close();
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(ShmRingHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size_t bytes = static_cast<size_t>(info.st_size);
+    void* mapping = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return false;
+    }
+
+    const ShmRingHeader* header = static_cast<const ShmRingHeader*>(mapping);
+    uint64_t capacity = header->capacity;
+    if (std::memcmp(header->magic, kShmRingMagic, sizeof(kShmRingMagic)) != 0 ||
+        header->version != kShmRingVersion || header->recordSize != sizeof(ShmRecord) ||
+        capacity == 0 || (capacity & (capacity - 1)) != 0 || shmRingBytes(capacity) > bytes) {
+        munmap(mapping, bytes);
+        return false;
+    }
+
+    header_ = header;
+    slots_ = shmRingSlots(header);
+    bytes_ = bytes;
+    lost_ = 0;
+    uint64_t head = header->head.load(std::memory_order_acquire);
+    next_ = fromOldest && head > capacity ? head - capacity : (fromOldest ? 0 : head);
+    return true;
+}
+
+void ShmReader::close() {
+    if (header_ != nullptr) {
+        munmap(const_cast<ShmRingHeader*>(header_), bytes_);
+        header_ = nullptr;
+        slots_ = nullptr;
+    }
+}
+
+// Seqlock read of record `sequence`; false if its slot no longer holds it
+bool ShmReader::readSlot(uint64_t sequence, ShmRecord& out) const {
+    const ShmSlot& slot = slots_[sequence & (header_->capacity - 1)];
+    uint64_t expected = 2 * sequence + 2;
+    if (slot.seq.load(std::memory_order_acquire) != expected) {
+        return false;
+    }
+    uint64_t words[kShmRecordWords];
+    for (size_t i = 0; i < kShmRecordWords; i++) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.seq.load(std::memory_order_relaxed) != expected) {
+        return false;
+    }
+    std::memcpy(&out, words, sizeof(out));
+    return true;
+}
+
+ShmReader::Result ShmReader::next(ShmRecord& out) {
+    if (header_ == nullptr) {
+        return Result::Closed;
+    }
+    // Read closed before head, so a closed ring with nothing left really is done
+    bool closed = header_->closed.load(std::memory_order_acquire) != 0;
+    while (true) {
+        uint64_t head = header_->head.load(std::memory_order_acquire);
+        if (next_ >= head) {
+            return closed ? Result::Closed : Result::Empty;
+        }
+        // Lapped: skip to the oldest record still in the ring
+        uint64_t capacity = header_->capacity;
+        if (head - next_ > capacity) {
+            lost_ += head - capacity - next_;
+            next_ = head - capacity;
+        }
+        if (readSlot(next_, out)) {
+            next_++;
+            return Result::Record;
+        }
+        // Overwritten while copying; the loop above resynchronizes
+        lost_++;
+        next_++;
+    }
+}
+
+bool ShmReader::latest(ShmRecord& out) const {
+    if (header_ == nullptr) {
+        return false;
+    }
+    // The newest slot can only be overwritten after a full lap; retry if so
+    for (int attempt = 0; attempt < 4; attempt++) {
+        uint64_t head = header_->head.load(std::memory_order_acquire);
+        if (head == 0) {
+            return false;
+        }
+        if (readSlot(head - 1, out)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,53 @@
+#ifndef SHM_READER_H
+#define SHM_READER_H
+
+#include "ShmRing.h"
+
+#include <cstdint>
+#include <string>
+
+// Consumer side of the live results ring. Maps the segment read-only and
+// follows the producer without locks or syscalls; each read copies one
+// 128-byte record and retries if the producer overwrote it meanwhile.
+// Depends only on ShmRing.h and libc, so other processes can link it alone.
+// One ShmReader per consumer thread.
+class ShmReader {
+public:
+    enum class Result {
+        Record,         // out holds the next record
+        Empty,          // Nothing new yet
+        Closed          // Producer shut down and everything was read
+    };
+
+    ShmReader() = default;
+    ~ShmReader();
+    ShmReader(const ShmReader&) = delete;
+    ShmReader& operator=(const ShmReader&) = delete;
+
+    // fromOldest: start with the oldest record still in the ring instead of
+    // the next one published
+    bool open(const std::string& name, bool fromOldest = false);
+    bool isOpen() const { return header_ != nullptr; }
+    void close();
+
+    Result next(ShmRecord& out);
+
+    // Newest complete record; false if nothing was published yet
+    bool latest(ShmRecord& out) const;
+
+    // Records overwritten before this reader got to them
+    uint64_t lost() const { return lost_; }
+    uint64_t capacity() const { return header_ != nullptr ? header_->capacity : 0; }
+    int64_t producerPid() const { return header_ != nullptr ? header_->producerPid : 0; }
+
+private:
+    bool readSlot(uint64_t sequence, ShmRecord& out) const;
+
+    const ShmRingHeader* header_ = nullptr;
+    const ShmSlot* slots_ = nullptr;
+    size_t bytes_ = 0;
+    uint64_t next_ = 0;
+    uint64_t lost_ = 0;
+};
+
+#endif // SHM_READER_H
@@ -0,0 +1,90 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Shared-memory layout of the live results ring, used by ShmPublisher and
+// ShmReader. Producers write records into a power-of-two array of slots
+// and never wait for readers; readers detect records overwritten under
+// them through each slot's sequence word (a per-slot seqlock).
+
+constexpr char kShmRingMagic[8] = {'V', 'S', 'L', 'I', 'V', 'E', '1', '\0'};
+constexpr uint32_t kShmRingVersion = 2;
+
+enum class ShmRecordType : uint32_t {
+    Vitals = 0,                 // One processed sample
+    Alarm = 1                   // An alarm raised or cleared (AlarmEngine)
+};
+
+// Vitals payload; -1 = no reading
+struct ShmVitals {
+    int32_t hr;
+    int32_t spo2;
+    int32_t systolic;
+    int32_t diastolic;
+    float ecgConfidence;
+    char ecgLabel[28];          // NUL-terminated, truncated
+};
+
+// Alarm payload; text fields are NUL-terminated and truncated
+struct ShmAlarm {
+    char rule[32];
+    char field[12];             // "hr", "spo2", "systolic" or "diastolic"
+    char severity[12];          // "info", "warning" or "critical"
+    uint32_t raised;            // 1 = raised, 0 = cleared
+    int32_t value;              // Field value that caused the transition
+    uint32_t latencyUs;         // From frame capture to publication
+};
+
+struct ShmRecord {
+    uint64_t sequence;          // Record number, from 0
+    int64_t timeUs;             // Capture time, microseconds since the epoch
+    char sourceId[32];          // NUL-terminated, truncated; "" in single-source mode
+    uint32_t type;              // ShmRecordType
+    uint32_t reserved;
+    union {
+        ShmVitals vitals;
+        ShmAlarm alarm;
+        uint8_t payload[72];
+    };
+};
+static_assert(sizeof(ShmRecord) == 128, "ShmRecord must stay 128 bytes");
+
+constexpr size_t kShmRecordWords = sizeof(ShmRecord) / sizeof(uint64_t);
+
+struct ShmRingHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t capacity;          // Slots, a power of two
+    int64_t producerPid;
+    int64_t startedUs;          // Producer start; changes when the segment is recreated
+    std::atomic<uint32_t> closed;                   // Set when the producer shuts down
+    alignas(64) std::atomic<uint64_t> head;         // Records published so far
+};
+
+// Sequence word: 2n+1 while record n is written, 2n+2 once it is complete.
+// The record is stored as relaxed atomic words so torn reads are detected
+// rather than being undefined behaviour.
+struct alignas(64) ShmSlot {
+    std::atomic<uint64_t> seq;
+    std::atomic<uint64_t> words[kShmRecordWords];
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory ring needs lock-free 64-bit atomics");
+
+inline size_t shmRingBytes(uint64_t capacity) {
+    return sizeof(ShmRingHeader) + capacity * sizeof(ShmSlot);
+}
+
+inline ShmSlot* shmRingSlots(ShmRingHeader* header) {
+    return reinterpret_cast<ShmSlot*>(header + 1);
+}
+
+inline const ShmSlot* shmRingSlots(const ShmRingHeader* header) {
+    return reinterpret_cast<const ShmSlot*>(header + 1);
+}
+
+#endif // SHM_RING_H
@@ -0,0 +1,149 @@
+#include "FramePool.h"
+#include "../monitoring/MetricsRegistry.h"
+#include "../utils/Logger.h"
+
+#include <cstdlib>
+#include <cstring>
+
+FramePool::Frame::Frame(const Frame& other) : slot_(other.slot_) {
+    if (slot_ != nullptr) {
+        slot_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+cv::Mat& FramePool::Frame::mat() const {
+    return slot_->mat;
+}
+
+void FramePool::Frame::reset() {
+    if (slot_ != nullptr && slot_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        slot_->pool->release(slot_);
+    }
+    slot_ = nullptr;
+}
+
+FramePool::~FramePool() {
+    for (std::unique_ptr<Slot>& slot : slots_) {
+        slot->mat.release();
+        std::free(slot->storage);
+    }
+}
+
+bool FramePool::parseBackpressure(const std::string& name, FrameBackpressure& backpressure) {
+    if (name == "drop") {
+        backpressure = FrameBackpressure::Drop;
+    } else if (name == "block") {
+        backpressure = FrameBackpressure::Block;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Point the slot's header at fresh aligned storage with padded rows
+bool FramePool::allocate(Slot& slot, int rows, int cols, int type) {
+    size_t rowBytes = static_cast<size_t>(cols) * CV_ELEM_SIZE(type);
+    size_t step = (rowBytes + kAlignment - 1) / kAlignment * kAlignment;
+    size_t bytes = step * static_cast<size_t>(rows);
+    unsigned char* storage = static_cast<unsigned char*>(std::aligned_alloc(kAlignment, bytes));
+    if (storage == nullptr) {
+        return false;
+    }
+    // Touch every page now so resident memory does not grow while running
+    std::memset(storage, 0, bytes);
+    slot.mat.release();
+    std::free(slot.storage);
+    slot.storage = storage;
+    slot.rows = rows;
+    slot.cols = cols;
+    slot.type = type;
+    slot.step = step;
+    slot.mat = cv::Mat(rows, cols, type, storage, step);
+    return true;
+}
+
+bool FramePool::init(const std::string& name, size_t slots, int width, int height,
+                     FrameBackpressure backpressure) {
+    if (slots == 0 || width <= 0 || height <= 0) {
+        LOG_ERROR("Frame pool " + name + ": invalid size");
+        return false;
+    }
+    name_ = name;
+    backpressure_ = backpressure;
+    for (size_t i = 0; i < slots; i++) {
+        std::unique_ptr<Slot> slot(new Slot());
+        slot->pool = this;
+        if (!allocate(*slot, height, width, CV_8UC3)) {
+            LOG_ERROR("Frame pool " + name + ": out of memory");
+            return false;
+        }
+        free_.push_back(slot.get());
+        slots_.push_back(std::move(slot));
+    }
+
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    std::string labels = "pool=\"" + name + "\"";
+    exhausted_ = &metrics.counter("vitalsign_frame_pool_exhausted_total",
+                                  "Captures that found every frame slot in use", labels);
+    reallocated_ = &metrics.counter("vitalsign_frame_pool_reallocations_total",
+                                    "Frame slots reallocated for a new stream size", labels);
+    metrics.gaugeCallback("vitalsign_frame_pool_in_use", "Frame slots held by pipeline stages",
+                          [this]() { return static_cast<double>(inUse()); }, labels);
+
+    size_t bytes = slots_.size() * slots_.front()->step * static_cast<size_t>(height);
+    LOG_INFO("Frame pool %s: %zu slots of %dx%d, %.1f MB, %s when full", name.c_str(), slots, width, height,
+             bytes / (1024.0 * 1024.0), backpressure == FrameBackpressure::Block ? "block" : "drop");
+    return true;
+}
+
+FramePool::Frame FramePool::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (free_.empty() && !closed_) {
+        exhausted_->inc();
+        if (backpressure_ == FrameBackpressure::Drop) {
+            return Frame();
+        }
+        available_.wait(lock, [this]() { return closed_ || !free_.empty(); });
+    }
+    if (closed_) {
+        return Frame();
+    }
+    // Most recently released first: its buffer is likely still in cache
+    Slot* slot = free_.back();
+    free_.pop_back();
+    slot->refs.store(1, std::memory_order_relaxed);
+    return Frame(slot);
+}
+
+void FramePool::release(Slot* slot) {
+    // The last reference is gone, so this thread owns the slot
+    if (slot->mat.data != slot->storage) {
+        const cv::Mat& mat = slot->mat;
+        if (!mat.empty() && (mat.rows != slot->rows || mat.cols != slot->cols || mat.type() != slot->type)) {
+            // The stream changed size and the read allocated a new buffer
+            LOG_WARN("Frame pool %s: frames are now %dx%d, reallocating slot", name_.c_str(), mat.cols, mat.rows);
+            reallocated_->inc();
+            if (!allocate(*slot, mat.rows, mat.cols, mat.type())) {
+                LOG_ERROR("Frame pool " + name_ + ": out of memory");
+            }
+        } else {
+            // A failed read released the header; point it back at the storage
+            slot->mat = cv::Mat(slot->rows, slot->cols, slot->type, slot->storage, slot->step);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    free_.push_back(slot);
+    available_.notify_one();
+}
+
+void FramePool::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    closed_ = true;
+    available_.notify_all();
+}
+
+size_t FramePool::inUse() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return slots_.size() - free_.size();
+}
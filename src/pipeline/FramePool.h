@@ -0,0 +1,104 @@
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Counter;
+
+// What acquire() does when every slot is held downstream
+enum class FrameBackpressure {
+    Drop,                               // Return an empty frame; the caller skips the capture
+    Block                               // Wait until a stage releases a slot
+};
+
+// Fixed set of preallocated frame buffers that capture reads into. Rows
+// start on kAlignment-byte boundaries. A Frame is a reference-counted
+// handle: copies share the slot, which returns to the pool when the last
+// copy is destroyed. Reading into a slot whose geometry matches the stream
+// reuses its buffer; if the stream size changes, the slot is reallocated
+// once to the new size when it is released.
+class FramePool {
+    struct Slot;
+
+public:
+    static constexpr size_t kAlignment = 64;
+
+    class Frame {
+    public:
+        Frame() = default;
+        Frame(const Frame& other);
+        Frame(Frame&& other) noexcept : slot_(other.slot_) { other.slot_ = nullptr; }
+        Frame& operator=(Frame other) noexcept {
+            std::swap(slot_, other.slot_);
+            return *this;
+        }
+        ~Frame() { reset(); }
+
+        explicit operator bool() const { return slot_ != nullptr; }
+
+        // Only the capture stage writes, before it shares the frame
+        cv::Mat& mat() const;
+
+        void reset();
+
+    private:
+        friend class FramePool;
+        explicit Frame(Slot* slot) : slot_(slot) {}
+
+        Slot* slot_ = nullptr;
+    };
+
+    FramePool() = default;
+    ~FramePool();
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // Allocate every slot up front; name labels the pool's metrics
+    bool init(const std::string& name, size_t slots, int width, int height, FrameBackpressure backpressure);
+
+    // Writable slot for the capture stage; empty when the pool is exhausted
+    // under Drop, or after close()
+    Frame acquire();
+
+    // Wake blocked acquire() calls with empty frames; held frames still return
+    void close();
+
+    size_t size() const { return slots_.size(); }
+    size_t inUse() const;
+
+    static bool parseBackpressure(const std::string& name, FrameBackpressure& backpressure);
+
+private:
+    struct Slot {
+        FramePool* pool = nullptr;
+        std::atomic<int> refs{0};
+        unsigned char* storage = nullptr;
+        int rows = 0;
+        int cols = 0;
+        int type = 0;
+        size_t step = 0;
+        cv::Mat mat;                    // Header over storage
+    };
+
+    static bool allocate(Slot& slot, int rows, int cols, int type);
+    void release(Slot* slot);
+
+    std::string name_;
+    FrameBackpressure backpressure_ = FrameBackpressure::Drop;
+    std::vector<std::unique_ptr<Slot>> slots_;
+    std::vector<Slot*> free_;
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    bool closed_ = false;
+    Counter* exhausted_ = nullptr;
+    Counter* reallocated_ = nullptr;
+};
+
+#endif // FRAME_POOL_H
@@ -0,0 +1,516 @@
+#include "MultiSourcePipeline.h"
+#include "../alarm/AlarmEngine.h"
+#include "../config/ConfigManager.h"
+#include "../database/DatabaseManager.h"
+#include "../monitoring/MetricsRegistry.h"
+#include "../monitoring/Tracer.h"
+#include "../output/ShmPublisher.h"
+#include "../sim/SyntheticMonitor.h"
+#include "../timeseries/ArchiveWriter.h"
+#include "../timeseries/TimeSeriesStore.h"
+#include "../utils/Logger.h"
+#include "../utils/StartupPlan.h"
+#include "../utils/TimestampFormatter.h"
+
+#include <opencv2/videoio.hpp>
+#include <algorithm>
+
+namespace {
+
+Histogram& ocrWait = MetricsRegistry::getInstance().histogram(
+    "vitalsign_engine_wait_seconds", "Time a source waited for a shared engine", "engine=\"ocr\"", 1e-6);
+Histogram& classifierWait = MetricsRegistry::getInstance().histogram(
+    "vitalsign_engine_wait_seconds", "Time a source waited for a shared engine", "engine=\"classifier\"", 1e-6);
+Counter& writerDropped = MetricsRegistry::getInstance().counter(
+    "vitalsign_writer_dropped_rows_total", "Rows dropped because the writer queue was full");
+
+std::string sourceLabel(const std::string& id) {
+    return "source=\"" + id + "\"";
+}
+
+uint64_t elapsedUs(std::chrono::steady_clock::time_point since) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - since).count());
+}
+
+} // namespace
+
+MultiSourcePipeline::MultiSourcePipeline(DatabaseManager& db, bool dbEnabled, CsvSink& csv)
+    : db_(db), dbEnabled_(dbEnabled), csv_(csv), executor_("pipeline") {
+}
+
+MultiSourcePipeline::~MultiSourcePipeline() {
+    stop();
+}
+
+bool MultiSourcePipeline::start(const std::vector<VideoSourceConfig>& sources, int ocrEngines, int workers) {
+    std::shared_ptr<const ConfigSnapshot> cfg = ConfigManager::getInstance().snapshot();
+
+    size_t engines = ocrEngines > 0
+        ? static_cast<size_t>(ocrEngines)
+        : std::min<size_t>(sources.size(), std::max(1u, std::thread::hardware_concurrency()));
+    // Each engine loads its traineddata on its own thread, then runs once on
+    // a synthetic frame so the first real frames do not pay for warm-up
+    std::vector<std::unique_ptr<VitalSignExtractor>> extractors(engines);
+    std::unique_ptr<EcgClassifier> classifier(new EcgClassifier());
+    cv::Mat warmupFrame;
+    StartupPlan startup;
+    bool warmup = cfg->startup.warmup;
+    if (warmup) {
+        startup.add("warmup_frame", [&]() {
+            SyntheticMonitorStyle style;
+            style.width = cfg->video.frameWidth;
+            style.height = cfg->video.frameHeight;
+            SyntheticMonitorGenerator generator(style);
+            SyntheticVitals truth;
+            generator.next(warmupFrame, truth);
+            return !warmupFrame.empty();
+        });
+    }
+    for (size_t i = 0; i < engines; i++) {
+        startup.add("ocr_engine_" + std::to_string(i + 1), [&, i]() {
+            std::unique_ptr<VitalSignExtractor> extractor(new VitalSignExtractor());
+            if (!extractor->init(cfg->ocr.language, cfg->vitalSigns.labels, cfg->vitalSigns.defaultSpO2)) {
+                LOG_ERROR("Could not initialize Tesseract engine " + std::to_string(i + 1));
+                return false;
+            }
+            if (warmup && !warmupFrame.empty()) {
+                std::string spo2 = cfg->vitalSigns.defaultSpO2;
+                extractor->processFrame(warmupFrame, cfg->ocr.confidenceThreshold, spo2);
+            }
+            extractors[i] = std::move(extractor);
+            return true;
+        }, warmup ? std::vector<std::string>{"warmup_frame"} : std::vector<std::string>{});
+    }
+    if (warmup && cfg->mlModel.enabled) {
+        startup.add("ml_warmup", [&]() {
+            cv::Mat cropped;
+            classifier->prepare(warmupFrame, cropped);
+            return classifier->run().ok;
+        }, {"warmup_frame"});
+    }
+    startup.start(cfg->startup.parallel);
+    startup.wait();
+
+    for (std::unique_ptr<VitalSignExtractor>& extractor : extractors) {
+        if (extractor) {
+            ocrPool_.add(std::move(extractor));
+        }
+    }
+    if (ocrPool_.size() == 0) {
+        LOG_CRITICAL("No Tesseract engine available for multi-source mode");
+        return false;
+    }
+
+    // The SDK keeps its tensor arena in globals, so one classifier is all
+    // the pool can usefully hold
+    classifierPool_.add(std::move(classifier));
+
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    metrics.gaugeCallback("vitalsign_ocr_engine_waiters", "Sources waiting for a Tesseract engine",
+                          [this]() { return static_cast<double>(ocrPool_.waiting()); });
+
+    running_ = true;
+    executor_.start(static_cast<size_t>(std::max(0, workers)));
+
+    for (const VideoSourceConfig& settings : sources) {
+        std::unique_ptr<Source> source(new Source());
+        source->settings = settings;
+        source->lastSpO2 = cfg->vitalSigns.defaultSpO2;
+        source->rate.reset(new RateController(settings.id));
+        source->fusion.reset(new TemporalFusion(settings.id));
+        std::string labels = sourceLabel(settings.id);
+        source->captured = &metrics.counter("vitalsign_source_frames_captured_total",
+                                            "Frames read per source", labels);
+        source->processed = &metrics.counter("vitalsign_source_frames_processed_total",
+                                             "Frames run through OCR and ML per source", labels);
+        source->dropped = &metrics.counter("vitalsign_source_frames_dropped_total",
+                                           "Empty or failed frame reads per source", labels);
+        source->skipped = &metrics.counter("vitalsign_source_frames_skipped_total",
+                                           "Frames replaced by a newer one before processing started", labels);
+        sources_.push_back(std::move(source));
+    }
+
+    activeSources_ = static_cast<int>(sources_.size());
+    for (auto& source : sources_) {
+        Source* s = source.get();
+        s->captureThread = std::thread(&MultiSourcePipeline::captureLoop, this, std::ref(*s));
+    }
+
+    LOG_INFO("Multi-source mode: " + std::to_string(sources_.size()) + " sources, " +
+             std::to_string(ocrPool_.size()) + " Tesseract engines, " +
+             std::to_string(executor_.workers()) + " workers");
+    return true;
+}
+
+void MultiSourcePipeline::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    for (auto& source : sources_) {
+        source->frames.close();
+    }
+    for (auto& source : sources_) {
+        if (source->captureThread.joinable()) {
+            source->captureThread.join();
+        }
+    }
+
+    // Frames already in flight finish and their rows are written; frames
+    // still pending are dropped since running_ is false
+    executor_.stop();
+
+    // Let a reconnect in progress finish, then write what it held back here
+    // since the executor no longer runs the writer
+    if (dbReconnectThread_.joinable()) {
+        dbReconnectThread_.join();
+    }
+    writeRows();
+
+    ocrPool_.close();
+    classifierPool_.close();
+    ocrPool_.forEach([](VitalSignExtractor& extractor) { extractor.end(); });
+}
+
+bool MultiSourcePipeline::openSource(const Source& source, cv::VideoCapture& capture) {
+    std::shared_ptr<const ConfigSnapshot> cfg = ConfigManager::getInstance().snapshot();
+    const VideoSourceConfig& settings = source.settings;
+    int maxAttempts = std::max(1, cfg->video.reconnectAttempts);
+
+    for (int attempt = 1; attempt <= maxAttempts && running_; attempt++) {
+        if (settings.type == "camera") {
+            capture.open(settings.cameraIndex);
+        } else if (settings.type == "stream") {
+            capture.open(settings.path, cv::CAP_FFMPEG);
+        } else {
+            capture.open(settings.path);
+        }
+        if (capture.isOpened()) {
+            LOG_INFO("Source " + settings.id + " opened");
+            return true;
+        }
+
+        LOG_WARN("Failed to open source " + settings.id + ", attempt " + std::to_string(attempt) + "/" +
+                 std::to_string(maxAttempts));
+        if (attempt < maxAttempts) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(cfg->video.reconnectDelayMs));
+        }
+    }
+    return false;
+}
+
+void MultiSourcePipeline::captureLoop(Source& source) {
+    Tracer::getInstance().setThreadName("capture-" + source.settings.id);
+    ConfigManager& config = ConfigManager::getInstance();
+    cv::VideoCapture capture;
+    bool opened = openSource(source, capture);
+    if (!opened) {
+        LOG_ERROR("Source " + source.settings.id + " unavailable, giving up");
+    }
+
+    // Capture reads into preallocated buffers sized to the stream
+    if (opened) {
+        std::shared_ptr<const ConfigSnapshot> cfg = config.snapshot();
+        FrameBackpressure backpressure = FrameBackpressure::Drop;
+        if (!FramePool::parseBackpressure(cfg->video.framePoolBackpressure, backpressure)) {
+            LOG_WARN("Unknown frame_pool_backpressure '" + cfg->video.framePoolBackpressure + "', using drop");
+        }
+        int width = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_WIDTH));
+        int height = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_HEIGHT));
+        if (!source.frames.init(source.settings.id, static_cast<size_t>(std::max(1, cfg->video.framePoolSize)),
+                                width > 0 ? width : cfg->video.frameWidth,
+                                height > 0 ? height : cfg->video.frameHeight, backpressure)) {
+            LOG_ERROR("Source " + source.settings.id + ": no frame buffers, giving up");
+            opened = false;
+        }
+    }
+
+    // Files are paced at their own frame rate, like a live feed
+    bool isFile = source.settings.type == "file";
+    double fps = opened && isFile ? capture.get(cv::CAP_PROP_FPS) : 0.0;
+    auto framePeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(fps > 0.0 ? 1.0 / fps : 0.0));
+    auto nextFrame = std::chrono::steady_clock::now();
+
+    while (opened && running_) {
+        FramePool::Frame frame = source.frames.acquire();
+        if (!frame) {
+            if (!running_) {
+                break;
+            }
+            // Every buffer is still held downstream; let this frame go
+            capture.grab();
+        } else {
+            if (!capture.read(frame.mat()) || frame.mat().empty()) {
+                source.dropped->inc();
+                capture.release();
+                if (isFile) {
+                    LOG_INFO("Source " + source.settings.id + " reached end of file");
+                    break;
+                }
+                LOG_WARN("Source " + source.settings.id + " lost, reconnecting");
+                opened = openSource(source, capture);
+                continue;
+            }
+            source.captured->inc();
+
+            int interval = source.settings.processingInterval > 0 ? source.settings.processingInterval
+                                                                  : config.snapshot()->video.processingInterval;
+            if (source.rate->shouldProcess(frame.mat(), interval)) {
+                std::lock_guard<std::mutex> lock(source.mutex);
+                if (source.hasPending) {
+                    source.skipped->inc();
+                }
+                source.pending = std::move(frame);
+                source.pendingTime = std::chrono::system_clock::now();
+                source.hasPending = true;
+                if (!source.busy) {
+                    source.busy = true;
+                    submitFrame(source);
+                }
+            }
+        }
+
+        if (fps > 0.0) {
+            nextFrame += framePeriod;
+            std::this_thread::sleep_until(nextFrame);
+        }
+    }
+
+    activeSources_--;
+}
+
+// Hand the pending frame to the executor; called with source.mutex held
+void MultiSourcePipeline::submitFrame(Source& source) {
+    FramePool::Frame frame = std::move(source.pending);
+    std::chrono::system_clock::time_point time = source.pendingTime;
+    source.hasPending = false;
+    executor_.submit([this, &source, frame, time]() { recognize(source, frame, time); });
+}
+
+// Run OCR now if an engine is free; otherwise park the frame in the pool,
+// which resubmits it with the engine once another task returns one
+void MultiSourcePipeline::recognize(Source& source, const FramePool::Frame& frame,
+                                    std::chrono::system_clock::time_point time) {
+    auto waitStart = std::chrono::steady_clock::now();
+    OcrLease ocr;
+    bool ready = ocrPool_.tryAcquire(ocr, [this, &source, frame, time, waitStart](OcrLease granted) {
+        ocrWait.record(elapsedUs(waitStart));
+        std::shared_ptr<OcrLease> held = std::make_shared<OcrLease>(std::move(granted));
+        executor_.submit([this, &source, frame, time, held]() { runOcr(source, frame, time, *held); });
+    });
+    if (ready) {
+        ocrWait.record(elapsedUs(waitStart));
+        runOcr(source, frame, time, ocr);
+    }
+}
+
+void MultiSourcePipeline::runOcr(Source& source, const FramePool::Frame& frame,
+                                 std::chrono::system_clock::time_point time, OcrLease& ocr) {
+    TRACE_SCOPE("source_ocr");
+    std::shared_ptr<const ConfigSnapshot> cfg = ConfigManager::getInstance().snapshot();
+
+    std::map<std::string, std::string> healthData;
+    if (ocr) {
+        healthData = ocr->processFrame(frame.mat(), cfg->ocr.confidenceThreshold, source.lastSpO2);
+        if (cfg->fusion.enabled) {
+            FusedVitals fused = source.fusion->update(ocr->lastReadings(), *cfg);
+            healthData["HR"] = fused.hrText();
+            healthData["SpO2"] = fused.spo2Text();
+            healthData["ABP"] = fused.abpText();
+        }
+    }
+    // Hand the engine to the next waiting source before the bookkeeping
+    ocr.reset();
+    source.rate->onReading(healthData);
+    VitalSample vitals = VitalSample::fromText(healthData["HR"], healthData["SpO2"], healthData["ABP"]);
+    TimeSeriesStore::getInstance().append(source.settings.id, time, vitals);
+    AlarmEngine::getInstance().evaluate(source.settings.id, time, vitals);
+
+    VitalSignData row;
+    char timeBuf[TimestampFormatter::kBufferSize];
+    TimestampFormatter::formatSeconds(time, timeBuf);
+    row.timestamp.assign(timeBuf, TimestampFormatter::kSecondsLength);
+    row.hr = healthData["HR"];
+    row.spo2 = healthData["SpO2"];
+    row.abp = healthData["ABP"];
+    row.ecg_classification = "unknown";
+    row.ecg_confidence = 0.0f;
+    row.source_id = source.settings.id;
+
+    // Inference is short and finishes a frame already in flight, so it
+    // goes ahead of new OCR work
+    if (cfg->mlModel.enabled) {
+        executor_.submit([this, &source, frame, row, time]() { classify(source, frame, row, time); },
+                         TaskPriority::High);
+    } else {
+        finishFrame(source, std::move(row), time);
+    }
+}
+
+void MultiSourcePipeline::classify(Source& source, const FramePool::Frame& frame, VitalSignData row,
+                                   std::chrono::system_clock::time_point time) {
+    auto waitStart = std::chrono::steady_clock::now();
+    ClassifierLease classifier;
+    bool ready = classifierPool_.tryAcquire(
+        classifier, [this, &source, frame, row, time, waitStart](ClassifierLease granted) {
+            classifierWait.record(elapsedUs(waitStart));
+            std::shared_ptr<ClassifierLease> held = std::make_shared<ClassifierLease>(std::move(granted));
+            executor_.submit([this, &source, frame, row, time, held]() {
+                runClassifier(source, frame, row, time, *held);
+            }, TaskPriority::High);
+        });
+    if (ready) {
+        classifierWait.record(elapsedUs(waitStart));
+        runClassifier(source, frame, std::move(row), time, classifier);
+    }
+}
+
+void MultiSourcePipeline::runClassifier(Source& source, const FramePool::Frame& frame, VitalSignData row,
+                                        std::chrono::system_clock::time_point time,
+                                        ClassifierLease& classifier) {
+    TRACE_SCOPE("source_ml");
+    if (classifier) {
+        cv::Mat cropped;
+        classifier->prepare(frame.mat(), cropped);
+        EcgResult result = classifier->run();
+        if (result.ok) {
+            row.ecg_classification = result.label;
+            row.ecg_confidence = result.confidence;
+        }
+    }
+    classifier.reset();
+    finishFrame(source, std::move(row), time);
+}
+
+void MultiSourcePipeline::finishFrame(Source& source, VitalSignData row,
+                                      std::chrono::system_clock::time_point time) {
+    source.processed->inc();
+    enqueue(std::move(row), time);
+
+    // Start on the frame that arrived meanwhile, if any
+    std::lock_guard<std::mutex> lock(source.mutex);
+    if (source.hasPending && running_) {
+        submitFrame(source);
+    } else {
+        source.busy = false;
+    }
+}
+
+void MultiSourcePipeline::enqueue(VitalSignData row, std::chrono::system_clock::time_point time) {
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        if (writerQueue_.size() >= kWriterQueueCapacity) {
+            writerQueue_.pop_front();
+            writerDropped.inc();
+        }
+        writerQueue_.push_back(WriterRow{std::move(row), time});
+    }
+    scheduleWriter();
+}
+
+// Queue a writer run unless one is already queued or running
+void MultiSourcePipeline::scheduleWriter() {
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        if (writerScheduled_) {
+            return;
+        }
+        writerScheduled_ = true;
+    }
+    executor_.submit([this]() { writeRows(); });
+}
+
+// Drain the writer queue; runs as a normal task, one at a time
+void MultiSourcePipeline::writeRows() {
+    std::deque<WriterRow> batch;
+    ArchiveWriter& archive = ArchiveWriter::getInstance();
+    ShmPublisher& publisher = ShmPublisher::getInstance();
+
+    // Rows held back by a finished reconnect go first
+    if (dbEnabled_) {
+        writeDb(nullptr);
+    }
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(writerMutex_);
+            if (writerQueue_.empty()) {
+                writerScheduled_ = false;
+                return;
+            }
+            batch.swap(writerQueue_);
+        }
+
+        TRACE_SCOPE("writer_batch");
+        for (const WriterRow& entry : batch) {
+            const VitalSignData& row = entry.data;
+            VitalSample vitals = VitalSample::fromText(row.hr, row.spo2, row.abp);
+            publisher.publish(row.source_id, entry.time, vitals, row.ecg_classification, row.ecg_confidence);
+            archive.append(row.source_id, entry.time, vitals, row.ecg_classification, row.ecg_confidence);
+            csv_.write(CsvRecord{entry.time, row.source_id, row.hr, row.spo2, row.abp,
+                                 row.ecg_classification, row.ecg_confidence});
+            if (dbEnabled_) {
+                writeDb(&row);
+            }
+        }
+        batch.clear();
+    }
+}
+
+// Insert row (if any) after the backlog, in order. While a reconnect runs,
+// rows are held back, up to the writer queue capacity, instead of waiting.
+void MultiSourcePipeline::writeDb(const VitalSignData* row) {
+    if (dbReconnecting_.load()) {
+        if (row != nullptr) {
+            if (dbBacklog_.size() >= kWriterQueueCapacity) {
+                dbBacklog_.pop_front();
+                writerDropped.inc();
+            }
+            dbBacklog_.push_back(*row);
+        }
+        return;
+    }
+    if (!db_.isConnected()) {
+        // The last reconnect failed; carry on without the database
+        if (!dbBacklog_.empty()) {
+            LOG_ERROR("Database unavailable, dropping " + std::to_string(dbBacklog_.size()) + " held rows");
+            dbBacklog_.clear();
+        }
+        return;
+    }
+
+    while (!dbBacklog_.empty()) {
+        if (!db_.insertVitalSign(dbBacklog_.front())) {
+            if (row != nullptr) {
+                dbBacklog_.push_back(*row);
+            }
+            startReconnect();
+            return;
+        }
+        dbBacklog_.pop_front();
+    }
+    if (row != nullptr && !db_.insertVitalSign(*row)) {
+        LOG_WARN("Failed to insert row for source " + row->source_id + ", attempting reconnect...");
+        dbBacklog_.push_back(*row);
+        startReconnect();
+    }
+}
+
+// Reconnect (with its retry sleeps) on a helper thread, then let the writer
+// flush the backlog
+void MultiSourcePipeline::startReconnect() {
+    dbReconnecting_ = true;
+    if (dbReconnectThread_.joinable()) {
+        dbReconnectThread_.join();
+    }
+    dbReconnectThread_ = std::thread([this]() {
+        std::shared_ptr<const ConfigSnapshot> cfg = ConfigManager::getInstance().snapshot();
+        db_.reconnect(cfg->database.retryAttempts, cfg->database.retryDelayMs);
+        dbReconnecting_ = false;
+        if (running_) {
+            scheduleWriter();
+        }
+    });
+}
@@ -0,0 +1,131 @@
+#ifndef MULTI_SOURCE_PIPELINE_H
+#define MULTI_SOURCE_PIPELINE_H
+
+#include "../config/ConfigSnapshot.h"
+#include "../database/StorageBackend.h"
+#include "../ml/EcgClassifier.h"
+#include "../ocr/TemporalFusion.h"
+#include "../ocr/VitalSignExtractor.h"
+#include "../output/CsvSink.h"
+#include "../utils/ResourcePool.h"
+#include "FramePool.h"
+#include "RateController.h"
+#include "TaskExecutor.h"
+
+#include <opencv2/core.hpp>
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Counter;
+class DatabaseManager;
+
+// Serves several monitor feeds (cameras, files, stream URLs) from one
+// process. Each source has a capture thread, which keeps only the newest
+// frame its rate controller marks as due. Processing runs as tasks on a work-stealing
+// executor: an OCR task per frame, a high-priority classifier task to finish
+// it, and a writer task that drains the rows of every source, tagged with
+// the source id, to CSV and the database. A source has at most one frame in
+// flight, which keeps its SpO2 carry-over in order. Tesseract engines and
+// the classifier are shared through FIFO resource pools, so sources are
+// served round-robin and a slow one cannot starve the rest. Executor
+// threads never block: a frame waiting for an engine is parked in the pool
+// and resubmitted when one frees up, and database reconnects run on their
+// own thread while the writer holds back the rows.
+class MultiSourcePipeline {
+public:
+    MultiSourcePipeline(DatabaseManager& db, bool dbEnabled, CsvSink& csv);
+    ~MultiSourcePipeline();
+    MultiSourcePipeline(const MultiSourcePipeline&) = delete;
+    MultiSourcePipeline& operator=(const MultiSourcePipeline&) = delete;
+
+    // Initialize the shared engines and start every thread; returns false if
+    // no Tesseract engine could be initialized. ocrEngines 0 = min(sources, cores),
+    // workers 0 = one executor thread per core.
+    bool start(const std::vector<VideoSourceConfig>& sources, int ocrEngines, int workers);
+
+    // Stop capture, finish frames in flight, drop the rest, drain the writer and join
+    void stop();
+
+    // Sources whose capture thread is still running (files end, cameras retry)
+    int activeSources() const { return activeSources_.load(std::memory_order_relaxed); }
+
+private:
+    struct Source {
+        VideoSourceConfig settings;
+        std::string lastSpO2;
+        std::unique_ptr<RateController> rate;
+        std::unique_ptr<TemporalFusion> fusion;
+        FramePool frames;               // Outlives the frames below that refer to it
+
+        // Newest frame handed from capture to processing
+        std::mutex mutex;
+        FramePool::Frame pending;
+        std::chrono::system_clock::time_point pendingTime;
+        bool hasPending = false;
+        bool busy = false;              // A frame of this source is in the executor
+
+        std::thread captureThread;
+
+        Counter* captured = nullptr;
+        Counter* processed = nullptr;
+        Counter* dropped = nullptr;
+        Counter* skipped = nullptr;
+    };
+
+    bool openSource(const Source& source, cv::VideoCapture& capture);
+    void captureLoop(Source& source);
+    void submitFrame(Source& source);
+    using OcrLease = ResourcePool<VitalSignExtractor>::Lease;
+    using ClassifierLease = ResourcePool<EcgClassifier>::Lease;
+
+    void recognize(Source& source, const FramePool::Frame& frame, std::chrono::system_clock::time_point time);
+    void runOcr(Source& source, const FramePool::Frame& frame, std::chrono::system_clock::time_point time,
+                OcrLease& ocr);
+    void classify(Source& source, const FramePool::Frame& frame, VitalSignData row,
+                  std::chrono::system_clock::time_point time);
+    void runClassifier(Source& source, const FramePool::Frame& frame, VitalSignData row,
+                       std::chrono::system_clock::time_point time, ClassifierLease& classifier);
+    void finishFrame(Source& source, VitalSignData row, std::chrono::system_clock::time_point time);
+    void enqueue(VitalSignData row, std::chrono::system_clock::time_point time);
+    void scheduleWriter();
+    void writeRows();
+    void writeDb(const VitalSignData* row);
+    void startReconnect();
+
+    DatabaseManager& db_;
+    bool dbEnabled_;
+    CsvSink& csv_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<int> activeSources_{0};
+    std::vector<std::unique_ptr<Source>> sources_;
+
+    ResourcePool<VitalSignExtractor> ocrPool_;
+    ResourcePool<EcgClassifier> classifierPool_;
+    TaskExecutor executor_;
+
+    // Single writer: rows from every source, in arrival order. At most one
+    // writer task is queued or running at a time.
+    struct WriterRow {
+        VitalSignData data;
+        std::chrono::system_clock::time_point time;     // Capture time, for the archive
+    };
+    static constexpr size_t kWriterQueueCapacity = 1024;
+    std::mutex writerMutex_;
+    std::deque<WriterRow> writerQueue_;
+    bool writerScheduled_ = false;
+
+    // Database rows held back while dbReconnectThread_ runs; only the writer
+    // task touches these (and stop(), after the executor has stopped)
+    std::deque<VitalSignData> dbBacklog_;
+    std::atomic<bool> dbReconnecting_{false};
+    std::thread dbReconnectThread_;
+};
+
+#endif // MULTI_SOURCE_PIPELINE_H
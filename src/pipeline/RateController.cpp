@@ -0,0 +1,213 @@
+#include "RateController.h"
+#include "../config/ConfigManager.h"
+#include "../monitoring/MetricsRegistry.h"
+#include "../timeseries/TimeSeriesStore.h"
+#include "../utils/Logger.h"
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+
+namespace {
+
+// Change detection compares 32x24 thumbnails: cheap enough for every frame
+const cv::Size kThumbnailSize(32, 24);
+
+double processCpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+bool outside(int value, int min, int max) {
+    return value >= 0 && (value < min || value > max);
+}
+
+} // namespace
+
+RateController::RateController(const std::string& sourceId) : sourceId_(sourceId) {
+    intervalGauge_ = &MetricsRegistry::getInstance().gauge(
+        "vitalsign_processing_interval_frames", "Current number of captured frames per processed frame",
+        sourceId.empty() ? "" : "source=\"" + sourceId + "\"");
+    cpuSampleWall_ = std::chrono::steady_clock::now();
+    cpuSampleSeconds_ = processCpuSeconds();
+}
+
+int RateController::interval() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::max(interval_, cpuFloor_);
+}
+
+bool RateController::shouldProcess(const cv::Mat& frame, int baseInterval) {
+    std::shared_ptr<const ConfigSnapshot> cfg = ConfigManager::getInstance().snapshot();
+    const ConfigSnapshot::RateControl& rc = cfg->rateControl;
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    bool first = interval_ == 0;
+    baseInterval_ = std::max(1, baseInterval);
+    minInterval_ = std::min(std::max(1, rc.minInterval), baseInterval_);
+
+    if (!rc.enabled) {
+        interval_ = baseInterval_;
+        cpuFloor_ = 0;
+    } else {
+        // Start at the slow rate; config reloads may move the bounds
+        interval_ = first ? baseInterval_ : std::min(std::max(interval_, minInterval_), baseInterval_);
+        updateCpuFloor(rc.cpuBudgetPercent);
+        if (rc.changeThreshold > 0.0f && interval_ > minInterval_ && !thumbnail_.empty() &&
+            pictureChanged(frame, rc.changeThreshold)) {
+            stableReadings_ = 0;
+            setInterval(minInterval_, "change", "picture changed");
+        }
+    }
+
+    int effective = std::max(interval_, cpuFloor_);
+    intervalGauge_->set(effective);
+    if (!first && ++framesSinceProcessed_ < effective) {
+        return false;
+    }
+    framesSinceProcessed_ = 0;
+    if (rc.enabled && rc.changeThreshold > 0.0f) {
+        cv::resize(frame, thumbnail_, kThumbnailSize, 0, 0, cv::INTER_AREA);
+    }
+    return true;
+}
+
+void RateController::onReading(const std::map<std::string, std::string>& values) {
+    std::shared_ptr<const ConfigSnapshot> cfg = ConfigManager::getInstance().snapshot();
+    const ConfigSnapshot::RateControl& rc = cfg->rateControl;
+    const ValidationRanges& ranges = cfg->vitalSigns.validation;
+    if (!rc.enabled) {
+        return;
+    }
+
+    auto field = [&values](const char* name) {
+        auto it = values.find(name);
+        return it != values.end() ? it->second : std::string();
+    };
+    std::string abp = field("ABP");
+    VitalSample sample = VitalSample::fromText(field("HR"), field("SpO2"), abp);
+    int hr = sample.hr;
+    int spo2 = sample.spo2;
+    int systolic = sample.systolic;
+    int diastolic = sample.diastolic;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    const char* reason = nullptr;
+    std::string detail;
+
+    // Out-of-range readings keep the rate up for as long as they last
+    if (outside(hr, ranges.hr_min, ranges.hr_max)) {
+        reason = "range";
+        detail = "HR " + std::to_string(hr) + " outside " + std::to_string(ranges.hr_min) + "-" +
+                 std::to_string(ranges.hr_max);
+    } else if (outside(spo2, ranges.spo2_min, ranges.spo2_max)) {
+        reason = "range";
+        detail = "SpO2 " + std::to_string(spo2) + " outside " + std::to_string(ranges.spo2_min) + "-" +
+                 std::to_string(ranges.spo2_max);
+    } else if (outside(systolic, ranges.abp_systolic_min, ranges.abp_systolic_max) ||
+               outside(diastolic, ranges.abp_diastolic_min, ranges.abp_diastolic_max)) {
+        reason = "range";
+        detail = "ABP " + abp + " outside validation range";
+    } else if (hr >= 0 && lastHr_ >= 0 && std::abs(hr - lastHr_) >= rc.hrDelta) {
+        reason = "delta";
+        detail = "HR " + std::to_string(lastHr_) + " -> " + std::to_string(hr);
+    } else if (spo2 >= 0 && lastSpO2_ >= 0 && std::abs(spo2 - lastSpO2_) >= rc.spo2Delta) {
+        reason = "delta";
+        detail = "SpO2 " + std::to_string(lastSpO2_) + " -> " + std::to_string(spo2);
+    } else if ((systolic >= 0 && lastSystolic_ >= 0 && std::abs(systolic - lastSystolic_) >= rc.abpDelta) ||
+               (diastolic >= 0 && lastDiastolic_ >= 0 && std::abs(diastolic - lastDiastolic_) >= rc.abpDelta)) {
+        reason = "delta";
+        detail = "ABP " + std::to_string(lastSystolic_) + "/" + std::to_string(lastDiastolic_) + " -> " + abp;
+    }
+
+    if (hr >= 0) lastHr_ = hr;
+    if (spo2 >= 0) lastSpO2_ = spo2;
+    if (systolic >= 0 && diastolic >= 0) {
+        lastSystolic_ = systolic;
+        lastDiastolic_ = diastolic;
+    }
+
+    if (reason != nullptr) {
+        stableReadings_ = 0;
+        if (interval_ > minInterval_) {
+            setInterval(minInterval_, reason, detail);
+        }
+        return;
+    }
+
+    if (++stableReadings_ >= std::max(1, rc.stableReadings) && interval_ < baseInterval_) {
+        setInterval(std::min(interval_ * 2, baseInterval_), "stable",
+                    std::to_string(stableReadings_) + " stable readings");
+        stableReadings_ = 0;
+    }
+}
+
+void RateController::setInterval(int interval, const char* reason, const std::string& detail) {
+    if (interval == interval_) {
+        return;
+    }
+    LOG_INFO("Processing interval " + std::to_string(interval_) + " -> " + std::to_string(interval) +
+             " frames" + (sourceId_.empty() ? "" : " (" + sourceId_ + ")") + ": " + detail);
+    MetricsRegistry::getInstance()
+        .counter("vitalsign_rate_changes_total", "Processing interval changes by cause",
+                 std::string("reason=\"") + reason + "\"")
+        .inc();
+    interval_ = interval;
+}
+
+// Sample process CPU at most once a second and move the interval floor so
+// the whole process stays under budgetPercent of all cores
+void RateController::updateCpuFloor(float budgetPercent) {
+    auto now = std::chrono::steady_clock::now();
+    double wall = std::chrono::duration<double>(now - cpuSampleWall_).count();
+    if (wall < 1.0) {
+        return;
+    }
+    double cpu = processCpuSeconds();
+    double percent = (cpu - cpuSampleSeconds_) / wall / std::max(1u, std::thread::hardware_concurrency()) * 100.0;
+    cpuSampleWall_ = now;
+    cpuSampleSeconds_ = cpu;
+
+    int floor = cpuFloor_;
+    if (budgetPercent <= 0.0f) {
+        floor = 0;
+    } else if (percent > budgetPercent) {
+        int current = std::max(interval_, cpuFloor_);
+        floor = std::min(baseInterval_, static_cast<int>(current * percent / budgetPercent) + 1);
+    } else if (percent < budgetPercent * 0.75 && cpuFloor_ > 0) {
+        floor = cpuFloor_ / 2 <= minInterval_ ? 0 : cpuFloor_ / 2;
+    }
+    if (floor == cpuFloor_) {
+        return;
+    }
+
+    int before = std::max(interval_, cpuFloor_);
+    int after = std::max(interval_, floor);
+    cpuFloor_ = floor;
+    if (before != after) {
+        LOG_INFO("Processing interval " + std::to_string(before) + " -> " + std::to_string(after) + " frames" +
+                 (sourceId_.empty() ? "" : " (" + sourceId_ + ")") + ": CPU " +
+                 std::to_string(static_cast<int>(percent)) + "% against budget " +
+                 std::to_string(static_cast<int>(budgetPercent)) + "%");
+        MetricsRegistry::getInstance()
+            .counter("vitalsign_rate_changes_total", "Processing interval changes by cause", "reason=\"cpu\"")
+            .inc();
+    }
+}
+
+bool RateController::pictureChanged(const cv::Mat& frame, double threshold) {
+    cv::resize(frame, scratch_, kThumbnailSize, 0, 0, cv::INTER_AREA);
+    if (scratch_.type() != thumbnail_.type()) {
+        return true;
+    }
+    cv::absdiff(scratch_, thumbnail_, scratch_);
+    cv::Scalar diff = cv::mean(scratch_);
+    double mean = 0.0;
+    for (int c = 0; c < scratch_.channels(); c++) {
+        mean += diff[c];
+    }
+    return mean / scratch_.channels() >= threshold;
+}
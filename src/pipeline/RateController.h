@@ -0,0 +1,66 @@
+#ifndef RATE_CONTROLLER_H
+#define RATE_CONTROLLER_H
+
+#include <opencv2/core.hpp>
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <string>
+
+class Gauge;
+
+// Decides which captured frames of one source go through OCR and inference.
+// The processing interval (in frames) drops to rate_control.min_interval as
+// soon as the picture changes, a reading moves by more than its delta, or a
+// reading leaves the validation ranges. After stable_readings quiet readings
+// it doubles back towards the source's processing_interval. A process-wide
+// CPU measurement raises a floor under the interval while the process is
+// over rate_control.cpu_budget_percent. With rate control disabled this is
+// the plain every-Nth-frame rule. Safe to call from the capture thread and
+// a processing thread at the same time.
+class RateController {
+public:
+    // sourceId labels the interval gauge and the log lines ("" = single source)
+    explicit RateController(const std::string& sourceId);
+
+    // Called for every captured frame; true if this one should be processed.
+    // baseInterval is the source's processing_interval, the slowest rate.
+    bool shouldProcess(const cv::Mat& frame, int baseInterval);
+
+    // Feed back the values read from the last processed frame
+    void onReading(const std::map<std::string, std::string>& values);
+
+    // Current effective interval in frames
+    int interval() const;
+
+private:
+    void setInterval(int interval, const char* reason, const std::string& detail);
+    void updateCpuFloor(float budgetPercent);
+    bool pictureChanged(const cv::Mat& frame, double threshold);
+
+    std::string sourceId_;
+    Gauge* intervalGauge_ = nullptr;
+
+    mutable std::mutex mutex_;
+    int interval_ = 0;                  // 0 until the first frame
+    int cpuFloor_ = 0;                  // Raised while over the CPU budget
+    int baseInterval_ = 1;
+    int minInterval_ = 1;
+    int framesSinceProcessed_ = 0;
+    int stableReadings_ = 0;
+
+    // Last processed frame, downscaled, for change detection
+    cv::Mat thumbnail_;
+    cv::Mat scratch_;
+
+    // Last accepted reading per field; -1 = none yet
+    int lastHr_ = -1;
+    int lastSpO2_ = -1;
+    int lastSystolic_ = -1;
+    int lastDiastolic_ = -1;
+
+    std::chrono::steady_clock::time_point cpuSampleWall_;
+    double cpuSampleSeconds_ = 0.0;
+};
+
+#endif // RATE_CONTROLLER_H
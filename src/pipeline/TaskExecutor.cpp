@@ -0,0 +1,171 @@
+#include "TaskExecutor.h"
+#include "../monitoring/MetricsRegistry.h"
+#include "../monitoring/Tracer.h"
+
+#include <algorithm>
+
+namespace {
+
+// Index of the calling thread's queue in the executor it belongs to
+thread_local const TaskExecutor* currentExecutor = nullptr;
+thread_local size_t currentWorker = 0;
+
+uint64_t elapsedUs(std::chrono::steady_clock::time_point since) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - since).count());
+}
+
+} // namespace
+
+TaskExecutor::TaskExecutor(const std::string& name) : name_(name) {
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    std::string labels = "executor=\"" + name + "\"";
+    normalTasks_ = &metrics.counter("vitalsign_executor_tasks_total", "Tasks run by the executor",
+                                    labels + ",priority=\"normal\"");
+    highTasks_ = &metrics.counter("vitalsign_executor_tasks_total", "Tasks run by the executor",
+                                  labels + ",priority=\"high\"");
+    steals_ = &metrics.counter("vitalsign_executor_steals_total",
+                               "Tasks taken from another worker's queue", labels);
+    normalLatency_ = &metrics.histogram("vitalsign_executor_queue_latency_seconds",
+                                        "Time from submit to the start of the task",
+                                        labels + ",priority=\"normal\"", 1e-6);
+    highLatency_ = &metrics.histogram("vitalsign_executor_queue_latency_seconds",
+                                      "Time from submit to the start of the task",
+                                      labels + ",priority=\"high\"", 1e-6);
+    queued_ = &metrics.gauge("vitalsign_executor_queued_tasks", "Tasks waiting for a worker", labels);
+}
+
+TaskExecutor::~TaskExecutor() {
+    stop();
+}
+
+void TaskExecutor::start(size_t workers) {
+    if (!threads_.empty()) {
+        return;
+    }
+    if (workers == 0) {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        stopping_ = false;
+    }
+    queues_.clear();
+    for (size_t i = 0; i < workers; i++) {
+        queues_.emplace_back(new WorkerQueue());
+    }
+    for (size_t i = 0; i < workers; i++) {
+        threads_.emplace_back(&TaskExecutor::workerLoop, this, i);
+    }
+}
+
+void TaskExecutor::submit(Task task, TaskPriority priority) {
+    QueuedTask queued{std::move(task), std::chrono::steady_clock::now()};
+    // Count the task before it becomes visible, so a worker taking it right
+    // away never decrements below zero
+    queued_->set(static_cast<double>(pending_.fetch_add(1) + 1));
+    if (priority == TaskPriority::High) {
+        std::lock_guard<std::mutex> lock(highMutex_);
+        highQueue_.push_back(std::move(queued));
+    } else {
+        // Own queue when called from a task, otherwise spread round-robin
+        size_t index = currentExecutor == this
+            ? currentWorker
+            : nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+        WorkerQueue& queue = *queues_[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.tasks.push_back(std::move(queued));
+    }
+
+    // Taking the lock orders the increment before a worker's predicate check
+    {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+    }
+    idle_.notify_one();
+}
+
+void TaskExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(idleMutex_);
+        stopping_ = true;
+    }
+    idle_.notify_all();
+    for (std::thread& thread : threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threads_.clear();
+}
+
+bool TaskExecutor::takeTask(size_t index, QueuedTask& out, bool& stolen, bool& high) {
+    {
+        std::lock_guard<std::mutex> lock(highMutex_);
+        if (!highQueue_.empty()) {
+            out = std::move(highQueue_.front());
+            highQueue_.pop_front();
+            high = true;
+            stolen = false;
+            return true;
+        }
+    }
+    high = false;
+
+    {
+        WorkerQueue& own = *queues_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            out = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            stolen = false;
+            return true;
+        }
+    }
+
+    // Steal the oldest task of the next non-empty queue
+    for (size_t offset = 1; offset < queues_.size(); offset++) {
+        WorkerQueue& victim = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            out = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            stolen = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskExecutor::runTask(QueuedTask& task, bool high) {
+    (high ? highLatency_ : normalLatency_)->record(elapsedUs(task.queuedAt));
+    (high ? highTasks_ : normalTasks_)->inc();
+    task.run();
+}
+
+void TaskExecutor::workerLoop(size_t index) {
+    currentExecutor = this;
+    currentWorker = index;
+    Tracer::getInstance().setThreadName(name_ + "-" + std::to_string(index));
+
+    while (true) {
+        QueuedTask task;
+        bool stolen = false;
+        bool high = false;
+        if (takeTask(index, task, stolen, high)) {
+            queued_->set(static_cast<double>(pending_.fetch_sub(1) - 1));
+            if (stolen) {
+                steals_->inc();
+            }
+            runTask(task, high);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(idleMutex_);
+        idle_.wait(lock, [&]() { return stopping_ || pending_.load() > 0; });
+        if (stopping_ && pending_.load() == 0) {
+            break;
+        }
+    }
+
+    currentExecutor = nullptr;
+}
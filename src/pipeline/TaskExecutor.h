@@ -0,0 +1,89 @@
+#ifndef TASK_EXECUTOR_H
+#define TASK_EXECUTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Counter;
+class Gauge;
+class Histogram;
+
+enum class TaskPriority {
+    Normal,     // Per-worker deques, stolen by idle workers
+    High        // Shared lane, taken before any normal task
+};
+
+// Small work-stealing thread pool. Each worker owns a deque: tasks it
+// submits itself go to the back and it pops from the back (newest first,
+// while the frame is still in cache); idle workers steal from the front of
+// the others' deques. Tasks submitted from outside the pool are spread
+// round-robin. High-priority tasks skip the deques and are taken first.
+// Tasks must not throw.
+class TaskExecutor {
+public:
+    using Task = std::function<void()>;
+
+    // name labels the metrics and the worker thread names in traces
+    explicit TaskExecutor(const std::string& name);
+    ~TaskExecutor();
+    TaskExecutor(const TaskExecutor&) = delete;
+    TaskExecutor& operator=(const TaskExecutor&) = delete;
+
+    // Start the workers; 0 = one per core
+    void start(size_t workers);
+
+    // Queue a task after start(); may be called from any thread, including a task
+    void submit(Task task, TaskPriority priority = TaskPriority::Normal);
+
+    // Run every queued task (and any they submit) to completion, then join
+    void stop();
+
+    size_t workers() const { return queues_.size(); }
+    size_t pending() const { return pending_.load(std::memory_order_relaxed); }
+
+private:
+    struct QueuedTask {
+        Task run;
+        std::chrono::steady_clock::time_point queuedAt;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<QueuedTask> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool takeTask(size_t index, QueuedTask& out, bool& stolen, bool& high);
+    void runTask(QueuedTask& task, bool high);
+
+    std::string name_;
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex highMutex_;
+    std::deque<QueuedTask> highQueue_;
+
+    // pending_ counts queued tasks; workers sleep on idle_ while it is zero
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> nextQueue_{0};
+    std::mutex idleMutex_;
+    std::condition_variable idle_;
+    bool stopping_ = false;
+
+    Counter* normalTasks_ = nullptr;
+    Counter* highTasks_ = nullptr;
+    Counter* steals_ = nullptr;
+    Histogram* normalLatency_ = nullptr;
+    Histogram* highLatency_ = nullptr;
+    Gauge* queued_ = nullptr;
+};
+
+#endif // TASK_EXECUTOR_H
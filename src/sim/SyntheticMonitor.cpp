@@ -0,0 +1,190 @@
+#include "SyntheticMonitor.h"
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+// Trace speed in pixels per second of signal
+constexpr double kEcgPixelsPerSecond = 120.0;
+
+// One heartbeat as a sum of Gaussian bumps (P, Q, R, S, T) over phase 0..1
+double ecgWaveform(double phase) {
+    auto bump = [phase](double center, double width, double amplitude) {
+        double d = (phase - center) / width;
+        return amplitude * std::exp(-d * d);
+    };
+    return bump(0.20, 0.025, 0.12) + bump(0.37, 0.010, -0.10) + bump(0.40, 0.012, 1.00) +
+           bump(0.43, 0.012, -0.25) + bump(0.65, 0.050, 0.30);
+}
+
+int clampInt(int value, int low, int high) {
+    return std::max(low, std::min(high, value));
+}
+
+} // namespace
+
+int SyntheticMonitorStyle::fontFromName(const std::string& name) {
+    if (name == "plain") return cv::FONT_HERSHEY_PLAIN;
+    if (name == "duplex") return cv::FONT_HERSHEY_DUPLEX;
+    if (name == "complex") return cv::FONT_HERSHEY_COMPLEX;
+    if (name == "triplex") return cv::FONT_HERSHEY_TRIPLEX;
+    return cv::FONT_HERSHEY_SIMPLEX;
+}
+
+SyntheticMonitorGenerator::SyntheticMonitorGenerator(const SyntheticMonitorStyle& style, uint64_t seed, double fps)
+    : style_(style), rng_(seed), fps_(fps > 0 ? fps : 30.0) {
+    vitals_.hr = rng_.uniform(60, 100);
+    vitals_.spo2 = rng_.uniform(94, 100);
+    vitals_.systolic = rng_.uniform(105, 140);
+    vitals_.diastolic = rng_.uniform(65, 90);
+}
+
+void SyntheticMonitorGenerator::advanceVitals() {
+    // Monitors refresh numerics about once a second; random-walk them at that rate
+    if (frameIndex_ == 0 || frameIndex_ % static_cast<uint64_t>(std::max(1.0, fps_)) != 0) {
+        return;
+    }
+    vitals_.hr = clampInt(vitals_.hr + rng_.uniform(-3, 4), 45, 160);
+    vitals_.spo2 = clampInt(vitals_.spo2 + rng_.uniform(-1, 2), 85, 100);
+    vitals_.systolic = clampInt(vitals_.systolic + rng_.uniform(-3, 4), 90, 180);
+    vitals_.diastolic = clampInt(vitals_.diastolic + rng_.uniform(-2, 3), 50, std::min(110, vitals_.systolic - 20));
+}
+
+void SyntheticMonitorGenerator::drawEcg(cv::Mat& frame, const cv::Rect& area, double timeSec) const {
+    // The newest sample sits at the right edge and the trace scrolls left
+    std::vector<cv::Point> points;
+    points.reserve(static_cast<size_t>(area.width));
+    double beatsPerSecond = vitals_.hr / 60.0;
+    double baseline = area.y + area.height * 0.65;
+    double gain = area.height * 0.55;
+    for (int x = 0; x < area.width; x++) {
+        double t = timeSec - (area.width - 1 - x) / kEcgPixelsPerSecond;
+        double beats = t * beatsPerSecond;
+        double phase = beats - std::floor(beats);
+        int y = static_cast<int>(baseline - gain * ecgWaveform(phase));
+        points.emplace_back(area.x + x, y);
+    }
+    cv::polylines(frame, std::vector<std::vector<cv::Point>>{points}, false, style_.ecgColor, 2, cv::LINE_AA);
+}
+
+void SyntheticMonitorGenerator::drawValue(cv::Mat& frame, const cv::Rect& area, const std::string& label,
+                                          const std::string& value, const cv::Scalar& valueColor) const {
+    int baseline = 0;
+    cv::Size labelSize = cv::getTextSize(label, style_.fontFace, style_.labelScale, style_.thickness, &baseline);
+    cv::Size valueSize = cv::getTextSize(value, style_.fontFace, style_.valueScale, style_.thickness, &baseline);
+    
+    int margin = std::max(4, area.height / 12);
+    cv::Point labelOrigin(area.x + margin, area.y + margin + labelSize.height);
+    cv::Point valueOrigin(area.x + margin, std::min(area.y + area.height - margin,
+                                                   labelOrigin.y + margin + valueSize.height));
+    
+    cv::rectangle(frame, area, style_.labelColor * 0.3, 1);
+    cv::putText(frame, label, labelOrigin, style_.fontFace, style_.labelScale, style_.labelColor, style_.thickness, cv::LINE_AA);
+    cv::putText(frame, value, valueOrigin, style_.fontFace, style_.valueScale, valueColor, style_.thickness, cv::LINE_AA);
+}
+
+void SyntheticMonitorGenerator::degrade(cv::Mat& frame) {
+    if (style_.perspective > 0.0) {
+        float w = static_cast<float>(frame.cols);
+        float h = static_cast<float>(frame.rows);
+        auto jitter = [this](float extent) {
+            return static_cast<float>(rng_.uniform(0.0, style_.perspective) * extent);
+        };
+        cv::Point2f src[4] = {{0, 0}, {w - 1, 0}, {w - 1, h - 1}, {0, h - 1}};
+        cv::Point2f dst[4] = {{jitter(w), jitter(h)}, {w - 1 - jitter(w), jitter(h)},
+                              {w - 1 - jitter(w), h - 1 - jitter(h)}, {jitter(w), h - 1 - jitter(h)}};
+        cv::Mat warped;
+        cv::warpPerspective(frame, warped, cv::getPerspectiveTransform(src, dst), frame.size(),
+                            cv::INTER_LINEAR, cv::BORDER_CONSTANT, style_.background);
+        // Copy into the caller's buffer (a frame-pool slot) rather than
+        // rebinding the header to the temporary
+        warped.copyTo(frame);
+    }
+    
+    if (style_.blurKernel > 1) {
+        int k = style_.blurKernel | 1;
+        cv::GaussianBlur(frame, frame, cv::Size(k, k), 0);
+    }
+    
+    if (style_.noiseSigma > 0.0) {
+        cv::Mat noise(frame.size(), CV_16SC3);
+        rng_.fill(noise, cv::RNG::NORMAL, 0.0, style_.noiseSigma);
+        cv::Mat widened;
+        frame.convertTo(widened, CV_16SC3);
+        widened += noise;
+        widened.convertTo(frame, CV_8UC3);
+    }
+}
+
+void SyntheticMonitorGenerator::next(cv::Mat& frame, SyntheticVitals& truth) {
+    advanceVitals();
+    vitals_.frameIndex = frameIndex_;
+    
+    frame.create(style_.height, style_.width, CV_8UC3);
+    frame.setTo(style_.background);
+    
+    const int w = style_.width;
+    const int h = style_.height;
+    const double timeSec = frameIndex_ / fps_;
+    
+    if (style_.layout == "row") {
+        // ECG across the top, three value boxes along the bottom
+        int ecgHeight = h * 55 / 100;
+        drawEcg(frame, cv::Rect(8, 8, w - 16, ecgHeight - 16), timeSec);
+        int boxWidth = w / 3;
+        int boxY = ecgHeight;
+        int boxHeight = h - ecgHeight - 8;
+        drawValue(frame, cv::Rect(4, boxY, boxWidth - 8, boxHeight), "HR", std::to_string(vitals_.hr), style_.hrColor);
+        drawValue(frame, cv::Rect(boxWidth + 4, boxY, boxWidth - 8, boxHeight), "SpO2", std::to_string(vitals_.spo2), style_.spo2Color);
+        drawValue(frame, cv::Rect(2 * boxWidth + 4, boxY, boxWidth - 8, boxHeight), "ABP", vitals_.abp(), style_.abpColor);
+    } else {
+        // ECG on the left, values stacked in a right-hand column
+        int ecgWidth = w * 55 / 100;
+        drawEcg(frame, cv::Rect(8, h / 8, ecgWidth - 16, h / 3), timeSec);
+        int boxX = ecgWidth;
+        int boxWidth = w - ecgWidth - 8;
+        int boxHeight = (h - 16) / 3;
+        drawValue(frame, cv::Rect(boxX, 8, boxWidth, boxHeight - 4), "HR", std::to_string(vitals_.hr), style_.hrColor);
+        drawValue(frame, cv::Rect(boxX, 8 + boxHeight, boxWidth, boxHeight - 4), "SpO2", std::to_string(vitals_.spo2), style_.spo2Color);
+        drawValue(frame, cv::Rect(boxX, 8 + 2 * boxHeight, boxWidth, boxHeight - 4), "ABP", vitals_.abp(), style_.abpColor);
+    }
+    
+    degrade(frame);
+    truth = vitals_;
+    frameIndex_++;
+}
+
+bool SyntheticMonitorGenerator::writeDataset(const std::string& dir, int count,
+                                             const SyntheticMonitorStyle& style, uint64_t seed, double fps) {
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    std::ofstream truthFile((fs::path(dir) / "ground_truth.csv").string());
+    if (!truthFile.is_open()) {
+        return false;
+    }
+    truthFile << "frame,file,hr,spo2,abp\n";
+    
+    SyntheticMonitorGenerator generator(style, seed, fps);
+    cv::Mat frame;
+    SyntheticVitals truth;
+    for (int i = 0; i < count; i++) {
+        generator.next(frame, truth);
+        char name[32];
+        snprintf(name, sizeof(name), "frame_%06d.png", i);
+        if (!cv::imwrite((fs::path(dir) / name).string(), frame)) {
+            return false;
+        }
+        truthFile << truth.frameIndex << "," << name << "," << truth.hr << ","
+                  << truth.spo2 << "," << truth.abp() << "\n";
+    }
+    return truthFile.good();
+}
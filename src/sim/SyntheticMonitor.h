@@ -0,0 +1,74 @@
+#ifndef SYNTHETIC_MONITOR_H
+#define SYNTHETIC_MONITOR_H
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <string>
+
+// Appearance of a rendered monitor frame
+struct SyntheticMonitorStyle {
+    int width = 640;
+    int height = 480;
+    std::string layout = "column";      // "column": values right of the ECG; "row": values below it
+    int fontFace = 0;                   // cv::HersheyFonts value (0 = FONT_HERSHEY_SIMPLEX)
+    double labelScale = 0.8;
+    double valueScale = 1.6;
+    int thickness = 2;
+    cv::Scalar background = cv::Scalar(0, 0, 0);
+    cv::Scalar labelColor = cv::Scalar(220, 220, 220);
+    cv::Scalar hrColor = cv::Scalar(0, 255, 0);
+    cv::Scalar spo2Color = cv::Scalar(255, 255, 0);
+    cv::Scalar abpColor = cv::Scalar(80, 80, 255);
+    cv::Scalar ecgColor = cv::Scalar(0, 255, 0);
+    
+    // Degradations applied after drawing
+    double noiseSigma = 0.0;            // Gaussian pixel noise (0-255 scale)
+    int blurKernel = 0;                 // Odd Gaussian kernel size; 0 disables
+    double perspective = 0.0;           // Max corner offset as a fraction of the frame size
+    
+    // Map a name ("simplex", "duplex", "plain", "complex", "triplex") to a Hershey font
+    static int fontFromName(const std::string& name);
+};
+
+// Ground truth for one rendered frame
+struct SyntheticVitals {
+    uint64_t frameIndex = 0;
+    int hr = 0;
+    int spo2 = 0;
+    int systolic = 0;
+    int diastolic = 0;
+    
+    std::string abp() const { return std::to_string(systolic) + "/" + std::to_string(diastolic); }
+};
+
+// Renders deterministic patient-monitor frames: labelled HR/SpO2/ABP values
+// that drift like real vitals and a scrolling ECG trace. The same seed and
+// style always produce the same frame sequence, so accuracy and speed can be
+// regression-tested offline.
+class SyntheticMonitorGenerator {
+public:
+    explicit SyntheticMonitorGenerator(const SyntheticMonitorStyle& style = SyntheticMonitorStyle(),
+                                       uint64_t seed = 1, double fps = 30.0);
+    
+    // Render the next frame and report the values drawn on it
+    void next(cv::Mat& frame, SyntheticVitals& truth);
+    
+    // Write count frames as frame_NNNNNN.png plus ground_truth.csv into dir
+    static bool writeDataset(const std::string& dir, int count,
+                             const SyntheticMonitorStyle& style, uint64_t seed, double fps = 30.0);
+    
+private:
+    void advanceVitals();
+    void drawEcg(cv::Mat& frame, const cv::Rect& area, double timeSec) const;
+    void drawValue(cv::Mat& frame, const cv::Rect& area, const std::string& label,
+                   const std::string& value, const cv::Scalar& valueColor) const;
+    void degrade(cv::Mat& frame);
+    
+    SyntheticMonitorStyle style_;
+    cv::RNG rng_;
+    double fps_;
+    uint64_t frameIndex_ = 0;
+    SyntheticVitals vitals_;
+};
+
+#endif // SYNTHETIC_MONITOR_H
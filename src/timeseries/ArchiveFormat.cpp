@@ -0,0 +1,410 @@
+#include "ArchiveFormat.h"
+
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <map>
+
+namespace {
+
+uint64_t zigzag(int64_t v) {
+    return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+}
+
+int64_t unzigzag(uint64_t u) {
+    return static_cast<int64_t>(u >> 1) ^ -static_cast<int64_t>(u & 1);
+}
+
+// Groups of 4 value bits, least significant first, each followed by a
+// continuation bit: small deltas cost 5 bits
+void writeVarint(BitWriter& bits, uint64_t value) {
+    do {
+        uint64_t group = value & 0xF;
+        value >>= 4;
+        bits.write(group, 4);
+        bits.write(value != 0 ? 1 : 0, 1);
+    } while (value != 0);
+}
+
+uint64_t readVarint(BitReader& bits) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 4) {
+        value |= bits.read(4) << shift;
+        if (bits.read(1) == 0) {
+            break;
+        }
+    }
+    return value;
+}
+
+uint32_t floatBits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+float bitsFloat(uint32_t u) {
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+void putLittleEndian(uint8_t*& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; i++) {
+        *out++ = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint64_t getLittleEndian(const uint8_t*& data, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; i++) {
+        value |= static_cast<uint64_t>(*data++) << (8 * i);
+    }
+    return value;
+}
+
+} // namespace
+
+void BitWriter::write(uint64_t bits, int count) {
+    if (count > 32) {
+        write(bits >> 32, count - 32);
+        count = 32;
+    }
+    if (count < 64) {
+        bits &= (uint64_t(1) << count) - 1;
+    }
+    acc_ = (acc_ << count) | bits;
+    pending_ += count;
+    while (pending_ >= 8) {
+        pending_ -= 8;
+        out_.push_back(static_cast<uint8_t>(acc_ >> pending_));
+    }
+}
+
+void BitWriter::finish() {
+    if (pending_ > 0) {
+        out_.push_back(static_cast<uint8_t>(acc_ << (8 - pending_)));
+        pending_ = 0;
+    }
+    acc_ = 0;
+}
+
+uint64_t BitReader::read(int count) {
+    if (count > 32) {
+        uint64_t high = read(count - 32);
+        return (high << 32) | read(32);
+    }
+    while (available_ < count) {
+        uint8_t byte = 0;
+        if (pos_ < size_) {
+            byte = data_[pos_++];
+        } else {
+            overrun_ = true;
+        }
+        acc_ = (acc_ << 8) | byte;
+        available_ += 8;
+    }
+    available_ -= count;
+    return (acc_ >> available_) & ((uint64_t(1) << count) - 1);
+}
+
+namespace archive {
+
+void encodeTimes(const std::vector<int64_t>& values, std::vector<uint8_t>& out) {
+    BitWriter bits(out);
+    int64_t prev = 0;
+    int64_t prevDelta = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        if (i == 0) {
+            bits.write(static_cast<uint64_t>(values[0]), 64);
+        } else if (i == 1) {
+            prevDelta = values[1] - prev;
+            writeVarint(bits, zigzag(prevDelta));
+        } else {
+            int64_t delta = values[i] - prev;
+            uint64_t dod = zigzag(delta - prevDelta);
+            if (dod == 0) {
+                bits.write(0, 1);
+            } else if (dod < (1u << 7)) {
+                bits.write(0x2, 2);
+                bits.write(dod, 7);
+            } else if (dod < (1u << 9)) {
+                bits.write(0x6, 3);
+                bits.write(dod, 9);
+            } else if (dod < (1u << 12)) {
+                bits.write(0xE, 4);
+                bits.write(dod, 12);
+            } else {
+                bits.write(0xF, 4);
+                bits.write(dod, 64);
+            }
+            prevDelta = delta;
+        }
+        prev = values[i];
+    }
+    bits.finish();
+}
+
+bool decodeTimes(const uint8_t* data, size_t size, size_t count, std::vector<int64_t>& values) {
+    BitReader bits(data, size);
+    values.resize(count);
+    int64_t prev = 0;
+    int64_t delta = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i == 0) {
+            prev = static_cast<int64_t>(bits.read(64));
+        } else if (i == 1) {
+            delta = unzigzag(readVarint(bits));
+            prev += delta;
+        } else {
+            uint64_t dod = 0;
+            if (bits.read(1) == 0) {
+                dod = 0;
+            } else if (bits.read(1) == 0) {
+                dod = bits.read(7);
+            } else if (bits.read(1) == 0) {
+                dod = bits.read(9);
+            } else if (bits.read(1) == 0) {
+                dod = bits.read(12);
+            } else {
+                dod = bits.read(64);
+            }
+            delta += unzigzag(dod);
+            prev += delta;
+        }
+        values[i] = prev;
+    }
+    return !bits.overrun();
+}
+
+void encodeInts(const std::vector<int32_t>& values, std::vector<uint8_t>& out) {
+    BitWriter bits(out);
+    int64_t prev = 0;
+    for (int32_t value : values) {
+        int64_t delta = static_cast<int64_t>(value) - prev;
+        if (delta == 0) {
+            bits.write(0, 1);
+        } else {
+            bits.write(1, 1);
+            writeVarint(bits, zigzag(delta));
+        }
+        prev = value;
+    }
+    bits.finish();
+}
+
+bool decodeInts(const uint8_t* data, size_t size, size_t count, std::vector<int32_t>& values) {
+    BitReader bits(data, size);
+    values.resize(count);
+    int64_t prev = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (bits.read(1) != 0) {
+            prev += unzigzag(readVarint(bits));
+        }
+        values[i] = static_cast<int32_t>(prev);
+    }
+    return !bits.overrun();
+}
+
+void encodeFloats(const std::vector<float>& values, std::vector<uint8_t>& out) {
+    BitWriter bits(out);
+    uint32_t prev = 0;
+    int prevLeading = -1;
+    int prevTrailing = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        uint32_t current = floatBits(values[i]);
+        if (i == 0) {
+            bits.write(current, 32);
+            prev = current;
+            continue;
+        }
+        uint32_t x = current ^ prev;
+        prev = current;
+        if (x == 0) {
+            bits.write(0, 1);
+            continue;
+        }
+        bits.write(1, 1);
+        int leading = __builtin_clz(x);
+        int trailing = __builtin_ctz(x);
+        if (leading > 31) leading = 31;
+        if (prevLeading >= 0 && leading >= prevLeading && trailing >= prevTrailing) {
+            // Meaningful bits fit the previous window
+            bits.write(0, 1);
+            bits.write(x >> prevTrailing, 32 - prevLeading - prevTrailing);
+        } else {
+            int length = 32 - leading - trailing;
+            bits.write(1, 1);
+            bits.write(static_cast<uint64_t>(leading), 5);
+            bits.write(static_cast<uint64_t>(length - 1), 5);
+            bits.write(x >> trailing, length);
+            prevLeading = leading;
+            prevTrailing = trailing;
+        }
+    }
+    bits.finish();
+}
+
+bool decodeFloats(const uint8_t* data, size_t size, size_t count, std::vector<float>& values) {
+    BitReader bits(data, size);
+    values.resize(count);
+    uint32_t prev = 0;
+    int prevLeading = 0;
+    int prevTrailing = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i == 0) {
+            prev = static_cast<uint32_t>(bits.read(32));
+        } else if (bits.read(1) != 0) {
+            if (bits.read(1) != 0) {
+                prevLeading = static_cast<int>(bits.read(5));
+                int length = static_cast<int>(bits.read(5)) + 1;
+                prevTrailing = 32 - prevLeading - length;
+                if (prevTrailing < 0) {
+                    return false;
+                }
+            }
+            int length = 32 - prevLeading - prevTrailing;
+            prev ^= static_cast<uint32_t>(bits.read(length) << prevTrailing);
+        }
+        values[i] = bitsFloat(prev);
+    }
+    return !bits.overrun();
+}
+
+void encodeLabels(const std::vector<std::string>& values, std::vector<uint8_t>& out) {
+    std::map<std::string, int32_t> ids;
+    std::vector<const std::string*> dictionary;
+    std::vector<int32_t> coded;
+    coded.reserve(values.size());
+    for (const std::string& value : values) {
+        auto inserted = ids.emplace(value, static_cast<int32_t>(dictionary.size()));
+        if (inserted.second) {
+            dictionary.push_back(&inserted.first->first);
+        }
+        coded.push_back(inserted.first->second);
+    }
+
+    BitWriter bits(out);
+    writeVarint(bits, dictionary.size());
+    for (const std::string* label : dictionary) {
+        writeVarint(bits, label->size());
+        for (char c : *label) {
+            bits.write(static_cast<uint8_t>(c), 8);
+        }
+    }
+    bits.finish();
+    encodeInts(coded, out);
+}
+
+bool decodeLabels(const uint8_t* data, size_t size, size_t count, std::vector<std::string>& values) {
+    BitReader bits(data, size);
+    uint64_t entries = readVarint(bits);
+    if (entries > count + 1) {
+        return false;
+    }
+    std::vector<std::string> dictionary(entries);
+    for (std::string& label : dictionary) {
+        uint64_t length = readVarint(bits);
+        if (length > size) {
+            return false;
+        }
+        label.resize(length);
+        for (char& c : label) {
+            c = static_cast<char>(bits.read(8));
+        }
+        if (bits.overrun()) {
+            return false;
+        }
+    }
+
+    // The dictionary is padded to a byte; the ids start after it
+    size_t used = bits.bytePosition();
+    std::vector<int32_t> ids;
+    if (!decodeInts(data + used, size - used, count, ids)) {
+        return false;
+    }
+    values.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        if (ids[i] < 0 || static_cast<size_t>(ids[i]) >= dictionary.size()) {
+            return false;
+        }
+        values[i] = dictionary[ids[i]];
+    }
+    return true;
+}
+
+void encodeIndex(const ArchiveBlockIndex& entry, uint8_t* out) {
+    putLittleEndian(out, static_cast<uint64_t>(entry.firstMs), 8);
+    putLittleEndian(out, static_cast<uint64_t>(entry.lastMs), 8);
+    putLittleEndian(out, entry.count, 4);
+    putLittleEndian(out, entry.reserved, 4);
+    for (int c = 0; c < kArchiveColumns; c++) {
+        putLittleEndian(out, entry.offset[c], 8);
+    }
+    for (int c = 0; c < kArchiveColumns; c++) {
+        putLittleEndian(out, entry.size[c], 4);
+    }
+}
+
+void decodeIndex(const uint8_t* data, ArchiveBlockIndex& entry) {
+    entry.firstMs = static_cast<int64_t>(getLittleEndian(data, 8));
+    entry.lastMs = static_cast<int64_t>(getLittleEndian(data, 8));
+    entry.count = static_cast<uint32_t>(getLittleEndian(data, 4));
+    entry.reserved = static_cast<uint32_t>(getLittleEndian(data, 4));
+    for (int c = 0; c < kArchiveColumns; c++) {
+        entry.offset[c] = getLittleEndian(data, 8);
+    }
+    for (int c = 0; c < kArchiveColumns; c++) {
+        entry.size[c] = static_cast<uint32_t>(getLittleEndian(data, 4));
+    }
+}
+
+const char* columnFileName(ArchiveColumn column) {
+    switch (column) {
+        case ArchiveColumn::Time: return "time.col";
+        case ArchiveColumn::Hr: return "hr.col";
+        case ArchiveColumn::SpO2: return "spo2.col";
+        case ArchiveColumn::Systolic: return "systolic.col";
+        case ArchiveColumn::Diastolic: return "diastolic.col";
+        case ArchiveColumn::EcgLabel: return "ecg_label.col";
+        case ArchiveColumn::EcgConfidence: return "ecg_confidence.col";
+        default: return "";
+    }
+}
+
+std::string sourceDirectory(const std::string& sourceId) {
+    if (sourceId.empty()) {
+        return "default";
+    }
+    std::string dir = sourceId;
+    for (char& c : dir) {
+        if (c == '/' || c == '\\') {
+            c = '_';
+        }
+    }
+    return dir == "." || dir == ".." ? "_" + dir : dir;
+}
+
+std::string utcDay(int64_t timeMs) {
+    time_t seconds = static_cast<time_t>(timeMs / 1000 - (timeMs % 1000 < 0 ? 1 : 0));
+    struct tm parts;
+    gmtime_r(&seconds, &parts);
+    char buf[16];
+    strftime(buf, sizeof(buf), "%Y-%m-%d", &parts);
+    return buf;
+}
+
+bool parseUtcDay(const std::string& day, int64_t& startMs) {
+    struct tm parts = {};
+    int consumed = 0;
+    if (sscanf(day.c_str(), "%4d-%2d-%2d%n", &parts.tm_year, &parts.tm_mon, &parts.tm_mday, &consumed) != 3 ||
+        static_cast<size_t>(consumed) != day.size()) {
+        return false;
+    }
+    parts.tm_year -= 1900;
+    parts.tm_mon -= 1;
+    startMs = static_cast<int64_t>(timegm(&parts)) * 1000;
+    return true;
+}
+
+} // namespace archive
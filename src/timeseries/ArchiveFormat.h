@@ -0,0 +1,108 @@
+#ifndef ARCHIVE_FORMAT_H
+#define ARCHIVE_FORMAT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One archived row; integer vitals are -1 when there was no reading
+struct ArchiveSample {
+    int64_t timeMs = 0;
+    int hr = -1;
+    int spo2 = -1;
+    int systolic = -1;
+    int diastolic = -1;
+    std::string ecgLabel;
+    float ecgConfidence = 0.0f;
+};
+
+// Column files of a partition, in index order
+enum class ArchiveColumn { Time, Hr, SpO2, Systolic, Diastolic, EcgLabel, EcgConfidence, Count };
+constexpr int kArchiveColumns = static_cast<int>(ArchiveColumn::Count);
+
+// Record appended to a partition's index file once all column chunks of a
+// block are on disk. A reader ignores records whose chunks run past the end
+// of a column file (a crash between the two writes). On disk the fields are
+// little-endian, in this order, without padding (kArchiveIndexRecordSize).
+struct ArchiveBlockIndex {
+    int64_t firstMs;
+    int64_t lastMs;
+    uint32_t count;
+    uint32_t reserved;
+    uint64_t offset[kArchiveColumns];
+    uint32_t size[kArchiveColumns];
+};
+
+constexpr size_t kArchiveIndexRecordSize = 8 + 8 + 4 + 4 + kArchiveColumns * (8 + 4);
+
+constexpr char kArchiveIndexMagic[8] = {'V', 'S', 'A', 'R', 'C', 'H', '1', '\0'};
+
+// MSB-first bit stream
+class BitWriter {
+public:
+    explicit BitWriter(std::vector<uint8_t>& out) : out_(out) {}
+    void write(uint64_t bits, int count);       // count <= 64
+    void finish();                              // Pad the last byte with zeros
+
+private:
+    std::vector<uint8_t>& out_;
+    uint64_t acc_ = 0;
+    int pending_ = 0;
+};
+
+class BitReader {
+public:
+    BitReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+    uint64_t read(int count);                   // count <= 64; zeros past the end
+    bool overrun() const { return overrun_; }
+    // Bytes touched so far, counting a partially read byte as consumed
+    size_t bytePosition() const { return pos_ - static_cast<size_t>(available_ / 8); }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+    uint64_t acc_ = 0;
+    int available_ = 0;
+    bool overrun_ = false;
+};
+
+// Column codecs. Every block is encoded on its own, so any block can be
+// decoded without the ones before it.
+//   Time: first value raw, first delta as a varint, then Gorilla
+//         delta-of-delta buckets ('0' for a steady interval)
+//   Integers: '0' for no change, else '1' + zig-zag delta in 4-bit varint groups
+//   Floats: Gorilla XOR against the previous value
+//   Labels: per-block dictionary, then ids as integers
+namespace archive {
+
+void encodeTimes(const std::vector<int64_t>& values, std::vector<uint8_t>& out);
+bool decodeTimes(const uint8_t* data, size_t size, size_t count, std::vector<int64_t>& values);
+
+void encodeInts(const std::vector<int32_t>& values, std::vector<uint8_t>& out);
+bool decodeInts(const uint8_t* data, size_t size, size_t count, std::vector<int32_t>& values);
+
+void encodeFloats(const std::vector<float>& values, std::vector<uint8_t>& out);
+bool decodeFloats(const uint8_t* data, size_t size, size_t count, std::vector<float>& values);
+
+void encodeLabels(const std::vector<std::string>& values, std::vector<uint8_t>& out);
+bool decodeLabels(const uint8_t* data, size_t size, size_t count, std::vector<std::string>& values);
+
+// Index record to and from its kArchiveIndexRecordSize bytes
+void encodeIndex(const ArchiveBlockIndex& entry, uint8_t* out);
+void decodeIndex(const uint8_t* data, ArchiveBlockIndex& entry);
+
+const char* columnFileName(ArchiveColumn column);
+constexpr const char* kIndexFileName = "index.bin";
+
+// Directory of a source under the archive root ("" -> "default", '/' -> '_')
+std::string sourceDirectory(const std::string& sourceId);
+
+// "YYYY-MM-DD" of the UTC day containing timeMs, and back to the day's start
+std::string utcDay(int64_t timeMs);
+bool parseUtcDay(const std::string& day, int64_t& startMs);
+
+} // namespace archive
+
+#endif // ARCHIVE_FORMAT_H
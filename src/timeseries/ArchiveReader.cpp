@@ -0,0 +1,175 @@
+#include "ArchiveReader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const int64_t kDayMs = 86400000LL;
+
+bool readFile(const fs::path& path, std::vector<uint8_t>& data) {
+    FILE* in = fopen(path.c_str(), "rb");
+    if (in == nullptr) {
+        return false;
+    }
+    data.clear();
+    uint8_t buf[65536];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+        data.insert(data.end(), buf, buf + n);
+    }
+    bool ok = ferror(in) == 0;
+    fclose(in);
+    return ok;
+}
+
+bool readChunk(FILE* in, uint64_t offset, uint32_t size, std::vector<uint8_t>& chunk) {
+    chunk.resize(size);
+    return fseek(in, static_cast<long>(offset), SEEK_SET) == 0 &&
+           fread(chunk.data(), 1, size, in) == size;
+}
+
+} // namespace
+
+ArchiveReader::ArchiveReader(const std::string& root) : root_(root) {
+}
+
+std::vector<std::string> ArchiveReader::sources() const {
+    std::vector<std::string> names;
+    std::error_code ec;
+    for (fs::directory_iterator it(root_, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_directory(ec)) {
+            names.push_back(it->path().filename().string());
+        }
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+bool ArchiveReader::read(const std::string& sourceId, int64_t fromMs, int64_t toMs,
+                         std::vector<ArchiveSample>& out, ArchiveReadStats* stats) const {
+    fs::path dir = fs::path(root_) / archive::sourceDirectory(sourceId);
+    std::error_code ec;
+    if (!fs::is_directory(dir, ec)) {
+        return false;
+    }
+
+    // Day names sort chronologically
+    std::vector<std::string> days;
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        std::string name = it->path().filename().string();
+        int64_t startMs = 0;
+        if (archive::parseUtcDay(name, startMs) && startMs <= toMs && startMs + kDayMs > fromMs) {
+            days.push_back(name);
+        }
+    }
+    std::sort(days.begin(), days.end());
+
+    ArchiveReadStats local;
+    ArchiveReadStats& counts = stats != nullptr ? *stats : local;
+    size_t before = out.size();
+    for (const std::string& day : days) {
+        readPartition((dir / day).string(), fromMs, toMs, out, counts);
+    }
+    counts.samples += out.size() - before;
+    return true;
+}
+
+bool ArchiveReader::readPartition(const std::string& dir, int64_t fromMs, int64_t toMs,
+                                  std::vector<ArchiveSample>& out, ArchiveReadStats& stats) const {
+    std::vector<uint8_t> index;
+    if (!readFile(fs::path(dir) / archive::kIndexFileName, index) || index.size() < sizeof(kArchiveIndexMagic) ||
+        std::memcmp(index.data(), kArchiveIndexMagic, sizeof(kArchiveIndexMagic)) != 0) {
+        return false;
+    }
+
+    FILE* columns[kArchiveColumns] = {};
+    uint64_t fileSize[kArchiveColumns] = {};
+    bool ok = true;
+    for (int c = 0; c < kArchiveColumns; c++) {
+        fs::path path = fs::path(dir) / archive::columnFileName(static_cast<ArchiveColumn>(c));
+        std::error_code ec;
+        fileSize[c] = fs::file_size(path, ec);
+        columns[c] = ec ? nullptr : fopen(path.c_str(), "rb");
+        ok = ok && columns[c] != nullptr;
+    }
+
+    // A torn trailing record is ignored
+    size_t records = ok ? (index.size() - sizeof(kArchiveIndexMagic)) / kArchiveIndexRecordSize : 0;
+    std::vector<uint8_t> chunk;
+    std::vector<int64_t> times;
+    std::vector<int32_t> ints[4];
+    std::vector<std::string> labels;
+    std::vector<float> confidences;
+    for (size_t r = 0; r < records; r++) {
+        ArchiveBlockIndex entry;
+        archive::decodeIndex(index.data() + sizeof(kArchiveIndexMagic) + r * kArchiveIndexRecordSize, entry);
+
+        // Chunks must lie inside the column files
+        bool complete = entry.count > 0;
+        for (int c = 0; complete && c < kArchiveColumns; c++) {
+            complete = entry.offset[c] + entry.size[c] <= fileSize[c];
+        }
+        if (!complete) {
+            continue;
+        }
+        stats.blocks++;
+        if (entry.lastMs < fromMs || entry.firstMs > toMs) {
+            continue;
+        }
+
+        bool decoded = true;
+        for (int c = 0; decoded && c < kArchiveColumns; c++) {
+            decoded = readChunk(columns[c], entry.offset[c], entry.size[c], chunk);
+            stats.encodedBytes += entry.size[c];
+            if (!decoded) {
+                break;
+            }
+            switch (static_cast<ArchiveColumn>(c)) {
+                case ArchiveColumn::Time:
+                    decoded = archive::decodeTimes(chunk.data(), chunk.size(), entry.count, times);
+                    break;
+                case ArchiveColumn::EcgLabel:
+                    decoded = archive::decodeLabels(chunk.data(), chunk.size(), entry.count, labels);
+                    break;
+                case ArchiveColumn::EcgConfidence:
+                    decoded = archive::decodeFloats(chunk.data(), chunk.size(), entry.count, confidences);
+                    break;
+                default:
+                    decoded = archive::decodeInts(chunk.data(), chunk.size(), entry.count,
+                                                  ints[c - static_cast<int>(ArchiveColumn::Hr)]);
+                    break;
+            }
+        }
+        if (!decoded) {
+            continue;
+        }
+        stats.blocksRead++;
+
+        for (size_t i = 0; i < entry.count; i++) {
+            if (times[i] < fromMs || times[i] > toMs) {
+                continue;
+            }
+            ArchiveSample sample;
+            sample.timeMs = times[i];
+            sample.hr = ints[0][i];
+            sample.spo2 = ints[1][i];
+            sample.systolic = ints[2][i];
+            sample.diastolic = ints[3][i];
+            sample.ecgLabel = labels[i];
+            sample.ecgConfidence = confidences[i];
+            out.push_back(std::move(sample));
+        }
+    }
+
+    for (FILE* column : columns) {
+        if (column != nullptr) {
+            fclose(column);
+        }
+    }
+    return ok;
+}
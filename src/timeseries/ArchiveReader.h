@@ -0,0 +1,40 @@
+#ifndef ARCHIVE_READER_H
+#define ARCHIVE_READER_H
+
+#include "ArchiveFormat.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct ArchiveReadStats {
+    size_t blocks = 0;          // Complete blocks in the partitions visited
+    size_t blocksRead = 0;      // Blocks overlapping the range, decoded
+    size_t samples = 0;         // Samples returned
+    size_t encodedBytes = 0;    // Column bytes of the decoded blocks
+};
+
+// Reads the files written by ArchiveWriter. Day directories outside the
+// range are skipped by name and blocks outside it by their index record, so
+// only overlapping blocks are read and decoded. Has no logger or metrics
+// dependency, for use by offline tools.
+class ArchiveReader {
+public:
+    explicit ArchiveReader(const std::string& root);
+
+    // Source directories present under the root
+    std::vector<std::string> sources() const;
+
+    // Samples of one source with fromMs <= timeMs <= toMs, in write order.
+    // Returns false if the source has no archive; damaged blocks are skipped.
+    bool read(const std::string& sourceId, int64_t fromMs, int64_t toMs,
+              std::vector<ArchiveSample>& out, ArchiveReadStats* stats = nullptr) const;
+
+private:
+    bool readPartition(const std::string& dir, int64_t fromMs, int64_t toMs,
+                       std::vector<ArchiveSample>& out, ArchiveReadStats& stats) const;
+
+    std::string root_;
+};
+
+#endif // ARCHIVE_READER_H
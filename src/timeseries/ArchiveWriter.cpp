@@ -0,0 +1,295 @@
+#include "ArchiveWriter.h"
+#include "../monitoring/MetricsRegistry.h"
+#include "../utils/Logger.h"
+
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+Counter& blocksWritten = MetricsRegistry::getInstance().counter(
+    "vitalsign_archive_blocks_total", "Column blocks written to the archive");
+Counter& bytesWritten = MetricsRegistry::getInstance().counter(
+    "vitalsign_archive_bytes_total", "Encoded bytes written to the archive");
+Counter& samplesWritten = MetricsRegistry::getInstance().counter(
+    "vitalsign_archive_samples_total", "Samples written to the archive");
+Counter& writeErrors = MetricsRegistry::getInstance().counter(
+    "vitalsign_archive_write_errors_total", "Archive blocks that could not be written");
+
+} // namespace
+
+ArchiveWriter& ArchiveWriter::getInstance() {
+    static ArchiveWriter instance;
+    return instance;
+}
+
+ArchiveWriter::~ArchiveWriter() {
+    close();
+}
+
+bool ArchiveWriter::init(const std::string& root, size_t blockSamples, int flushIntervalSec) {
+    close();
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::error_code ec;
+    fs::create_directories(root, ec);
+    if (ec) {
+        LOG_ERROR("Cannot create archive directory " + root + ": " + ec.message());
+        return false;
+    }
+    root_ = root;
+    blockSamples_ = std::max<size_t>(1, blockSamples);
+    flushInterval_ = std::chrono::seconds(std::max(1, flushIntervalSec));
+    stop_ = false;
+    writer_ = std::thread(&ArchiveWriter::writerLoop, this);
+    open_ = true;
+    LOG_INFO("Vitals archive: " + root + ", blocks of " + std::to_string(blockSamples_) + " samples");
+    return true;
+}
+
+void ArchiveWriter::append(const std::string& sourceId, std::chrono::system_clock::time_point time,
+                           const VitalSample& vitals, const std::string& ecgLabel, float ecgConfidence) {
+    if (!open_) {
+        return;
+    }
+
+    ArchiveSample sample;
+    sample.timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+    sample.hr = vitals.hr;
+    sample.spo2 = vitals.spo2;
+    sample.systolic = vitals.systolic;
+    sample.diastolic = vitals.diastolic;
+    sample.ecgLabel = ecgLabel;
+    sample.ecgConfidence = ecgConfidence;
+    std::string day = archive::utcDay(sample.timeMs);
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Source& source = sources_[sourceId];
+    if (!source.pending.empty() && source.day != day) {
+        sealLocked(sourceId, source);
+    }
+    if (source.pending.empty()) {
+        if (source.pending.capacity() == 0 && !spare_.empty()) {
+            source.pending.swap(spare_.back());
+            spare_.pop_back();
+        }
+        source.pending.reserve(blockSamples_);
+        source.day = day;
+        source.since = now;
+    }
+    source.pending.push_back(std::move(sample));
+
+    if (source.pending.size() >= blockSamples_) {
+        sealLocked(sourceId, source);
+    }
+}
+
+// Hand the pending samples to the writer thread
+void ArchiveWriter::sealLocked(const std::string& sourceId, Source& source) {
+    sealed_.push_back(Block{sourceId, source.day, std::move(source.pending)});
+    source.pending.clear();
+    wake_.notify_one();
+}
+
+// Seals blocks whose flush interval has passed, including those of sources
+// that stopped appending, and writes sealed blocks
+void ArchiveWriter::writerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        auto now = std::chrono::steady_clock::now();
+        auto next = now + flushInterval_;
+        for (auto& entry : sources_) {
+            Source& source = entry.second;
+            if (source.pending.empty()) {
+                continue;
+            }
+            if (now - source.since >= flushInterval_) {
+                sealLocked(entry.first, source);
+            } else {
+                next = std::min(next, source.since + flushInterval_);
+            }
+        }
+        if (!sealed_.empty()) {
+            lock.unlock();
+            writeSealed();
+            lock.lock();
+            continue;
+        }
+        wake_.wait_until(lock, next);
+    }
+}
+
+void ArchiveWriter::flush() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& entry : sources_) {
+            if (!entry.second.pending.empty()) {
+                sealLocked(entry.first, entry.second);
+            }
+        }
+    }
+    writeSealed();
+}
+
+void ArchiveWriter::close() {
+    std::thread writer;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        open_ = false;
+        stop_ = true;
+        wake_.notify_all();
+        writer.swap(writer_);
+    }
+    if (writer.joinable()) {
+        writer.join();
+    }
+    flush();
+    std::lock_guard<std::mutex> writing(writeMutex_);
+    for (auto& entry : partitions_) {
+        closePartition(entry.second);
+    }
+    partitions_.clear();
+}
+
+// Write every sealed block in order; the writer thread and flush() take turns
+void ArchiveWriter::writeSealed() {
+    std::lock_guard<std::mutex> writing(writeMutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        writing_.swap(sealed_);
+    }
+    for (const Block& block : writing_) {
+        writeBlock(block);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Block& block : writing_) {
+        block.samples.clear();
+        spare_.push_back(std::move(block.samples));
+    }
+    writing_.clear();
+}
+
+// Open (creating) the column and index files of a source's day, closing the
+// previous day's; a new index file starts with the magic
+bool ArchiveWriter::openPartition(const std::string& sourceId, const std::string& day, Partition& partition) {
+    closePartition(partition);
+    fs::path dir = fs::path(root_) / archive::sourceDirectory(sourceId) / day;
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    bool ok = !ec;
+    for (int c = 0; ok && c < kArchiveColumns; c++) {
+        fs::path path = dir / archive::columnFileName(static_cast<ArchiveColumn>(c));
+        partition.columns[c] = fopen(path.c_str(), "ab");
+        ok = partition.columns[c] != nullptr && fseek(partition.columns[c], 0, SEEK_END) == 0;
+        long size = ok ? ftell(partition.columns[c]) : -1;
+        ok = size >= 0;
+        partition.columnBytes[c] = static_cast<uint64_t>(size);
+    }
+    if (ok) {
+        partition.index = fopen((dir / archive::kIndexFileName).c_str(), "ab");
+        ok = partition.index != nullptr && fseek(partition.index, 0, SEEK_END) == 0;
+        long size = ok ? ftell(partition.index) : -1;
+        ok = size >= 0;
+        if (ok && size == 0) {
+            ok = fwrite(kArchiveIndexMagic, 1, sizeof(kArchiveIndexMagic), partition.index) ==
+                     sizeof(kArchiveIndexMagic) &&
+                 fflush(partition.index) == 0;
+        }
+    }
+    if (!ok) {
+        LOG_ERROR("Cannot open archive partition " + dir.string());
+        closePartition(partition);
+        return false;
+    }
+    partition.day = day;
+    return true;
+}
+
+void ArchiveWriter::closePartition(Partition& partition) {
+    for (FILE*& column : partition.columns) {
+        if (column != nullptr) {
+            fclose(column);
+            column = nullptr;
+        }
+    }
+    if (partition.index != nullptr) {
+        fclose(partition.index);
+        partition.index = nullptr;
+    }
+    partition.day.clear();
+}
+
+// Encode and append one block to its partition's open files
+bool ArchiveWriter::writeBlock(const Block& block) {
+    const std::vector<ArchiveSample>& samples = block.samples;
+    size_t n = samples.size();
+    if (n == 0) {
+        return true;
+    }
+    std::vector<int64_t> times(n);
+    std::vector<int32_t> ints[4];
+    std::vector<std::string> labels(n);
+    std::vector<float> confidences(n);
+    for (auto& column : ints) {
+        column.resize(n);
+    }
+    ArchiveBlockIndex entry = {};
+    entry.firstMs = samples[0].timeMs;
+    entry.lastMs = samples[0].timeMs;
+    entry.count = static_cast<uint32_t>(n);
+    for (size_t i = 0; i < n; i++) {
+        const ArchiveSample& s = samples[i];
+        times[i] = s.timeMs;
+        ints[0][i] = s.hr;
+        ints[1][i] = s.spo2;
+        ints[2][i] = s.systolic;
+        ints[3][i] = s.diastolic;
+        labels[i] = s.ecgLabel;
+        confidences[i] = s.ecgConfidence;
+        entry.firstMs = std::min(entry.firstMs, s.timeMs);
+        entry.lastMs = std::max(entry.lastMs, s.timeMs);
+    }
+
+    std::vector<uint8_t> chunks[kArchiveColumns];
+    archive::encodeTimes(times, chunks[static_cast<int>(ArchiveColumn::Time)]);
+    for (int i = 0; i < 4; i++) {
+        archive::encodeInts(ints[i], chunks[static_cast<int>(ArchiveColumn::Hr) + i]);
+    }
+    archive::encodeLabels(labels, chunks[static_cast<int>(ArchiveColumn::EcgLabel)]);
+    archive::encodeFloats(confidences, chunks[static_cast<int>(ArchiveColumn::EcgConfidence)]);
+
+    Partition& partition = partitions_[block.sourceId];
+    bool ok = (partition.index != nullptr && partition.day == block.day) ||
+              openPartition(block.sourceId, block.day, partition);
+
+    // Each file is flushed per block so the index record never reaches the
+    // disk before its chunks
+    size_t bytes = 0;
+    for (int c = 0; ok && c < kArchiveColumns; c++) {
+        entry.offset[c] = partition.columnBytes[c];
+        entry.size[c] = static_cast<uint32_t>(chunks[c].size());
+        ok = fwrite(chunks[c].data(), 1, chunks[c].size(), partition.columns[c]) == chunks[c].size() &&
+             fflush(partition.columns[c]) == 0;
+        partition.columnBytes[c] += chunks[c].size();
+        bytes += chunks[c].size();
+    }
+    uint8_t record[kArchiveIndexRecordSize];
+    archive::encodeIndex(entry, record);
+    ok = ok && fwrite(record, 1, sizeof(record), partition.index) == sizeof(record) &&
+         fflush(partition.index) == 0;
+
+    if (!ok) {
+        // Reopen on the next block, re-reading the file sizes
+        closePartition(partition);
+        writeErrors.inc();
+        LOG_ERROR("Failed to write archive block for " + archive::sourceDirectory(block.sourceId) + "/" +
+                  block.day);
+        return false;
+    }
+    blocksWritten.inc();
+    bytesWritten.inc(bytes + sizeof(record));
+    samplesWritten.inc(n);
+    return true;
+}
@@ -0,0 +1,94 @@
+#ifndef ARCHIVE_WRITER_H
+#define ARCHIVE_WRITER_H
+
+#include "ArchiveFormat.h"
+#include "TimeSeriesStore.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Long-term vitals history as compressed column files:
+//   <root>/<source id, or "default">/<UTC day>/{time,hr,...}.col + index.bin
+// Samples are buffered per source and sealed into one independently
+// decodable block per column when block_samples are buffered, the flush
+// interval has passed (checked by the writer thread, so idle sources flush
+// too), or the UTC day changes. Sealed blocks are encoded and written by the
+// writer thread, which keeps each source's current day files open; append()
+// never touches the disk. Column chunks are written before the block's index
+// record, so a crash can only lose the block being written.
+class ArchiveWriter {
+public:
+    static ArchiveWriter& getInstance();
+
+    bool init(const std::string& root, size_t blockSamples, int flushIntervalSec);
+    bool isOpen() const { return open_.load(); }
+
+    void append(const std::string& sourceId, std::chrono::system_clock::time_point time,
+                const VitalSample& vitals, const std::string& ecgLabel, float ecgConfidence);
+
+    // Write every buffered sample now
+    void flush();
+
+    // Flush, stop the writer thread and close the files; call before exit
+    void close();
+
+private:
+    ArchiveWriter() = default;
+    ~ArchiveWriter();
+    ArchiveWriter(const ArchiveWriter&) = delete;
+    ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+    struct Source {
+        std::vector<ArchiveSample> pending;
+        std::string day;                                // UTC day of the pending samples
+        std::chrono::steady_clock::time_point since;    // First pending sample
+    };
+
+    // Sealed samples waiting for the writer
+    struct Block {
+        std::string sourceId;
+        std::string day;
+        std::vector<ArchiveSample> samples;
+    };
+
+    // Open files of a source's current day; used by one writer at a time
+    struct Partition {
+        std::string day;
+        FILE* columns[kArchiveColumns] = {};
+        FILE* index = nullptr;
+        uint64_t columnBytes[kArchiveColumns] = {};
+    };
+
+    void sealLocked(const std::string& sourceId, Source& source);
+    void writerLoop();
+    void writeSealed();
+    bool writeBlock(const Block& block);
+    bool openPartition(const std::string& sourceId, const std::string& day, Partition& partition);
+    static void closePartition(Partition& partition);
+
+    std::mutex mutex_;                                  // Guards sources_, sealed_, spare_, stop_
+    std::condition_variable wake_;
+    std::map<std::string, Source> sources_;
+    std::vector<Block> sealed_;
+    std::vector<Block> writing_;                        // Guarded by writeMutex_
+    std::vector<std::vector<ArchiveSample>> spare_;     // Written blocks' buffers, reused
+    std::thread writer_;
+    bool stop_ = false;
+
+    std::mutex writeMutex_;                             // Held while writing; guards partitions_
+    std::map<std::string, Partition> partitions_;
+
+    std::string root_;
+    size_t blockSamples_ = 4096;
+    std::chrono::seconds flushInterval_{60};
+    std::atomic<bool> open_{false};
+};
+
+#endif // ARCHIVE_WRITER_H
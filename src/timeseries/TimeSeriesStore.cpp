@@ -0,0 +1,314 @@
+#include "TimeSeriesStore.h"
+#include "../utils/TimestampFormatter.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+const int64_t kLevelWidthUs[] = {0, 1000000LL, 60000000LL, 3600000000LL};
+
+// [text, end) as a positive integer, or -1 if it holds anything but digits
+// ("0" is the extractor's "no value"; an HR read of "120/80" is a miss)
+int parseValue(const char* text, const char* end) {
+    if (text == end || end - text > 9) {
+        return -1;
+    }
+    int value = 0;
+    for (const char* c = text; c != end; ++c) {
+        if (*c < '0' || *c > '9') {
+            return -1;
+        }
+        value = value * 10 + (*c - '0');
+    }
+    return value > 0 ? value : -1;
+}
+
+int parseValue(const std::string& text) {
+    return parseValue(text.data(), text.data() + text.size());
+}
+
+} // namespace
+
+VitalSample VitalSample::fromText(const std::string& hr, const std::string& spo2, const std::string& abp) {
+    VitalSample sample;
+    sample.hr = parseValue(hr);
+    sample.spo2 = parseValue(spo2);
+    size_t slash = abp.find('/');
+    if (slash != std::string::npos) {
+        sample.systolic = parseValue(abp.data(), abp.data() + slash);
+        sample.diastolic = parseValue(abp.data() + slash + 1, abp.data() + abp.size());
+    }
+    return sample;
+}
+
+int VitalSample::get(VitalField field) const {
+    switch (field) {
+        case VitalField::Hr: return hr;
+        case VitalField::SpO2: return spo2;
+        case VitalField::Systolic: return systolic;
+        case VitalField::Diastolic: return diastolic;
+        default: return -1;
+    }
+}
+
+void TimeSeriesStore::Ring::allocate(size_t capacity, int64_t width) {
+    capacity = std::max<size_t>(1, capacity);
+    widthUs = width;
+    start.assign(capacity, 0);
+    min.assign(capacity, 0.0f);
+    max.assign(capacity, 0.0f);
+    sum.assign(capacity, 0.0);
+    count.assign(capacity, 0);
+    head = 0;
+    size = 0;
+    wrapped = false;
+}
+
+void TimeSeriesStore::Ring::add(int64_t timeUs, float value) {
+    int64_t bucket = bucketStart(timeUs);
+
+    // Still inside the newest bucket
+    if (widthUs > 0 && size > 0) {
+        size_t last = (head + capacity() - 1) % capacity();
+        if (start[last] == bucket) {
+            min[last] = std::min(min[last], value);
+            max[last] = std::max(max[last], value);
+            sum[last] += value;
+            count[last]++;
+            return;
+        }
+    }
+
+    if (size == capacity()) {
+        wrapped = true;
+    }
+    start[head] = bucket;
+    min[head] = value;
+    max[head] = value;
+    sum[head] = value;
+    count[head] = 1;
+    head = (head + 1) % capacity();
+    size = std::min(size + 1, capacity());
+}
+
+// First logical index whose start is >= timeUs
+size_t TimeSeriesStore::Ring::lowerBound(int64_t timeUs) const {
+    size_t lo = 0;
+    size_t hi = size;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (start[slot(mid)] < timeUs) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+// Has every sample from fromUs on: nothing was overwritten yet, or the
+// oldest retained entry starts at or before it
+bool TimeSeriesStore::Ring::covers(int64_t fromUs) const {
+    return !wrapped || (size > 0 && start[slot(0)] <= bucketStart(fromUs));
+}
+
+// Logical entries [first, end) as one point
+TsPoint TimeSeriesStore::Ring::merge(size_t first, size_t end) const {
+    size_t i = slot(first);
+    TsPoint p;
+    p.timeUs = start[i];
+    p.min = min[i];
+    p.max = max[i];
+    double total = 0.0;
+    for (size_t logical = first; logical < end; logical++) {
+        i = slot(logical);
+        p.min = std::min(p.min, min[i]);
+        p.max = std::max(p.max, max[i]);
+        total += sum[i];
+        p.count += count[i];
+    }
+    p.mean = p.count > 0 ? static_cast<float>(total / p.count) : 0.0f;
+    return p;
+}
+
+// Entries in [fromUs, toUs] into out, merging runs of neighbours when there
+// are more than maxPoints. Reserves at most maxPoints.
+void TimeSeriesStore::Ring::collect(int64_t fromUs, int64_t toUs, size_t maxPoints,
+                                    std::vector<TsPoint>& out) const {
+    out.clear();
+    size_t first = lowerBound(bucketStart(fromUs));
+    size_t last = lowerBound(toUs + 1);
+    if (first >= last) {
+        return;
+    }
+    size_t n = last - first;
+    size_t group = n > maxPoints ? (n + maxPoints - 1) / maxPoints : 1;
+    out.reserve((n + group - 1) / group);
+    for (size_t i = first; i < last; i += group) {
+        out.push_back(merge(i, std::min(last, i + group)));
+    }
+}
+
+size_t TimeSeriesStore::Ring::bytes() const {
+    return capacity() * (sizeof(int64_t) + 2 * sizeof(float) + sizeof(double) + sizeof(uint32_t));
+}
+
+TimeSeriesStore& TimeSeriesStore::getInstance() {
+    static TimeSeriesStore instance;
+    return instance;
+}
+
+void TimeSeriesStore::init(const std::vector<std::string>& sourceIds, const TsCapacity& capacity) {
+    const size_t capacities[] = {capacity.raw, capacity.seconds, capacity.minutes, capacity.hours};
+    sources_.clear();
+    sourceIds_.clear();
+    memoryBytes_ = 0;
+    for (const std::string& id : sourceIds) {
+        std::unique_ptr<Source> source(new Source());
+        for (Series& series : source->series) {
+            for (int level = 0; level < static_cast<int>(TsResolution::Count); level++) {
+                series.levels[level].allocate(capacities[level], kLevelWidthUs[level]);
+                memoryBytes_ += series.levels[level].bytes();
+            }
+        }
+        sources_[id] = std::move(source);
+    }
+    for (const auto& entry : sources_) {
+        sourceIds_.push_back(entry.first);
+    }
+}
+
+const TimeSeriesStore::Source* TimeSeriesStore::find(const std::string& sourceId) const {
+    auto it = sources_.find(sourceId);
+    return it != sources_.end() ? it->second.get() : nullptr;
+}
+
+void TimeSeriesStore::append(const std::string& sourceId, std::chrono::system_clock::time_point time,
+                             const VitalSample& sample) {
+    auto it = sources_.find(sourceId);
+    if (it == sources_.end()) {
+        return;
+    }
+    Source* source = it->second.get();
+    int64_t timeUs = TimestampFormatter::toEpochMicros(time);
+
+    std::lock_guard<std::mutex> lock(source->mutex);
+    if (timeUs < source->lastTimeUs) {
+        return;
+    }
+    source->lastTimeUs = timeUs;
+    for (int f = 0; f < static_cast<int>(VitalField::Count); f++) {
+        int value = sample.get(static_cast<VitalField>(f));
+        if (value < 0) {
+            continue;
+        }
+        for (Ring& ring : source->series[f].levels) {
+            ring.add(timeUs, static_cast<float>(value));
+        }
+    }
+}
+
+bool TimeSeriesStore::queryResolution(const std::string& sourceId, VitalField field, TsResolution resolution,
+                                      int64_t fromUs, int64_t toUs, size_t maxPoints,
+                                      std::vector<TsPoint>& out) const {
+    out.clear();
+    const Source* source = find(sourceId);
+    if (source == nullptr || field == VitalField::Count || resolution == TsResolution::Count) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(source->mutex);
+    const Ring& ring = source->series[static_cast<int>(field)].levels[static_cast<int>(resolution)];
+    ring.collect(fromUs, toUs, std::max<size_t>(1, maxPoints), out);
+    return true;
+}
+
+bool TimeSeriesStore::query(const std::string& sourceId, VitalField field, int64_t fromUs, int64_t toUs,
+                            size_t maxPoints, std::vector<TsPoint>& out, TsResolution* used) const {
+    out.clear();
+    const Source* source = find(sourceId);
+    if (source == nullptr || field == VitalField::Count) {
+        return false;
+    }
+    maxPoints = std::max<size_t>(1, maxPoints);
+
+    std::lock_guard<std::mutex> lock(source->mutex);
+    const Series& series = source->series[static_cast<int>(field)];
+    const int levels = static_cast<int>(TsResolution::Count);
+
+    // Finest level that still holds fromUs and fits the budget; counting is
+    // two binary searches. Failing that, the coarsest level that holds fromUs,
+    // merged down. If none reaches back that far, the one reaching furthest.
+    int chosen = -1;
+    int coarsestCovering = -1;
+    int furthest = 0;
+    int64_t furthestStart = INT64_MAX;
+    for (int level = 0; level < levels; level++) {
+        const Ring& ring = series.levels[level];
+        if (ring.size > 0 && ring.start[ring.slot(0)] < furthestStart) {
+            furthest = level;
+            furthestStart = ring.start[ring.slot(0)];
+        }
+        if (!ring.covers(fromUs)) {
+            continue;
+        }
+        coarsestCovering = level;
+        size_t n = ring.lowerBound(toUs + 1) - ring.lowerBound(ring.bucketStart(fromUs));
+        if (chosen < 0 && n <= maxPoints) {
+            chosen = level;
+        }
+    }
+    if (chosen < 0) {
+        chosen = coarsestCovering >= 0 ? coarsestCovering : furthest;
+    }
+    if (used != nullptr) {
+        *used = static_cast<TsResolution>(chosen);
+    }
+    series.levels[chosen].collect(fromUs, toUs, maxPoints, out);
+    return true;
+}
+
+bool TimeSeriesStore::latest(const std::string& sourceId, VitalField field, TsPoint& out) const {
+    const Source* source = find(sourceId);
+    if (source == nullptr || field == VitalField::Count) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(source->mutex);
+    const Ring& raw = source->series[static_cast<int>(field)].levels[static_cast<int>(TsResolution::Raw)];
+    if (raw.size == 0) {
+        return false;
+    }
+    out = raw.merge(raw.size - 1, raw.size);
+    return true;
+}
+
+const char* TimeSeriesStore::fieldName(VitalField field) {
+    switch (field) {
+        case VitalField::Hr: return "hr";
+        case VitalField::SpO2: return "spo2";
+        case VitalField::Systolic: return "systolic";
+        case VitalField::Diastolic: return "diastolic";
+        default: return "";
+    }
+}
+
+bool TimeSeriesStore::parseField(const std::string& name, VitalField& field) {
+    for (int f = 0; f < static_cast<int>(VitalField::Count); f++) {
+        if (name == fieldName(static_cast<VitalField>(f))) {
+            field = static_cast<VitalField>(f);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* TimeSeriesStore::resolutionName(TsResolution resolution) {
+    switch (resolution) {
+        case TsResolution::Raw: return "raw";
+        case TsResolution::Second: return "1s";
+        case TsResolution::Minute: return "1m";
+        case TsResolution::Hour: return "1h";
+        default: return "";
+    }
+}
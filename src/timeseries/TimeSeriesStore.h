@@ -0,0 +1,134 @@
+#ifndef TIME_SERIES_STORE_H
+#define TIME_SERIES_STORE_H
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+enum class VitalField { Hr, SpO2, Systolic, Diastolic, Count };
+
+enum class TsResolution { Raw, Second, Minute, Hour, Count };
+
+// One processed frame's values; -1 = no reading
+struct VitalSample {
+    int hr = -1;
+    int spo2 = -1;
+    int systolic = -1;
+    int diastolic = -1;
+
+    // From the extractor's strings ("0" = no reading, ABP as "120/80"). The
+    // one parser for OCR text: a field that is not all digits (each ABP half
+    // on its own) has no reading.
+    static VitalSample fromText(const std::string& hr, const std::string& spo2, const std::string& abp);
+    int get(VitalField field) const;
+};
+
+// Query result; a raw sample has min == max == mean and count 1
+struct TsPoint {
+    int64_t timeUs = 0;         // Sample time, or bucket start
+    float min = 0.0f;
+    float max = 0.0f;
+    float mean = 0.0f;
+    uint32_t count = 0;
+};
+
+struct TsCapacity {
+    size_t raw = 4096;
+    size_t seconds = 3600;      // 1 h of 1 s buckets
+    size_t minutes = 1440;      // 1 day of 1 min buckets
+    size_t hours = 720;         // 30 days of 1 h buckets
+};
+
+// In-process history of the vitals of every source. Each (source, field)
+// series is a set of fixed-size columnar rings: raw samples, plus 1 s, 1 min
+// and 1 h min/max/mean rollups updated on every append. All memory is
+// allocated by init(); nothing grows afterwards and the oldest data is
+// overwritten. Appends and queries lock only the source they touch.
+class TimeSeriesStore {
+public:
+    static TimeSeriesStore& getInstance();
+
+    // Allocate the rings for these sources ("" is the single-source id)
+    void init(const std::vector<std::string>& sourceIds, const TsCapacity& capacity);
+    bool isInitialized() const { return !sources_.empty(); }
+    const std::vector<std::string>& sourceIds() const { return sourceIds_; }
+    bool hasSource(const std::string& sourceId) const { return find(sourceId) != nullptr; }
+
+    // Samples must arrive in time order per source; older ones are dropped
+    void append(const std::string& sourceId, std::chrono::system_clock::time_point time,
+                const VitalSample& sample);
+
+    // Points in [fromUs, toUs] from the finest resolution that still retains
+    // fromUs and has at most maxPoints of them. If every retaining one has
+    // more, the coarsest of them is merged down to maxPoints; if none retains
+    // fromUs, the one reaching furthest back is used. out is filled in place
+    // and reserves at most maxPoints. Returns false for an unknown source.
+    bool query(const std::string& sourceId, VitalField field, int64_t fromUs, int64_t toUs,
+               size_t maxPoints, std::vector<TsPoint>& out, TsResolution* used = nullptr) const;
+
+    // Points of one resolution in [fromUs, toUs], with runs of neighbours
+    // merged when there are more than maxPoints
+    bool queryResolution(const std::string& sourceId, VitalField field, TsResolution resolution,
+                         int64_t fromUs, int64_t toUs, size_t maxPoints, std::vector<TsPoint>& out) const;
+
+    // Newest raw sample; false if the source is unknown or has none
+    bool latest(const std::string& sourceId, VitalField field, TsPoint& out) const;
+
+    // Bytes reserved by init()
+    size_t memoryBytes() const { return memoryBytes_; }
+
+    static const char* fieldName(VitalField field);
+    static bool parseField(const std::string& name, VitalField& field);
+    static const char* resolutionName(TsResolution resolution);
+
+private:
+    TimeSeriesStore() = default;
+    TimeSeriesStore(const TimeSeriesStore&) = delete;
+    TimeSeriesStore& operator=(const TimeSeriesStore&) = delete;
+
+    // Column-oriented ring of buckets (or raw samples with count 1)
+    struct Ring {
+        int64_t widthUs = 0;            // 0 = raw samples
+        std::vector<int64_t> start;
+        std::vector<float> min;
+        std::vector<float> max;
+        std::vector<double> sum;
+        std::vector<uint32_t> count;
+        size_t head = 0;                // Next slot to write
+        size_t size = 0;
+        bool wrapped = false;           // Oldest entries have been overwritten
+
+        void allocate(size_t capacity, int64_t width);
+        size_t capacity() const { return start.size(); }
+        size_t slot(size_t logical) const { return (head + capacity() - size + logical) % capacity(); }
+        int64_t bucketStart(int64_t timeUs) const { return widthUs > 0 ? timeUs - timeUs % widthUs : timeUs; }
+        void add(int64_t timeUs, float value);
+        size_t lowerBound(int64_t timeUs) const;
+        bool covers(int64_t fromUs) const;
+        TsPoint merge(size_t first, size_t end) const;
+        void collect(int64_t fromUs, int64_t toUs, size_t maxPoints, std::vector<TsPoint>& out) const;
+        size_t bytes() const;
+    };
+
+    struct Series {
+        Ring levels[static_cast<int>(TsResolution::Count)];
+    };
+
+    struct Source {
+        mutable std::mutex mutex;
+        Series series[static_cast<int>(VitalField::Count)];
+        int64_t lastTimeUs = 0;
+    };
+
+    const Source* find(const std::string& sourceId) const;
+
+    std::map<std::string, std::unique_ptr<Source>> sources_;
+    std::vector<std::string> sourceIds_;    // Sorted keys of sources_
+    size_t memoryBytes_ = 0;
+};
+
+#endif // TIME_SERIES_STORE_H
@@ -1,16 +1,41 @@
 #include "Logger.h"
+#include "TimestampFormatter.h"
 #include <iostream>
 #include <filesystem>
 #include <algorithm>
+#include <cstring>
+#include <cstdio>
 
 namespace fs = std::filesystem;
 
+namespace {
+
+const char* levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::DEBUG:    return "DEBUG";
+        case LogLevel::INFO:     return "INFO ";
+        case LogLevel::WARN:     return "WARN ";
+        case LogLevel::ERROR:    return "ERROR";
+        case LogLevel::CRITICAL: return "CRIT ";
+        default:                 return "UNKNOWN";
+    }
+}
+
+// Writer thread wakes at least this often to pick up new records
+constexpr std::chrono::milliseconds kWriterPollInterval(10);
+
+// Maximum records drained per pass before checking flush/rotation state
+constexpr size_t kWriterBatchSize = 1024;
+
+} // namespace
+
 Logger& Logger::getInstance() {
     static Logger instance;
     return instance;
 }
 
 Logger::~Logger() {
+    shutdown();
     if (logFile_.is_open()) {
         logFile_.close();
     }
@@ -22,133 +47,350 @@ void Logger::init(const std::string& logFilePath,
                   bool fileEnabled,
                   size_t maxFileSizeMB,
                   int maxFiles) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    
-    logFilePath_ = logFilePath;
-    currentLevel_ = level;
-    consoleEnabled_ = consoleEnabled;
-    fileEnabled_ = fileEnabled;
-    maxFileSizeBytes_ = maxFileSizeMB * 1024 * 1024;
-    maxFiles_ = maxFiles;
-    
-    if (fileEnabled_) {
-        // Create directory if it doesn't exist
-        fs::path logPath(logFilePath_);
-        fs::path logDir = logPath.parent_path();
-        if (!logDir.empty() && !fs::exists(logDir)) {
-            fs::create_directories(logDir);
-        }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
         
-        // Open log file in append mode
-        logFile_.open(logFilePath_, std::ios::app);
-        if (!logFile_.is_open()) {
-            std::cerr << "Error: Could not open log file: " << logFilePath_ << std::endl;
-            fileEnabled_ = false;
+        logFilePath_ = logFilePath;
+        currentLevel_ = level;
+        consoleEnabled_ = consoleEnabled;
+        fileEnabled_ = fileEnabled;
+        maxFileSizeBytes_ = maxFileSizeMB * 1024 * 1024;
+        maxFiles_ = maxFiles;
+        
+        if (fileEnabled_) {
+            // Create directory if it doesn't exist
+            fs::path logPath(logFilePath_);
+            fs::path logDir = logPath.parent_path();
+            if (!logDir.empty() && !fs::exists(logDir)) {
+                fs::create_directories(logDir);
+            }
+            
+            openLogFile();
+            if (!logFile_.is_open()) {
+                std::cerr << "Error: Could not open log file: " << logFilePath_ << std::endl;
+                fileEnabled_ = false;
+            }
         }
+        
+        initialized_ = true;
     }
     
-    initialized_ = true;
+    // Logged outside the lock since log() takes mutex_ itself
     info("Logger initialized");
 }
 
+void Logger::openLogFile() {
+    // Open log file in append mode and seed the size counter once
+    logFile_.open(logFilePath_, std::ios::app);
+    std::error_code ec;
+    auto size = fs::file_size(logFilePath_, ec);
+    fileSize_ = ec ? 0 : static_cast<size_t>(size);
+}
+
+void Logger::startAsync(size_t queueCapacity, LogOverflowPolicy policy, int flushIntervalMs) {
+    std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+    
+    if (asyncEnabled_.load()) {
+        return;
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // shutdown() left no producer or writer on the ring, so it can be
+        // replaced; a live ring is never swapped out from under them
+        if (!queue_ || queue_->capacity() < queueCapacity) {
+            queue_.reset(new MpscRingBuffer<LogRecord>(queueCapacity));
+        }
+        overflowPolicy_ = policy;
+        flushInterval_ = std::chrono::milliseconds(flushIntervalMs > 0 ? flushIntervalMs : 1);
+        stopWriter_ = false;
+    }
+    
+    writerThread_ = std::thread(&Logger::writerLoop, this);
+    asyncEnabled_.store(true);
+}
+
+void Logger::shutdown() {
+    std::lock_guard<std::mutex> lifecycle(lifecycleMutex_);
+    
+    if (!asyncEnabled_.exchange(false)) {
+        return;
+    }
+    
+    // Producers that saw the flag set finish their push before the final
+    // drain; later ones see it cleared and write synchronously
+    while (asyncProducers_.load() != 0) {
+        writerCv_.notify_one();
+        std::this_thread::yield();
+    }
+    
+    stopWriter_ = true;
+    writerCv_.notify_one();
+    if (writerThread_.joinable()) {
+        writerThread_.join();
+    }
+    stopWriter_ = false;
+}
+
 void Logger::setLogLevel(LogLevel level) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    currentLevel_ = level;
+    currentLevel_.store(level, std::memory_order_relaxed);
 }
 
 void Logger::debug(const std::string& message) {
-    log(LogLevel::DEBUG, message);
+    log(LogLevel::DEBUG, message.data(), message.size());
 }
 
 void Logger::info(const std::string& message) {
-    log(LogLevel::INFO, message);
+    log(LogLevel::INFO, message.data(), message.size());
 }
 
 void Logger::warn(const std::string& message) {
-    log(LogLevel::WARN, message);
+    log(LogLevel::WARN, message.data(), message.size());
 }
 
 void Logger::error(const std::string& message) {
-    log(LogLevel::ERROR, message);
+    log(LogLevel::ERROR, message.data(), message.size());
 }
 
 void Logger::critical(const std::string& message) {
-    log(LogLevel::CRITICAL, message);
+    log(LogLevel::CRITICAL, message.data(), message.size());
 }
 
-void Logger::log(LogLevel level, const std::string& message) {
+#define LOGGER_FORWARD_FORMATTED(level) \
+    va_list args; \
+    va_start(args, format); \
+    logFormatted(level, format, args); \
+    va_end(args)
+
+void Logger::debug(const char* format, ...) {
+    LOGGER_FORWARD_FORMATTED(LogLevel::DEBUG);
+}
+
+void Logger::info(const char* format, ...) {
+    LOGGER_FORWARD_FORMATTED(LogLevel::INFO);
+}
+
+void Logger::warn(const char* format, ...) {
+    LOGGER_FORWARD_FORMATTED(LogLevel::WARN);
+}
+
+void Logger::error(const char* format, ...) {
+    LOGGER_FORWARD_FORMATTED(LogLevel::ERROR);
+}
+
+void Logger::critical(const char* format, ...) {
+    LOGGER_FORWARD_FORMATTED(LogLevel::CRITICAL);
+}
+
+#undef LOGGER_FORWARD_FORMATTED
+
+void Logger::logFormatted(LogLevel level, const char* format, va_list args) {
+    if (initialized_ && !isEnabled(level)) {
+        return;
+    }
+    
+    char buffer[kRecordTextSize];
+    int written = std::vsnprintf(buffer, sizeof(buffer), format, args);
+    if (written < 0) {
+        return;
+    }
+    log(level, buffer, std::min(static_cast<size_t>(written), sizeof(buffer) - 1));
+}
+
+void Logger::log(LogLevel level, const char* message, size_t length) {
     if (!initialized_) {
         // Fallback to console if not initialized
-        std::cout << message << std::endl;
+        std::cout.write(message, static_cast<std::streamsize>(length));
+        std::cout << std::endl;
         return;
     }
     
-    if (level < currentLevel_) {
+    if (!isEnabled(level)) {
         return; // Skip if below current log level
     }
     
+    if (asyncEnabled_.load(std::memory_order_relaxed)) {
+        // Announce the push before re-checking the flag so shutdown() either
+        // waits for it or this record falls through to the synchronous path
+        asyncProducers_.fetch_add(1);
+        bool queued = asyncEnabled_.load() && logAsync(level, message, length);
+        asyncProducers_.fetch_sub(1);
+        if (queued) {
+            return;
+        }
+    }
+    
     std::lock_guard<std::mutex> lock(mutex_);
     
-    std::string formattedMessage = formatMessage(level, message);
+    std::string formattedMessage = formatMessage(level, message, length);
+    writeLine(level, formattedMessage.data(), formattedMessage.size());
     
-    // Console output
+    // Sync mode keeps every line durable as soon as it is logged
     if (consoleEnabled_) {
-        if (level >= LogLevel::ERROR) {
-            std::cerr << formattedMessage << std::endl;
-        } else {
-            std::cout << formattedMessage << std::endl;
+        (level >= LogLevel::ERROR ? std::cerr : std::cout).flush();
+    }
+    if (fileEnabled_ && logFile_.is_open()) {
+        logFile_.flush();
+    }
+}
+
+bool Logger::logAsync(LogLevel level, const char* message, size_t length) {
+    auto fill = [&](LogRecord& record) {
+        record.level = level;
+        record.length = static_cast<uint32_t>(formatRecord(record.text, kRecordTextSize, level, message, length));
+    };
+    
+    if (!queue_->tryPush(fill)) {
+        if (overflowPolicy_ == LogOverflowPolicy::DROP) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        while (!queue_->tryPush(fill)) {
+            // Once shutdown starts, stop waiting and let the caller write it
+            if (!asyncEnabled_.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            writerCv_.notify_one();
+            std::this_thread::yield();
+        }
+    }
+    
+    // Errors get written out promptly instead of waiting for the poll interval
+    if (level >= LogLevel::ERROR) {
+        writerCv_.notify_one();
+    }
+    return true;
+}
+
+void Logger::writerLoop() {
+    auto lastFlush = std::chrono::steady_clock::now();
+    uint64_t reportedDropped = dropped_.load();
+    bool dirty = false;
+    bool urgent = false;
+    
+    for (;;) {
+        size_t drained = 0;
+        bool stopping = stopWriter_.load();
+        uint64_t flushRequest = flushRequested_.load();
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            
+            while (drained < kWriterBatchSize &&
+                   queue_->tryPop([&](LogRecord& record) {
+                       writeLine(record.level, record.text, record.length);
+                       urgent = urgent || record.level >= LogLevel::ERROR;
+                   })) {
+                drained++;
+            }
+            dirty = dirty || drained > 0;
+            
+            uint64_t dropped = dropped_.load(std::memory_order_relaxed);
+            if (dropped != reportedDropped) {
+                std::string text = "Log queue overflow: " + std::to_string(dropped - reportedDropped) +
+                                   " records dropped";
+                std::string notice = formatMessage(LogLevel::WARN, text.data(), text.size());
+                writeLine(LogLevel::WARN, notice.data(), notice.size());
+                reportedDropped = dropped;
+                dirty = true;
+            }
+            
+            auto now = std::chrono::steady_clock::now();
+            bool drainedAll = queue_->empty();
+            bool flushWanted = urgent || now - lastFlush >= flushInterval_ ||
+                               (drainedAll && (stopping || flushRequest != flushCompleted_));
+            if (dirty && flushWanted) {
+                if (consoleEnabled_) {
+                    std::cout.flush();
+                    std::cerr.flush();
+                }
+                if (fileEnabled_ && logFile_.is_open()) {
+                    logFile_.flush();
+                }
+                dirty = false;
+                urgent = false;
+                lastFlush = now;
+            }
+            
+            if (drainedAll && stopping) {
+                break;
+            }
+            if (drainedAll && flushRequest != flushCompleted_) {
+                std::lock_guard<std::mutex> writerLock(writerMutex_);
+                flushCompleted_ = flushRequest;
+                flushedCv_.notify_all();
+            }
         }
+        
+        if (drained == 0) {
+            std::unique_lock<std::mutex> writerLock(writerMutex_);
+            writerCv_.wait_for(writerLock, kWriterPollInterval);
+        }
+    }
+    
+    std::lock_guard<std::mutex> writerLock(writerMutex_);
+    flushCompleted_ = flushRequested_.load();
+    flushedCv_.notify_all();
+}
+
+void Logger::writeLine(LogLevel level, const char* line, size_t length) {
+    // Console output
+    if (consoleEnabled_) {
+        std::ostream& out = level >= LogLevel::ERROR ? std::cerr : std::cout;
+        out.write(line, static_cast<std::streamsize>(length));
+        out.put('\n');
     }
     
     // File output
     if (fileEnabled_ && logFile_.is_open()) {
-        logFile_ << formattedMessage << std::endl;
-        logFile_.flush();
+        logFile_.write(line, static_cast<std::streamsize>(length));
+        logFile_.put('\n');
+        fileSize_ += length + 1;
         
         // Check if rotation is needed
         checkAndRotate();
     }
 }
 
-std::string Logger::formatMessage(LogLevel level, const std::string& message) {
-    std::ostringstream oss;
-    oss << "[" << getCurrentTimestamp() << "] "
-        << "[" << levelToString(level) << "] "
-        << message;
-    return oss.str();
-}
-
-std::string Logger::levelToString(LogLevel level) {
-    switch (level) {
-        case LogLevel::DEBUG:    return "DEBUG";
-        case LogLevel::INFO:     return "INFO ";
-        case LogLevel::WARN:     return "WARN ";
-        case LogLevel::ERROR:    return "ERROR";
-        case LogLevel::CRITICAL: return "CRIT ";
-        default:                 return "UNKNOWN";
-    }
+std::string Logger::formatMessage(LogLevel level, const char* message, size_t length) {
+    std::string formatted;
+    formatted.resize(TimestampFormatter::kMillisLength + 16 + length);
+    formatted.resize(formatRecord(&formatted[0], formatted.size() + 1, level, message, length));
+    return formatted;
 }
 
-std::string Logger::getCurrentTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+size_t Logger::formatRecord(char* out, size_t capacity, LogLevel level, const char* message, size_t messageLength) {
+    // "[<timestamp>] [LEVEL] " is assembled by hand; capacity always exceeds it
+    size_t length = 0;
+    out[length++] = '[';
+    length += TimestampFormatter::formatMillis(std::chrono::system_clock::now(), out + length);
+    std::memcpy(out + length, "] [", 3);
+    length += 3;
+    const char* name = levelName(level);
+    size_t nameLength = std::strlen(name);
+    std::memcpy(out + length, name, nameLength);
+    length += nameLength;
+    std::memcpy(out + length, "] ", 2);
+    length += 2;
     
-    std::ostringstream oss;
-    oss << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S");
-    oss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    return oss.str();
+    size_t room = capacity - 1 - length;
+    if (messageLength <= room) {
+        std::memcpy(out + length, message, messageLength);
+        length += messageLength;
+    } else {
+        // Truncate oversized messages, marking the cut
+        std::memcpy(out + length, message, room - 3);
+        std::memcpy(out + length + room - 3, "...", 3);
+        length += room;
+    }
+    out[length] = '\0';
+    return length;
 }
 
 void Logger::checkAndRotate() {
     if (!logFile_.is_open()) return;
     
-    // Get current file size
-    logFile_.seekp(0, std::ios::end);
-    size_t fileSize = logFile_.tellp();
-    
-    if (fileSize >= maxFileSizeBytes_) {
+    if (fileSize_ >= maxFileSizeBytes_) {
         rotateLogFile();
     }
 }
@@ -179,7 +421,7 @@ void Logger::rotateLogFile() {
     }
     
     // Open new log file
-    logFile_.open(logFilePath_, std::ios::app);
+    openLogFile();
     if (!logFile_.is_open()) {
         std::cerr << "Error: Could not reopen log file after rotation" << std::endl;
         fileEnabled_ = false;
@@ -187,6 +429,15 @@ void Logger::rotateLogFile() {
 }
 
 void Logger::flush() {
+    if (asyncEnabled_.load(std::memory_order_acquire)) {
+        uint64_t target = flushRequested_.fetch_add(1) + 1;
+        writerCv_.notify_one();
+        std::unique_lock<std::mutex> writerLock(writerMutex_);
+        flushedCv_.wait_for(writerLock, std::chrono::seconds(2),
+                            [&] { return flushCompleted_ >= target; });
+        return;
+    }
+    
     std::lock_guard<std::mutex> lock(mutex_);
     if (logFile_.is_open()) {
         logFile_.flush();
@@ -8,6 +8,25 @@
 #include <ctime>
 #include <iomanip>
 #include <sstream>
+#include <atomic>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+#include <cstdarg>
+#include "MpscRingBuffer.h"
+
+// Lowest level compiled into the binary (0=DEBUG ... 4=CRITICAL). Log
+// statements below it are removed entirely, e.g. -DLOG_COMPILE_MIN_LEVEL=1
+// strips every LOG_DEBUG from a release build.
+#ifndef LOG_COMPILE_MIN_LEVEL
+#define LOG_COMPILE_MIN_LEVEL 0
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LOGGER_PRINTF_FORMAT(fmtIndex, argIndex) __attribute__((format(printf, fmtIndex, argIndex)))
+#else
+#define LOGGER_PRINTF_FORMAT(fmtIndex, argIndex)
+#endif
 
 // Log levels
 enum class LogLevel {
@@ -18,6 +37,12 @@ enum class LogLevel {
     CRITICAL = 4
 };
 
+// What async producers do when the ring buffer is full
+enum class LogOverflowPolicy {
+    DROP,   // Discard the record and count it (never blocks the caller)
+    BLOCK   // Spin/yield until the writer thread frees a slot
+};
+
 class Logger {
 public:
     static Logger& getInstance();
@@ -30,6 +55,16 @@ public:
               size_t maxFileSizeMB = 10,
               int maxFiles = 5);
     
+    // Switch to async mode: callers format into a lock-free ring buffer and a
+    // background thread batches writes, rotation and flushing
+    void startAsync(size_t queueCapacity = 8192,
+                    LogOverflowPolicy policy = LogOverflowPolicy::DROP,
+                    int flushIntervalMs = 1000);
+    
+    // Stop accepting async records, wait for in-flight producers, drain the
+    // ring buffer and stop the writer thread (back to sync mode)
+    void shutdown();
+    
     // Log methods
     void debug(const std::string& message);
     void info(const std::string& message);
@@ -37,41 +72,123 @@ public:
     void error(const std::string& message);
     void critical(const std::string& message);
     
+    // printf-style variants; the message is only formatted once the level
+    // check has passed, into a stack buffer with no heap allocation
+    void debug(const char* format, ...) LOGGER_PRINTF_FORMAT(2, 3);
+    void info(const char* format, ...) LOGGER_PRINTF_FORMAT(2, 3);
+    void warn(const char* format, ...) LOGGER_PRINTF_FORMAT(2, 3);
+    void error(const char* format, ...) LOGGER_PRINTF_FORMAT(2, 3);
+    void critical(const char* format, ...) LOGGER_PRINTF_FORMAT(2, 3);
+    
+    // Cheap runtime check used by the LOG_* macros before evaluating arguments
+    bool isEnabled(LogLevel level) const {
+        return level >= currentLevel_.load(std::memory_order_relaxed);
+    }
+    
     // Set log level
     void setLogLevel(LogLevel level);
     
-    // Flush logs
+    // Flush logs (waits for the writer thread in async mode)
     void flush();
     
+    // Records discarded by the DROP overflow policy since startup
+    uint64_t getDroppedCount() const { return dropped_.load(std::memory_order_relaxed); }
+    
+    // Records waiting for the writer thread (0 in synchronous mode)
+    size_t getQueueDepth() const { return queue_ ? queue_->size() : 0; }
+    
 private:
     Logger() = default;
     ~Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
     
-    void log(LogLevel level, const std::string& message);
-    std::string formatMessage(LogLevel level, const std::string& message);
-    std::string levelToString(LogLevel level);
-    std::string getCurrentTimestamp();
+    // Preformatted line stored in the async ring buffer
+    static constexpr size_t kRecordTextSize = 496;
+    struct LogRecord {
+        LogLevel level;
+        uint32_t length;
+        char text[kRecordTextSize];
+    };
+    
+    void log(LogLevel level, const char* message, size_t length);
+    void logFormatted(LogLevel level, const char* format, va_list args);
+    bool logAsync(LogLevel level, const char* message, size_t length);
+    void writerLoop();
+    void writeLine(LogLevel level, const char* line, size_t length);
+    std::string formatMessage(LogLevel level, const char* message, size_t length);
+    size_t formatRecord(char* out, size_t capacity, LogLevel level, const char* message, size_t length);
+    void openLogFile();
     void rotateLogFile();
     void checkAndRotate();
     
     std::ofstream logFile_;
     std::mutex mutex_;
     std::string logFilePath_;
-    LogLevel currentLevel_ = LogLevel::INFO;
+    std::atomic<LogLevel> currentLevel_{LogLevel::INFO};
     bool consoleEnabled_ = true;
     bool fileEnabled_ = true;
     size_t maxFileSizeBytes_ = 10 * 1024 * 1024; // 10MB default
+    size_t fileSize_ = 0;                        // Tracked instead of seeking the stream
     int maxFiles_ = 5;
     bool initialized_ = false;
+    
+    // Async mode state
+    std::unique_ptr<MpscRingBuffer<LogRecord>> queue_;
+    std::thread writerThread_;
+    std::atomic<bool> asyncEnabled_{false};        // Producers may push
+    std::atomic<int> asyncProducers_{0};           // Producers between check and push
+    std::mutex lifecycleMutex_;                    // Serializes startAsync/shutdown
+    std::atomic<bool> stopWriter_{false};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> flushRequested_{0};
+    uint64_t flushCompleted_ = 0;
+    LogOverflowPolicy overflowPolicy_ = LogOverflowPolicy::DROP;
+    std::chrono::milliseconds flushInterval_{1000};
+    std::mutex writerMutex_;
+    std::condition_variable writerCv_;
+    std::condition_variable flushedCv_;
 };
 
-// Convenience macros
-#define LOG_DEBUG(msg) Logger::getInstance().debug(msg)
-#define LOG_INFO(msg) Logger::getInstance().info(msg)
-#define LOG_WARN(msg) Logger::getInstance().warn(msg)
-#define LOG_ERROR(msg) Logger::getInstance().error(msg)
-#define LOG_CRITICAL(msg) Logger::getInstance().critical(msg)
+// Convenience macros. Arguments are only evaluated when the level is enabled,
+// so LOG_DEBUG("x=" + std::to_string(x)) costs one relaxed load when debug is
+// off. Pass printf-style arguments (LOG_DEBUG("x=%d", x)) to also skip the
+// std::string temporaries when it is on. Statements below
+// LOG_COMPILE_MIN_LEVEL are type-checked but compiled out.
+#define LOG_AT_LEVEL(level, method, ...) \
+    do { \
+        Logger& logger_ = Logger::getInstance(); \
+        if (logger_.isEnabled(level)) logger_.method(__VA_ARGS__); \
+    } while (0)
+#define LOG_DISABLED(method, ...) \
+    do { \
+        if (false) Logger::getInstance().method(__VA_ARGS__); \
+    } while (0)
+
+#if LOG_COMPILE_MIN_LEVEL <= 0
+#define LOG_DEBUG(...) LOG_AT_LEVEL(LogLevel::DEBUG, debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) LOG_DISABLED(debug, __VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_MIN_LEVEL <= 1
+#define LOG_INFO(...) LOG_AT_LEVEL(LogLevel::INFO, info, __VA_ARGS__)
+#else
+#define LOG_INFO(...) LOG_DISABLED(info, __VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_MIN_LEVEL <= 2
+#define LOG_WARN(...) LOG_AT_LEVEL(LogLevel::WARN, warn, __VA_ARGS__)
+#else
+#define LOG_WARN(...) LOG_DISABLED(warn, __VA_ARGS__)
+#endif
+
+#if LOG_COMPILE_MIN_LEVEL <= 3
+#define LOG_ERROR(...) LOG_AT_LEVEL(LogLevel::ERROR, error, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) LOG_DISABLED(error, __VA_ARGS__)
+#endif
+
+#define LOG_CRITICAL(...) LOG_AT_LEVEL(LogLevel::CRITICAL, critical, __VA_ARGS__)
 
 #endif // LOGGER_H
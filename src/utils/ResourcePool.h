@@ -0,0 +1,178 @@
+#ifndef RESOURCE_POOL_H
+#define RESOURCE_POOL_H
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Fixed set of expensive objects (Tesseract engines, the classifier) shared
+// by several threads. Waiters are served strictly in arrival order, so when
+// each source thread holds at most one request at a time the pool hands out
+// engines round-robin and no source can starve the others. Threads that must
+// not block (executor workers) queue a callback with tryAcquire() instead.
+template <typename T>
+class ResourcePool {
+public:
+    // Returns the object to the pool when destroyed; empty after close()
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(ResourcePool* pool, T* item) : pool_(pool), item_(item) {}
+        Lease(Lease&& other) noexcept : pool_(other.pool_), item_(other.item_) {
+            other.pool_ = nullptr;
+            other.item_ = nullptr;
+        }
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                reset();
+                pool_ = other.pool_;
+                item_ = other.item_;
+                other.pool_ = nullptr;
+                other.item_ = nullptr;
+            }
+            return *this;
+        }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        ~Lease() { reset(); }
+
+        explicit operator bool() const { return item_ != nullptr; }
+        T* operator->() const { return item_; }
+        T& operator*() const { return *item_; }
+
+        void reset() {
+            // Clear first: release() may run a grant that touches this lease
+            ResourcePool* pool = pool_;
+            T* item = item_;
+            pool_ = nullptr;
+            item_ = nullptr;
+            if (pool != nullptr && item != nullptr) {
+                pool->release(item);
+            }
+        }
+
+    private:
+        ResourcePool* pool_ = nullptr;
+        T* item_ = nullptr;
+    };
+
+    // Called with a lease once an object is free (see tryAcquire)
+    using Grant = std::function<void(Lease)>;
+
+    ResourcePool() = default;
+    ResourcePool(const ResourcePool&) = delete;
+    ResourcePool& operator=(const ResourcePool&) = delete;
+
+    // Takes ownership; call before the pool is shared
+    void add(std::unique_ptr<T> item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(item.get());
+        items_.push_back(std::move(item));
+        available_.notify_all();
+    }
+
+    size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return items_.size();
+    }
+
+    size_t waiting() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return waiters_.size() + grants_.size();
+    }
+
+    // Block until an object is free and every earlier waiter has been served
+    Lease acquire() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        uint64_t ticket = nextTicket_++;
+        waiters_.push_back(ticket);
+        available_.wait(lock, [&]() { return closed_ || (waiters_.front() == ticket && !free_.empty()); });
+        waiters_.erase(std::find(waiters_.begin(), waiters_.end(), ticket));
+        if (closed_) {
+            available_.notify_all();
+            return Lease();
+        }
+        T* item = free_.back();
+        free_.pop_back();
+        // The next waiter may be able to proceed too
+        available_.notify_all();
+        return Lease(this, item);
+    }
+
+    // Non-blocking acquire. Returns true with lease set (empty after close())
+    // when the caller can go ahead now. Otherwise queues grant behind earlier
+    // requests and returns false; grant is later called with the lease on the
+    // thread that returns an object (or with an empty lease from close()), so
+    // it should hand the work back to its executor rather than run it there.
+    bool tryAcquire(Lease& lease, Grant grant) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (closed_) {
+            lock.unlock();
+            lease = Lease();
+            return true;
+        }
+        if (waiters_.empty() && grants_.empty() && !free_.empty()) {
+            T* item = free_.back();
+            free_.pop_back();
+            lock.unlock();
+            lease = Lease(this, item);
+            return true;
+        }
+        grants_.push_back(std::move(grant));
+        return false;
+    }
+
+    // Wake all waiters with empty leases; outstanding leases still return normally
+    void close() {
+        std::deque<Grant> grants;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+            grants.swap(grants_);
+            available_.notify_all();
+        }
+        for (Grant& grant : grants) {
+            grant(Lease());
+        }
+    }
+
+    // Apply fn to every object; only while no leases are outstanding
+    template <typename Fn>
+    void forEach(Fn fn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& item : items_) {
+            fn(*item);
+        }
+    }
+
+private:
+    void release(T* item) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        // Blocked acquire() calls go first, then the oldest queued grant
+        if (!closed_ && waiters_.empty() && !grants_.empty()) {
+            Grant grant = std::move(grants_.front());
+            grants_.pop_front();
+            lock.unlock();
+            grant(Lease(this, item));
+            return;
+        }
+        free_.push_back(item);
+        available_.notify_all();
+    }
+
+    mutable std::mutex mutex_;
+    std::condition_variable available_;
+    std::vector<std::unique_ptr<T>> items_;
+    std::vector<T*> free_;
+    std::deque<uint64_t> waiters_;
+    std::deque<Grant> grants_;
+    uint64_t nextTicket_ = 0;
+    bool closed_ = false;
+};
+
+#endif // RESOURCE_POOL_H
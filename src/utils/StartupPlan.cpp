@@ -0,0 +1,124 @@
+#include "StartupPlan.h"
+#include "Logger.h"
+#include "../monitoring/MetricsRegistry.h"
+
+StartupPlan::~StartupPlan() {
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+}
+
+bool StartupPlan::add(const std::string& name, Phase phase, const std::vector<std::string>& after) {
+    Entry entry;
+    entry.name = name;
+    entry.run = std::move(phase);
+    bool ok = true;
+    for (const std::string& dependency : after) {
+        size_t found = phases_.size();
+        for (size_t i = 0; i < phases_.size(); i++) {
+            if (phases_[i].name == dependency) {
+                found = i;
+            }
+        }
+        if (found == phases_.size()) {
+            LOG_ERROR("Startup phase %s needs unknown phase %s", name.c_str(), dependency.c_str());
+            ok = false;
+            continue;
+        }
+        entry.after.push_back(found);
+    }
+    invalid_ = invalid_ || !ok;
+    phases_.push_back(std::move(entry));
+    return ok;
+}
+
+void StartupPlan::start(bool parallel) {
+    started_ = std::chrono::steady_clock::now();
+    if (invalid_) {
+        // A typo in a dependency would otherwise run the phase too early
+        LOG_ERROR("Startup plan has unknown dependencies; no phase is run");
+        for (Entry& entry : phases_) {
+            entry.state = State::Skipped;
+        }
+        return;
+    }
+    for (size_t i = 0; i < phases_.size(); i++) {
+        if (parallel) {
+            threads_.emplace_back(&StartupPlan::runPhase, this, i);
+        } else {
+            runPhase(i);
+        }
+    }
+}
+
+void StartupPlan::runPhase(size_t index) {
+    Entry& entry = phases_[index];
+    {
+        // Dependencies were added earlier, so waiting on them cannot deadlock
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [&]() {
+            for (size_t dependency : entry.after) {
+                if (phases_[dependency].state == State::Pending) return false;
+            }
+            return true;
+        });
+        for (size_t dependency : entry.after) {
+            if (phases_[dependency].state != State::Ok) {
+                entry.state = State::Skipped;
+                done_.notify_all();
+                return;
+            }
+        }
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    bool ok = entry.run();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entry.seconds = seconds;
+    entry.state = ok ? State::Ok : State::Failed;
+    done_.notify_all();
+}
+
+bool StartupPlan::wait() {
+    for (std::thread& thread : threads_) {
+        thread.join();
+    }
+    threads_.clear();
+    if (phases_.empty()) {
+        return true;
+    }
+
+    MetricsRegistry& metrics = MetricsRegistry::getInstance();
+    double total = std::chrono::duration<double>(std::chrono::steady_clock::now() - started_).count();
+    double sum = 0.0;
+    bool allOk = true;
+    for (const Entry& entry : phases_) {
+        if (entry.state == State::Skipped) {
+            LOG_WARN("Startup phase %s skipped: %s", entry.name.c_str(),
+                     invalid_ ? "the plan is invalid" : "a phase it needs failed");
+            allOk = false;
+            continue;
+        }
+        sum += entry.seconds;
+        allOk = allOk && entry.state == State::Ok;
+        metrics.gauge("vitalsign_startup_phase_seconds", "Duration of each start-up phase",
+                      "phase=\"" + entry.name + "\"").set(entry.seconds);
+        LOG_INFO("Startup phase %s: %.0f ms%s", entry.name.c_str(), entry.seconds * 1000.0,
+                 entry.state == State::Ok ? "" : " (failed)");
+    }
+    metrics.gauge("vitalsign_startup_seconds", "Wall time of the start-up phases").set(total);
+    LOG_INFO("Startup phases done in %.0f ms (%.0f ms if run one after another)", total * 1000.0, sum * 1000.0);
+    return allOk;
+}
+
+bool StartupPlan::succeeded(const std::string& name) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const Entry& entry : phases_) {
+        if (entry.name == name) {
+            return entry.state == State::Ok;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,59 @@
+#ifndef STARTUP_PLAN_H
+#define STARTUP_PLAN_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Named start-up phases run concurrently, each on its own thread as soon as
+// the phases it depends on have succeeded. A phase whose dependency failed
+// is skipped. start() returns at once so the caller can do cheap set-up
+// meanwhile; wait() joins the phases and logs how long each took.
+class StartupPlan {
+public:
+    using Phase = std::function<bool()>;
+
+    StartupPlan() = default;
+    ~StartupPlan();
+    StartupPlan(const StartupPlan&) = delete;
+    StartupPlan& operator=(const StartupPlan&) = delete;
+
+    // Dependencies must already have been added, so the plan has no cycles.
+    // An unknown dependency is logged, returns false and invalidates the plan.
+    bool add(const std::string& name, Phase phase, const std::vector<std::string>& after = {});
+
+    // parallel = false runs every phase inline, in the order added. An
+    // invalid plan runs nothing and every phase counts as skipped.
+    void start(bool parallel);
+
+    // Returns false if any phase failed or was skipped
+    bool wait();
+
+    bool succeeded(const std::string& name) const;
+
+private:
+    enum class State { Pending, Ok, Failed, Skipped };
+
+    struct Entry {
+        std::string name;
+        Phase run;
+        std::vector<size_t> after;
+        State state = State::Pending;
+        double seconds = 0.0;
+    };
+
+    void runPhase(size_t index);
+
+    std::vector<Entry> phases_;
+    std::vector<std::thread> threads_;
+    mutable std::mutex mutex_;
+    std::condition_variable done_;
+    std::chrono::steady_clock::time_point started_;
+    bool invalid_ = false;              // add() named an unknown dependency
+};
+
+#endif // STARTUP_PLAN_H
@@ -0,0 +1,104 @@
+#include "TimestampFormatter.h"
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace {
+
+struct PrefixCache {
+    std::time_t second = static_cast<std::time_t>(-1);
+    char text[TimestampFormatter::kSecondsLength + 1];
+};
+
+thread_local PrefixCache t_cache;
+
+// Epoch seconds of the start of the last local hour parsed on this thread
+struct HourCache {
+    int year = -1, month = -1, day = -1, hour = -1;
+    std::time_t start = 0;
+};
+
+thread_local HourCache t_hour;
+
+} // namespace
+
+void TimestampFormatter::writePrefix(Clock::time_point time, char* out) {
+    std::time_t second = Clock::to_time_t(time);
+    if (second != t_cache.second) {
+        std::tm tm{};
+        localtime_r(&second, &tm);
+        std::strftime(t_cache.text, sizeof(t_cache.text), "%Y-%m-%d %H:%M:%S", &tm);
+        t_cache.second = second;
+    }
+    std::memcpy(out, t_cache.text, kSecondsLength);
+}
+
+size_t TimestampFormatter::formatSeconds(Clock::time_point time, char* out) {
+    writePrefix(time, out);
+    out[kSecondsLength] = '\0';
+    return kSecondsLength;
+}
+
+size_t TimestampFormatter::formatMillis(Clock::time_point time, char* out) {
+    writePrefix(time, out);
+    
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count() % 1000;
+    if (ms < 0) ms += 1000;
+    out[kSecondsLength] = '.';
+    out[kSecondsLength + 1] = static_cast<char>('0' + ms / 100);
+    out[kSecondsLength + 2] = static_cast<char>('0' + (ms / 10) % 10);
+    out[kSecondsLength + 3] = static_cast<char>('0' + ms % 10);
+    out[kMillisLength] = '\0';
+    return kMillisLength;
+}
+
+std::string TimestampFormatter::seconds(Clock::time_point time) {
+    char buffer[kBufferSize];
+    return std::string(buffer, formatSeconds(time, buffer));
+}
+
+std::string TimestampFormatter::millis(Clock::time_point time) {
+    char buffer[kBufferSize];
+    return std::string(buffer, formatMillis(time, buffer));
+}
+
+bool TimestampFormatter::parseLocal(const char* text, int64_t& epochUs) {
+    int year, month, day, hour, minute, second, consumed = 0;
+    if (std::sscanf(text, "%4d-%2d-%2d %2d:%2d:%2d%n", &year, &month, &day, &hour, &minute, &second,
+                    &consumed) != 6) {
+        return false;
+    }
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour < 0 || hour > 23 ||
+        minute < 0 || minute > 59 || second < 0 || second > 60) {
+        return false;
+    }
+    int64_t micros = 0;
+    const char* fraction = text + consumed;
+    if (*fraction == '.') {
+        int64_t scale = 100000;
+        for (fraction++; *fraction >= '0' && *fraction <= '9'; fraction++) {
+            micros += (*fraction - '0') * scale;
+            scale /= 10;
+        }
+    }
+    if (*fraction != '\0') {
+        return false;
+    }
+    
+    HourCache& cache = t_hour;
+    if (year != cache.year || month != cache.month || day != cache.day || hour != cache.hour) {
+        std::tm tm{};
+        tm.tm_year = year - 1900;
+        tm.tm_mon = month - 1;
+        tm.tm_mday = day;
+        tm.tm_hour = hour;
+        tm.tm_isdst = -1;
+        std::time_t start = std::mktime(&tm);
+        if (start == static_cast<std::time_t>(-1)) {
+            return false;
+        }
+        cache = HourCache{year, month, day, hour, start};
+    }
+    epochUs = (static_cast<int64_t>(cache.start) + minute * 60 + second) * 1000000 + micros;
+    return true;
+}
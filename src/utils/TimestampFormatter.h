@@ -0,0 +1,44 @@
+#ifndef TIMESTAMP_FORMATTER_H
+#define TIMESTAMP_FORMATTER_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Local-time "YYYY-MM-DD HH:MM:SS[.mmm]" formatting shared by the logger and
+// output rows. The date/time prefix is rendered once per second per thread
+// (via localtime_r) and reused; only the milliseconds are written per call.
+class TimestampFormatter {
+public:
+    using Clock = std::chrono::system_clock;
+    
+    static constexpr size_t kSecondsLength = 19;   // "YYYY-MM-DD HH:MM:SS"
+    static constexpr size_t kMillisLength = 23;    // "YYYY-MM-DD HH:MM:SS.mmm"
+    static constexpr size_t kBufferSize = 24;      // Longest form plus NUL
+    
+    // Write the timestamp plus a terminating NUL into out (kBufferSize bytes);
+    // returns the number of characters written excluding the NUL
+    static size_t formatSeconds(Clock::time_point time, char* out);
+    static size_t formatMillis(Clock::time_point time, char* out);
+    
+    // Convenience wrappers returning std::string
+    static std::string seconds(Clock::time_point time = Clock::now());
+    static std::string millis(Clock::time_point time = Clock::now());
+    
+    // Inverse of the formatters: parse "YYYY-MM-DD HH:MM:SS[.ffffff]" as
+    // local time into microseconds since the epoch. The zone offset is looked
+    // up once per hour per thread. Returns false on malformed text.
+    static bool parseLocal(const char* text, int64_t& epochUs);
+    
+    // Microseconds since the Unix epoch, for binary sinks
+    static int64_t toEpochMicros(Clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+    }
+    
+private:
+    // Copies the cached prefix for the second containing time into out
+    static void writePrefix(Clock::time_point time, char* out);
+};
+
+#endif // TIMESTAMP_FORMATTER_H
@@ -0,0 +1,64 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <cstdio>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Minimal unit-test support: TEST(name) registers a case, CHECK* record a
+// failure and carry on, REQUIRE* record it and leave the case. tests/TestMain.cpp
+// runs every registered case and exits non-zero if any check failed.
+namespace test {
+
+struct Case {
+    const char* name;
+    std::function<void()> run;
+};
+
+inline std::vector<Case>& cases() {
+    static std::vector<Case> all;
+    return all;
+}
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+struct Registrar {
+    Registrar(const char* name, std::function<void()> run) { cases().push_back({name, std::move(run)}); }
+};
+
+inline bool fail(const char* file, int line, const std::string& what) {
+    std::fprintf(stderr, "  %s:%d: %s\n", file, line, what.c_str());
+    failures()++;
+    return false;
+}
+
+template <typename A, typename B>
+std::string describe(const char* expression, const A& a, const B& b) {
+    std::ostringstream out;
+    out << expression << " (" << a << " vs " << b << ")";
+    return out.str();
+}
+
+} // namespace test
+
+#define TEST(name)                                                     \
+    static void name();                                                \
+    static test::Registrar name##_registrar(#name, name);              \
+    static void name()
+
+#define CHECK(cond) \
+    ((cond) ? true : test::fail(__FILE__, __LINE__, #cond))
+#define CHECK_EQ(a, b) \
+    ((a) == (b) ? true : test::fail(__FILE__, __LINE__, test::describe(#a " == " #b, (a), (b))))
+#define CHECK_NEAR(a, b, tolerance) \
+    (((a) - (b) <= (tolerance) && (b) - (a) <= (tolerance)) ? true \
+        : test::fail(__FILE__, __LINE__, test::describe(#a " ~= " #b, (a), (b))))
+#define REQUIRE(cond) \
+    do { if (!CHECK(cond)) return; } while (0)
+
+#endif // TEST_H
@@ -0,0 +1,18 @@
+#include "Test.h"
+#include "../src/utils/Logger.h"
+
+int main() {
+    // Keep expected error paths quiet
+    Logger::getInstance().setLogLevel(LogLevel::CRITICAL);
+
+    int failedCases = 0;
+    for (const test::Case& c : test::cases()) {
+        int before = test::failures();
+        c.run();
+        bool ok = test::failures() == before;
+        failedCases += ok ? 0 : 1;
+        std::printf("%s %s\n", ok ? "[ ok ]" : "[FAIL]", c.name);
+    }
+    std::printf("%zu cases, %d failed\n", test::cases().size(), failedCases);
+    return failedCases == 0 ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+#include "Test.h"
+#include "../src/alarm/AlarmEngine.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+const int64_t kStartMs = 1790000000000LL;
+
+std::chrono::system_clock::time_point at(int sec) {
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(kStartMs + sec * 1000LL));
+}
+
+VitalSample hr(int value) {
+    VitalSample sample;
+    sample.hr = value;
+    return sample;
+}
+
+AlarmRuleConfig rule(const std::string& name, const std::string& when, float value, int forSec = 0) {
+    AlarmRuleConfig config;
+    config.name = name;
+    config.field = "hr";
+    config.when = when;
+    config.value = value;
+    config.forSec = forSec;
+    config.withinSec = 10;
+    return config;
+}
+
+int connectTo(const std::string& path) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    path.copy(addr.sun_path, sizeof(addr.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Next line from fd, or "" after timeoutMs
+std::string readLine(int fd, std::string& buffered, int timeoutMs = 2000) {
+    while (buffered.find('\n') == std::string::npos) {
+        pollfd pfd{fd, POLLIN, 0};
+        char chunk[512];
+        ssize_t n;
+        if (poll(&pfd, 1, timeoutMs) <= 0 || (n = ::recv(fd, chunk, sizeof(chunk), 0)) <= 0) {
+            return "";
+        }
+        buffered.append(chunk, static_cast<size_t>(n));
+    }
+    size_t end = buffered.find('\n');
+    std::string line = buffered.substr(0, end);
+    buffered.erase(0, end + 1);
+    return line;
+}
+
+bool contains(const std::string& text, const std::string& part) {
+    return text.find(part) != std::string::npos;
+}
+
+} // namespace
+
+TEST(alarm_raises_after_hold_and_clears) {
+    AlarmEngine& engine = AlarmEngine::getInstance();
+    REQUIRE(engine.init({"bed-1", "bed-2"}, {rule("tachycardia", "above", 120, 3)}));
+    engine.evaluate("bed-1", at(0), hr(130));
+    engine.evaluate("bed-1", at(2), hr(131));
+    CHECK(engine.activeAlarms().empty());
+    engine.evaluate("bed-1", at(3), hr(132));
+    engine.evaluate("bed-2", at(3), hr(80));
+
+    std::vector<ActiveAlarm> active = engine.activeAlarms();
+    REQUIRE(CHECK_EQ(active.size(), 1u));
+    CHECK_EQ(active[0].source, "bed-1");
+    CHECK_EQ(active[0].rule, "tachycardia");
+    CHECK_EQ(active[0].value, 132);
+    CHECK(active[0].since == at(3));
+
+    // A missing reading keeps it; a normal one clears it
+    engine.evaluate("bed-1", at(4), VitalSample());
+    CHECK_EQ(engine.activeAlarms().size(), 1u);
+    engine.evaluate("bed-1", at(5), hr(90));
+    CHECK(engine.activeAlarms().empty());
+}
+
+TEST(rise_uses_the_window_minimum) {
+    AlarmEngine& engine = AlarmEngine::getInstance();
+    REQUIRE(engine.init({""}, {rule("jump", "rise", 20)}));
+    engine.evaluate("", at(0), hr(70));
+    engine.evaluate("", at(5), hr(80));
+    CHECK(engine.activeAlarms().empty());
+    engine.evaluate("", at(9), hr(91));
+    CHECK_EQ(engine.activeAlarms().size(), 1u);
+    // 70 has left the 10 s window; the minimum is now 80
+    engine.evaluate("", at(12), hr(95));
+    CHECK(engine.activeAlarms().empty());
+}
+
+TEST(late_socket_client_gets_active_alarms_then_events) {
+    AlarmEngine& engine = AlarmEngine::getInstance();
+    REQUIRE(engine.init({""}, {rule("tachycardia", "above", 120), rule("bradycardia", "below", 40)}));
+    char dir[] = "/tmp/vitalsign_alarm_XXXXXX";
+    REQUIRE(mkdtemp(dir) != nullptr);
+    std::string path = std::string(dir) + "/alarms.sock";
+    REQUIRE(engine.listen(path));
+
+    engine.evaluate("", at(0), hr(150));
+
+    // No event follows the connection; the greeting alone reports the alarm
+    int fd = connectTo(path);
+    REQUIRE(fd >= 0);
+    std::string buffered;
+    std::string greeting = readLine(fd, buffered);
+    CHECK(contains(greeting, "\"rule\":\"tachycardia\""));
+    CHECK(contains(greeting, "\"state\":\"active\""));
+    CHECK(contains(greeting, "\"value\":150"));
+
+    engine.evaluate("", at(1), hr(100));
+    std::string event = readLine(fd, buffered);
+    CHECK(contains(event, "\"state\":\"cleared\""));
+
+    // Nothing active: a new client gets no greeting, only later events
+    int second = connectTo(path);
+    REQUIRE(second >= 0);
+    std::string secondBuffered;
+    CHECK_EQ(readLine(second, secondBuffered, 300), "");
+    engine.evaluate("", at(2), hr(30));
+    CHECK(contains(readLine(second, secondBuffered), "\"rule\":\"bradycardia\""));
+
+    ::close(fd);
+    ::close(second);
+    engine.shutdown();
+    rmdir(dir);
+}
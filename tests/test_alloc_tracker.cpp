@@ -0,0 +1,78 @@
+#include "Test.h"
+#include "../src/monitoring/AllocTracker.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Built with -DALLOC_TRACKING=1 (see test_alloc_tracker_FLAGS in the Makefile)
+
+TEST(frame_counts_its_own_allocations) {
+    REQUIRE(AllocTracker::kCompiled);
+    AllocTracker& allocs = AllocTracker::getInstance();
+    std::vector<std::unique_ptr<int>> held;
+    held.reserve(10);
+    {
+        AllocFrameScope frame;
+        for (int i = 0; i < 10; i++) {
+            held.emplace_back(new int(i));
+        }
+    }
+    CHECK_EQ(allocs.lastFrameAllocs(), 10u);
+}
+
+TEST(other_threads_are_not_charged_to_the_frame) {
+    AllocTracker& allocs = AllocTracker::getInstance();
+    std::atomic<int> phase{0};
+    std::vector<std::unique_ptr<int>> background;
+    background.reserve(1000);
+    std::thread worker([&]() {
+        while (phase.load() != 1) {
+            std::this_thread::yield();
+        }
+        for (int i = 0; i < 1000; i++) {
+            background.emplace_back(new int(i));
+        }
+        phase.store(2);
+    });
+
+    std::unique_ptr<int> own;
+    {
+        AllocFrameScope frame;
+        phase.store(1);
+        while (phase.load() != 2) {
+            std::this_thread::yield();
+        }
+        own.reset(new int(1));
+    }
+    worker.join();
+    CHECK_EQ(background.size(), 1000u);
+    CHECK_EQ(allocs.lastFrameAllocs(), 1u);
+}
+
+TEST(steady_frames_are_split_by_stage) {
+    AllocTracker& allocs = AllocTracker::getInstance();
+    allocs.setWarmupFrames(1);
+    allocs.reset();
+    std::vector<std::unique_ptr<int>> held;
+    held.reserve(16);
+    for (int frame = 0; frame < 3; frame++) {
+        AllocFrameScope scope;
+        {
+            ALLOC_STAGE(Ocr);
+            held.emplace_back(new int(frame));
+        }
+        ALLOC_STAGE(Ml);
+        held.emplace_back(new int(frame));
+        held.emplace_back(new int(frame));
+    }
+    AllocSummary summary = allocs.summary();
+    CHECK_EQ(summary.frames, 3);
+    CHECK_EQ(summary.steadyFrames, 2);
+    CHECK_EQ(summary.steady[static_cast<int>(AllocStage::Ocr)].allocs, 2u);
+    CHECK_EQ(summary.steady[static_cast<int>(AllocStage::Ml)].allocs, 4u);
+    CHECK_NEAR(summary.steadyAllocsPerFrame, 3.0, 1e-9);
+    allocs.setWarmupFrames(0);
+    allocs.reset();
+}
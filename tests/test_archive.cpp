@@ -0,0 +1,184 @@
+#include "Test.h"
+#include "../src/timeseries/ArchiveReader.h"
+#include "../src/timeseries/ArchiveWriter.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <random>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+const int64_t kDayStartMs = 1765843200000LL;    // 2025-12-16 00:00:00 UTC
+
+std::string tempDirectory() {
+    char path[] = "/tmp/vitalsign_archive_XXXXXX";
+    return mkdtemp(path);
+}
+
+std::chrono::system_clock::time_point at(int64_t ms) {
+    return std::chrono::system_clock::time_point(std::chrono::milliseconds(ms));
+}
+
+VitalSample vitals(int i) {
+    VitalSample sample;
+    sample.hr = 70 + i % 5;
+    sample.spo2 = i % 7 == 0 ? -1 : 97;
+    sample.systolic = 120;
+    sample.diastolic = 80 - i % 3;
+    return sample;
+}
+
+} // namespace
+
+TEST(codecs_round_trip) {
+    std::mt19937 rng(7);
+    std::vector<int64_t> times;
+    std::vector<int32_t> ints;
+    std::vector<float> floats;
+    std::vector<std::string> labels;
+    int64_t t = kDayStartMs;
+    for (int i = 0; i < 1000; i++) {
+        t += 1000 + static_cast<int64_t>(rng() % 3) - 1 + (i == 500 ? 3600000 : 0);
+        times.push_back(t);
+        ints.push_back(i % 50 == 0 ? -1 : 60 + static_cast<int32_t>(rng() % 40));
+        floats.push_back(static_cast<float>(rng() % 1000) / 1000.0f);
+        labels.push_back(i % 3 == 0 ? "Normal" : (i % 3 == 1 ? "AFib" : ""));
+    }
+
+    std::vector<uint8_t> encoded;
+    std::vector<int64_t> decodedTimes;
+    archive::encodeTimes(times, encoded);
+    REQUIRE(archive::decodeTimes(encoded.data(), encoded.size(), times.size(), decodedTimes));
+    CHECK(decodedTimes == times);
+
+    std::vector<int32_t> decodedInts;
+    encoded.clear();
+    archive::encodeInts(ints, encoded);
+    REQUIRE(archive::decodeInts(encoded.data(), encoded.size(), ints.size(), decodedInts));
+    CHECK(decodedInts == ints);
+
+    std::vector<float> decodedFloats;
+    encoded.clear();
+    archive::encodeFloats(floats, encoded);
+    REQUIRE(archive::decodeFloats(encoded.data(), encoded.size(), floats.size(), decodedFloats));
+    CHECK(decodedFloats == floats);
+
+    std::vector<std::string> decodedLabels;
+    encoded.clear();
+    archive::encodeLabels(labels, encoded);
+    REQUIRE(archive::decodeLabels(encoded.data(), encoded.size(), labels.size(), decodedLabels));
+    CHECK(decodedLabels == labels);
+}
+
+TEST(index_record_is_little_endian_without_padding) {
+    ArchiveBlockIndex entry = {};
+    entry.firstMs = 0x0102030405060708LL;
+    entry.lastMs = -2;
+    entry.count = 0x0A0B0C0D;
+    for (int c = 0; c < kArchiveColumns; c++) {
+        entry.offset[c] = 0x1000u + c;
+        entry.size[c] = 0x20u + c;
+    }
+    uint8_t record[kArchiveIndexRecordSize];
+    archive::encodeIndex(entry, record);
+    CHECK_EQ(kArchiveIndexRecordSize, 108u);
+    CHECK_EQ(record[0], 0x08);
+    CHECK_EQ(record[7], 0x01);
+    CHECK_EQ(record[8], 0xFE);
+    CHECK_EQ(record[16], 0x0D);
+    CHECK_EQ(record[24], 0x00);                             // offset[0] = 0x1000
+    CHECK_EQ(record[25], 0x10);
+    CHECK_EQ(record[24 + kArchiveColumns * 8], 0x20);       // size[0]
+
+    ArchiveBlockIndex decoded = {};
+    archive::decodeIndex(record, decoded);
+    CHECK_EQ(decoded.firstMs, entry.firstMs);
+    CHECK_EQ(decoded.lastMs, entry.lastMs);
+    CHECK_EQ(decoded.count, entry.count);
+    CHECK_EQ(decoded.offset[kArchiveColumns - 1], entry.offset[kArchiveColumns - 1]);
+    CHECK_EQ(decoded.size[kArchiveColumns - 1], entry.size[kArchiveColumns - 1]);
+}
+
+TEST(written_blocks_read_back_across_days) {
+    std::string root = tempDirectory();
+    ArchiveWriter& writer = ArchiveWriter::getInstance();
+    REQUIRE(writer.init(root, 100, 60));
+    // 250 samples a second apart, then 10 on the next day
+    for (int i = 0; i < 250; i++) {
+        writer.append("bed-1", at(kDayStartMs + i * 1000), vitals(i), i % 2 ? "Normal" : "AFib", 0.5f);
+    }
+    for (int i = 0; i < 10; i++) {
+        writer.append("bed-1", at(kDayStartMs + 86400000 + i * 1000), vitals(i), "Normal", 0.25f);
+    }
+    writer.close();
+
+    ArchiveReader reader(root);
+    std::vector<ArchiveSample> samples;
+    ArchiveReadStats stats;
+    REQUIRE(reader.read("bed-1", kDayStartMs, kDayStartMs + 2 * 86400000, samples, &stats));
+    REQUIRE(CHECK_EQ(samples.size(), 260u));
+    CHECK_EQ(stats.blocks, 4u);
+    CHECK_EQ(samples[0].timeMs, kDayStartMs);
+    CHECK_EQ(samples[7].spo2, -1);
+    CHECK_EQ(samples[1].ecgLabel, "Normal");
+    CHECK_EQ(samples[259].timeMs, kDayStartMs + 86400000 + 9000);
+    CHECK_NEAR(samples[259].ecgConfidence, 0.25f, 1e-6f);
+
+    // A range inside the first block only decodes that block
+    samples.clear();
+    stats = ArchiveReadStats();
+    REQUIRE(reader.read("bed-1", kDayStartMs + 10000, kDayStartMs + 20000, samples, &stats));
+    CHECK_EQ(samples.size(), 11u);
+    CHECK_EQ(stats.blocksRead, 1u);
+    fs::remove_all(root);
+}
+
+TEST(idle_source_flushes_after_the_interval) {
+    std::string root = tempDirectory();
+    ArchiveWriter& writer = ArchiveWriter::getInstance();
+    REQUIRE(writer.init(root, 1000, 1));
+    for (int i = 0; i < 5; i++) {
+        writer.append("", at(kDayStartMs + i * 1000), vitals(i), "", 0.0f);
+    }
+
+    // No further appends; the writer thread must seal the partial block
+    ArchiveReader reader(root);
+    std::vector<ArchiveSample> samples;
+    for (int wait = 0; wait < 40 && samples.empty(); wait++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        samples.clear();
+        reader.read("", kDayStartMs, kDayStartMs + 86400000, samples);
+    }
+    CHECK_EQ(samples.size(), 5u);
+    writer.close();
+    fs::remove_all(root);
+}
+
+TEST(torn_index_record_is_ignored) {
+    std::string root = tempDirectory();
+    ArchiveWriter& writer = ArchiveWriter::getInstance();
+    REQUIRE(writer.init(root, 10, 60));
+    for (int i = 0; i < 20; i++) {
+        writer.append("", at(kDayStartMs + i * 1000), vitals(i), "", 0.0f);
+    }
+    writer.close();
+
+    // Half a record, as if the process died while writing it
+    fs::path index = fs::path(root) / "default" / archive::utcDay(kDayStartMs) / archive::kIndexFileName;
+    FILE* out = fopen(index.c_str(), "ab");
+    REQUIRE(out != nullptr);
+    uint8_t partial[kArchiveIndexRecordSize / 2] = {1};
+    fwrite(partial, 1, sizeof(partial), out);
+    fclose(out);
+
+    ArchiveReader reader(root);
+    std::vector<ArchiveSample> samples;
+    REQUIRE(reader.read("", kDayStartMs, kDayStartMs + 86400000, samples));
+    CHECK_EQ(samples.size(), 20u);
+    fs::remove_all(root);
+}
@@ -0,0 +1,135 @@
+#include "Test.h"
+#include "../src/output/CsvSink.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+std::string tempDirectory() {
+    char path[] = "/tmp/vitalsign_csv_XXXXXX";
+    return mkdtemp(path);
+}
+
+size_t openFds() {
+    size_t count = 0;
+    for (const auto& entry : fs::directory_iterator("/proc/self/fd")) {
+        (void)entry;
+        count++;
+    }
+    return count;
+}
+
+size_t lineCount(const std::string& path) {
+    std::ifstream in(path);
+    size_t lines = 0;
+    for (std::string line; std::getline(in, line);) {
+        lines++;
+    }
+    return lines;
+}
+
+CsvRecord record(int i) {
+    static const std::string hr[] = {"72", "73", "74"};
+    CsvRecord row;
+    row.time = std::chrono::system_clock::now();
+    row.hr = hr[i % 3];
+    row.spo2 = "98";
+    row.abp = "120/80";
+    row.ecgLabel = "Normal";
+    row.ecgConfidence = 0.5f;
+    return row;
+}
+
+} // namespace
+
+TEST(reopen_closes_the_previous_file) {
+    std::string dir = tempDirectory();
+    CsvSinkOptions options;
+    options.path = dir + "/a.csv";
+    CsvSink sink;
+    REQUIRE(sink.open(options));
+    sink.write(record(0));
+    size_t fds = openFds();
+
+    options.path = dir + "/b.csv";
+    for (int i = 0; i < 5; i++) {
+        REQUIRE(sink.open(options));
+    }
+    CHECK_EQ(openFds(), fds);
+    // The row buffered for the first file was written before it was closed
+    CHECK_EQ(lineCount(dir + "/a.csv"), 2u);
+    sink.close();
+    fs::remove_all(dir);
+}
+
+TEST(size_rotation_happens_before_the_overflowing_row) {
+    std::string dir = tempDirectory();
+    CsvSinkOptions options;
+    options.path = dir + "/out.csv";
+    options.rotation = CsvRotation::Size;
+    options.maxFileBytes = 300;
+    options.maxFiles = 50;
+    options.bufferBytes = 64 * 1024;    // Clamped to maxFileBytes
+    options.flushIntervalMs = 60000;
+    CsvSink sink;
+    REQUIRE(sink.open(options));
+    const int rows = 40;
+    for (int i = 0; i < rows; i++) {
+        sink.write(record(i));
+    }
+    sink.close();
+
+    // Every file is within the limit and holds rows, and none are lost
+    size_t dataRows = 0;
+    size_t files = 0;
+    bool withinLimit = true;
+    bool allHoldRows = true;
+    for (int i = 0; i <= options.maxFiles; i++) {
+        std::string path = options.path + (i > 0 ? "." + std::to_string(i) : "");
+        if (!fs::exists(path)) {
+            continue;
+        }
+        files++;
+        withinLimit = withinLimit && fs::file_size(path) <= options.maxFileBytes;
+        size_t lines = lineCount(path);
+        allHoldRows = allHoldRows && lines > 1;
+        dataRows += lines - 1;
+    }
+    CHECK(withinLimit);
+    CHECK(allHoldRows);
+    CHECK_EQ(dataRows, static_cast<size_t>(rows));
+    CHECK(files > 1 && files < static_cast<size_t>(rows));
+    fs::remove_all(dir);
+}
+
+TEST(row_larger_than_the_limit_does_not_churn) {
+    std::string dir = tempDirectory();
+    CsvSinkOptions options;
+    options.path = dir + "/out.csv";
+    options.rotation = CsvRotation::Size;
+    options.maxFileBytes = 10;          // Smaller than the header and any row
+    options.maxFiles = 50;
+    CsvSink sink;
+    REQUIRE(sink.open(options));
+    for (int i = 0; i < 5; i++) {
+        sink.write(record(i));
+    }
+    sink.close();
+
+    // One row per file: never a file with only a header
+    size_t files = 0;
+    for (int i = 0; i <= options.maxFiles; i++) {
+        std::string path = options.path + (i > 0 ? "." + std::to_string(i) : "");
+        if (fs::exists(path)) {
+            files++;
+            CHECK_EQ(lineCount(path), 2u);
+        }
+    }
+    CHECK_EQ(files, 5u);
+    fs::remove_all(dir);
+}
@@ -0,0 +1,86 @@
+#include "Test.h"
+#include "../src/config/JsonValue.h"
+
+#include <fstream>
+#include <sstream>
+
+TEST(parses_scalars) {
+    JsonValue v;
+    REQUIRE(JsonValue::parse("true", v));
+    CHECK(v.isBool() && v.asBool());
+    REQUIRE(JsonValue::parse("null", v));
+    CHECK(v.isNull());
+    REQUIRE(JsonValue::parse("-12.5e1", v));
+    CHECK_EQ(v.asNumber(), -125.0);
+    REQUIRE(JsonValue::parse("  \"text\"  ", v));
+    CHECK_EQ(v.asString(), "text");
+}
+
+TEST(typed_accessors_fall_back_on_mismatch) {
+    JsonValue v;
+    REQUIRE(JsonValue::parse("\"5\"", v));
+    CHECK_EQ(v.asInt(7), 7);
+    CHECK_EQ(v.asBool(true), true);
+    REQUIRE(JsonValue::parse("42.9", v));
+    CHECK_EQ(v.asInt(), 42);
+    CHECK_EQ(v.asString("none"), "none");
+}
+
+TEST(decodes_string_escapes_and_surrogate_pairs) {
+    JsonValue v;
+    REQUIRE(JsonValue::parse(R"("a\"b\\c\/d\n\t\u00e9\ud83d\ude00")", v));
+    CHECK_EQ(v.asString(), "a\"b\\c/d\n\t\xc3\xa9\xf0\x9f\x98\x80");
+}
+
+TEST(objects_keep_member_order_and_support_dotted_paths) {
+    JsonValue v;
+    REQUIRE(JsonValue::parse(R"({"b": 1, "a": {"enabled": true, "x": [1, 2, 3]}, "c": {"enabled": false}})", v));
+    REQUIRE(v.isObject());
+    REQUIRE(v.keys().size() == 3u);
+    CHECK_EQ(v.keys()[0], "b");
+    CHECK_EQ(v.keys()[1], "a");
+    REQUIRE(v.find("a.enabled") != nullptr);
+    CHECK(v.find("a.enabled")->asBool());
+    // Same leaf name under different parents resolves independently
+    REQUIRE(v.find("c.enabled") != nullptr);
+    CHECK(!v.find("c.enabled")->asBool(true));
+    REQUIRE(v.find("a.x") != nullptr);
+    CHECK_EQ(v.find("a.x")->size(), 3u);
+    CHECK(v.find("a.missing") == nullptr);
+    CHECK(v.find("b.enabled") == nullptr);
+}
+
+TEST(tolerates_line_comments) {
+    JsonValue v;
+    REQUIRE(JsonValue::parse("{\n  \"a\": 1, // one\n  // whole line\n  \"b\": 2\n}", v));
+    CHECK_EQ(v.find("b")->asInt(), 2);
+}
+
+TEST(rejects_malformed_input_with_offset) {
+    const char* bad[] = {"", "{", "[1,]", "{\"a\" 1}", "tru", "\"open", "1 2", "\"\\x\"", "[\"\\ud83d\\u0041\"]"};
+    for (const char* text : bad) {
+        JsonValue v;
+        std::string error;
+        if (!CHECK(!JsonValue::parse(text, v, &error))) {
+            std::fprintf(stderr, "    accepted: %s\n", text);
+        }
+        CHECK(error.find("offset") != std::string::npos);
+    }
+}
+
+TEST(rejects_excessive_nesting) {
+    JsonValue v;
+    std::string deep(10000, '[');
+    CHECK(!JsonValue::parse(deep, v));
+}
+
+TEST(parses_shipped_config) {
+    std::ifstream in("config/config.json");
+    REQUIRE(in.good());
+    std::stringstream text;
+    text << in.rdbuf();
+    JsonValue v;
+    std::string error;
+    CHECK(JsonValue::parse(text.str(), v, &error));
+    CHECK(v.find("logging.async") != nullptr);
+}
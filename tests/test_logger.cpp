@@ -0,0 +1,89 @@
+#include "Test.h"
+#include "../src/utils/Logger.h"
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+// The logger is a process-wide singleton, so every case shares one file and
+// counts only the lines carrying its own tag
+const std::string& logPath() {
+    static const std::string path = [] {
+        std::string p = "/tmp/vitalsign_logger_test_" + std::to_string(getpid()) + ".log";
+        unlink(p.c_str());
+        Logger::getInstance().init(p, LogLevel::INFO, false, true, 1024, 2);
+        return p;
+    }();
+    return path;
+}
+
+int countLines(const std::string& path, const std::string& needle) {
+    std::ifstream in(path);
+    std::string line;
+    int count = 0;
+    while (std::getline(in, line)) {
+        count += line.find(needle) != std::string::npos ? 1 : 0;
+    }
+    return count;
+}
+
+// Producers log continuously while the writer thread is stopped and
+// restarted; every record must end up in the file exactly once
+void runRestartCycles(LogOverflowPolicy policy, const std::string& tag) {
+    const std::string& path = logPath();
+    Logger& logger = Logger::getInstance();
+    uint64_t droppedBefore = logger.getDroppedCount();
+
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+    std::atomic<int> running{kProducers};
+    std::vector<std::thread> producers;
+    logger.startAsync(16, policy, 5);
+    for (int p = 0; p < kProducers; p++) {
+        producers.emplace_back([&, p]() {
+            for (int i = 0; i < kPerProducer; i++) {
+                logger.info("%s %d %d", tag.c_str(), p, i);
+            }
+            running--;
+        });
+    }
+    while (running.load() > 0) {
+        logger.shutdown();
+        logger.startAsync(16, policy, 5);
+    }
+    for (std::thread& t : producers) {
+        t.join();
+    }
+    logger.shutdown();
+
+    int expected = kProducers * kPerProducer - static_cast<int>(logger.getDroppedCount() - droppedBefore);
+    CHECK_EQ(countLines(path, tag + " "), expected);
+}
+
+} // namespace
+
+TEST(block_policy_loses_nothing_across_shutdown_and_restart) {
+    runRestartCycles(LogOverflowPolicy::BLOCK, "block");
+    CHECK_EQ(Logger::getInstance().getDroppedCount(), 0u);
+}
+
+TEST(drop_policy_accounts_for_every_record_across_restart) {
+    runRestartCycles(LogOverflowPolicy::DROP, "drop");
+}
+
+TEST(block_producer_falls_back_to_sync_after_shutdown) {
+    const std::string& path = logPath();
+    Logger& logger = Logger::getInstance();
+    logger.startAsync(4, LogOverflowPolicy::BLOCK, 5);
+    logger.shutdown();
+    for (int i = 0; i < 100; i++) {
+        logger.info("sync %d", i);
+    }
+    CHECK_EQ(logger.getQueueDepth(), 0u);
+    CHECK_EQ(countLines(path, "sync "), 100);
+}
@@ -0,0 +1,61 @@
+#include "Test.h"
+#include "../src/monitoring/MetricsRegistry.h"
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Bucket {
+    std::string le;
+    uint64_t count;
+};
+
+// The _bucket lines of one histogram in a rendered scrape
+std::vector<Bucket> buckets(const std::string& scrape, const std::string& name) {
+    std::vector<Bucket> out;
+    std::istringstream lines(scrape);
+    std::string line;
+    std::string prefix = name + "_bucket{le=\"";
+    while (std::getline(lines, line)) {
+        if (line.compare(0, prefix.size(), prefix) != 0) continue;
+        size_t quote = line.find('"', prefix.size());
+        out.push_back({line.substr(prefix.size(), quote - prefix.size()),
+                       std::strtoull(line.c_str() + line.rfind(' ') + 1, nullptr, 10)});
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(histogram_exports_the_same_buckets_every_scrape) {
+    MetricsRegistry& registry = MetricsRegistry::getInstance();
+    Histogram& h = registry.histogram("test_latency_seconds", "Test latencies", "", 1e-6);
+    std::vector<Bucket> empty = buckets(registry.renderPrometheus(), "test_latency_seconds");
+
+    h.record(3);
+    h.record(900);
+    h.record(250000);
+    std::vector<Bucket> some = buckets(registry.renderPrometheus(), "test_latency_seconds");
+    h.record(uint64_t(1) << 45);            // Saturates: only +Inf holds it
+    std::vector<Bucket> all = buckets(registry.renderPrometheus(), "test_latency_seconds");
+
+    REQUIRE(empty.size() == some.size());
+    REQUIRE(some.size() == all.size());
+    CHECK_EQ(all.size(), static_cast<size_t>(Histogram::kBucketCount / Histogram::kSubBuckets));
+    bool sameBounds = true;
+    bool cumulative = true;
+    for (size_t i = 0; i < all.size(); i++) {
+        sameBounds = sameBounds && empty[i].le == all[i].le && some[i].le == all[i].le;
+        cumulative = cumulative && (i == 0 || all[i].count >= all[i - 1].count);
+    }
+    CHECK(sameBounds);
+    CHECK(cumulative);
+    CHECK_EQ(empty.back().le, "+Inf");
+    CHECK_EQ(empty.back().count, 0u);
+    CHECK_EQ(some[some.size() - 2].count, 3u);
+    CHECK_EQ(all[all.size() - 2].count, 3u);
+    CHECK_EQ(all.back().count, 4u);
+}
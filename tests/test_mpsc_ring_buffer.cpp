@@ -0,0 +1,87 @@
+#include "Test.h"
+#include "../src/utils/MpscRingBuffer.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+TEST(capacity_rounds_up_to_power_of_two) {
+    CHECK_EQ(MpscRingBuffer<int>(5).capacity(), 8u);
+    CHECK_EQ(MpscRingBuffer<int>(8).capacity(), 8u);
+    CHECK_EQ(MpscRingBuffer<int>(0).capacity(), 2u);
+}
+
+TEST(push_fails_when_full_and_pop_when_empty) {
+    MpscRingBuffer<int> ring(4);
+    for (int i = 0; i < 4; i++) {
+        CHECK(ring.tryPush([i](int& slot) { slot = i; }));
+    }
+    CHECK(!ring.tryPush([](int& slot) { slot = 99; }));
+    CHECK_EQ(ring.size(), 4u);
+
+    for (int i = 0; i < 4; i++) {
+        int value = -1;
+        CHECK(ring.tryPop([&](int& slot) { value = slot; }));
+        CHECK_EQ(value, i);
+    }
+    CHECK(!ring.tryPop([](int&) {}));
+    CHECK(ring.empty());
+}
+
+TEST(wraps_around_many_times_in_order) {
+    MpscRingBuffer<int> ring(4);
+    int next = 0;
+    for (int i = 0; i < 1000; i++) {
+        REQUIRE(ring.tryPush([i](int& slot) { slot = i; }));
+        if (i % 3 == 2) {
+            while (ring.tryPop([&](int& slot) { CHECK_EQ(slot, next); next++; })) {
+            }
+        }
+    }
+    while (ring.tryPop([&](int& slot) { CHECK_EQ(slot, next); next++; })) {
+    }
+    CHECK_EQ(next, 1000);
+}
+
+TEST(concurrent_producers_deliver_every_element_once_in_per_producer_order) {
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 50000;
+    MpscRingBuffer<std::pair<int, int>> ring(64);
+    std::atomic<bool> start{false};
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; p++) {
+        producers.emplace_back([&, p]() {
+            while (!start.load()) {
+                std::this_thread::yield();
+            }
+            for (int i = 0; i < kPerProducer; i++) {
+                while (!ring.tryPush([&](std::pair<int, int>& slot) { slot = {p, i}; })) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> expected(kProducers, 0);
+    int received = 0;
+    bool ordered = true;
+    start = true;
+    while (received < kProducers * kPerProducer) {
+        if (!ring.tryPop([&](std::pair<int, int>& slot) {
+                ordered = ordered && slot.second == expected[slot.first];
+                expected[slot.first] = slot.second + 1;
+                received++;
+            })) {
+            std::this_thread::yield();
+        }
+    }
+    for (std::thread& t : producers) {
+        t.join();
+    }
+    CHECK(ordered);
+    for (int p = 0; p < kProducers; p++) {
+        CHECK_EQ(expected[p], kPerProducer);
+    }
+    CHECK(ring.empty());
+}
@@ -0,0 +1,269 @@
+#include "Test.h"
+#include "../src/api/QueryServer.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <poll.h>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+const int64_t kStartMs = 1790000000000LL;
+
+std::string socketPath() {
+    return "/tmp/vitalsign_test_query_" + std::to_string(getpid()) + ".sock";
+}
+
+// Server on a fresh socket over a store holding HR 70, 71, ... for "bed-1"
+bool startServer() {
+    TimeSeriesStore& store = TimeSeriesStore::getInstance();
+    store.init({"bed-1"}, TsCapacity());
+    for (int i = 0; i < 120; i++) {
+        VitalSample sample;
+        sample.hr = 70 + i % 10;
+        store.append("bed-1", std::chrono::system_clock::time_point(std::chrono::milliseconds(kStartMs + i * 1000LL)),
+                     sample);
+    }
+    QueryServer::Options options;
+    options.maxConnections = 4;
+    options.maxPoints = 50;
+    return QueryServer::getInstance().startUnix(socketPath(), options);
+}
+
+int connectTo(const std::string& path) {
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    path.copy(addr.sun_path, sizeof(addr.sun_path) - 1);
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+        ::close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+void sendAll(int fd, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        ssize_t n = ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+        if (n <= 0) return;
+        sent += static_cast<size_t>(n);
+    }
+}
+
+// Append what arrives to buffered; false on EOF, error or timeout
+bool receive(int fd, std::string& buffered, int timeoutMs = 2000) {
+    pollfd pfd{fd, POLLIN, 0};
+    char chunk[4096];
+    ssize_t n;
+    if (poll(&pfd, 1, timeoutMs) <= 0 || (n = ::recv(fd, chunk, sizeof(chunk), 0)) <= 0) {
+        return false;
+    }
+    buffered.append(chunk, static_cast<size_t>(n));
+    return true;
+}
+
+struct Response {
+    int status = 0;
+    std::string headers;
+    std::string body;
+};
+
+// Next response on fd (headers plus Content-Length body); status 0 if none
+Response readResponse(int fd, std::string& buffered) {
+    Response response;
+    size_t headerEnd;
+    while ((headerEnd = buffered.find("\r\n\r\n")) == std::string::npos) {
+        if (!receive(fd, buffered)) return response;
+    }
+    response.headers = buffered.substr(0, headerEnd + 4);
+    size_t lengthAt = response.headers.find("Content-Length: ");
+    size_t length = lengthAt != std::string::npos ? std::strtoul(response.headers.c_str() + lengthAt + 16, nullptr, 10) : 0;
+    while (buffered.size() < headerEnd + 4 + length) {
+        if (!receive(fd, buffered)) return response;
+    }
+    response.body = buffered.substr(headerEnd + 4, length);
+    buffered.erase(0, headerEnd + 4 + length);
+    response.status = std::atoi(response.headers.c_str() + 9);
+    return response;
+}
+
+// Whether the server closes fd without sending anything more
+bool closedByServer(int fd, std::string& buffered) {
+    size_t before = buffered.size();
+    while (receive(fd, buffered)) {
+    }
+    return buffered.size() == before;
+}
+
+std::string get(const std::string& target, const char* extraHeaders = "") {
+    return "GET " + target + " HTTP/1.1\r\nHost: test\r\n" + extraHeaders + "\r\n";
+}
+
+int status(const std::string& target) {
+    int fd = connectTo(socketPath());
+    if (fd < 0) return -1;
+    std::string buffered;
+    sendAll(fd, get(target, "Connection: close\r\n"));
+    int code = readResponse(fd, buffered).status;
+    ::close(fd);
+    return code;
+}
+
+bool contains(const std::string& text, const std::string& part) {
+    return text.find(part) != std::string::npos;
+}
+
+} // namespace
+
+TEST(endpoints_answer_with_json) {
+    REQUIRE(startServer());
+    int fd = connectTo(socketPath());
+    REQUIRE(fd >= 0);
+    std::string buffered;
+
+    sendAll(fd, get("/api/sources"));
+    Response sources = readResponse(fd, buffered);
+    CHECK_EQ(sources.status, 200);
+    CHECK_EQ(sources.body, "{\"sources\":[\"bed-1\"]}");
+
+    sendAll(fd, get("/api/latest?source=bed-1"));
+    Response latest = readResponse(fd, buffered);
+    CHECK_EQ(latest.status, 200);
+    CHECK(contains(latest.body, "\"hr\":{\"time_ms\":" + std::to_string(kStartMs + 119000) + ",\"value\":79}"));
+    CHECK(contains(latest.body, "\"spo2\":null"));
+
+    std::string range = "/api/range?source=bed-1&field=hr&from=" + std::to_string(kStartMs) +
+                        "&to=" + std::to_string(kStartMs + 9000);
+    sendAll(fd, get(range));
+    Response points = readResponse(fd, buffered);
+    CHECK_EQ(points.status, 200);
+    CHECK(contains(points.body, "\"resolution\":\"raw\""));
+    CHECK(contains(points.body, "[" + std::to_string(kStartMs) + ",70,70,70,1]"));
+
+    // The documented rollup example uses the resolution names the store reports
+    std::string rollup = "/api/rollup?source=bed-1&field=hr&resolution=1m&from=" + std::to_string(kStartMs) +
+                         "&to=" + std::to_string(kStartMs + 119000);
+    sendAll(fd, get(rollup));
+    Response minutes = readResponse(fd, buffered);
+    CHECK_EQ(minutes.status, 200);
+    CHECK(contains(minutes.body, "\"resolution\":\"1m\""));
+    ::close(fd);
+
+    CHECK_EQ(status("/api/latest?source=bed-9"), 404);
+    CHECK_EQ(status("/api/nothing"), 404);
+    CHECK_EQ(status("/api/rollup?source=bed-1&field=hr&resolution=minute"), 400);
+    CHECK_EQ(status("/api/range?source=bed-1&field=pulse"), 400);
+    QueryServer::getInstance().stop();
+}
+
+TEST(pipelined_requests_are_answered_in_order) {
+    REQUIRE(startServer());
+    int fd = connectTo(socketPath());
+    REQUIRE(fd >= 0);
+    std::string buffered;
+
+    // Three requests in one write; the last asks to close
+    sendAll(fd, get("/api/latest?source=bed-1") + get("/api/latest?source=bed-9") +
+                get("/api/sources", "Connection: close\r\n"));
+    Response first = readResponse(fd, buffered);
+    Response second = readResponse(fd, buffered);
+    Response third = readResponse(fd, buffered);
+    CHECK_EQ(first.status, 200);
+    CHECK(contains(first.headers, "Connection: keep-alive"));
+    CHECK_EQ(second.status, 404);
+    CHECK_EQ(third.status, 200);
+    CHECK(contains(third.body, "sources"));
+    CHECK(contains(third.headers, "Connection: close"));
+    CHECK(closedByServer(fd, buffered));
+    ::close(fd);
+    QueryServer::getInstance().stop();
+}
+
+TEST(connection_persistence_follows_the_http_version) {
+    REQUIRE(startServer());
+    std::string buffered;
+
+    // HTTP/1.1 stays open for a second request on the same connection
+    int fd = connectTo(socketPath());
+    REQUIRE(fd >= 0);
+    sendAll(fd, get("/health"));
+    CHECK_EQ(readResponse(fd, buffered).status, 200);
+    sendAll(fd, get("/health"));
+    CHECK_EQ(readResponse(fd, buffered).status, 200);
+    ::close(fd);
+
+    // HTTP/1.0 closes unless it asks for keep-alive
+    fd = connectTo(socketPath());
+    REQUIRE(fd >= 0);
+    sendAll(fd, "GET /health HTTP/1.0\r\n\r\n");
+    Response once = readResponse(fd, buffered);
+    CHECK_EQ(once.status, 200);
+    CHECK(contains(once.headers, "Connection: close"));
+    CHECK(closedByServer(fd, buffered));
+    ::close(fd);
+
+    fd = connectTo(socketPath());
+    REQUIRE(fd >= 0);
+    sendAll(fd, "GET /health HTTP/1.0\r\nConnection: keep-alive\r\n\r\n");
+    CHECK(contains(readResponse(fd, buffered).headers, "Connection: keep-alive"));
+    sendAll(fd, "GET /health HTTP/1.0\r\nConnection: keep-alive\r\n\r\n");
+    CHECK_EQ(readResponse(fd, buffered).status, 200);
+    ::close(fd);
+
+    // A request with a body is answered, then the unread body ends the connection
+    fd = connectTo(socketPath());
+    REQUIRE(fd >= 0);
+    sendAll(fd, "POST /api/sources HTTP/1.1\r\nContent-Length: 2\r\n\r\n{}");
+    Response post = readResponse(fd, buffered);
+    CHECK_EQ(post.status, 405);
+    CHECK(contains(post.headers, "Connection: close"));
+    CHECK(closedByServer(fd, buffered));
+    ::close(fd);
+    QueryServer::getInstance().stop();
+}
+
+TEST(malformed_and_oversized_requests_close_the_connection) {
+    REQUIRE(startServer());
+    std::string buffered;
+
+    int fd = connectTo(socketPath());
+    REQUIRE(fd >= 0);
+    sendAll(fd, "GARBAGE\r\n\r\n");
+    CHECK(closedByServer(fd, buffered));
+    CHECK(buffered.empty());
+    ::close(fd);
+
+    // Headers that never end within the request buffer
+    fd = connectTo(socketPath());
+    REQUIRE(fd >= 0);
+    sendAll(fd, "GET /health HTTP/1.1\r\nX-Padding: " + std::string(8192, 'a'));
+    Response tooLarge = readResponse(fd, buffered);
+    CHECK_EQ(tooLarge.status, 431);
+    CHECK(closedByServer(fd, buffered));
+    ::close(fd);
+
+    // The server still serves new connections
+    CHECK_EQ(status("/health"), 200);
+    QueryServer::getInstance().stop();
+}
+
+TEST(out_of_range_times_are_rejected) {
+    REQUIRE(startServer());
+    const std::string base = "/api/range?source=bed-1&field=hr";
+    CHECK_EQ(status(base + "&from=9223372036854775807"), 400);                 // * 1000 overflows
+    CHECK_EQ(status(base + "&to=-9223372036854775807"), 400);
+    CHECK_EQ(status(base + "&from=99999999999999999999"), 400);                // Not an int64
+    CHECK_EQ(status(base + "&last=9223372036855"), 400);                       // * 1000000 overflows
+    CHECK_EQ(status(base + "&to=-9223372036854775&last=1"), 400);              // to - last overflows
+    CHECK_EQ(status(base + "&last=0"), 400);
+    CHECK_EQ(status(base + "&from=2000&to=1000"), 400);
+    CHECK_EQ(status(base + "&from=12abc"), 400);
+    CHECK_EQ(status(base + "&max_points=0"), 400);
+    CHECK_EQ(status(base + "&from=" + std::to_string(kStartMs) + "&to=" + std::to_string(kStartMs + 1000)), 200);
+    CHECK_EQ(status(base + "&last=60"), 200);
+    QueryServer::getInstance().stop();
+}
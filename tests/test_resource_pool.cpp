@@ -0,0 +1,108 @@
+#include "Test.h"
+#include "../src/pipeline/TaskExecutor.h"
+#include "../src/utils/ResourcePool.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TEST(try_acquire_grants_queued_requests_in_order) {
+    ResourcePool<int> pool;
+    pool.add(std::unique_ptr<int>(new int(7)));
+
+    ResourcePool<int>::Lease first;
+    REQUIRE(pool.tryAcquire(first, [](ResourcePool<int>::Lease) {}));
+    REQUIRE(first);
+    CHECK_EQ(*first, 7);
+
+    std::vector<int> order;
+    std::vector<ResourcePool<int>::Lease> granted;
+    granted.reserve(3);
+    for (int i = 0; i < 3; i++) {
+        ResourcePool<int>::Lease lease;
+        CHECK(!pool.tryAcquire(lease, [&, i](ResourcePool<int>::Lease l) {
+            order.push_back(i);
+            granted.push_back(std::move(l));
+        }));
+        CHECK(!lease);
+    }
+    CHECK_EQ(pool.waiting(), 3u);
+
+    // Each release hands the object straight to the oldest request
+    first.reset();
+    REQUIRE(order.size() == 1u);
+    CHECK_EQ(order[0], 0);
+    CHECK(static_cast<bool>(granted[0]));
+    granted[0].reset();
+    granted[1].reset();
+    REQUIRE(order.size() == 3u);
+    CHECK_EQ(order[1], 1);
+    CHECK_EQ(order[2], 2);
+    CHECK_EQ(pool.waiting(), 0u);
+
+    // Free again once the last holder lets go
+    granted[2].reset();
+    ResourcePool<int>::Lease again;
+    CHECK(pool.tryAcquire(again, [](ResourcePool<int>::Lease) {}));
+    CHECK(static_cast<bool>(again));
+}
+
+TEST(close_hands_queued_requests_empty_leases) {
+    ResourcePool<int> pool;
+    pool.add(std::unique_ptr<int>(new int(1)));
+    ResourcePool<int>::Lease held;
+    REQUIRE(pool.tryAcquire(held, [](ResourcePool<int>::Lease) {}));
+
+    int emptyGrants = 0;
+    ResourcePool<int>::Lease lease;
+    CHECK(!pool.tryAcquire(lease, [&](ResourcePool<int>::Lease l) { emptyGrants += l ? 0 : 1; }));
+    pool.close();
+    CHECK_EQ(emptyGrants, 1);
+    CHECK(pool.tryAcquire(lease, [](ResourcePool<int>::Lease) {}));
+    CHECK(!lease);
+}
+
+TEST(executor_tasks_share_an_engine_without_blocking) {
+    // Two workers, one engine, many tasks: parked tasks are resubmitted with
+    // the engine and every task runs exactly once
+    ResourcePool<int> pool;
+    pool.add(std::unique_ptr<int>(new int(0)));
+    TaskExecutor executor("test");
+    executor.start(2);
+
+    constexpr int kTasks = 2000;
+    std::atomic<int> inUse{0};
+    std::atomic<int> overlap{0};
+    std::atomic<int> done{0};
+    std::function<void(ResourcePool<int>::Lease&)> work = [&](ResourcePool<int>::Lease& lease) {
+        if (inUse.fetch_add(1) != 0) {
+            overlap++;
+        }
+        (*lease)++;
+        inUse--;
+        lease.reset();
+        done++;
+    };
+    for (int i = 0; i < kTasks; i++) {
+        executor.submit([&]() {
+            ResourcePool<int>::Lease lease;
+            bool ready = pool.tryAcquire(lease, [&](ResourcePool<int>::Lease granted) {
+                std::shared_ptr<ResourcePool<int>::Lease> held =
+                    std::make_shared<ResourcePool<int>::Lease>(std::move(granted));
+                executor.submit([&, held]() { work(*held); });
+            });
+            if (ready) {
+                work(lease);
+            }
+        });
+    }
+    executor.stop();
+    CHECK_EQ(done.load(), kTasks);
+    CHECK_EQ(overlap.load(), 0);
+    CHECK_EQ(executor.pending(), 0u);
+    ResourcePool<int>::Lease lease;
+    REQUIRE(pool.tryAcquire(lease, [](ResourcePool<int>::Lease) {}));
+    CHECK_EQ(*lease, kTasks);
+}
@@ -0,0 +1,161 @@
+#include "Test.h"
+#include "../src/output/ShmPublisher.h"
+#include "../src/output/ShmReader.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+std::string segmentName() {
+    return "/vitalsign_test_shm_" + std::to_string(getpid());
+}
+
+// Publish HR = record number, so torn or misplaced records are visible
+void publish(uint64_t count, uint64_t& published) {
+    ShmPublisher& publisher = ShmPublisher::getInstance();
+    for (uint64_t i = 0; i < count; i++) {
+        VitalSample sample;
+        sample.hr = static_cast<int>(published++);
+        publisher.publish("bed-1", std::chrono::system_clock::now(), sample, "", 0.0f);
+    }
+}
+
+// Records received and whether each one was the one it claimed to be
+struct Tally {
+    uint64_t received = 0;
+    bool ordered = true;
+    bool intact = true;
+    int64_t lastSequence = -1;
+
+    void add(const ShmRecord& record) {
+        received++;
+        ordered = ordered && static_cast<int64_t>(record.sequence) > lastSequence;
+        intact = intact && record.vitals.hr == static_cast<int32_t>(record.sequence);
+        lastSequence = static_cast<int64_t>(record.sequence);
+    }
+};
+
+ShmReader::Result drain(ShmReader& reader, Tally& tally) {
+    ShmRecord record;
+    ShmReader::Result result;
+    while ((result = reader.next(record)) == ShmReader::Result::Record) {
+        tally.add(record);
+    }
+    return result;
+}
+
+} // namespace
+
+TEST(lagging_reader_counts_what_it_lost) {
+    ShmPublisher& publisher = ShmPublisher::getInstance();
+    REQUIRE(publisher.init(segmentName(), 8));
+    ShmReader reader;
+    REQUIRE(reader.open(segmentName()));
+    CHECK_EQ(reader.capacity(), 8u);
+
+    uint64_t published = 0;
+    publish(20, published);
+    Tally tally;
+    CHECK(drain(reader, tally) == ShmReader::Result::Empty);
+    CHECK_EQ(tally.received, 8u);                   // Only the last lap survives
+    CHECK_EQ(reader.lost(), 12u);
+    CHECK_EQ(tally.lastSequence, 19);
+
+    publish(3, published);
+    CHECK(drain(reader, tally) == ShmReader::Result::Empty);
+    CHECK_EQ(tally.received + reader.lost(), published);
+    CHECK(tally.ordered);
+    CHECK(tally.intact);
+    publisher.close();
+}
+
+TEST(concurrent_reader_sees_every_record_or_counts_it_lost) {
+    ShmPublisher& publisher = ShmPublisher::getInstance();
+    REQUIRE(publisher.init(segmentName(), 64));
+    ShmReader reader;
+    REQUIRE(reader.open(segmentName()));
+
+    const uint64_t kRecords = 200000;
+    std::atomic<bool> done{false};
+    std::thread producer([&]() {
+        uint64_t published = 0;
+        while (published < kRecords) {
+            publish(1000, published);
+            std::this_thread::yield();
+        }
+        done = true;
+    });
+
+    // Read in bursts with pauses so the producer laps the reader now and then
+    Tally tally;
+    ShmRecord record;
+    while (!done.load()) {
+        for (int i = 0; i < 200 && reader.next(record) == ShmReader::Result::Record; i++) {
+            tally.add(record);
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    producer.join();
+    publisher.close();
+
+    CHECK(drain(reader, tally) == ShmReader::Result::Closed);
+    CHECK_EQ(tally.received + reader.lost(), kRecords);
+    CHECK_EQ(tally.lastSequence, static_cast<int64_t>(kRecords - 1));
+    CHECK(tally.ordered);
+    CHECK(tally.intact);
+}
+
+TEST(latest_and_oldest_reads) {
+    ShmPublisher& publisher = ShmPublisher::getInstance();
+    REQUIRE(publisher.init(segmentName(), 4));
+    ShmReader reader;
+    REQUIRE(reader.open(segmentName()));
+    ShmRecord record;
+    CHECK(!reader.latest(record));
+
+    uint64_t published = 0;
+    publish(6, published);
+    REQUIRE(reader.latest(record));
+    CHECK_EQ(record.sequence, 5u);
+    CHECK_EQ(record.vitals.hr, 5);
+
+    // A reader opened now starts at the next record, or at the oldest kept one
+    ShmReader next;
+    ShmReader oldest;
+    REQUIRE(next.open(segmentName()));
+    REQUIRE(oldest.open(segmentName(), true));
+    CHECK(next.next(record) == ShmReader::Result::Empty);
+    REQUIRE(oldest.next(record) == ShmReader::Result::Record);
+    CHECK_EQ(record.sequence, 2u);
+    CHECK_EQ(oldest.lost(), 0u);
+    publisher.close();
+}
+
+TEST(closed_after_the_producer_shuts_down) {
+    ShmPublisher& publisher = ShmPublisher::getInstance();
+    REQUIRE(publisher.init(segmentName(), 8));
+    ShmReader caughtUp;
+    ShmReader behind;
+    REQUIRE(caughtUp.open(segmentName()));
+    REQUIRE(behind.open(segmentName()));
+
+    uint64_t published = 0;
+    publish(3, published);
+    Tally tally;
+    CHECK(drain(caughtUp, tally) == ShmReader::Result::Empty);
+    publisher.close();
+
+    // Records published before close() are still delivered, then Closed
+    ShmRecord record;
+    CHECK(caughtUp.next(record) == ShmReader::Result::Closed);
+    Tally rest;
+    CHECK(drain(behind, rest) == ShmReader::Result::Closed);
+    CHECK_EQ(rest.received, 3u);
+
+    // The name is gone once the producer has closed
+    ShmReader late;
+    CHECK(!late.open(segmentName()));
+}
@@ -0,0 +1,210 @@
+#include "Test.h"
+#include "../src/database/SqliteBackend.h"
+#include "../src/utils/TimestampFormatter.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+// Fixed zone with DST so local-time conversion is actually exercised
+struct ZoneFixture {
+    ZoneFixture() {
+        setenv("TZ", "America/New_York", 1);
+        tzset();
+    }
+};
+ZoneFixture zone;
+
+std::string tempDatabase() {
+    char path[] = "/tmp/vitalsign_test_XXXXXX";
+    int fd = mkstemp(path);
+    close(fd);
+    unlink(path);
+    return path;
+}
+
+// Rows one second apart starting at 2024-03-10 01:59:58 local, across the DST jump
+TimestampFormatter::Clock::time_point rowTime(int i) {
+    std::tm tm = {};
+    tm.tm_year = 2024 - 1900;
+    tm.tm_mon = 2;
+    tm.tm_mday = 10;
+    tm.tm_hour = 1;
+    tm.tm_min = 59;
+    tm.tm_sec = 58;
+    tm.tm_isdst = -1;
+    return TimestampFormatter::Clock::from_time_t(std::mktime(&tm) + i);
+}
+
+bool insertRows(SqliteBackend& db, int count) {
+    for (int i = 0; i < count; i++) {
+        VitalSignData data;
+        data.timestamp = TimestampFormatter::seconds(rowTime(i));
+        data.hr = std::to_string(60 + i);
+        data.spo2 = "98";
+        data.abp = "120/80";
+        data.ecg_classification = "N";
+        data.ecg_confidence = 0.9f;
+        data.source_id = i % 2 == 0 ? "bed1" : "";
+        if (!db.insertVitalSign(data)) {
+            return false;
+        }
+    }
+    return db.flush();
+}
+
+} // namespace
+
+TEST(parse_local_round_trips_formatted_time) {
+    auto now = std::chrono::time_point_cast<std::chrono::seconds>(TimestampFormatter::Clock::now());
+    int64_t us = 0;
+    REQUIRE(TimestampFormatter::parseLocal(TimestampFormatter::seconds(now).c_str(), us));
+    CHECK_EQ(us, TimestampFormatter::toEpochMicros(now));
+
+    REQUIRE(TimestampFormatter::parseLocal("2024-01-15 12:00:00.250000", us));
+    int64_t whole = 0;
+    REQUIRE(TimestampFormatter::parseLocal("2024-01-15 12:00:00", whole));
+    CHECK_EQ(us - whole, 250000);
+    // EST is UTC-5 in January
+    CHECK_EQ(whole, int64_t(1705338000) * 1000000);
+}
+
+TEST(parse_local_rejects_malformed_text) {
+    int64_t us = 0;
+    CHECK(!TimestampFormatter::parseLocal("", us));
+    CHECK(!TimestampFormatter::parseLocal("2024-01-15", us));
+    CHECK(!TimestampFormatter::parseLocal("2024-01-15 12:00:00x", us));
+    CHECK(!TimestampFormatter::parseLocal("2024-13-15 12:00:00", us));
+}
+
+TEST(stream_returns_rows_in_order_across_batches) {
+    std::string path = tempDatabase();
+    SqliteBackend db(path, 4, 1000);
+    REQUIRE(db.connect());
+    REQUIRE(db.createTables());
+    REQUIRE(insertRows(db, 10));
+
+    std::vector<int64_t> times;
+    std::vector<std::string> hrs;
+    int64_t delivered = db.streamVitalSigns(
+        TimestampFormatter::seconds(rowTime(0)), TimestampFormatter::seconds(rowTime(10)),
+        [&](const VitalSignRow& row) {
+            times.push_back(row.timestamp_us);
+            hrs.push_back(row.hr);
+            return true;
+        },
+        3);
+    CHECK_EQ(delivered, 10);
+    REQUIRE(times.size() == 10u);
+    for (int i = 0; i < 10; i++) {
+        CHECK_EQ(times[i], TimestampFormatter::toEpochMicros(rowTime(i)));
+        CHECK_EQ(hrs[i], std::to_string(60 + i));
+    }
+    db.disconnect();
+    unlink(path.c_str());
+}
+
+TEST(stream_stops_when_callback_returns_false) {
+    std::string path = tempDatabase();
+    SqliteBackend db(path, 1, 1000);
+    REQUIRE(db.connect());
+    REQUIRE(db.createTables());
+    REQUIRE(insertRows(db, 6));
+
+    int seen = 0;
+    int64_t delivered = db.streamVitalSigns(
+        TimestampFormatter::seconds(rowTime(0)), TimestampFormatter::seconds(rowTime(6)),
+        [&](const VitalSignRow&) { return ++seen < 4; }, 2);
+    CHECK_EQ(delivered, 4);
+    CHECK_EQ(seen, 4);
+    db.disconnect();
+    unlink(path.c_str());
+}
+
+TEST(stream_callback_may_use_the_backend) {
+    std::string path = tempDatabase();
+    SqliteBackend db(path, 1, 1000);
+    REQUIRE(db.connect());
+    REQUIRE(db.createTables());
+    REQUIRE(insertRows(db, 4));
+
+    // Copying rows out of range from inside the callback must not deadlock
+    int64_t delivered = db.streamVitalSigns(
+        TimestampFormatter::seconds(rowTime(0)), TimestampFormatter::seconds(rowTime(4)),
+        [&](const VitalSignRow& row) {
+            VitalSignData copy;
+            copy.timestamp = "2030-01-01 00:00:00";
+            copy.hr = row.hr;
+            copy.spo2 = row.spo2;
+            copy.abp = row.abp;
+            copy.ecg_classification = row.ecg_classification;
+            copy.ecg_confidence = row.ecg_confidence;
+            return db.insertVitalSign(copy);
+        },
+        2);
+    CHECK_EQ(delivered, 4);
+    CHECK_EQ(db.getRecentVitalSigns(100).size(), 8u);
+    db.disconnect();
+    unlink(path.c_str());
+}
+
+namespace {
+
+// Rows visible to a separate connection, i.e. committed
+int committedRows(const std::string& path) {
+    sqlite3* db = nullptr;
+    int count = -1;
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) == SQLITE_OK &&
+        sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM vital_signs;", -1, &stmt, nullptr) == SQLITE_OK &&
+        sqlite3_step(stmt) == SQLITE_ROW) {
+        count = sqlite3_column_int(stmt, 0);
+    }
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return count;
+}
+
+} // namespace
+
+TEST(idle_batch_commits_after_flush_interval) {
+    std::string path = tempDatabase();
+    SqliteBackend db(path, 50, 50);
+    REQUIRE(db.connect());
+    REQUIRE(db.createTables());
+
+    VitalSignData data;
+    data.timestamp = "2024-01-15 12:00:00";
+    data.hr = "70";
+    REQUIRE(db.insertVitalSign(data));
+    CHECK_EQ(committedRows(path), 0);
+
+    // No further inserts: the flusher must commit on its own
+    int committed = 0;
+    for (int i = 0; i < 100 && committed == 0; i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        committed = committedRows(path);
+    }
+    CHECK_EQ(committed, 1);
+    db.disconnect();
+    unlink(path.c_str());
+}
+
+TEST(destructor_commits_open_batch) {
+    std::string path = tempDatabase();
+    {
+        SqliteBackend db(path, 50, 60000);
+        REQUIRE(db.connect());
+        REQUIRE(db.createTables());
+        VitalSignData data;
+        data.timestamp = "2024-01-15 12:00:00";
+        REQUIRE(db.insertVitalSign(data));
+        REQUIRE(db.insertVitalSign(data));
+    }
+    CHECK_EQ(committedRows(path), 2);
+    unlink(path.c_str());
+}
@@ -0,0 +1,46 @@
+#include "Test.h"
+#include "../src/utils/StartupPlan.h"
+
+#include <atomic>
+
+TEST(phases_run_after_their_dependencies) {
+    for (bool parallel : {false, true}) {
+        StartupPlan plan;
+        std::atomic<int> order{0};
+        int configRan = -1;
+        int cameraRan = -1;
+        int warmupRan = -1;
+        CHECK(plan.add("config", [&]() { configRan = order++; return true; }));
+        CHECK(plan.add("camera", [&]() { cameraRan = order++; return true; }, {"config"}));
+        CHECK(plan.add("warmup", [&]() { warmupRan = order++; return true; }, {"camera", "config"}));
+        plan.start(parallel);
+        CHECK(plan.wait());
+        CHECK(configRan < cameraRan);
+        CHECK(cameraRan < warmupRan);
+        CHECK(plan.succeeded("warmup"));
+    }
+}
+
+TEST(failed_dependency_skips_the_phase) {
+    StartupPlan plan;
+    bool ran = false;
+    plan.add("camera", []() { return false; });
+    plan.add("warmup", [&]() { ran = true; return true; }, {"camera"});
+    plan.add("database", []() { return true; });
+    plan.start(true);
+    CHECK(!plan.wait());
+    CHECK(!ran);
+    CHECK(!plan.succeeded("warmup"));
+    CHECK(plan.succeeded("database"));
+}
+
+TEST(unknown_dependency_refuses_to_run) {
+    StartupPlan plan;
+    bool ran = false;
+    CHECK(plan.add("camera", [&]() { ran = true; return true; }));
+    CHECK(!plan.add("warmup", [&]() { ran = true; return true; }, {"camrea"}));
+    plan.start(true);
+    CHECK(!plan.wait());
+    CHECK(!ran);
+    CHECK(!plan.succeeded("camera"));
+}
@@ -0,0 +1,168 @@
+#include "Test.h"
+#include "../src/ocr/TemporalFusion.h"
+
+#include <algorithm>
+#include <deque>
+#include <cmath>
+#include <random>
+
+namespace {
+
+std::map<std::string, OcrReading> reads(const std::string& hr, float confidence = 90.0f,
+                                        const std::string& spo2 = "0", const std::string& abp = "0") {
+    std::map<std::string, OcrReading> out;
+    out["HR"] = OcrReading{hr, confidence};
+    out["SpO2"] = OcrReading{spo2, confidence};
+    out["ABP"] = OcrReading{abp, confidence};
+    return out;
+}
+
+ConfigSnapshot config(int window, int tolerance = 2) {
+    ConfigSnapshot cfg;
+    cfg.fusion.window = window;
+    cfg.fusion.tolerance = tolerance;
+    cfg.vitalSigns.spo2HistorySize = window;
+    return cfg;
+}
+
+} // namespace
+
+TEST(sliding_median_matches_sorting_the_window) {
+    std::mt19937 rng(3);
+    for (size_t window : {1u, 2u, 5u, 8u}) {
+        SlidingMedian median(window);
+        std::deque<int> recent;
+        for (int i = 0; i < 2000; i++) {
+            int value = static_cast<int>(rng() % 12) - 2;   // Some misses (< 0), many repeats
+            median.push(value);
+            recent.push_back(value);
+            if (recent.size() > window) {
+                recent.pop_front();
+            }
+            std::vector<int> valid;
+            for (int v : recent) {
+                if (v >= 0) valid.push_back(v);
+            }
+            REQUIRE(median.empty() == valid.empty());
+            if (!valid.empty()) {
+                std::sort(valid.begin(), valid.end());
+                REQUIRE(median.median() == valid[(valid.size() - 1) / 2]);
+            }
+        }
+    }
+}
+
+TEST(majority_value_wins_over_a_misread) {
+    TemporalFusion fusion;
+    ConfigSnapshot cfg = config(5);
+    FusedVitals fused;
+    for (const char* hr : {"72", "72", "12", "72", "78"}) {
+        fused = fusion.update(reads(hr), cfg);
+    }
+    // "12" is outside the HR range and never enters the window
+    CHECK_EQ(fused.hr.value, 72);
+    CHECK_EQ(fused.hrText(), "72");
+}
+
+TEST(median_is_used_without_a_majority) {
+    TemporalFusion fusion;
+    ConfigSnapshot cfg = config(5, 0);
+    FusedVitals fused;
+    for (const char* hr : {"70", "80", "90", "100", "110"}) {
+        fused = fusion.update(reads(hr), cfg);
+    }
+    CHECK_EQ(fused.hr.value, 90);
+    CHECK_NEAR(fused.hr.stability, 0.2f, 1e-4f);
+}
+
+TEST(stability_counts_reads_within_tolerance) {
+    TemporalFusion fusion;
+    ConfigSnapshot cfg = config(4, 2);
+    FusedVitals fused;
+    for (const char* hr : {"80", "80", "81", "95"}) {
+        fused = fusion.update(reads(hr), cfg);
+    }
+    CHECK_EQ(fused.hr.value, 80);
+    CHECK_NEAR(fused.hr.stability, 0.75f, 1e-4f);
+}
+
+TEST(field_empties_after_a_window_of_misses) {
+    TemporalFusion fusion;
+    ConfigSnapshot cfg = config(3);
+    FusedVitals fused = fusion.update(reads("75"), cfg);
+    CHECK_EQ(fused.hr.value, 75);
+    fused = fusion.update(reads("0"), cfg);
+    fused = fusion.update(reads("0"), cfg);
+    CHECK_EQ(fused.hr.value, 75);
+    fused = fusion.update(reads("0"), cfg);
+    CHECK_EQ(fused.hr.value, -1);
+    CHECK_EQ(fused.hrText(), "0");
+}
+
+TEST(abp_halves_are_fused_independently) {
+    TemporalFusion fusion;
+    ConfigSnapshot cfg = config(3);
+    fusion.update(reads("0", 90.0f, "0", "120/80"), cfg);
+    fusion.update(reads("0", 90.0f, "0", "120/300"), cfg);
+    FusedVitals fused = fusion.update(reads("0", 90.0f, "0", "garbage"), cfg);
+    CHECK_EQ(fused.abpText(), "120/80");
+}
+
+TEST(slashed_reads_are_not_hr_or_spo2) {
+    TemporalFusion fusion;
+    ConfigSnapshot cfg = config(3);
+    FusedVitals fused;
+    for (int i = 0; i < 3; i++) {
+        fused = fusion.update(reads("120/80", 90.0f, "120/80", "120/80"), cfg);
+    }
+    CHECK_EQ(fused.hr.value, -1);
+    CHECK_EQ(fused.spo2.value, -1);
+    CHECK_EQ(fused.abpText(), "120/80");
+}
+
+TEST(running_mode_matches_a_full_scan) {
+    // Reference: weight per value over the window, heaviest (lowest on ties)
+    // wins when it holds half the weight, otherwise the lower median
+    std::mt19937 rng(11);
+    const size_t window = 7;
+    TemporalFusion fusion;
+    ConfigSnapshot cfg = config(static_cast<int>(window), 0);
+    std::deque<std::pair<int, float>> recent;
+    for (int i = 0; i < 3000; i++) {
+        int hr = 60 + static_cast<int>(rng() % 5);
+        float confidence = static_cast<float>(20 + rng() % 80);
+        if (rng() % 6 == 0) {
+            hr = 0;     // Missed read
+        }
+        FusedVitals fused = fusion.update(reads(std::to_string(hr), confidence), cfg);
+        recent.push_back({hr > 0 ? hr : -1, confidence / 100.0f});
+        if (recent.size() > window) {
+            recent.pop_front();
+        }
+
+        std::map<int, float> votes;
+        std::vector<int> valid;
+        float total = 0.0f;
+        for (const auto& r : recent) {
+            if (r.first >= 0) {
+                votes[r.first] += r.second;
+                total += r.second;
+                valid.push_back(r.first);
+            }
+        }
+        int expected = -1;
+        if (!votes.empty()) {
+            auto best = std::max_element(votes.begin(), votes.end(),
+                [](const std::pair<const int, float>& a, const std::pair<const int, float>& b) {
+                    return a.second < b.second;
+                });
+            std::sort(valid.begin(), valid.end());
+            // Weights are summed in a different order, so skip exact ties
+            if (std::abs(best->second * 2.0f - total) < 1e-4f) {
+                continue;
+            }
+            expected = best->second * 2.0f >= total ? best->first : valid[(valid.size() - 1) / 2];
+        }
+        REQUIRE(fused.hr.value == expected);
+    }
+}
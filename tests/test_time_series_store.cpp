@@ -0,0 +1,148 @@
+#include "Test.h"
+#include "../src/timeseries/TimeSeriesStore.h"
+
+namespace {
+
+const int64_t kStartUs = 1789999200LL * 1000000;    // On an hour boundary
+
+// Fresh store with one source ("") and HR samples 60, 61, ... every stepUs
+TimeSeriesStore& fill(const TsCapacity& capacity, int samples, int64_t stepUs) {
+    TimeSeriesStore& store = TimeSeriesStore::getInstance();
+    store.init({""}, capacity);
+    for (int i = 0; i < samples; i++) {
+        VitalSample sample;
+        sample.hr = 60 + i;
+        auto time = std::chrono::system_clock::time_point(std::chrono::microseconds(kStartUs + i * stepUs));
+        store.append("", time, sample);
+    }
+    return store;
+}
+
+TsCapacity capacity(size_t raw, size_t seconds, size_t minutes, size_t hours) {
+    TsCapacity c;
+    c.raw = raw;
+    c.seconds = seconds;
+    c.minutes = minutes;
+    c.hours = hours;
+    return c;
+}
+
+} // namespace
+
+TEST(range_uses_raw_samples_when_they_fit) {
+    TimeSeriesStore& store = fill(capacity(100, 100, 100, 100), 50, 1000000);
+    std::vector<TsPoint> out;
+    TsResolution used = TsResolution::Count;
+    REQUIRE(store.query("", VitalField::Hr, kStartUs, kStartUs + 60000000, 100, out, &used));
+    CHECK(used == TsResolution::Raw);
+    CHECK_EQ(out.size(), 50u);
+    CHECK_EQ(out.front().timeUs, kStartUs);
+    CHECK_NEAR(out.back().mean, 109.0f, 1e-6);
+}
+
+TEST(range_skips_a_level_that_no_longer_holds_the_start) {
+    // Raw keeps only the last 10 samples; seconds still hold all 100
+    TimeSeriesStore& store = fill(capacity(10, 1000, 100, 100), 100, 1000000);
+    std::vector<TsPoint> out;
+    TsResolution used = TsResolution::Count;
+    REQUIRE(store.query("", VitalField::Hr, kStartUs, kStartUs + 100000000, 1000, out, &used));
+    CHECK(used == TsResolution::Second);
+    CHECK_EQ(out.size(), 100u);
+    CHECK_EQ(out.front().timeUs, kStartUs);
+}
+
+TEST(range_moves_to_a_coarser_level_to_fit_the_budget) {
+    TimeSeriesStore& store = fill(capacity(1000, 1000, 100, 100), 300, 1000000);
+    std::vector<TsPoint> out;
+    TsResolution used = TsResolution::Count;
+    REQUIRE(store.query("", VitalField::Hr, kStartUs, kStartUs + 300000000, 10, out, &used));
+    uint32_t total = 0;
+    for (const TsPoint& p : out) total += p.count;
+    CHECK(used == TsResolution::Minute);
+    CHECK_EQ(out.size(), 5u);
+    CHECK_EQ(total, 300u);
+}
+
+TEST(range_merges_the_coarsest_covering_level_down) {
+    // Three hours every 10 s: only the 1 s level still holds the start, with
+    // more points than the budget
+    TimeSeriesStore& store = fill(capacity(10, 2000, 2, 2), 1080, 10000000);
+    std::vector<TsPoint> out;
+    TsResolution used = TsResolution::Count;
+    REQUIRE(store.query("", VitalField::Hr, kStartUs, kStartUs + 10800000000LL, 20, out, &used));
+    uint32_t total = 0;
+    for (const TsPoint& p : out) total += p.count;
+    CHECK(used == TsResolution::Second);
+    CHECK_EQ(out.size(), 20u);
+    CHECK_EQ(total, 1080u);
+    CHECK_EQ(out.front().timeUs, kStartUs);
+    CHECK_NEAR(out.front().min, 60.0f, 1e-6);
+    CHECK_NEAR(out.back().max, 1139.0f, 1e-6);
+}
+
+TEST(range_falls_back_to_the_level_reaching_furthest_back) {
+    // Every level has wrapped; the hourly ring still reaches back furthest
+    TimeSeriesStore& store = fill(capacity(4, 4, 4, 4), 20, 1800000000LL);
+    std::vector<TsPoint> out;
+    TsResolution used = TsResolution::Count;
+    REQUIRE(store.query("", VitalField::Hr, kStartUs, kStartUs + 36000000000LL, 1000, out, &used));
+    CHECK(used == TsResolution::Hour);
+    CHECK_EQ(out.size(), 4u);
+    CHECK_EQ(out.front().timeUs, kStartUs + 6 * 3600000000LL);
+}
+
+TEST(rollup_merges_instead_of_truncating) {
+    TimeSeriesStore& store = fill(capacity(1000, 1000, 100, 100), 100, 1000000);
+    std::vector<TsPoint> out;
+    REQUIRE(store.queryResolution("", VitalField::Hr, TsResolution::Second, kStartUs, kStartUs + 100000000,
+                                  10, out));
+    CHECK_EQ(out.size(), 10u);
+    CHECK_EQ(out.front().timeUs, kStartUs);
+    CHECK_EQ(out.front().count, 10u);
+    CHECK_NEAR(out.front().mean, 64.5f, 1e-6);
+    CHECK_NEAR(out.back().max, 159.0f, 1e-6);
+}
+
+TEST(query_fills_the_callers_buffer_in_place) {
+    TimeSeriesStore& store = fill(capacity(1000, 1000, 100, 100), 500, 1000000);
+    std::vector<TsPoint> out;
+    out.reserve(50);
+    const TsPoint* data = out.data();
+    bool same = true;
+    for (size_t budget : {50u, 20u, 7u}) {
+        REQUIRE(store.query("", VitalField::Hr, kStartUs, kStartUs + 500000000, budget, out));
+        REQUIRE(store.queryResolution("", VitalField::Hr, TsResolution::Raw, kStartUs, kStartUs + 500000000,
+                                      budget, out));
+        same = same && out.data() == data && out.size() <= budget;
+    }
+    CHECK(same);
+}
+
+TEST(unknown_source_and_empty_range) {
+    TimeSeriesStore& store = fill(capacity(10, 10, 10, 10), 5, 1000000);
+    std::vector<TsPoint> out;
+    bool unknown = store.query("bed-9", VitalField::Hr, kStartUs, kStartUs + 1, 10, out);
+    REQUIRE(store.query("", VitalField::SpO2, kStartUs, kStartUs + 10000000, 10, out));
+    CHECK(!unknown);
+    CHECK(out.empty());
+}
+
+TEST(sample_text_fields_parse_strictly) {
+    VitalSample sample = VitalSample::fromText("72", "98", "120/80");
+    CHECK_EQ(sample.hr, 72);
+    CHECK_EQ(sample.spo2, 98);
+    CHECK_EQ(sample.systolic, 120);
+    CHECK_EQ(sample.diastolic, 80);
+
+    // The ABP word read under the HR or SpO2 label is not a value for them
+    sample = VitalSample::fromText("120/80", "120/80", "12O/80");
+    CHECK_EQ(sample.hr, -1);
+    CHECK_EQ(sample.spo2, -1);
+    CHECK_EQ(sample.systolic, -1);
+    CHECK_EQ(sample.diastolic, 80);
+
+    sample = VitalSample::fromText("0", "", "0");
+    CHECK_EQ(sample.hr, -1);
+    CHECK_EQ(sample.spo2, -1);
+    CHECK_EQ(sample.systolic, -1);
+}
@@ -0,0 +1,134 @@
+// Export the compressed vitals archive to CSV.
+//
+// Usage: archive_export <archive dir> [--source ID] [--from "YYYY-MM-DD HH:MM:SS"]
+//                       [--to "YYYY-MM-DD HH:MM:SS"] [--stats]
+//
+// Rows go to stdout with the columns of the live CSV output (local time);
+// --from/--to are local time and inclusive. Without --source every source in
+// the archive is exported. --stats prints block and decode figures to stderr.
+
+#include "src/timeseries/ArchiveReader.h"
+#include "src/utils/TimestampFormatter.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace {
+
+bool parseLocalTime(const char* text, int64_t& ms) {
+    struct tm parts = {};
+    int consumed = 0;
+    if (sscanf(text, "%4d-%2d-%2d %2d:%2d:%2d%n", &parts.tm_year, &parts.tm_mon, &parts.tm_mday,
+               &parts.tm_hour, &parts.tm_min, &parts.tm_sec, &consumed) != 6 || text[consumed] != '\0') {
+        return false;
+    }
+    parts.tm_year -= 1900;
+    parts.tm_mon -= 1;
+    parts.tm_isdst = -1;
+    ms = static_cast<int64_t>(mktime(&parts)) * 1000;
+    return true;
+}
+
+// Same text as the extractor output: "0" for no reading
+void printValue(int value) {
+    printf("%d", value > 0 ? value : 0);
+}
+
+void usage() {
+    fprintf(stderr, "usage: archive_export <archive dir> [--source ID] [--from \"YYYY-MM-DD HH:MM:SS\"]\n"
+                    "                      [--to \"YYYY-MM-DD HH:MM:SS\"] [--stats]\n");
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        usage();
+        return 1;
+    }
+
+    std::string root = argv[1];
+    std::vector<std::string> sources;
+    int64_t fromMs = std::numeric_limits<int64_t>::min();
+    int64_t toMs = std::numeric_limits<int64_t>::max();
+    bool stats = false;
+    for (int i = 2; i < argc; i++) {
+        bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--source") == 0 && hasValue) {
+            sources.push_back(argv[++i]);
+        } else if (strcmp(argv[i], "--from") == 0 && hasValue) {
+            if (!parseLocalTime(argv[++i], fromMs)) {
+                fprintf(stderr, "bad --from time: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--to") == 0 && hasValue) {
+            if (!parseLocalTime(argv[++i], toMs)) {
+                fprintf(stderr, "bad --to time: %s\n", argv[i]);
+                return 1;
+            }
+            toMs += 999;    // Whole last second
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        } else {
+            usage();
+            return 1;
+        }
+    }
+
+    ArchiveReader reader(root);
+    if (sources.empty()) {
+        sources = reader.sources();
+    }
+
+    printf("Time,Source,HR,SpO2,ABP,ECG_Classification,ECG_Confidence\n");
+    ArchiveReadStats totals;
+    double decodeSeconds = 0.0;
+    std::vector<ArchiveSample> samples;
+    char timeBuf[TimestampFormatter::kBufferSize];
+    for (const std::string& source : sources) {
+        samples.clear();
+        auto start = std::chrono::steady_clock::now();
+        if (!reader.read(source, fromMs, toMs, samples, &totals)) {
+            fprintf(stderr, "no archive for source %s in %s\n", source.c_str(), root.c_str());
+            continue;
+        }
+        decodeSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // The single-source archive directory is exported with an empty id
+        const char* id = source == "default" ? "" : source.c_str();
+        for (const ArchiveSample& s : samples) {
+            TimestampFormatter::formatSeconds(
+                TimestampFormatter::Clock::time_point(std::chrono::milliseconds(s.timeMs)), timeBuf);
+            printf("%s,%s,", timeBuf, id);
+            printValue(s.hr);
+            putchar(',');
+            printValue(s.spo2);
+            putchar(',');
+            if (s.systolic > 0 && s.diastolic > 0) {
+                printf("%d/%d", s.systolic, s.diastolic);
+            } else {
+                putchar('0');
+            }
+            printf(",%s,%g\n", s.ecgLabel.c_str(), s.ecgConfidence);
+        }
+    }
+
+    if (stats) {
+        fprintf(stderr, "sources: %zu\nblocks: %zu (%zu read)\nsamples: %zu\nencoded bytes read: %zu",
+                sources.size(), totals.blocks, totals.blocksRead, totals.samples, totals.encodedBytes);
+        if (totals.samples > 0) {
+            fprintf(stderr, " (%.2f per sample)", static_cast<double>(totals.encodedBytes) / totals.samples);
+        }
+        fprintf(stderr, "\nread + decode: %.3f s", decodeSeconds);
+        if (decodeSeconds > 0.0) {
+            fprintf(stderr, " (%.1f M samples/s)", totals.samples / decodeSeconds / 1e6);
+        }
+        fprintf(stderr, "\n");
+    }
+    return 0;
+}
@@ -0,0 +1,89 @@
+// Follow the live results ring published by the application.
+//
+// Usage: shm_tail [name] [--oldest]
+//
+// name defaults to /vitalsign_live (publish.shm_name). Prints one CSV line
+// per vitals record as it is published, and alarm events as "#"-prefixed
+// lines; --oldest starts with the records still in the ring. Exits when the producer shuts down. Polls every millisecond
+// when idle; a latency-critical consumer could spin on next() instead.
+
+#include "src/output/ShmReader.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <thread>
+
+namespace {
+
+volatile sig_atomic_t g_stop = 0;
+
+void onSignal(int) {
+    g_stop = 1;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string name = "/vitalsign_live";
+    bool fromOldest = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--oldest") == 0) {
+            fromOldest = true;
+        } else if (argv[i][0] == '/') {
+            name = argv[i];
+        } else {
+            fprintf(stderr, "usage: shm_tail [name] [--oldest]\n");
+            return 1;
+        }
+    }
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+
+    ShmReader reader;
+    if (!reader.open(name, fromOldest)) {
+        fprintf(stderr, "cannot open shared memory ring %s (is publish.enabled set?)\n", name.c_str());
+        return 1;
+    }
+    fprintf(stderr, "following %s: %" PRIu64 " slots, producer pid %" PRId64 "\n",
+            name.c_str(), reader.capacity(), reader.producerPid());
+
+    printf("Time,Source,HR,SpO2,Systolic,Diastolic,ECG_Classification,ECG_Confidence\n");
+    ShmRecord record;
+    while (!g_stop) {
+        ShmReader::Result result = reader.next(record);
+        if (result == ShmReader::Result::Closed) {
+            fprintf(stderr, "producer closed the ring\n");
+            break;
+        }
+        if (result == ShmReader::Result::Empty) {
+            fflush(stdout);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+
+        time_t seconds = static_cast<time_t>(record.timeUs / 1000000);
+        struct tm parts;
+        localtime_r(&seconds, &parts);
+        char timeBuf[32];
+        strftime(timeBuf, sizeof(timeBuf), "%Y-%m-%d %H:%M:%S", &parts);
+        int millis = static_cast<int>(record.timeUs / 1000 % 1000);
+        if (record.type == static_cast<uint32_t>(ShmRecordType::Alarm)) {
+            const ShmAlarm& alarm = record.alarm;
+            printf("# %s.%03d,%s,alarm %s %s,%s,%s=%d,latency %u us\n", timeBuf, millis, record.sourceId,
+                   alarm.raised ? "raised" : "cleared", alarm.rule, alarm.severity, alarm.field, alarm.value,
+                   alarm.latencyUs);
+            continue;
+        }
+        const ShmVitals& vitals = record.vitals;
+        printf("%s.%03d,%s,%d,%d,%d,%d,%s,%g\n", timeBuf, millis, record.sourceId, vitals.hr, vitals.spo2,
+               vitals.systolic, vitals.diastolic, vitals.ecgLabel, vitals.ecgConfidence);
+    }
+
+    fprintf(stderr, "records lost to overwrites: %" PRIu64 "\n", reader.lost());
+    return 0;
+}